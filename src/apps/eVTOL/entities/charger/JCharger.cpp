@@ -1,11 +1,15 @@
 #include "JCharger.h"
+#include <stdexcept>
+#include <core/serialization/JBinaryStream.h>
 
 namespace joby {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-
 Charger::Charger():
-    m_occupied(false)
+    m_occupied(false),
+    m_occupiedTime(0.0),
+    m_busyTime(0.0),
+    m_chargeCount(0)
 {
 }
 
@@ -13,6 +17,41 @@ Charger::~Charger()
 {
 }
 
+void Charger::occupy(double time)
+{
+    if (m_occupied) {
+        throw std::logic_error("Error, charger is already occupied");
+    }
+    m_occupied = true;
+    m_occupiedTime = time;
+    m_chargeCount++;
+}
+
+void Charger::release(double time)
+{
+    if (!m_occupied) {
+        throw std::logic_error("Error, charger is not occupied");
+    }
+    m_occupied = false;
+    m_busyTime += time - m_occupiedTime;
+}
+
+void Charger::save(BinaryWriter & writer) const
+{
+    writer.write(m_occupied);
+    writer.write(m_occupiedTime);
+    writer.write(m_busyTime);
+    writer.write(uint64_t(m_chargeCount));
+}
+
+void Charger::load(BinaryReader & reader)
+{
+    reader.read(m_occupied);
+    reader.read(m_occupiedTime);
+    reader.read(m_busyTime);
+    m_chargeCount = size_t(reader.read<uint64_t>());
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 } // end namespacing
@@ -1,11 +1,12 @@
 #ifndef J_CHARGER_H
 #define J_CHARGER_H
-/** @file JCharger.h 
+/** @file JCharger.h
     Defines a class representing a charger for an eVTOL aircraft
 */
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Includes
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <cstddef>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Namespace Definitions
@@ -15,6 +16,8 @@ namespace joby {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Forward Declarations
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class BinaryWriter;
+class BinaryReader;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Class Definitions
@@ -40,11 +43,36 @@ public:
     //-----------------------------------------------------------------------------------------------------------------
     /// @name Properties
     /// @{
+
+    bool isOccupied() const { return m_occupied; }
+
+    /// @brief The number of charges started on the charger
+    size_t chargeCount() const { return m_chargeCount; }
+
+    /// @brief The total time the charger has been occupied up to the given simulation time, in seconds
+    double busyTime(double time) const { return m_busyTime + (m_occupied ? time - m_occupiedTime : 0.0); }
+
+    /// @brief The fraction of the given span of simulation time that the charger has been occupied for
+    double utilization(double time, double elapsed) const { return elapsed > 0.0 ? busyTime(time) / elapsed : 0.0; }
+
     /// @}
 
     //-----------------------------------------------------------------------------------------------------------------
 	/// @name Public Methods
 	/// @{
+
+    /// @brief Connect a vehicle to the charger at the given simulation time
+    void occupy(double time);
+
+    /// @brief Disconnect the vehicle at the given simulation time
+    void release(double time);
+
+    /// @brief Write the state of the charger for a checkpoint
+    void save(BinaryWriter& writer) const;
+
+    /// @brief Restore state written by save()
+    void load(BinaryReader& reader);
+
 	/// @}
 
 protected:
@@ -58,6 +86,15 @@ protected:
     /// I would store this as a bitwise flag
     bool m_occupied;
 
+    /// @brief The simulation time at which the current vehicle was connected, in seconds
+    double m_occupiedTime;
+
+    /// @brief The total time spent occupied by vehicles that have since been disconnected, in seconds
+    double m_busyTime;
+
+    /// @brief The number of charges started on the charger
+    size_t m_chargeCount;
+
     /// @}
 
 };
@@ -66,4 +103,4 @@ protected:
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 } // end namespacing
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,220 @@
+#include "JChargerAllocator.h"
+#include <algorithm>
+#include <stdexcept>
+#include <core/serialization/JBinaryStream.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief The index of the lowest set bit of a nonzero word
+static uint32_t LowestSetBit(uint64_t word)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return uint32_t(index);
+#else
+    return uint32_t(__builtin_ctzll(word));
+#endif
+}
+
+const char * ChargerAllocator::PolicyName(ChargerQueuePolicy policy)
+{
+    switch (policy) {
+    case ChargerQueuePolicy::kFirstComeFirstServed:
+        return "First come, first served";
+    case ChargerQueuePolicy::kPriority:
+        return "Priority";
+    default:
+        return "Unknown";
+    }
+}
+
+ChargerAllocator::ChargerAllocator()
+{
+    resize(0);
+}
+
+ChargerAllocator::~ChargerAllocator()
+{
+}
+
+void ChargerAllocator::setPolicy(ChargerQueuePolicy policy)
+{
+    if (policy != m_policy && waitingCount()) {
+        throw std::logic_error("Error, cannot change the charger queue policy while aircraft are waiting");
+    }
+    m_policy = policy;
+}
+
+void ChargerAllocator::resize(size_t count)
+{
+    if (count > size_t(UINT32_MAX)) {
+        throw std::invalid_argument("Error, too many chargers");
+    }
+
+    // Clear chargers so they can all be reinitialized to default values
+    m_chargers.clear();
+    m_chargers.resize(count);
+    m_line.clear();
+    m_priorityLine.clear();
+    m_sequence = 0;
+    resetFreeBits();
+}
+
+size_t ChargerAllocator::memoryFootprint() const
+{
+    size_t bytes = m_chargers.capacity() * sizeof(Charger)
+        + m_freeBits.capacity() * sizeof(std::vector<uint64_t>)
+        + m_line.size() * sizeof(uint32_t)
+        + m_priorityLine.capacity() * sizeof(WaitingAircraft);
+    for (const std::vector<uint64_t>& level : m_freeBits) {
+        bytes += level.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+bool ChargerAllocator::tryAcquire(double time, uint32_t & outCharger)
+{
+    if (!m_freeCount) {
+        return false;
+    }
+
+    // Walk down from the top, following the lowest word with a free charger
+    uint32_t index = 0;
+    for (size_t level = m_freeBits.size(); level-- > 0;) {
+        index = index * 64 + LowestSetBit(m_freeBits[level][index]);
+    }
+    setFree(index, false);
+    m_chargers[index].occupy(time);
+    outCharger = index;
+    return true;
+}
+
+bool ChargerAllocator::release(uint32_t charger, double time, uint32_t & outAircraft)
+{
+    m_chargers[charger].release(time);
+    if (popWaiting(outAircraft)) {
+        // Hand over the charger without ever marking it as free
+        m_chargers[charger].occupy(time);
+        return true;
+    }
+    setFree(charger, true);
+    return false;
+}
+
+void ChargerAllocator::enqueue(uint32_t aircraft, double priority)
+{
+    if (m_policy == ChargerQueuePolicy::kPriority) {
+        m_priorityLine.push_back(WaitingAircraft{ priority, m_sequence++, aircraft });
+        std::push_heap(m_priorityLine.begin(), m_priorityLine.end());
+    }
+    else {
+        m_line.push_back(aircraft);
+    }
+}
+
+void ChargerAllocator::save(BinaryWriter & writer) const
+{
+    writer.write(uint64_t(m_chargers.size()));
+    for (const Charger& charger : m_chargers) {
+        charger.save(writer);
+    }
+    writer.write(m_policy);
+    writer.writeVector(std::vector<uint32_t>(m_line.begin(), m_line.end()));
+    writer.writeVector(m_priorityLine);
+    writer.write(m_sequence);
+}
+
+void ChargerAllocator::load(BinaryReader & reader)
+{
+    if (reader.read<uint64_t>() != m_chargers.size()) {
+        throw std::runtime_error("Error, checkpoint does not match the scene's chargers");
+    }
+    for (Charger& charger : m_chargers) {
+        charger.load(reader);
+    }
+    if (reader.read<ChargerQueuePolicy>() != m_policy) {
+        throw std::runtime_error("Error, checkpoint does not match the scene's charger queue policy");
+    }
+    std::vector<uint32_t> line;
+    reader.readVector(line);
+    m_line.assign(line.begin(), line.end());
+    reader.readVector(m_priorityLine);
+    reader.read(m_sequence);
+    resetFreeBits();
+}
+
+void ChargerAllocator::resetFreeBits()
+{
+    // Size each level of the bitmap to cover the one below, until a single word covers everything
+    m_freeBits.clear();
+    size_t bitCount = m_chargers.size();
+    do {
+        m_freeBits.emplace_back((bitCount + 63) / 64, 0);
+        bitCount = m_freeBits.back().size();
+    } while (bitCount > 1);
+
+    m_freeCount = 0;
+    for (uint32_t i = 0; i < m_chargers.size(); i++) {
+        if (!m_chargers[i].isOccupied()) {
+            setFree(i, true);
+        }
+    }
+}
+
+void ChargerAllocator::setFree(uint32_t charger, bool isFree)
+{
+    // Marking a charger twice would miscount the free chargers, and leave tryAcquire searching an empty word
+    if (charger >= m_chargers.size() || bool(m_freeBits[0][charger / 64] & (uint64_t(1) << (charger % 64))) == isFree) {
+        throw std::logic_error(isFree ? "Error, charger is already free" : "Error, charger is already in use");
+    }
+
+    uint64_t index = charger;
+    for (std::vector<uint64_t>& words : m_freeBits) {
+        uint64_t& word = words[index / 64];
+        uint64_t bit = uint64_t(1) << (index % 64);
+        bool wasEmpty = !word;
+        if (isFree) {
+            word |= bit;
+        }
+        else {
+            word &= ~bit;
+        }
+
+        // Only words that gained their first free charger, or lost their last, change the level above
+        if (wasEmpty == !word) {
+            break;
+        }
+        index /= 64;
+    }
+    m_freeCount += isFree ? 1 : size_t(-1);
+}
+
+bool ChargerAllocator::popWaiting(uint32_t & outAircraft)
+{
+    if (m_policy == ChargerQueuePolicy::kPriority) {
+        if (m_priorityLine.empty()) {
+            return false;
+        }
+        std::pop_heap(m_priorityLine.begin(), m_priorityLine.end());
+        outAircraft = uint32_t(m_priorityLine.back().m_aircraft);
+        m_priorityLine.pop_back();
+    }
+    else {
+        if (m_line.empty()) {
+            return false;
+        }
+        outAircraft = m_line.front();
+        m_line.pop_front();
+    }
+    return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
@@ -0,0 +1,181 @@
+#ifndef J_CHARGER_ALLOCATOR_H
+#define J_CHARGER_ALLOCATOR_H
+/** @file JChargerAllocator.h
+    Defines the assignment of chargers to aircraft, and the line of aircraft waiting for one
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include <apps/eVTOL/entities/charger/JCharger.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class BinaryWriter;
+class BinaryReader;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief The orders in which waiting aircraft are handed chargers
+enum class ChargerQueuePolicy : uint8_t {
+    kFirstComeFirstServed = 0, // In order of arrival
+    kPriority, // Lowest priority value first, and in order of arrival among equal priorities
+    COUNT
+};
+
+/// @class ChargerAllocator
+/// @brief Hands out chargers to aircraft, queueing aircraft while every charger is busy
+/// @details Free chargers are tracked by a hierarchical bitmap, in which each bit of a level records whether
+/// the corresponding word of the level below has any free chargers. Finding the lowest-numbered free charger
+/// walks one word per level, so takes O(log64 n) time, and claiming or freeing one updates at most one word
+/// per level. Waiting aircraft are kept in a FIFO line, or in a binary heap for priority order, so that
+/// handing a freed charger to the next aircraft never scans the line
+class ChargerAllocator {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Methods
+    /// @{
+
+    static const char* PolicyName(ChargerQueuePolicy policy);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    ChargerAllocator();
+    ~ChargerAllocator();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    const std::vector<Charger>& chargers() const { return m_chargers; }
+
+    /// @brief The number of chargers not in use
+    size_t freeCount() const { return m_freeCount; }
+
+    /// @brief The number of aircraft waiting for a charger
+    size_t waitingCount() const { return m_policy == ChargerQueuePolicy::kPriority ? m_priorityLine.size() : m_line.size(); }
+
+    /// @brief The order in which waiting aircraft are handed chargers
+    /// @details Can only be changed while no aircraft are waiting
+    ChargerQueuePolicy policy() const { return m_policy; }
+    void setPolicy(ChargerQueuePolicy policy);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Replace the chargers with the given number of free ones, and empty the line
+    void resize(size_t count);
+
+    /// @brief Claim the lowest-numbered free charger at the given time
+    /// @param[out] outCharger The index of the claimed charger
+    /// @return False if every charger is in use
+    bool tryAcquire(double time, uint32_t& outCharger);
+
+    /// @brief Free a charger at the given time, handing it straight to the next waiting aircraft if there is one
+    /// @param[out] outAircraft The index of the aircraft now occupying the charger
+    /// @return False if no aircraft was waiting, leaving the charger free
+    /// @details Throws if the charger is not in use
+    bool release(uint32_t charger, double time, uint32_t& outAircraft);
+
+    /// @brief Add an aircraft to the line for a charger
+    /// @param[in] priority The aircraft's place in line under the priority policy, where lower values go first.
+    /// Ignored under the first-come, first-served policy
+    void enqueue(uint32_t aircraft, double priority = 0.0);
+
+    /// @brief The number of bytes allocated for the chargers, the bitmap and the line
+    size_t memoryFootprint() const;
+
+    /// @brief Write the state of every charger and the line for a checkpoint
+    void save(BinaryWriter& writer) const;
+
+    /// @brief Restore state written by save()
+    /// @details The allocator must already hold the same number of chargers, and use the same policy
+    void load(BinaryReader& reader);
+
+	/// @}
+
+protected:
+
+    /// @brief An aircraft in the priority line
+    struct WaitingAircraft {
+        double m_priority;
+        uint64_t m_sequence;
+
+        /// @brief The index of the aircraft, stored wide so that checkpoints of the line hold no padding
+        uint64_t m_aircraft;
+
+        /// @brief Orders the heap so that its front is the lowest priority value, then the earliest arrival
+        bool operator<(const WaitingAircraft& other) const {
+            return m_priority > other.m_priority || (m_priority == other.m_priority && m_sequence > other.m_sequence);
+        }
+    };
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Methods
+    /// @{
+
+    /// @brief Rebuild the bitmap from the occupancy of each charger
+    void resetFreeBits();
+
+    /// @brief Mark a charger as free or in use in every level of the bitmap
+    /// @details Throws if the charger is already marked that way
+    void setFree(uint32_t charger, bool isFree);
+
+    /// @brief Pop the next aircraft from the line, if there is one
+    bool popWaiting(uint32_t& outAircraft);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    /// @brief The chargers, indexed by charger
+    std::vector<Charger> m_chargers;
+
+    /// @brief The levels of the free bitmap, from one bit per charger up to a single word
+    std::vector<std::vector<uint64_t>> m_freeBits;
+
+    /// @brief The number of chargers not in use
+    size_t m_freeCount = 0;
+
+    /// @brief The order in which waiting aircraft are handed chargers
+    ChargerQueuePolicy m_policy = ChargerQueuePolicy::kFirstComeFirstServed;
+
+    /// @brief Aircraft waiting under the first-come, first-served policy, in order of arrival
+    std::deque<uint32_t> m_line;
+
+    /// @brief Aircraft waiting under the priority policy, as a binary heap
+    std::vector<WaitingAircraft> m_priorityLine;
+
+    /// @brief The number of aircraft that have joined the priority line, used to break ties in order of arrival
+    uint64_t m_sequence = 0;
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
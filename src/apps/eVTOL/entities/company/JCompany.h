@@ -7,6 +7,7 @@
 // Includes
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #include <string>
+#include <core/statistics/JDistribution.h>
 #include <apps/eVTOL/entities/vehicle/JeVTOL.h>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -21,6 +22,86 @@ namespace joby {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Class Definitions
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @struct CompanyStatistics
+/// @brief Totals accumulated over a simulation for all of a company's aircraft
+struct CompanyStatistics {
+    /// @brief Add the totals from another part of the simulation, e.g. another vertiport
+    CompanyStatistics& operator+=(const CompanyStatistics& other) {
+        m_flightCount += other.m_flightCount;
+        m_flightTime += other.m_flightTime;
+        m_distance += other.m_distance;
+        m_chargeCount += other.m_chargeCount;
+        m_chargeTime += other.m_chargeTime;
+        m_waitTime += other.m_waitTime;
+        m_faultCount += other.m_faultCount;
+        m_passengerMiles += other.m_passengerMiles;
+        return *this;
+    }
+
+    /// @brief The number of flights started
+    size_t m_flightCount = 0;
+
+    /// @brief The total time spent in flight, in hours
+    double m_flightTime = 0.0;
+
+    /// @brief The total distance flown, in miles
+    double m_distance = 0.0;
+
+    /// @brief The number of charging sessions started
+    size_t m_chargeCount = 0;
+
+    /// @brief The total time spent connected to a charger, in hours
+    double m_chargeTime = 0.0;
+
+    /// @brief The total time spent waiting in line for a charger, in hours
+    double m_waitTime = 0.0;
+
+    /// @brief The number of faults encountered
+    size_t m_faultCount = 0;
+
+    /// @brief The total distance flown by all passengers, in miles
+    double m_passengerMiles = 0.0;
+};
+
+/// @struct CompanyDistributions
+/// @brief How the individual flights and charging sessions of a company's aircraft are spread, as opposed to
+/// their totals
+struct CompanyDistributions {
+    /// @brief Fold in the distributions from another part of the simulation, e.g. another vertiport
+    void merge(const CompanyDistributions& other) {
+        m_flightTime.merge(other.m_flightTime);
+        m_distance.merge(other.m_distance);
+        m_chargeTime.merge(other.m_chargeTime);
+        m_waitTime.merge(other.m_waitTime);
+    }
+
+    void save(BinaryWriter& writer) const {
+        m_flightTime.save(writer);
+        m_distance.save(writer);
+        m_chargeTime.save(writer);
+        m_waitTime.save(writer);
+    }
+
+    void load(BinaryReader& reader) {
+        m_flightTime.load(reader);
+        m_distance.load(reader);
+        m_chargeTime.load(reader);
+        m_waitTime.load(reader);
+    }
+
+    /// @brief The length of each flight that ended in a landing, in hours, told apart to the second
+    Distribution m_flightTime{ 1.0 / 3600.0 };
+
+    /// @brief The distance of each flight that ended in a landing, in miles, told apart to a hundredth of a mile
+    Distribution m_distance{ 0.01 };
+
+    /// @brief The length of each completed charge, in hours
+    Distribution m_chargeTime{ 1.0 / 3600.0 };
+
+    /// @brief The time each aircraft spent in line before each charge, in hours
+    Distribution m_waitTime{ 1.0 / 3600.0 };
+};
+
 /// @class Company
 /// @brief Defines an eVTOL manufacturer
 /// @note I decided that this class was a nice way to have a factory generator of specifically-configured
@@ -47,9 +128,19 @@ public:
     /// @name Properties
     /// @{
 
+    const std::string& name() const { return m_name; }
+
     const Aircraft& aircraftSpec() const { return m_aircraftSpec; }
     void setAircraftSpec(const Aircraft& aircraft) { m_aircraftSpec = aircraft; }
 
+    /// @brief Totals for the company's aircraft over the current simulation
+    CompanyStatistics& statistics() { return m_statistics; }
+    const CompanyStatistics& statistics() const { return m_statistics; }
+
+    /// @brief The spread of the company's flights and charges over the current simulation
+    CompanyDistributions& distributions() { return m_distributions; }
+    const CompanyDistributions& distributions() const { return m_distributions; }
+
     /// @}
 
     //-----------------------------------------------------------------------------------------------------------------
@@ -71,6 +162,12 @@ protected:
     /// @details This aircraft acts as a blueprint for all aircrafts instantiated by the company
     Aircraft m_aircraftSpec;
 
+    /// @brief Totals for the company's aircraft over the current simulation
+    CompanyStatistics m_statistics;
+
+    /// @brief The spread of the company's flights and charges over the current simulation
+    CompanyDistributions m_distributions;
+
     /// @}
 
 };
@@ -0,0 +1,301 @@
+#include "JFleet.h"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <core/serialization/JBinaryStream.h>
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+Fleet::Fleet()
+{
+}
+
+Fleet::~Fleet()
+{
+}
+
+uint32_t Fleet::addSpecification(const Aircraft & specification)
+{
+    m_specifications.push_back(specification);
+
+    // Energy use is per mile, so convert to a rate per hour of cruise
+    m_energiesPerHour.push_back(specification.energyUse() * specification.cruiseSpeed());
+    m_cruiseSpeeds.push_back(specification.cruiseSpeed());
+    m_flyingCounts.push_back(0);
+    return uint32_t(m_specifications.size() - 1);
+}
+
+uint32_t Fleet::add(uint32_t companyId, uint32_t vertiportId)
+{
+    if (companyId >= m_specifications.size()) {
+        throw std::invalid_argument("Error, no specification for the aircraft's company");
+    }
+    m_companyIds.push_back(companyId);
+    m_vertiportIds.push_back(vertiportId);
+    m_states.push_back(AircraftState::kFlying);
+    m_batteryCharges.push_back(m_specifications[companyId].batteryCapacity());
+    m_stateStartTimes.push_back(0.0);
+    m_hoursToFault.push_back(0.0);
+    m_passengerCounts.push_back(uint32_t(m_specifications[companyId].maxPassengerCount()));
+    m_distances.push_back(0.0);
+    m_waitTimes.push_back(0.0);
+    m_flyingCounts[companyId]++;
+    return uint32_t(m_companyIds.size() - 1);
+}
+
+uint32_t Fleet::add(const uint32_t * companyIds, const uint32_t * vertiportIds, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (companyIds[i] >= m_specifications.size()) {
+            throw std::invalid_argument("Error, no specification for the aircraft's company");
+        }
+    }
+    size_t first = m_companyIds.size();
+    reserve(first + count);
+    m_companyIds.insert(m_companyIds.end(), companyIds, companyIds + count);
+    m_vertiportIds.insert(m_vertiportIds.end(), vertiportIds, vertiportIds + count);
+    m_states.resize(first + count, AircraftState::kFlying);
+    m_stateStartTimes.resize(first + count, 0.0);
+    m_hoursToFault.resize(first + count, 0.0);
+    m_distances.resize(first + count, 0.0);
+    m_waitTimes.resize(first + count, 0.0);
+    for (size_t i = 0; i < count; i++) {
+        m_batteryCharges.push_back(m_specifications[companyIds[i]].batteryCapacity());
+        m_passengerCounts.push_back(uint32_t(m_specifications[companyIds[i]].maxPassengerCount()));
+        m_flyingCounts[companyIds[i]]++;
+    }
+    return uint32_t(first);
+}
+
+void Fleet::reserve(size_t aircraftCount)
+{
+    m_companyIds.reserve(aircraftCount);
+    m_vertiportIds.reserve(aircraftCount);
+    m_states.reserve(aircraftCount);
+    m_batteryCharges.reserve(aircraftCount);
+    m_stateStartTimes.reserve(aircraftCount);
+    m_hoursToFault.reserve(aircraftCount);
+    m_passengerCounts.reserve(aircraftCount);
+    m_distances.reserve(aircraftCount);
+    m_waitTimes.reserve(aircraftCount);
+}
+
+size_t Fleet::memoryFootprint() const
+{
+    return m_specifications.capacity() * sizeof(Aircraft)
+        + (m_energiesPerHour.capacity() + m_cruiseSpeeds.capacity()) * sizeof(double)
+        + m_flyingCounts.capacity() * sizeof(uint32_t)
+        + (m_companyIds.capacity() + m_vertiportIds.capacity() + m_passengerCounts.capacity()) * sizeof(uint32_t)
+        + m_states.capacity() * sizeof(AircraftState)
+        + (m_batteryCharges.capacity() + m_stateStartTimes.capacity() + m_hoursToFault.capacity()
+            + m_distances.capacity() + m_waitTimes.capacity()) * sizeof(double);
+}
+
+void Fleet::clear()
+{
+    m_specifications.clear();
+    m_energiesPerHour.clear();
+    m_cruiseSpeeds.clear();
+    m_flyingCounts.clear();
+    m_companyIds.clear();
+    m_vertiportIds.clear();
+    m_states.clear();
+    m_batteryCharges.clear();
+    m_stateStartTimes.clear();
+    m_hoursToFault.clear();
+    m_passengerCounts.clear();
+    m_distances.clear();
+    m_waitTimes.clear();
+}
+
+void Fleet::save(BinaryWriter & writer) const
+{
+    writer.writeVector(m_companyIds);
+    writer.writeVector(m_vertiportIds);
+    writer.writeVector(m_states);
+    writer.writeVector(m_batteryCharges);
+    writer.writeVector(m_stateStartTimes);
+    writer.writeVector(m_hoursToFault);
+    writer.writeVector(m_passengerCounts);
+    writer.writeVector(m_distances);
+    writer.writeVector(m_waitTimes);
+}
+
+void Fleet::load(BinaryReader & reader)
+{
+    std::vector<uint32_t> companyIds;
+    reader.readVector(companyIds);
+    if (companyIds != m_companyIds) {
+        throw std::runtime_error("Error, checkpoint does not match the fleet's aircraft");
+    }
+    reader.readVector(m_vertiportIds);
+    reader.readVector(m_states);
+    reader.readVector(m_batteryCharges);
+    reader.readVector(m_stateStartTimes);
+    reader.readVector(m_hoursToFault);
+    reader.readVector(m_passengerCounts);
+    reader.readVector(m_distances);
+    reader.readVector(m_waitTimes);
+    if (m_vertiportIds.size() != size() || m_states.size() != size() || m_batteryCharges.size() != size() || m_stateStartTimes.size() != size() ||
+        m_hoursToFault.size() != size() || m_passengerCounts.size() != size() || m_distances.size() != size() || m_waitTimes.size() != size()) {
+        throw std::runtime_error("Error, checkpoint does not match the fleet's aircraft");
+    }
+    countFlying();
+}
+
+void Fleet::setCountsFlying(bool countsFlying)
+{
+    bool wasCounting = m_countsFlying;
+    m_countsFlying = countsFlying;
+    if (countsFlying && !wasCounting) {
+        countFlying();
+    }
+}
+
+void Fleet::countFlying()
+{
+    std::fill(m_flyingCounts.begin(), m_flyingCounts.end(), 0);
+    for (uint32_t i = 0; i < size(); i++) {
+        m_flyingCounts[m_companyIds[i]] += m_states[i] == AircraftState::kFlying ? 1 : 0;
+    }
+}
+
+void Fleet::setKernel(SimdLevel kernel)
+{
+    if (!Simd::IsSupported(kernel)) {
+        throw std::invalid_argument(std::string("Error, ") + Simd::LevelName(kernel) + " is not supported on this CPU");
+    }
+    m_kernel = kernel;
+}
+
+void Fleet::step(double deltaSec, std::vector<uint32_t>& outInterrupted)
+{
+    outInterrupted.clear();
+    double deltaHours = Units::Convert<TimeUnits::kSeconds, TimeUnits::kHours>(deltaSec);
+    uint32_t aircraftCount = uint32_t(size());
+    switch (m_kernel) {
+    case SimdLevel::kAvx2:
+        stepAvx2(0, aircraftCount, deltaHours, outInterrupted);
+        break;
+    case SimdLevel::kSse2:
+        stepSse2(0, aircraftCount, deltaHours, outInterrupted);
+        break;
+    default:
+        stepScalar(0, aircraftCount, deltaHours, outInterrupted);
+        break;
+    }
+}
+
+void Fleet::stepScalar(uint32_t begin, uint32_t end, double deltaHours, std::vector<uint32_t>& outInterrupted)
+{
+    // Mirrors fly(), and the fault countdown of the fleet process, for an aircraft that flies the whole step
+    for (uint32_t i = begin; i < end; i++) {
+        if (m_states[i] != AircraftState::kFlying) {
+            continue;
+        }
+        uint32_t companyId = m_companyIds[i];
+        double energyNeeded = m_energiesPerHour[companyId] * deltaHours;
+        if (energyNeeded < m_batteryCharges[i] && m_hoursToFault[i] > deltaHours) {
+            m_batteryCharges[i] -= energyNeeded;
+            m_hoursToFault[i] -= deltaHours;
+            m_distances[i] += m_cruiseSpeeds[companyId] * deltaHours;
+        }
+        else {
+            outInterrupted.push_back(i);
+        }
+    }
+}
+
+void Fleet::stepSse2(uint32_t begin, uint32_t end, double deltaHours, std::vector<uint32_t>& outInterrupted)
+{
+    uint32_t i = begin;
+#ifdef J_SIMD_X86
+    const __m128d delta = _mm_set1_pd(deltaHours);
+    for (; i + 2 <= end; i += 2) {
+        bool flying0 = m_states[i] == AircraftState::kFlying;
+        bool flying1 = m_states[i + 1] == AircraftState::kFlying;
+        if (!flying0 && !flying1) {
+            continue;
+        }
+        __m128d flying = _mm_castsi128_pd(_mm_set_epi64x(flying1 ? -1 : 0, flying0 ? -1 : 0));
+
+        // SSE2 has no gathers, so load the company values one lane at a time
+        uint32_t companyId0 = m_companyIds[i];
+        uint32_t companyId1 = m_companyIds[i + 1];
+        __m128d energyPerHour = _mm_set_pd(m_energiesPerHour[companyId1], m_energiesPerHour[companyId0]);
+        __m128d cruiseSpeed = _mm_set_pd(m_cruiseSpeeds[companyId1], m_cruiseSpeeds[companyId0]);
+
+        __m128d charge = _mm_loadu_pd(&m_batteryCharges[i]);
+        __m128d hoursToFault = _mm_loadu_pd(&m_hoursToFault[i]);
+        __m128d distance = _mm_loadu_pd(&m_distances[i]);
+        __m128d energyNeeded = _mm_mul_pd(energyPerHour, delta);
+        __m128d fullStep = _mm_and_pd(_mm_cmplt_pd(energyNeeded, charge), _mm_cmpgt_pd(hoursToFault, delta));
+        __m128d update = _mm_and_pd(flying, fullStep);
+
+        // Blend, so that lanes that are not flying a full step are written back unchanged
+        charge = _mm_or_pd(_mm_and_pd(update, _mm_sub_pd(charge, energyNeeded)), _mm_andnot_pd(update, charge));
+        hoursToFault = _mm_or_pd(_mm_and_pd(update, _mm_sub_pd(hoursToFault, delta)), _mm_andnot_pd(update, hoursToFault));
+        distance = _mm_or_pd(_mm_and_pd(update, _mm_add_pd(distance, _mm_mul_pd(cruiseSpeed, delta))), _mm_andnot_pd(update, distance));
+        _mm_storeu_pd(&m_batteryCharges[i], charge);
+        _mm_storeu_pd(&m_hoursToFault[i], hoursToFault);
+        _mm_storeu_pd(&m_distances[i], distance);
+
+        int interrupted = _mm_movemask_pd(_mm_andnot_pd(fullStep, flying));
+        for (uint32_t lane = 0; interrupted; lane++, interrupted >>= 1) {
+            if (interrupted & 1) {
+                outInterrupted.push_back(i + lane);
+            }
+        }
+    }
+#endif
+    stepScalar(i, end, deltaHours, outInterrupted);
+}
+
+J_TARGET_AVX2 void Fleet::stepAvx2(uint32_t begin, uint32_t end, double deltaHours, std::vector<uint32_t>& outInterrupted)
+{
+    uint32_t i = begin;
+#ifdef J_SIMD_X86
+    static_assert(sizeof(AircraftState) == 1 && AircraftState::kFlying == AircraftState(0), "Error, the AVX2 kernel reads states as zero bytes");
+    const __m256d delta = _mm256_set1_pd(deltaHours);
+    const __m256d allLanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    for (; i + 4 <= end; i += 4) {
+        int32_t states;
+        std::memcpy(&states, &m_states[i], sizeof(states));
+        __m256i widenedStates = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(states));
+        __m256d flying = _mm256_castsi256_pd(_mm256_cmpeq_epi64(widenedStates, _mm256_setzero_si256()));
+        if (!_mm256_movemask_pd(flying)) {
+            continue;
+        }
+
+        __m128i companyIds = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_companyIds[i]));
+        // Masked gathers with every lane enabled, since the unmasked form reads an uninitialized source register
+        __m256d energyPerHour = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), m_energiesPerHour.data(), companyIds, allLanes, sizeof(double));
+        __m256d cruiseSpeed = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), m_cruiseSpeeds.data(), companyIds, allLanes, sizeof(double));
+
+        __m256d charge = _mm256_loadu_pd(&m_batteryCharges[i]);
+        __m256d hoursToFault = _mm256_loadu_pd(&m_hoursToFault[i]);
+        __m256d distance = _mm256_loadu_pd(&m_distances[i]);
+        __m256d energyNeeded = _mm256_mul_pd(energyPerHour, delta);
+        __m256d fullStep = _mm256_and_pd(_mm256_cmp_pd(energyNeeded, charge, _CMP_LT_OQ), _mm256_cmp_pd(hoursToFault, delta, _CMP_GT_OQ));
+        __m256d update = _mm256_and_pd(flying, fullStep);
+
+        // Blend, so that lanes that are not flying a full step are written back unchanged
+        _mm256_storeu_pd(&m_batteryCharges[i], _mm256_blendv_pd(charge, _mm256_sub_pd(charge, energyNeeded), update));
+        _mm256_storeu_pd(&m_hoursToFault[i], _mm256_blendv_pd(hoursToFault, _mm256_sub_pd(hoursToFault, delta), update));
+        _mm256_storeu_pd(&m_distances[i], _mm256_blendv_pd(distance, _mm256_add_pd(distance, _mm256_mul_pd(cruiseSpeed, delta)), update));
+
+        int interrupted = _mm256_movemask_pd(_mm256_andnot_pd(fullStep, flying));
+        for (uint32_t lane = 0; interrupted; lane++, interrupted >>= 1) {
+            if (interrupted & 1) {
+                outInterrupted.push_back(i + lane);
+            }
+        }
+    }
+#endif
+    stepScalar(i, end, deltaHours, outInterrupted);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
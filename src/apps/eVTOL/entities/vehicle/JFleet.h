@@ -0,0 +1,301 @@
+#ifndef J_FLEET_H
+#define J_FLEET_H
+/** @file JFleet.h
+    Defines the storage for the dynamic state of every aircraft in a scene
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <core/physics/JUnits.h>
+#include <core/simd/JSimd.h>
+#include <apps/eVTOL/entities/vehicle/JeVTOL.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class BinaryWriter;
+class BinaryReader;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @class Fleet
+/// @brief Stores the dynamic state of a set of aircraft as a structure of arrays
+/// @details Each dynamic field has its own contiguous array, indexed by aircraft, so that a pass over one
+/// field of every aircraft only touches the memory holding that field. Specifications are not copied into
+/// each aircraft, but looked up by company index in a table that is small enough to stay in cache
+/// @note Aircraft states must be changed through setState(), which keeps count of the aircraft flying for
+/// each company unless counting is switched off
+class Fleet {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Methods
+    /// @{
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    Fleet();
+    ~Fleet();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    /// @brief The number of aircraft in the fleet
+    size_t size() const { return m_companyIds.size(); }
+    bool empty() const { return m_companyIds.empty(); }
+
+    /// @brief The number of companies with a specification in the fleet
+    size_t specificationCount() const { return m_specifications.size(); }
+
+    /// @brief The specification of a company's aircraft
+    const Aircraft& companySpecification(uint32_t companyId) const { return m_specifications[companyId]; }
+
+    /// @brief The specification of the company that built an aircraft
+    const Aircraft& specification(uint32_t aircraftIndex) const { return m_specifications[m_companyIds[aircraftIndex]]; }
+
+    /// @brief The index of the company that built an aircraft
+    uint32_t companyId(uint32_t aircraftIndex) const { return m_companyIds[aircraftIndex]; }
+
+    /// @brief The current operational state of an aircraft
+    AircraftState state(uint32_t aircraftIndex) const { return m_states[aircraftIndex]; }
+    void setState(uint32_t aircraftIndex, AircraftState state) {
+        AircraftState& currentState = m_states[aircraftIndex];
+        if (currentState != state && m_countsFlying) {
+            uint32_t& flyingCount = m_flyingCounts[m_companyIds[aircraftIndex]];
+            flyingCount += state == AircraftState::kFlying ? 1 : 0;
+            flyingCount -= currentState == AircraftState::kFlying ? 1 : 0;
+        }
+        currentState = state;
+    }
+
+    /// @brief Whether setState() keeps count of the aircraft flying for each company
+    /// @details Switched off while aircraft change state from several threads at once, e.g. when vertiports
+    /// are run as partitions. The counts are rebuilt when it is switched back on
+    bool countsFlying() const { return m_countsFlying; }
+    void setCountsFlying(bool countsFlying);
+
+    /// @brief The number of flying aircraft built by a company
+    uint32_t flyingCount(uint32_t companyId) const { return m_flyingCounts[companyId]; }
+
+    /// @brief The number of flying aircraft built by each company
+    const std::vector<uint32_t>& flyingCounts() const { return m_flyingCounts; }
+
+    /// @brief The index of the vertiport that an aircraft is at, or is flying to
+    uint32_t vertiportId(uint32_t aircraftIndex) const { return m_vertiportIds[aircraftIndex]; }
+    void setVertiportId(uint32_t aircraftIndex, uint32_t vertiportId) { m_vertiportIds[aircraftIndex] = vertiportId; }
+
+    /// @brief The energy remaining in an aircraft's battery, in kWh
+    double batteryCharge(uint32_t aircraftIndex) const { return m_batteryCharges[aircraftIndex]; }
+    void setBatteryCharge(uint32_t aircraftIndex, double charge) { m_batteryCharges[aircraftIndex] = charge; }
+
+    /// @brief The simulation time at which an aircraft entered its current state, in seconds
+    double stateStartTime(uint32_t aircraftIndex) const { return m_stateStartTimes[aircraftIndex]; }
+    void setStateStartTime(uint32_t aircraftIndex, double time) { m_stateStartTimes[aircraftIndex] = time; }
+
+    /// @brief The flight time remaining until an aircraft's next fault, in hours
+    double hoursToFault(uint32_t aircraftIndex) const { return m_hoursToFault[aircraftIndex]; }
+    void setHoursToFault(uint32_t aircraftIndex, double hours) { m_hoursToFault[aircraftIndex] = hours; }
+
+    /// @brief The number of passengers aboard an aircraft on its current or last flight
+    /// @details Starts out as the aircraft's capacity, which every flight carries unless the scene models demand
+    uint32_t passengerCount(uint32_t aircraftIndex) const { return m_passengerCounts[aircraftIndex]; }
+    void setPassengerCount(uint32_t aircraftIndex, uint32_t count) { m_passengerCounts[aircraftIndex] = count; }
+
+    /// @brief The total distance flown by an aircraft, in miles
+    double distance(uint32_t aircraftIndex) const { return m_distances[aircraftIndex]; }
+
+    /// @brief The total time an aircraft has spent waiting for a charger, in hours
+    double waitTime(uint32_t aircraftIndex) const { return m_waitTimes[aircraftIndex]; }
+    void addWaitTime(uint32_t aircraftIndex, double hours) { m_waitTimes[aircraftIndex] += hours; }
+
+    /// @brief The instruction set used by step()
+    /// @details Defaults to the most capable one supported by the CPU. Every kernel gives identical results
+    SimdLevel kernel() const { return m_kernel; }
+    void setKernel(SimdLevel kernel);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Add the specification of the next company, returning its index
+    uint32_t addSpecification(const Aircraft& specification);
+
+    /// @brief Add a fully charged aircraft built by the given company, returning its index
+    /// @param[in] vertiportId The vertiport that the aircraft is first bound for
+    uint32_t add(uint32_t companyId, uint32_t vertiportId = 0);
+
+    /// @brief Add a run of fully charged aircraft at once, returning the index of the first
+    /// @param[in] companyIds The company that built each aircraft
+    /// @param[in] vertiportIds The vertiport that each aircraft is first bound for
+    uint32_t add(const uint32_t* companyIds, const uint32_t* vertiportIds, size_t count);
+
+    /// @brief Allocate room for the given number of aircraft in every array, so that adding them doesn't reallocate
+    void reserve(size_t aircraftCount);
+
+    /// @brief The number of bytes allocated for the fleet's arrays
+    size_t memoryFootprint() const;
+
+    /// @brief Remove every aircraft and specification
+    void clear();
+
+    /// @brief Fly an aircraft at cruise for up to the given time, draining its battery and adding to its distance
+    /// @param[in] deltaSec The time to fly for, in seconds
+    /// @return The time actually flown, in seconds, which is less than requested if the battery ran out
+    double fly(uint32_t aircraftIndex, double deltaSec) {
+        uint32_t companyId = m_companyIds[aircraftIndex];
+        double& charge = m_batteryCharges[aircraftIndex];
+        double energyPerHour = m_energiesPerHour[companyId];
+        double energyNeeded = energyPerHour * Units::Convert<TimeUnits::kSeconds, TimeUnits::kHours>(deltaSec);
+        double secondsFlown = deltaSec;
+        if (energyNeeded < charge) {
+            charge -= energyNeeded;
+        }
+        else {
+            // The battery runs out partway through
+            double hoursFlown = charge / energyPerHour;
+            charge = 0.0;
+            secondsFlown = std::min(deltaSec, Units::Convert<TimeUnits::kHours, TimeUnits::kSeconds>(hoursFlown));
+        }
+        m_distances[aircraftIndex] += m_cruiseSpeeds[companyId] * Units::Convert<TimeUnits::kSeconds, TimeUnits::kHours>(secondsFlown);
+        return secondsFlown;
+    }
+
+    /// @brief The flight time until an aircraft's battery runs out at cruise, in hours
+    /// @details Infinite for aircraft that use no energy
+    double hoursToDepletion(uint32_t aircraftIndex) const {
+        double energyPerHour = m_energiesPerHour[m_companyIds[aircraftIndex]];
+        return energyPerHour > 0.0 ? m_batteryCharges[aircraftIndex] / energyPerHour : std::numeric_limits<double>::infinity();
+    }
+
+    /// @brief The flight time of a company's aircraft at cruise on a full battery, in hours
+    /// @details Infinite for aircraft that use no energy
+    double fullChargeHours(uint32_t companyId) const {
+        double energyPerHour = m_energiesPerHour[companyId];
+        return energyPerHour > 0.0 ? m_specifications[companyId].batteryCapacity() / energyPerHour : std::numeric_limits<double>::infinity();
+    }
+
+    /// @brief Fly an aircraft at cruise until its battery runs out, adding to its distance
+    /// @return The time flown, in hours, which is exactly hoursToDepletion()
+    double flyUntilDepleted(uint32_t aircraftIndex) {
+        double hoursFlown = hoursToDepletion(aircraftIndex);
+        m_batteryCharges[aircraftIndex] = 0.0;
+        m_distances[aircraftIndex] += m_cruiseSpeeds[m_companyIds[aircraftIndex]] * hoursFlown;
+        return hoursFlown;
+    }
+
+    /// @brief Fly every flying aircraft for a full step, except those whose battery would run out or that would
+    /// fault during the step
+    /// @details This is the bulk of each step of the fleet, and is vectorized with the instruction set given by
+    /// kernel(). Aircraft that were passed over are left untouched for the caller to fly()
+    /// @param[in] deltaSec The length of the step, in seconds
+    /// @param[out] outInterrupted Cleared, then filled with the indices of the aircraft that were passed over, in order
+    void step(double deltaSec, std::vector<uint32_t>& outInterrupted);
+
+    /// @brief Fill an aircraft's battery back up to capacity
+    void recharge(uint32_t aircraftIndex) { m_batteryCharges[aircraftIndex] = specification(aircraftIndex).batteryCapacity(); }
+
+    /// @brief Write the state of every aircraft for a checkpoint
+    /// @details Specifications are not written, since they come from the scene's companies
+    void save(BinaryWriter& writer) const;
+
+    /// @brief Restore state written by save()
+    /// @details The fleet must already hold the same number of aircraft
+    void load(BinaryReader& reader);
+
+	/// @}
+
+protected:
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Methods
+    /// @{
+
+    /// @brief Rebuild the number of flying aircraft built by each company from their states
+    void countFlying();
+
+    /// @brief Step the aircraft in [begin, end) one at a time
+    void stepScalar(uint32_t begin, uint32_t end, double deltaHours, std::vector<uint32_t>& outInterrupted);
+
+    /// @brief Step the aircraft in [begin, end) two at a time, finishing off with stepScalar()
+    void stepSse2(uint32_t begin, uint32_t end, double deltaHours, std::vector<uint32_t>& outInterrupted);
+
+    /// @brief Step the aircraft in [begin, end) four at a time, finishing off with stepScalar()
+    J_TARGET_AVX2 void stepAvx2(uint32_t begin, uint32_t end, double deltaHours, std::vector<uint32_t>& outInterrupted);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    /// @brief The specification of each company's aircraft, indexed by company
+    std::vector<Aircraft> m_specifications;
+
+    /// @brief The energy used by each company's aircraft per hour of cruise, in kWh
+    std::vector<double> m_energiesPerHour;
+
+    /// @brief The cruise speed of each company's aircraft, in mph
+    std::vector<double> m_cruiseSpeeds;
+
+    /// @brief The number of flying aircraft built by each company
+    std::vector<uint32_t> m_flyingCounts;
+
+    /// @brief Whether setState() keeps count of the aircraft flying for each company
+    bool m_countsFlying = true;
+
+    /// @brief The index of the company that built each aircraft
+    std::vector<uint32_t> m_companyIds;
+
+    /// @brief The index of the vertiport that each aircraft is at, or is flying to
+    std::vector<uint32_t> m_vertiportIds;
+
+    /// @brief The current operational state of each aircraft
+    std::vector<AircraftState> m_states;
+
+    /// @brief The energy remaining in each aircraft's battery, in kWh
+    std::vector<double> m_batteryCharges;
+
+    /// @brief The simulation time at which each aircraft entered its current state, in seconds
+    std::vector<double> m_stateStartTimes;
+
+    /// @brief The flight time remaining until each aircraft's next fault, in hours
+    std::vector<double> m_hoursToFault;
+
+    /// @brief The number of passengers aboard each aircraft on its current or last flight
+    std::vector<uint32_t> m_passengerCounts;
+
+    /// @brief The total distance flown by each aircraft, in miles
+    std::vector<double> m_distances;
+
+    /// @brief The total time each aircraft has spent waiting for a charger, in hours
+    std::vector<double> m_waitTimes;
+
+    /// @brief The instruction set used by step()
+    SimdLevel m_kernel = Simd::SupportedLevel();
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
@@ -13,10 +13,6 @@ Aircraft::Aircraft(double cruiseSpeed, double batteryCapacity, double chargeTime
 {
 }
 
-Aircraft::~Aircraft()
-{
-}
-
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 } // end namespacing
@@ -6,6 +6,8 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Includes
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+#include <cstddef>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Namespace Definitions
@@ -19,8 +21,19 @@ namespace joby {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Class Definitions
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief The operational states of an aircraft
+enum class AircraftState : uint8_t {
+    kFlying = 0, // Cruising until the battery runs out
+    kWaiting, // Waiting in line for a charger
+    kCharging, // Connected to a charger
+    kIdle, // Charged, and waiting at a vertiport for passengers
+    COUNT
+};
+
 /// @class Aircraft
-/// @brief Defines an eVTOL aircraft
+/// @brief Defines the specification of an eVTOL aircraft
+/// @details The dynamic state of each aircraft in flight is kept by a Fleet, which refers back to the
+/// specification of the company that built it
 /// @note In production code, I would likely create an abstract class representing a generic
 /// aircraft, or even a vehicle. However, since this problem only assumes one type of vehicle,
 /// I didn't bother
@@ -38,13 +51,20 @@ public:
     /// @{
 
     Aircraft(double cruiseSpeed, double batteryCapacity, double chargeTime, double energyUse, size_t maxPassengerCount, double failureRate);
-    ~Aircraft();
 
     /// @}
 
     //-----------------------------------------------------------------------------------------------------------------
     /// @name Properties
     /// @{
+
+    double cruiseSpeed() const { return m_cruiseSpeed; }
+    double batteryCapacity() const { return m_batteryCapacity; }
+    double chargeTime() const { return m_chargeTime; }
+    double energyUse() const { return m_energyUse; }
+    size_t maxPassengerCount() const { return m_maxPassengerCount; }
+    double failureRate() const { return m_failureRate; }
+
     /// @}
 
     //-----------------------------------------------------------------------------------------------------------------
@@ -82,15 +102,6 @@ protected:
 
     /// @}
 
-private:
-
-    /// @brief The unique ID corresponding to the company that created the eVTOL
-    size_t m_companyId;
-
-    /// @brief The unique ID corresponding to this eVTOL
-    size_t m_id;
-
-
 };
 
 
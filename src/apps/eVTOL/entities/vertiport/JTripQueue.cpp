@@ -0,0 +1,234 @@
+#include "JTripQueue.h"
+#include <algorithm>
+#include <cmath>
+#include <core/physics/JUnits.h>
+#include <core/serialization/JBinaryStream.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief The largest number of requests drawn at a time
+static constexpr size_t s_maxDrawCount = 4096;
+
+/// @brief The index of the lowest set bit of a nonzero word
+static uint32_t LowestSetBit(uint64_t word)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return uint32_t(index);
+#else
+    return uint32_t(__builtin_ctzll(word));
+#endif
+}
+
+/// @brief The mean number of trips requested per second at a vertiport
+static double RequestsPerSecond(const DemandSettings& settings)
+{
+    return settings.m_tripsPerHour / Units::Convert<TimeUnits::kHours, TimeUnits::kSeconds>(1.0);
+}
+
+void DemandStatistics::save(BinaryWriter & writer) const
+{
+    writer.write(uint64_t(m_requestCount));
+    writer.write(uint64_t(m_tripCount));
+    writer.write(uint64_t(m_abandonedCount));
+    writer.write(uint64_t(m_passengerCount));
+    writer.write(m_idleTime);
+    m_waitTime.save(writer);
+}
+
+void DemandStatistics::load(BinaryReader & reader)
+{
+    m_requestCount = size_t(reader.read<uint64_t>());
+    m_tripCount = size_t(reader.read<uint64_t>());
+    m_abandonedCount = size_t(reader.read<uint64_t>());
+    m_passengerCount = size_t(reader.read<uint64_t>());
+    reader.read(m_idleTime);
+    m_waitTime.load(reader);
+}
+
+TripQueue::TripQueue():
+    m_idle(s_maxCapacity + 1)
+{
+}
+
+TripQueue::~TripQueue()
+{
+}
+
+void TripQueue::reset(const DemandSettings & settings, uint64_t seed, uint64_t streamId, bool antithetic, uint32_t origin,
+    uint32_t vertiportCount, double time)
+{
+    m_settings = settings;
+    m_stream.reseed(seed, streamId);
+    m_stream.setAntithetic(antithetic);
+    m_origin = origin;
+    m_vertiportCount = vertiportCount;
+    m_nextRequestTime = time + m_stream.exponential(RequestsPerSecond(m_settings));
+
+    m_requests.clear();
+    m_head = 0;
+    for (std::deque<uint32_t>& line : m_idle) {
+        line.clear();
+    }
+    m_idleMask = 0;
+    m_idleCount = 0;
+    m_matches.clear();
+    m_statistics = DemandStatistics();
+}
+
+void TripQueue::addIdle(uint32_t aircraft, uint32_t capacity)
+{
+    capacity = std::min(capacity, s_maxCapacity);
+    m_idle[capacity].push_back(aircraft);
+    m_idleMask |= uint64_t(1) << capacity;
+    m_idleCount++;
+}
+
+void TripQueue::addRequest(const TripRequest & request)
+{
+    m_requests.push_back(request);
+    m_statistics.m_requestCount++;
+}
+
+void TripQueue::generate(double time)
+{
+    if (!m_settings.enabled()) {
+        return;
+    }
+
+    // Draw enough gaps for the requests expected by the given time, with some to spare, along with a destination
+    // and a party size for each. Gaps drawn past the given time are thrown away, so each call leaves the stream in
+    // a state that depends only on the calls before it
+    const double ratePerSec = RequestsPerSecond(m_settings);
+    while (m_nextRequestTime <= time) {
+        double expectedCount = (time - m_nextRequestTime) * ratePerSec;
+        size_t drawCount = std::min(size_t(expectedCount + 4.0 * std::sqrt(expectedCount)) + 1, s_maxDrawCount);
+        m_draws.resize(3 * drawCount);
+        double* gaps = m_draws.data();
+        double* choices = gaps + drawCount;
+        m_stream.exponentials(ratePerSec, gaps, drawCount);
+        m_stream.uniforms(choices, 2 * drawCount);
+
+        for (size_t i = 0; i < drawCount && m_nextRequestTime <= time; i++) {
+            // Parties never ask to fly to the vertiport they are at, unless it is the only one
+            uint32_t destination = m_origin;
+            if (m_vertiportCount > 1) {
+                destination = uint32_t(RandomStream::ToIndex(choices[2 * i], m_vertiportCount - 1));
+                destination += destination >= m_origin ? 1 : 0;
+            }
+            uint32_t passengerCount = 1 + uint32_t(RandomStream::ToIndex(choices[2 * i + 1], m_settings.m_maxPartySize));
+            addRequest(TripRequest{ m_nextRequestTime, destination, passengerCount });
+            m_nextRequestTime += gaps[i];
+        }
+    }
+}
+
+const std::vector<TripMatch>& TripQueue::dispatch(double time)
+{
+    generate(time);
+    m_matches.clear();
+
+    // Requests are in order of arrival, so those that have waited too long are all at the front
+    const double oldestTime = time - m_settings.m_maxWait;
+    while (m_head < m_requests.size() && m_requests[m_head].m_time < oldestTime) {
+        m_head++;
+        m_statistics.m_abandonedCount++;
+    }
+
+    // Hand out idle aircraft until there are none left, gathering parties that didn't fit at the front
+    size_t keptEnd = m_head;
+    size_t i = m_head;
+    for (; i < m_requests.size() && m_idleMask; i++) {
+        const TripRequest& request = m_requests[i];
+        uint32_t aircraft;
+        if (popIdle(request.m_passengerCount, aircraft)) {
+            double waitHours = Units::Convert<TimeUnits::kSeconds, TimeUnits::kHours>(time - request.m_time);
+            m_statistics.m_tripCount++;
+            m_statistics.m_passengerCount += request.m_passengerCount;
+            m_statistics.m_waitTime.add(waitHours);
+            m_matches.push_back(TripMatch{ aircraft, request });
+        }
+        else {
+            m_requests[keptEnd++] = request;
+        }
+    }
+
+    // Move the parties that didn't fit up against the requests that weren't reached, which keeps them in order
+    // and copies only what was kept
+    size_t keptCount = keptEnd - m_head;
+    std::copy_backward(m_requests.begin() + m_head, m_requests.begin() + keptEnd, m_requests.begin() + i);
+    m_head = i - keptCount;
+
+    // Clear out the front once it makes up most of the line
+    if (m_head > m_requests.size() / 2) {
+        m_requests.erase(m_requests.begin(), m_requests.begin() + m_head);
+        m_head = 0;
+    }
+    return m_matches;
+}
+
+size_t TripQueue::memoryFootprint() const
+{
+    size_t bytes = m_requests.capacity() * sizeof(TripRequest)
+        + m_matches.capacity() * sizeof(TripMatch)
+        + m_draws.capacity() * sizeof(double)
+        + m_idle.capacity() * sizeof(std::deque<uint32_t>);
+    return bytes + m_idleCount * sizeof(uint32_t);
+}
+
+void TripQueue::save(BinaryWriter & writer) const
+{
+    writer.write(m_stream.state());
+    writer.write(m_nextRequestTime);
+    writer.writeVector(std::vector<TripRequest>(m_requests.begin() + m_head, m_requests.end()));
+    for (const std::deque<uint32_t>& line : m_idle) {
+        writer.writeVector(std::vector<uint32_t>(line.begin(), line.end()));
+    }
+    m_statistics.save(writer);
+}
+
+void TripQueue::load(BinaryReader & reader)
+{
+    m_stream.setState(reader.read<RandomStream::State>());
+    reader.read(m_nextRequestTime);
+    reader.readVector(m_requests);
+    m_head = 0;
+
+    std::vector<uint32_t> line;
+    m_idleMask = 0;
+    m_idleCount = 0;
+    for (uint32_t capacity = 0; capacity <= s_maxCapacity; capacity++) {
+        reader.readVector(line);
+        m_idle[capacity].assign(line.begin(), line.end());
+        m_idleMask |= line.empty() ? 0 : uint64_t(1) << capacity;
+        m_idleCount += line.size();
+    }
+    m_statistics.load(reader);
+}
+
+bool TripQueue::popIdle(uint32_t passengerCount, uint32_t & outAircraft)
+{
+    uint64_t fits = m_idleMask & (~uint64_t(0) << std::min(passengerCount, s_maxCapacity));
+    if (!fits) {
+        return false;
+    }
+    uint32_t capacity = LowestSetBit(fits);
+    std::deque<uint32_t>& line = m_idle[capacity];
+    outAircraft = line.front();
+    line.pop_front();
+    if (line.empty()) {
+        m_idleMask &= ~(uint64_t(1) << capacity);
+    }
+    m_idleCount--;
+    return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
@@ -0,0 +1,237 @@
+#ifndef J_TRIP_QUEUE_H
+#define J_TRIP_QUEUE_H
+/** @file JTripQueue.h
+    Defines passenger demand at a vertiport, as trip requests matched in batches to the aircraft idling there
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include <core/random/JRandomStream.h>
+#include <core/statistics/JDistribution.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class BinaryWriter;
+class BinaryReader;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief How passengers ask for trips, the same at every vertiport
+struct DemandSettings {
+    /// @brief Whether there is any demand, without which aircraft take off as soon as they are charged
+    bool enabled() const { return m_tripsPerHour > 0.0; }
+
+    /// @brief The mean number of trips requested per hour at each vertiport, or zero for no demand
+    double m_tripsPerHour = 0.0;
+
+    /// @brief The time between batches of matches at each vertiport, in seconds
+    double m_dispatchInterval = 60.0;
+
+    /// @brief How long passengers wait for an aircraft before giving up on their trip, in seconds
+    double m_maxWait = 1800.0;
+
+    /// @brief The largest party that asks for a trip. Parties are drawn evenly from one up to this size
+    uint32_t m_maxPartySize = 4;
+};
+
+/// @brief A party of passengers asking for a trip from a vertiport
+struct TripRequest {
+    /// @brief The simulation time at which the trip was requested, in seconds
+    double m_time;
+
+    /// @brief The vertiport the party wants to fly to
+    uint32_t m_destination;
+
+    uint32_t m_passengerCount;
+};
+
+/// @brief An idle aircraft handed a trip
+struct TripMatch {
+    uint32_t m_aircraft;
+    TripRequest m_request;
+};
+
+/// @struct DemandStatistics
+/// @brief Totals for the trips requested at one or more vertiports
+struct DemandStatistics {
+    /// @brief Add the totals from another vertiport
+    DemandStatistics& operator+=(const DemandStatistics& other) {
+        m_requestCount += other.m_requestCount;
+        m_tripCount += other.m_tripCount;
+        m_abandonedCount += other.m_abandonedCount;
+        m_passengerCount += other.m_passengerCount;
+        m_idleTime += other.m_idleTime;
+        m_waitTime.merge(other.m_waitTime);
+        return *this;
+    }
+
+    void save(BinaryWriter& writer) const;
+    void load(BinaryReader& reader);
+
+    /// @brief The number of trips requested
+    size_t m_requestCount = 0;
+
+    /// @brief The number of trips handed to an aircraft
+    size_t m_tripCount = 0;
+
+    /// @brief The number of trips given up on after waiting too long
+    size_t m_abandonedCount = 0;
+
+    /// @brief The number of passengers carried
+    size_t m_passengerCount = 0;
+
+    /// @brief The total time aircraft spent idle, waiting for passengers, in hours
+    double m_idleTime = 0.0;
+
+    /// @brief The time each party waited before its trip was handed to an aircraft, in hours
+    Distribution m_waitTime{ 1.0 / 3600.0 };
+};
+
+/// @class TripQueue
+/// @brief Generates the trips requested at a vertiport, and matches them to its idle aircraft in batches
+/// @details Requests arrive as a Poisson process, drawn a batch at a time when the vertiport dispatches, as
+/// exponential gaps from the vertiport's own random stream. They wait in a FIFO line until they are handed to an
+/// aircraft or given up on. Idle aircraft are indexed by their passenger capacity, one FIFO line per capacity,
+/// with a bitmask of the capacities that have any aircraft waiting. Matching a party to the smallest aircraft
+/// that fits it is a mask and a bit scan, so dispatching never scans the fleet, and stops scanning the requests
+/// as soon as no aircraft are left
+class TripQueue {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Members
+    /// @{
+
+    /// @brief The largest party, or passenger capacity, that is told apart. Larger aircraft are indexed as this size
+    static constexpr uint32_t s_maxCapacity = 63;
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    TripQueue();
+    ~TripQueue();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    const DemandSettings& settings() const { return m_settings; }
+
+    /// @brief The number of trips waiting for an aircraft
+    size_t requestCount() const { return m_requests.size() - m_head; }
+
+    /// @brief The number of aircraft waiting for passengers
+    size_t idleCount() const { return m_idleCount; }
+
+    /// @brief Totals for the trips requested at the vertiport
+    DemandStatistics& statistics() { return m_statistics; }
+    const DemandStatistics& statistics() const { return m_statistics; }
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Empty the queue, and start generating requests from the given time
+    /// @param[in] streamId Keys the vertiport's random stream, which must differ from every aircraft's
+    /// @param[in] origin The index of the vertiport, which parties never ask to fly to
+    void reset(const DemandSettings& settings, uint64_t seed, uint64_t streamId, bool antithetic, uint32_t origin,
+        uint32_t vertiportCount, double time);
+
+    /// @brief Add an aircraft to the line of those waiting for passengers
+    void addIdle(uint32_t aircraft, uint32_t capacity);
+
+    /// @brief Add a request to the back of the line, e.g. one not generated by the queue itself
+    void addRequest(const TripRequest& request);
+
+    /// @brief Generate the requests made up to the given time
+    void generate(double time);
+
+    /// @brief Generate the requests made up to the given time, give up on those that have waited too long, and
+    /// hand the rest to idle aircraft in order of arrival
+    /// @details Each party is given the smallest idle aircraft that fits it, the one that has waited longest among
+    /// equal sizes. Parties too large for any idle aircraft keep their place in line
+    /// @return The matches made, valid until the next dispatch
+    const std::vector<TripMatch>& dispatch(double time);
+
+    /// @brief The number of bytes allocated for the requests and the idle aircraft
+    size_t memoryFootprint() const;
+
+    /// @brief Write the requests, idle aircraft, random stream and totals for a checkpoint
+    void save(BinaryWriter& writer) const;
+
+    /// @brief Restore state written by save()
+    /// @details The queue must already have been reset with the same settings
+    void load(BinaryReader& reader);
+
+	/// @}
+
+protected:
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Methods
+    /// @{
+
+    /// @brief Take the smallest idle aircraft that can carry the given party, if there is one
+    bool popIdle(uint32_t passengerCount, uint32_t& outAircraft);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    DemandSettings m_settings;
+
+    /// @brief The stream that request times, destinations and party sizes are drawn from
+    RandomStream m_stream;
+
+    uint32_t m_origin = 0;
+    uint32_t m_vertiportCount = 1;
+
+    /// @brief The time of the next request, already drawn but not yet made, in seconds
+    double m_nextRequestTime = 0.0;
+
+    /// @brief The line of requests, in order of arrival, starting at m_head. Requests are appended at the back,
+    /// and the front is only cleared out once it makes up most of the vector
+    std::vector<TripRequest> m_requests;
+    size_t m_head = 0;
+
+    /// @brief Idle aircraft indexed by passenger capacity, in order of arrival
+    std::vector<std::deque<uint32_t>> m_idle;
+
+    /// @brief Bit n is set if any idle aircraft has capacity n
+    uint64_t m_idleMask = 0;
+    size_t m_idleCount = 0;
+
+    /// @brief The matches made by the last dispatch, and scratch space for drawing requests
+    std::vector<TripMatch> m_matches;
+    std::vector<double> m_draws;
+
+    DemandStatistics m_statistics;
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
@@ -0,0 +1,35 @@
+#include "JVertiport.h"
+#include <core/serialization/JBinaryStream.h>
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+Vertiport::Vertiport(const std::string & name, size_t chargerCount):
+    m_name(name)
+{
+    m_chargerAllocator.resize(chargerCount);
+}
+
+Vertiport::~Vertiport()
+{
+}
+
+void Vertiport::save(BinaryWriter & writer) const
+{
+    m_chargerAllocator.save(writer);
+    m_tripQueue.save(writer);
+    writer.write(uint64_t(m_arrivalCount));
+    writer.write(uint64_t(m_departureCount));
+}
+
+void Vertiport::load(BinaryReader & reader)
+{
+    m_chargerAllocator.load(reader);
+    m_tripQueue.load(reader);
+    m_arrivalCount = size_t(reader.read<uint64_t>());
+    m_departureCount = size_t(reader.read<uint64_t>());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
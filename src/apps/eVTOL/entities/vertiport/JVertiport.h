@@ -0,0 +1,123 @@
+#ifndef J_VERTIPORT_H
+#define J_VERTIPORT_H
+/** @file JVertiport.h
+    Defines a class representing a vertiport, where eVTOL aircraft land and charge
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <string>
+
+#include <apps/eVTOL/entities/charger/JChargerAllocator.h>
+#include <apps/eVTOL/entities/vertiport/JTripQueue.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class BinaryWriter;
+class BinaryReader;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @class Vertiport
+/// @brief Defines a vertiport, with its own pool of chargers and its own line of aircraft waiting for them
+/// @details Aircraft only ever use the chargers of the vertiport they landed at, so vertiports share no state
+/// and can be simulated as separate partitions
+class Vertiport {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Methods
+    /// @{
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    Vertiport(const std::string& name, size_t chargerCount);
+    ~Vertiport();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    const std::string& name() const { return m_name; }
+
+    /// @brief Hands out the vertiport's chargers, and holds the line of aircraft waiting for one
+    ChargerAllocator& chargerAllocator() { return m_chargerAllocator; }
+    const ChargerAllocator& chargerAllocator() const { return m_chargerAllocator; }
+
+    const std::vector<Charger>& chargers() const { return m_chargerAllocator.chargers(); }
+
+    /// @brief Generates the vertiport's trip requests, and holds the aircraft idling there until they are matched
+    TripQueue& tripQueue() { return m_tripQueue; }
+    const TripQueue& tripQueue() const { return m_tripQueue; }
+
+    /// @brief The number of aircraft waiting in line for a charger
+    size_t waitingCount() const { return m_chargerAllocator.waitingCount(); }
+
+    /// @brief The number of aircraft that have landed at the vertiport
+    size_t arrivalCount() const { return m_arrivalCount; }
+
+    /// @brief The number of aircraft that have taken off from the vertiport
+    size_t departureCount() const { return m_departureCount; }
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Count an aircraft landing at the vertiport
+    void addArrival() { m_arrivalCount++; }
+
+    /// @brief Count an aircraft taking off from the vertiport
+    void addDeparture() { m_departureCount++; }
+
+    /// @brief Write the state of the vertiport for a checkpoint
+    void save(BinaryWriter& writer) const;
+
+    /// @brief Restore state written by save()
+    /// @details The vertiport must already hold the same number of chargers
+    void load(BinaryReader& reader);
+
+	/// @}
+
+protected:
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    /// @brief The name of the vertiport
+    std::string m_name;
+
+    /// @brief The chargers at the vertiport, and the aircraft waiting for them
+    ChargerAllocator m_chargerAllocator;
+
+    /// @brief The trips requested at the vertiport, and the aircraft waiting for passengers
+    TripQueue m_tripQueue;
+
+    /// @brief The number of aircraft that have landed at the vertiport
+    size_t m_arrivalCount = 0;
+
+    /// @brief The number of aircraft that have taken off from the vertiport
+    size_t m_departureCount = 0;
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
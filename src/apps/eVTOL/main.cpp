@@ -9,37 +9,580 @@
  */
 
 #include <core/diagnostics/JLogger.h>
+#include <core/containers/JString.h>
+#include <core/physics/JUnits.h>
 #include <apps/eVTOL/sim/JScene.h>
+#include <apps/eVTOL/sim/JScenarioConfig.h>
+#include <apps/eVTOL/sim/JScenarioGenerator.h>
 #include <core/sim/JSimulator.h>
+#include <core/sim/JPartitionedSimulator.h>
+#include <core/serialization/JCheckpoint.h>
+#include <core/serialization/JTable.h>
+#include <core/sim/JEnsembleRunner.h>
+#include <core/sim/JParameterSweep.h>
+#include <core/diagnostics/JRunHash.h>
+#include <core/diagnostics/JTrace.h>
+#include <core/time/JTimer.h>
 
 using namespace joby;
 
+/// @brief The scenario run when no config file is given, see ScenarioConfig for loading one
+ScenarioConfig defaultConfig()
+{
+    // NOTE: In production code, I would also leverage the Quantity class
+    // that I've included in this project to ensure that the correcr units
+    // are enforced
+    ScenarioConfig config;
+    config.m_companies = {
+        { "Alpha",   Aircraft{ 120.0, 320.0, 0.6, 1.6, 4, 0.25 } },
+        { "Beta",    Aircraft{ 100, 100, 0.2, 1.5, 5, 0.1 } },
+        { "Charlie", Aircraft{ 160, 220, 0.8, 2.2, 3, 0.05 } },
+        { "Delta",   Aircraft{ 90, 120, 0.62, 0.8, 2, 0.22 } },
+        { "Echo",    Aircraft{ 30, 150, 0.3, 5.8, 2, 0.61 } }
+    };
+    config.m_scenario.m_seed = 2021;
+    return config;
+}
+
+/// @brief Set up the scene to be simulated
+/// @param[in] config The companies, the number of aircraft, vertiports and chargers, and the mix of companies
+/// @param[in] seed Keys every random choice made in the scene
+/// @param[in] antithetic Whether to mirror every random choice, see RandomStream
+/// @param[in] threadCount The number of threads to generate the scene on, which doesn't change the scene
+ScenarioStatistics setUpScene(Scene& scene, const ScenarioConfig& config, uint64_t seed, bool antithetic = false, size_t threadCount = 0)
+{
+    config.addCompanies(scene);
+    ScenarioSettings settings = config.m_scenario;
+    settings.m_seed = seed;
+    settings.m_antithetic = antithetic;
+    ScenarioGenerator generator(threadCount);
+    return generator.build(scene, settings);
+}
+
+/// @brief Report how long a scene took to build, and how much memory it holds
+void reportScenario(const Scene& scene, const ScenarioStatistics& statistics)
+{
+    size_t chargerCount = 0;
+    for (const Vertiport& vertiport : scene.vertiports()) {
+        chargerCount += vertiport.chargerAllocator().chargers().size();
+    }
+    Logger::LogInfo(JString::Format("Built %d aircraft, %d vertiports and %d chargers in %.3f seconds, using %.1f MB",
+        (int)scene.fleet().size(), (int)scene.vertiports().size(), (int)chargerCount,
+        statistics.m_elapsedSec, double(statistics.m_memoryBytes) / (1024.0 * 1024.0)).c_str());
+}
+
+/// @brief Trace every change of aircraft state in a scene to a file, or do nothing if the path is empty
+/// @param[in] bufferCount The number of threads that may record at once, one per vertiport for a partitioned scene
+std::unique_ptr<TraceRecorder> startTrace(Scene& scene, const std::string& path, size_t bufferCount)
+{
+    if (path.empty()) {
+        return nullptr;
+    }
+    auto recorder = std::make_unique<TraceRecorder>(path, Scene::AircraftTraceSchema(), bufferCount);
+    scene.setTraceRecorder(recorder.get());
+    return recorder;
+}
+
+/// @brief Write out the rest of a trace, and report its size
+void finishTrace(TraceRecorder* recorder, const std::string& path)
+{
+    if (!recorder) {
+        return;
+    }
+    recorder->flush();
+    Logger::LogInfo(JString::Format("Traced %d state changes to %s, %.1f MB",
+        (int)recorder->writtenCount(), path.c_str(), double(recorder->writtenBytes()) / (1024.0 * 1024.0)).c_str());
+}
+
+/// @brief Export the totals of each company in a scene to a table, or do nothing if the path is empty
+/// @details The table is CSV for a ".csv" path, and columnar binary otherwise
+void exportSummary(const Scene& scene, const std::string& path)
+{
+    if (path.empty()) {
+        return;
+    }
+    TableWriter writer(path, Scene::SummaryColumns(), Table::FormatOf(path));
+    scene.exportSummary(writer);
+    writer.flush();
+    Logger::LogInfo(JString::Format("Exported a summary of %d companies to %s", (int)writer.rowCount(), path.c_str()).c_str());
+}
+
+/// @brief The seed of an ensemble replica, counting up from the seed of the scenario
+/// @details Antithetic pairs of replicas share a seed, and the second of each pair mirrors the first
+uint64_t replicaSeed(const EnsembleRunner& runner, const ScenarioConfig& config, size_t replica)
+{
+    return config.m_scenario.m_seed + (runner.isAntithetic() ? replica / 2 : replica);
+}
+
+bool isMirroredReplica(const EnsembleRunner& runner, size_t replica)
+{
+    return runner.isAntithetic() && replica % 2;
+}
+
+/// @brief The statistics reported for each company by ensembles
+static constexpr size_t s_metricCount = 5;
+static const char* s_metricNames[s_metricCount] = { "flight hours", "miles", "charge hours", "faults", "passenger miles" };
+
+/// @brief Simulate a scene on a simulator of its own, and write out the metrics for each company
+void runReplica(Scene& scene, double endTime, double* outMetrics)
+{
+    Simulator sim(0);
+    sim.setDeterministic(true);
+    scene.initialize(sim);
+    sim.simulateUntil(endTime, 1.0);
+    scene.finalize(sim.simulationTime());
+
+    for (size_t i = 0; i < scene.companies().size(); i++) {
+        const CompanyStatistics& statistics = scene.companies()[i].statistics();
+        double* companyMetrics = outMetrics + i * s_metricCount;
+        companyMetrics[0] = statistics.m_flightTime;
+        companyMetrics[1] = statistics.m_distance;
+        companyMetrics[2] = statistics.m_chargeTime;
+        companyMetrics[3] = double(statistics.m_faultCount);
+        companyMetrics[4] = statistics.m_passengerMiles;
+    }
+}
+
+/// @brief Run replicas until every metric is precise enough, or for a fixed count if the precision is zero
+template<typename ReplicaFunction>
+EnsembleSummary runReplicas(EnsembleRunner& runner, size_t maxReplicaCount, double precision, size_t metricCount, const ReplicaFunction& runReplica)
+{
+    if (precision <= 0.0) {
+        return runner.run(maxReplicaCount, metricCount, runReplica);
+    }
+
+    StoppingRule rule;
+    rule.m_relativeHalfWidth = precision;
+    rule.m_maxReplicaCount = maxReplicaCount;
+    EnsembleSummary summary = runner.runUntil(rule, metricCount, runReplica);
+    if (!summary.m_converged) {
+        Logger::LogWarning(JString::Format("Stopped at %d replicas without reaching a relative precision of %.3f",
+            (int)summary.m_replicaCount, precision).c_str());
+    }
+    return summary;
+}
+
+/// @brief Simulate the scene many times with different seeds, and report the mean of each company's statistics
+/// @param[in] maxReplicaCount The number of replicas to give up after
+/// @param[in] precision The target half-width of every 95% confidence interval, relative to its mean.
+/// With zero, exactly maxReplicaCount replicas are run
+/// @param[in] antithetic Whether to run replicas in antithetic pairs
+/// @param[in] summaryPath A table to export each replica's metrics for each company to, if not empty
+void runEnsemble(const ScenarioConfig& config, size_t maxReplicaCount, double precision, bool antithetic, double endTime,
+    const std::string& summaryPath)
+{
+    Scene prototype;
+    config.addCompanies(prototype);
+    const size_t companyCount = prototype.companies().size();
+
+    // Every replica owns its simulator and scene, so replicas share nothing but their results row
+    EnsembleRunner runner;
+    runner.setAntithetic(antithetic);
+
+    // Replicas are exported a batch at a time, and written out while the next batch runs
+    std::unique_ptr<TableWriter> summaryWriter;
+    if (!summaryPath.empty()) {
+        std::vector<TableColumn> columns = {
+            { "replica", TableColumnType::kInteger },
+            { "seed", TableColumnType::kInteger },
+            { "company", TableColumnType::kText }
+        };
+        for (const char* metricName : s_metricNames) {
+            columns.push_back({ metricName, TableColumnType::kReal });
+        }
+        summaryWriter = std::make_unique<TableWriter>(summaryPath, columns, Table::FormatOf(summaryPath));
+        runner.setReplicaHandler([&](size_t firstReplica, size_t replicaCount, size_t metricCount, const double* samples) {
+            for (size_t replica = 0; replica < replicaCount; replica++) {
+                for (size_t i = 0; i < companyCount; i++) {
+                    summaryWriter->add(uint64_t(firstReplica + replica))
+                        .add(replicaSeed(runner, config, firstReplica + replica))
+                        .add(prototype.companies()[i].name());
+                    const double* metrics = samples + replica * metricCount + i * s_metricCount;
+                    for (size_t metric = 0; metric < s_metricCount; metric++) {
+                        summaryWriter->add(metrics[metric]);
+                    }
+                    summaryWriter->endRow();
+                }
+            }
+        });
+    }
+    EnsembleSummary summary = runReplicas(runner, maxReplicaCount, precision, s_metricCount * companyCount,
+        [&runner, &config, endTime](size_t replica, double* outMetrics) {
+            Scene scene;
+            setUpScene(scene, config, replicaSeed(runner, config, replica), isMirroredReplica(runner, replica));
+            runReplica(scene, endTime, outMetrics);
+        });
+
+    for (size_t i = 0; i < companyCount; i++) {
+        std::string line = prototype.companies()[i].name() + ":";
+        for (size_t metric = 0; metric < s_metricCount; metric++) {
+            const RunningStatistics& statistics = summary.m_metrics[i * s_metricCount + metric];
+            line += JString::Format(" %.3f +/- %.3f %s%s", statistics.mean(), statistics.confidenceHalfWidth(),
+                s_metricNames[metric], metric + 1 < s_metricCount ? "," : "");
+        }
+        Logger::LogInfo(line.c_str());
+    }
+    if (antithetic) {
+        for (size_t i = 0; i < companyCount; i++) {
+            std::string line = prototype.companies()[i].name() + " variance reduced by antithetic pairs:";
+            for (size_t metric = 0; metric < s_metricCount; metric++) {
+                line += JString::Format(" %.2fx %s%s", summary.varianceReductionFactor(i * s_metricCount + metric),
+                    s_metricNames[metric], metric + 1 < s_metricCount ? "," : "");
+            }
+            Logger::LogInfo(line.c_str());
+        }
+    }
+    Logger::LogInfo(JString::Format("Ran %d replicas on %d threads in %.2f seconds, %.1f replicas per second (95%% confidence intervals)",
+        (int)summary.m_replicaCount, (int)runner.threadCount(), summary.m_elapsedSec, summary.replicasPerSecond()).c_str());
+    if (summaryWriter) {
+        summaryWriter->flush();
+        Logger::LogInfo(JString::Format("Exported %d replica rows to %s", (int)summaryWriter->rowCount(), summaryPath.c_str()).c_str());
+    }
+}
+
+/// @brief Compare the scene with two different numbers of chargers, using common random numbers
+/// @details Each replica runs both configurations with the same seed, so each aircraft draws the same faults
+/// in both, and reports their difference. The variance of the difference is then usually far smaller than
+/// that of independent runs, which is reported as the variance reduction factor
+void runComparison(const ScenarioConfig& config, size_t firstChargerCount, size_t secondChargerCount, size_t replicaCount, bool antithetic, double endTime)
+{
+    Scene prototype;
+    config.addCompanies(prototype);
+    ScenarioConfig firstConfig = config;
+    firstConfig.m_scenario.m_chargerCount = firstChargerCount;
+    ScenarioConfig secondConfig = config;
+    secondConfig.m_scenario.m_chargerCount = secondChargerCount;
+    const size_t metricCount = s_metricCount * prototype.companies().size();
+
+    // Each replica reports the metrics of the first configuration, then of the second, then their differences
+    EnsembleRunner runner;
+    runner.setAntithetic(antithetic);
+    EnsembleSummary summary = runner.run(replicaCount, 3 * metricCount,
+        [&runner, &firstConfig, &secondConfig, metricCount, endTime](size_t replica, double* outMetrics) {
+            Scene firstScene;
+            setUpScene(firstScene, firstConfig, replicaSeed(runner, firstConfig, replica), isMirroredReplica(runner, replica));
+            runReplica(firstScene, endTime, outMetrics);
+
+            Scene secondScene;
+            setUpScene(secondScene, secondConfig, replicaSeed(runner, secondConfig, replica), isMirroredReplica(runner, replica));
+            runReplica(secondScene, endTime, outMetrics + metricCount);
+
+            for (size_t metric = 0; metric < metricCount; metric++) {
+                outMetrics[2 * metricCount + metric] = outMetrics[metricCount + metric] - outMetrics[metric];
+            }
+        });
+
+    for (size_t i = 0; i < prototype.companies().size(); i++) {
+        for (size_t metric = 0; metric < s_metricCount; metric++) {
+            size_t index = i * s_metricCount + metric;
+            const RunningStatistics& first = summary.m_metrics[index];
+            const RunningStatistics& second = summary.m_metrics[metricCount + index];
+            const RunningStatistics& difference = summary.m_metrics[2 * metricCount + index];
+            Logger::LogInfo(JString::Format("%s %s: %.3f with %d chargers, %.3f with %d, difference %.3f +/- %.3f, variance reduced %.1fx",
+                prototype.companies()[i].name().c_str(), s_metricNames[metric],
+                first.mean(), (int)firstChargerCount, second.mean(), (int)secondChargerCount,
+                difference.mean(), difference.confidenceHalfWidth(),
+                EnsembleSummary::PairedVarianceReductionFactor(first, second, difference)).c_str());
+        }
+    }
+    Logger::LogInfo(JString::Format("Ran %d replicas of each configuration in %.2f seconds (95%% confidence intervals)",
+        (int)summary.m_replicaCount, summary.m_elapsedSec).c_str());
+}
+
+/// @brief Sweep the specification of a single company's aircraft and the number of chargers, running an
+/// ensemble at each point of the design and streaming the results to a CSV file
+/// @param[in] config The scene to fly each design in. The swept company replaces the configured ones, carrying as
+/// many passengers as the first of them
+/// @param[in] design "grid" for every combination of three levels of each parameter, or "lhs" for a Latin hypercube
+/// @param[in] pointCount The number of points in a Latin hypercube design
+/// @details Points already in the results file are skipped, so rerunning an interrupted sweep resumes it
+void runSweep(const ScenarioConfig& config, const std::string& design, size_t pointCount, size_t maxReplicaCount, double precision,
+    bool antithetic, double endTime)
+{
+    const std::vector<SweepParameter> parameters = {
+        { "cruise speed", 80.0, 160.0 },
+        { "battery capacity", 150.0, 350.0 },
+        { "charge time", 0.3, 1.0 },
+        { "energy use", 1.0, 2.5 },
+        { "failure rate", 0.05, 0.5 },
+        { "chargers", 1.0, 5.0 }
+    };
+    std::vector<std::string> metricNames(s_metricNames, s_metricNames + s_metricCount);
+
+    // Results depend on the settings of each ensemble and on the scene as well as on the parameters
+    const size_t passengerCount = config.m_companies.front().m_aircraft.maxPassengerCount();
+    RunHash settingsHash;
+    settingsHash.add(endTime);
+    settingsHash.add(uint64_t(maxReplicaCount));
+    settingsHash.add(precision);
+    settingsHash.add(antithetic);
+    settingsHash.add(config.m_scenario.m_seed);
+    settingsHash.add(uint64_t(config.m_scenario.m_aircraftCount));
+    settingsHash.add(uint64_t(config.m_scenario.m_vertiportCount));
+    settingsHash.add(config.m_scenario.m_demand.m_tripsPerHour);
+    settingsHash.add(uint64_t(passengerCount));
+    ParameterSweep sweep(parameters, metricNames, "eVTOL_sweep.csv", settingsHash.value());
+
+    std::vector<SweepPoint> points;
+    if (design == "grid") {
+        points = ParameterSweep::GridDesign(parameters);
+    }
+    else if (design == "lhs") {
+        points = ParameterSweep::LatinHypercubeDesign(parameters, pointCount, config.m_scenario.m_seed);
+    }
+    else {
+        throw std::invalid_argument("Error, unrecognized sweep design " + design);
+    }
+    Logger::LogInfo(JString::Format("Sweeping %d points, %d of which have cached results",
+        (int)points.size(), (int)std::count_if(points.begin(), points.end(), [&sweep](const SweepPoint& point) { return sweep.isFinished(point); })).c_str());
+
+    // A fleet file names the configured companies, so designs are always flown by generated aircraft
+    ScenarioConfig designConfig = config;
+    designConfig.m_scenario.m_companyWeights.clear();
+    designConfig.m_scenario.m_fleetPath.clear();
+
+    EnsembleRunner runner;
+    runner.setAntithetic(antithetic);
+    size_t runCount = sweep.run(points, [&](const SweepPoint& point) {
+        designConfig.m_companies = { { "Design", Aircraft{ point[0], point[1], point[2], point[3], passengerCount, point[4] } } };
+        designConfig.m_scenario.m_chargerCount = size_t(std::lround(point[5]));
+        return runReplicas(runner, maxReplicaCount, precision, s_metricCount,
+            [&runner, &designConfig, endTime](size_t replica, double* outMetrics) {
+                Scene scene;
+                setUpScene(scene, designConfig, replicaSeed(runner, designConfig, replica), isMirroredReplica(runner, replica));
+                runReplica(scene, endTime, outMetrics);
+            });
+    });
+    Logger::LogInfo(JString::Format("Ran %d sweep points", (int)runCount).c_str());
+}
+
+/// @brief Simulate a network of vertiports, running each vertiport as a partition across a thread pool
+/// @details Results are the same for any number of threads
+void runNetwork(const ScenarioConfig& config, size_t threadCount, double endTime, const std::string& tracePath,
+    const std::string& summaryPath)
+{
+    const size_t vertiportCount = config.m_scenario.m_vertiportCount;
+    Scene scene;
+    reportScenario(scene, setUpScene(scene, config, config.m_scenario.m_seed, false, threadCount));
+    std::unique_ptr<TraceRecorder> traceRecorder = startTrace(scene, tracePath, vertiportCount);
+
+    Timer timer;
+    timer.start();
+    PartitionedSimulator sim(vertiportCount, threadCount);
+    scene.initialize(sim);
+    sim.simulateUntil(endTime);
+    scene.finalize(sim.simulationTime());
+    double elapsedSec = timer.getElapsed<double>();
+    finishTrace(traceRecorder.get(), tracePath);
+
+    scene.report();
+    exportSummary(scene, summaryPath);
+    const PartitionedSimulatorStatistics& statistics = sim.statistics();
+    Logger::LogInfo(JString::Format("Ran %d vertiports on %d threads in %.3f seconds: %d windows and %d events, %d of them flights between partitions",
+        (int)vertiportCount, (int)sim.threadCount(), elapsedSec, (int)statistics.m_windowCount, (int)statistics.m_eventCount, (int)statistics.m_sentCount).c_str());
+
+    RunHash hash = sim.runHash();
+    scene.hashState(hash);
+    Logger::LogInfo(JString::Format("Run hash: %016llx", (unsigned long long)hash.value()).c_str());
+}
+
 int main(int argc, char *argv[])
 {
+    // Write log messages from a background thread, so that replicas and partitions never wait on the console,
+    // and write out whatever is still queued if the application crashes
+    Logger::InstallCrashHandler();
+    Logger::Get().startAsync();
     Logger::LogInfo("Running eVTOL application");
 
-    // Create the scene
-    // NOTE: In production code, I would have this be entirely data-driven,
-    // loading in a JSON file describing the scene, the different companies, their
-    // vehicle specifications, the number of vehicles in the simulation, the
-    // number of chargers, etc.
+    // Convert a trace or a columnar summary to CSV if asked, e.g. "eVTOL --trace-to-csv eVTOL.trace eVTOL.csv"
+    // or "eVTOL --table-to-csv summary.table summary.csv", and do nothing else
+    for (int i = 1; i + 2 < argc; i++) {
+        bool isTrace = std::string(argv[i]) == "--trace-to-csv";
+        if (isTrace || std::string(argv[i]) == "--table-to-csv") {
+            size_t rowCount = isTrace ? TraceReader::ToCsv(argv[i + 1], argv[i + 2]) : TableReader::ToCsv(argv[i + 1], argv[i + 2]);
+            Logger::LogInfo(JString::Format("Wrote %d rows of %s to %s", (int)rowCount, argv[i + 1], argv[i + 2]).c_str());
+            return 0;
+        }
+    }
+
+    // Load the companies and the scene from a config file if one was given, e.g. "eVTOL --config scenario.ini",
+    // or otherwise simulate three hours of operations by the default companies
+    ScenarioConfig config = defaultConfig();
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--config") {
+            Timer timer;
+            timer.start();
+            config = ScenarioConfig::Load(argv[i + 1]);
+            Logger::LogInfo(JString::Format("Loaded %d companies from %s in %.3f ms",
+                (int)config.m_companies.size(), argv[i + 1], timer.getElapsed<double>() * 1e3).c_str());
+        }
+    }
+
+    // Estimate statistics over many seeds if asked, e.g. "eVTOL --ensemble 10000 --precision 0.02" runs until
+    // every interval is within 2% of its mean, or for 10000 replicas at most.
+    // Sweep aircraft designs if asked, e.g. "eVTOL --sweep lhs --points 100 --ensemble 500", where the
+    // ensemble count and precision apply to every point.
+    // Compare charger counts if asked, e.g. "eVTOL --compare-chargers 2 3 --ensemble 500".
+    // Simulate a network of vertiports if asked, e.g. "eVTOL --vertiports 64 --threads 8", each run as a partition.
+    // Any of these may add "--antithetic" to run replicas in antithetic pairs.
+    // Scale the scene if asked, e.g. "eVTOL --aircraft 1000000 --chargers 5000 --weights 4,1,1,1,1", where chargers
+    // are per vertiport and weights give the relative share of each company's aircraft. These override the config.
+    // Scenes otherwise start out with twenty aircraft per vertiport and three chargers at each.
+    // Trace the state changes of every aircraft in a single run or a network if asked, e.g. "eVTOL --trace eVTOL.trace"
+    // Export a table of each company's totals, or of every replica of an ensemble, if asked, e.g. "eVTOL --summary
+    // summary.csv", which is CSV for a ".csv" path and columnar binary otherwise
+    // Model passenger demand if asked, e.g. "eVTOL --demand 120" for 120 trips requested per hour at each vertiport,
+    // so that charged aircraft wait for passengers rather than taking off at once. This overrides the config
+    size_t ensembleCount = 0;
+    double precision = 0.05;
+    std::string sweepDesign;
+    size_t sweepPointCount = 64;
+    size_t comparedChargerCounts[2] = { 0, 0 };
+    bool antithetic = false;
+    size_t threadCount = std::thread::hardware_concurrency();
+    std::string tracePath;
+    std::string summaryPath;
+    ScenarioSettings& scenario = config.m_scenario;
+    size_t vertiportCount = scenario.m_vertiportCount;
+    size_t aircraftCount = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--antithetic") {
+            antithetic = true;
+        }
+        else if (std::string(argv[i]) == "--compare-chargers" && i + 2 < argc) {
+            comparedChargerCounts[0] = std::stoul(argv[i + 1]);
+            comparedChargerCounts[1] = std::stoul(argv[i + 2]);
+        }
+    }
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--ensemble") {
+            ensembleCount = std::stoul(argv[i + 1]);
+        }
+        else if (std::string(argv[i]) == "--precision") {
+            precision = std::stod(argv[i + 1]);
+        }
+        else if (std::string(argv[i]) == "--sweep") {
+            sweepDesign = argv[i + 1];
+        }
+        else if (std::string(argv[i]) == "--points") {
+            sweepPointCount = std::stoul(argv[i + 1]);
+        }
+        else if (std::string(argv[i]) == "--vertiports") {
+            vertiportCount = std::stoul(argv[i + 1]);
+        }
+        else if (std::string(argv[i]) == "--threads") {
+            threadCount = std::stoul(argv[i + 1]);
+        }
+        else if (std::string(argv[i]) == "--trace") {
+            tracePath = argv[i + 1];
+        }
+        else if (std::string(argv[i]) == "--summary") {
+            summaryPath = argv[i + 1];
+        }
+        else if (std::string(argv[i]) == "--aircraft") {
+            aircraftCount = std::stoul(argv[i + 1]);
+        }
+        else if (std::string(argv[i]) == "--demand") {
+            scenario.m_demand.m_tripsPerHour = std::stod(argv[i + 1]);
+        }
+        else if (std::string(argv[i]) == "--chargers") {
+            scenario.m_chargerCount = std::stoul(argv[i + 1]);
+        }
+        else if (std::string(argv[i]) == "--weights") {
+            scenario.m_companyWeights.clear();
+            std::string_view weights = argv[i + 1];
+            while (!weights.empty()) {
+                double weight;
+                if (!JString::ToNumber(JString::NextToken(weights, ','), weight)) {
+                    throw std::invalid_argument(std::string("Error, invalid company weights ") + argv[i + 1]);
+                }
+                scenario.m_companyWeights.push_back(weight);
+            }
+        }
+    }
+
+    // Aircraft follow the number of vertiports, unless the count was set
+    if (aircraftCount) {
+        scenario.m_aircraftCount = aircraftCount;
+    }
+    else if (vertiportCount != scenario.m_vertiportCount) {
+        scenario.m_aircraftCount = 20 * vertiportCount;
+    }
+    scenario.m_vertiportCount = vertiportCount;
+    const double endTime = Units::Convert<TimeUnits::kHours, TimeUnits::kSeconds>(config.m_hours);
+    if (!sweepDesign.empty()) {
+        runSweep(config, sweepDesign, sweepPointCount, ensembleCount ? ensembleCount : 200, precision, antithetic, endTime);
+        return 0;
+    }
+    if (comparedChargerCounts[0]) {
+        runComparison(config, comparedChargerCounts[0], comparedChargerCounts[1], ensembleCount ? ensembleCount : 200, antithetic, endTime);
+        return 0;
+    }
+    if (ensembleCount) {
+        runEnsemble(config, ensembleCount, precision, antithetic, endTime, summaryPath);
+        return 0;
+    }
+    if (vertiportCount > 1) {
+        runNetwork(config, threadCount, endTime, tracePath, summaryPath);
+        return 0;
+    }
+
+    // Pick up from a checkpoint if one was given, e.g. "eVTOL --restore eVTOL.checkpoint"
+    const std::string checkpointPath = "eVTOL.checkpoint";
+    std::string restorePath;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--restore") {
+            restorePath = argv[i + 1];
+        }
+    }
 
-    // NOTE: In production code, I would also leverage the Quantity class
-    // that I've included in this project to ensure that the correcr units
-    // are enforced
     Scene scene;
-    scene.setChargerCount(3);
-    scene.addCompany("Alpha",   Aircraft{ 120.0, 320.0, 0.6, 1.6, 4, 0.25 });
-    scene.addCompany("Beta",    Aircraft{ 100, 100, 0.2, 1.5, 5, 0.1 });
-    scene.addCompany("Charlie", Aircraft{ 160, 220, 0.8, 2.2, 3, 0.05 });
-    scene.addCompany("Delta",   Aircraft{ 90, 120, 0.62, 0.8, 2, 0.22 });
-    scene.addCompany("Echo",    Aircraft{ 30, 150, 0.3, 5.8, 2, 0.61 });
-
-    // Simulate
+    reportScenario(scene, setUpScene(scene, config, scenario.m_seed, false, threadCount));
+
+    // When restoring, only trace from the restored state on, since it replaces the launches made by initialize
+    std::unique_ptr<TraceRecorder> traceRecorder;
+    if (restorePath.empty()) {
+        traceRecorder = startTrace(scene, tracePath, 1);
+    }
+
     Simulator sim;
-    //sim.simulate(scene);
+    sim.setDeterministic(true);
+    scene.initialize(sim);
+    if (!restorePath.empty()) {
+        std::vector<char> payload = Checkpoint::Read(restorePath);
+        BinaryReader reader(payload);
+        sim.load(reader);
+        scene.load(reader);
+        traceRecorder = startTrace(scene, tracePath, 1);
+        Logger::LogInfo(JString::Format("Restored checkpoint at %.0f seconds", sim.simulationTime()).c_str());
+    }
+
+    // Checkpoint every half hour. Checkpoints are written in the background, so the simulation only
+    // pauses to copy its state
+    const double checkpointInterval = Units::Convert<TimeUnits::kHours, TimeUnits::kSeconds>(0.5);
+    CheckpointWriter checkpointWriter;
+    while (sim.simulationTime() < endTime) {
+        sim.simulateUntil(std::min(sim.simulationTime() + checkpointInterval, endTime), 1.0);
+        BinaryWriter& writer = checkpointWriter.beginSnapshot();
+        sim.save(writer);
+        scene.save(writer);
+        checkpointWriter.commit(checkpointPath);
+    }
+    checkpointWriter.flush();
+    scene.finalize(sim.simulationTime());
+    finishTrace(traceRecorder.get(), tracePath);
 
     // Vehicle metrics viewer?
+    scene.report();
+    exportSummary(scene, summaryPath);
+    const SimulatorStatistics& statistics = sim.statistics();
+    Logger::LogInfo(JString::Format("Ran %llu fixed steps and %llu partial steps, skipped %llu idle steps, and handled %llu events",
+        (unsigned long long)statistics.m_fixedStepCount, (unsigned long long)statistics.m_partialStepCount,
+        (unsigned long long)statistics.m_skippedStepCount, (unsigned long long)statistics.m_eventCount).c_str());
+
+    // Identical runs produce identical hashes, so this can be diffed to catch changes in behavior
+    scene.hashState(sim.runHash());
+    Logger::LogInfo(JString::Format("Run hash: %016llx", (unsigned long long)sim.runHash().value()).c_str());
 	
     return 0;
 }
@@ -0,0 +1,87 @@
+#include "JFleetProcess.h"
+#include <algorithm>
+#include <cmath>
+#include <apps/eVTOL/sim/JScene.h>
+#include <core/physics/JUnits.h>
+#include <core/sim/JSimulator.h>
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+FleetProcess::FleetProcess(Scene& scene, const Simulator& simulator):
+    Process(),
+    m_scene(scene),
+    m_simulator(simulator)
+{
+}
+
+FleetProcess::~FleetProcess()
+{
+}
+
+void FleetProcess::onUpdate(double deltaSec)
+{
+    double startTime = m_simulator.simulationTime();
+
+    Fleet& fleet = m_scene.fleet();
+    std::vector<Company>& companies = m_scene.companies();
+
+    // Fly everything that makes it through the whole step in bulk, leaving out aircraft that deplete or fault
+    m_fullStepCounts = fleet.flyingCounts();
+    fleet.step(deltaSec, m_interrupted);
+    for (uint32_t i : m_interrupted) {
+        m_fullStepCounts[fleet.companyId(i)]--;
+    }
+
+    // Every aircraft that flew the full step covered the same ground as the others from its company
+    double deltaHours = Units::Convert<TimeUnits::kSeconds, TimeUnits::kHours>(deltaSec);
+    for (uint32_t companyId = 0; companyId < m_fullStepCounts.size(); companyId++) {
+        const Aircraft& spec = fleet.companySpecification(companyId);
+        double aircraftCount = double(m_fullStepCounts[companyId]);
+        double milesFlown = spec.cruiseSpeed() * deltaHours;
+        CompanyStatistics& statistics = companies[companyId].statistics();
+        statistics.m_flightTime += aircraftCount * deltaHours;
+        statistics.m_distance += aircraftCount * milesFlown;
+        statistics.m_passengerMiles += aircraftCount * milesFlown * spec.maxPassengerCount();
+    }
+
+    // Fly the rest one at a time
+    for (uint32_t i : m_interrupted) {
+        // Tally the distance covered during the step
+        const Aircraft& spec = fleet.specification(i);
+        double secondsFlown = fleet.fly(i, deltaSec);
+        double hoursFlown = Units::Convert<TimeUnits::kSeconds, TimeUnits::kHours>(secondsFlown);
+        double milesFlown = spec.cruiseSpeed() * hoursFlown;
+        CompanyStatistics& statistics = companies[fleet.companyId(i)].statistics();
+        statistics.m_flightTime += hoursFlown;
+        statistics.m_distance += milesFlown;
+        statistics.m_passengerMiles += milesFlown * spec.maxPassengerCount();
+
+        // Count down the flight time to the next fault, drawing the time to the one after as each fault occurs
+        double faultHours = hoursFlown;
+        while (fleet.hoursToFault(i) <= faultHours) {
+            faultHours -= fleet.hoursToFault(i);
+            statistics.m_faultCount++;
+            fleet.setHoursToFault(i, m_scene.drawHoursToFault(i));
+        }
+        fleet.setHoursToFault(i, fleet.hoursToFault(i) - faultHours);
+
+        if (fleet.batteryCharge(i) <= 0.0) {
+            m_scene.onBatteryDepleted(i, startTime + secondsFlown);
+        }
+    }
+
+    bool anyFlying = std::any_of(fleet.flyingCounts().begin(), fleet.flyingCounts().end(),
+        [](uint32_t count) {
+            return count > 0;
+        });
+
+    // Nothing left to integrate until an aircraft takes off again
+    if (!anyFlying) {
+        pause();
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
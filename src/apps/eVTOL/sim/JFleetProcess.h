@@ -0,0 +1,90 @@
+#ifndef J_FLEET_PROCESS_H
+#define J_FLEET_PROCESS_H
+/** @file JFleetProcess.h 
+    Defines the process that flies all airborne aircraft in a scene
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <vector>
+#include <core/processes/JProcess.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class Scene;
+class Simulator;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @class FleetProcess
+/// @brief Integrates the flight of every airborne aircraft at the simulator's fixed step
+/// @details Drains batteries, tallies flight statistics and counts down each aircraft's flight time to its next
+/// fault, drawing the time to the one after from Scene::drawHoursToFault as each fault occurs. Aircraft are handed
+/// back to the scene when their batteries run out. The fleet flies most aircraft in a single vectorized pass, and
+/// only those that run out of battery or reach a fault during the step are flown one at a time. The process pauses
+/// itself while nothing is flying, so that the simulator can skip straight to the next charging event, and the
+/// scene resumes it on takeoff
+class FleetProcess : public Process {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Methods
+    /// @{
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    FleetProcess(Scene& scene, const Simulator& simulator);
+    ~FleetProcess();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    virtual void onUpdate(double deltaSec) override;
+    virtual void onFixedUpdate(double) override {}
+
+	/// @}
+
+protected:
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    /// @brief The scene whose aircraft are flown
+    Scene& m_scene;
+
+    /// @brief The simulator running the process, for the time at the start of each step
+    const Simulator& m_simulator;
+
+    /// @brief The aircraft that ran out of battery or faulted during the current step, reused between steps
+    std::vector<uint32_t> m_interrupted;
+
+    /// @brief The number of aircraft from each company that flew the whole of the current step
+    std::vector<uint32_t> m_fullStepCounts;
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
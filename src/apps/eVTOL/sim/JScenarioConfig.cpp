@@ -0,0 +1,76 @@
+#include "JScenarioConfig.h"
+#include <apps/eVTOL/sim/JScene.h>
+#include <core/serialization/JConfigFile.h>
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+ScenarioConfig ScenarioConfig::Load(const std::string & path)
+{
+    ScenarioConfig config = FromConfig(ConfigFile::Load(path));
+
+    // Fleet files sit beside the config that names them
+    const std::string& fleetPath = config.m_scenario.m_fleetPath;
+    size_t directoryEnd = path.find_last_of("/\\");
+    if (!fleetPath.empty() && fleetPath.find_first_of("/\\") != 0 && fleetPath.find(':') == std::string::npos
+        && directoryEnd != std::string::npos) {
+        config.m_scenario.m_fleetPath = path.substr(0, directoryEnd + 1) + fleetPath;
+    }
+    return config;
+}
+
+ScenarioConfig ScenarioConfig::FromConfig(const ConfigFile & file)
+{
+    ScenarioConfig config;
+    std::vector<double> weights;
+    bool weighted = false;
+    for (const ConfigSection& section : file.sections()) {
+        if (section.name() == "scenario") {
+            ScenarioSettings& scenario = config.m_scenario;
+            scenario.m_seed = section.number<uint64_t>("seed", scenario.m_seed);
+            scenario.m_aircraftCount = section.number<size_t>("aircraft", scenario.m_aircraftCount);
+            scenario.m_vertiportCount = section.number<size_t>("vertiports", scenario.m_vertiportCount);
+            scenario.m_chargerCount = section.number<size_t>("chargers", scenario.m_chargerCount);
+            scenario.m_fleetPath = section.value("fleet", scenario.m_fleetPath);
+            scenario.m_demand.m_tripsPerHour = section.number<double>("demand", scenario.m_demand.m_tripsPerHour);
+            scenario.m_demand.m_dispatchInterval = section.number<double>("dispatch_interval", scenario.m_demand.m_dispatchInterval);
+            scenario.m_demand.m_maxWait = section.number<double>("max_wait", scenario.m_demand.m_maxWait);
+            scenario.m_demand.m_maxPartySize = section.number<uint32_t>("max_party", scenario.m_demand.m_maxPartySize);
+            config.m_hours = section.number<double>("hours", config.m_hours);
+        }
+        else if (section.name() == "company") {
+            config.m_companies.push_back(CompanyConfig{ std::string(section.value("name")), Aircraft(
+                section.number<double>("cruise_speed"),
+                section.number<double>("battery_capacity"),
+                section.number<double>("charge_time"),
+                section.number<double>("energy_use"),
+                section.number<size_t>("passengers"),
+                section.number<double>("fault_rate")) });
+            weighted |= section.has("weight");
+            weights.push_back(section.number<double>("weight", 1.0));
+        }
+        else {
+            throw section.error(section.line(), "unrecognized section " + std::string(section.name()));
+        }
+    }
+    if (config.m_companies.empty()) {
+        throw std::runtime_error("Error, " + file.sourceName() + " configures no companies");
+    }
+
+    // Without weights, companies are drawn evenly, exactly as for a scene built in code
+    if (weighted) {
+        config.m_scenario.m_companyWeights = weights;
+    }
+    return config;
+}
+
+void ScenarioConfig::addCompanies(Scene & scene) const
+{
+    for (const CompanyConfig& company : m_companies) {
+        scene.addCompany(company.m_name, company.m_aircraft);
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
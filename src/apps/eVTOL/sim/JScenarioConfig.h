@@ -0,0 +1,104 @@
+#ifndef J_SCENARIO_CONFIG_H
+#define J_SCENARIO_CONFIG_H
+/** @file JScenarioConfig.h 
+    Defines the settings of a run that are loaded from a configuration file
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <string>
+#include <vector>
+#include <apps/eVTOL/entities/vehicle/JeVTOL.h>
+#include <apps/eVTOL/sim/JScenarioGenerator.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class ConfigFile;
+class Scene;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief A company and the aircraft it builds
+struct CompanyConfig {
+    std::string m_name;
+    Aircraft m_aircraft;
+};
+
+/// @class ScenarioConfig
+/// @brief The companies, scene and run parameters of a simulation, loaded from a configuration file
+/// @details Files have a [scenario] section and one [company] section per company, e.g.
+/// @code
+/// [scenario]
+/// seed = 2021          # Keys every random choice in the scene
+/// hours = 3            # How long to simulate
+/// aircraft = 20        # Generated aircraft, drawn from the companies below
+/// vertiports = 1
+/// chargers = 3         # At each vertiport
+/// fleet = fleet.csv    # Optional, a CSV of company,vertiport rows to fly instead of generated aircraft
+/// demand = 0           # Trips requested per hour at each vertiport, or 0 to fly whenever charged
+/// dispatch_interval = 60   # Seconds between matching trips to idle aircraft
+/// max_wait = 1800      # Seconds a party waits for an aircraft before giving up
+/// max_party = 4        # Parties are drawn evenly from one up to this many passengers
+///
+/// [company]
+/// name = Alpha
+/// cruise_speed = 120   # mph
+/// battery_capacity = 320   # kWh
+/// charge_time = 0.6    # hours
+/// energy_use = 1.6     # kWh per mile
+/// passengers = 4
+/// fault_rate = 0.25    # per hour
+/// weight = 1           # Optional, the company's relative share of generated aircraft
+/// @endcode
+/// Any key left out of the [scenario] section keeps its default. The fleet path is relative to the config file
+class ScenarioConfig {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Methods
+    /// @{
+
+    /// @brief Load the config file at the given path, throwing if it is missing or malformed
+    static ScenarioConfig Load(const std::string& path);
+
+    /// @brief Read a parsed config file
+    static ScenarioConfig FromConfig(const ConfigFile& file);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Add the configured companies to a scene
+    void addCompanies(Scene& scene) const;
+
+	/// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    std::vector<CompanyConfig> m_companies;
+
+    /// @brief The size of the scene, and its seed
+    ScenarioSettings m_scenario;
+
+    /// @brief The number of hours to simulate
+    double m_hours = 3.0;
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
@@ -0,0 +1,95 @@
+#include "JScenarioGenerator.h"
+#include <algorithm>
+#include <string_view>
+#include <apps/eVTOL/sim/JScene.h>
+#include <core/containers/JString.h>
+#include <core/serialization/JMappedFile.h>
+#include <core/time/JTimer.h>
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t ScenarioGenerator::LoadFleet(const std::string & path, Scene & scene, uint64_t seed, bool antithetic)
+{
+    std::vector<std::string_view> companyNames;
+    for (const Company& company : scene.companies()) {
+        companyNames.push_back(company.name());
+    }
+
+    // Lines are usually short, so this overestimates the row count by a little, to size the arrays once
+    MappedFile file(path);
+    std::string_view text = file.view();
+    size_t rowEstimate = size_t(std::count(text.begin(), text.end(), '\n')) + 1;
+    std::vector<uint32_t> companyIds;
+    std::vector<uint32_t> vertiportIds;
+    companyIds.reserve(rowEstimate);
+    vertiportIds.reserve(rowEstimate);
+
+    size_t lineNumber = 0;
+    while (!text.empty()) {
+        lineNumber++;
+        std::string_view line = JString::Trim(JString::NextToken(text, '\n'));
+        if (line.empty() || (lineNumber == 1 && line == "company,vertiport")) {
+            continue;
+        }
+        std::string_view companyName = JString::Trim(JString::NextToken(line, ','));
+        uint32_t vertiportId;
+        if (!JString::ToNumber(JString::Trim(line), vertiportId)) {
+            throw std::runtime_error(JString::Format("Error, %s:%d: expected company,vertiport", path.c_str(), int(lineNumber)));
+        }
+        auto company = std::find(companyNames.begin(), companyNames.end(), companyName);
+        if (company == companyNames.end()) {
+            throw std::runtime_error(JString::Format("Error, %s:%d: no company named %s", path.c_str(), int(lineNumber),
+                std::string(companyName).c_str()));
+        }
+        companyIds.push_back(uint32_t(company - companyNames.begin()));
+        vertiportIds.push_back(vertiportId);
+    }
+    scene.addAircraft(companyIds.data(), vertiportIds.data(), companyIds.size(), seed, antithetic);
+    return companyIds.size();
+}
+
+ScenarioGenerator::ScenarioGenerator(size_t threadCount):
+    m_threadPool(threadCount > 1 ? threadCount : 0)
+{
+}
+
+ScenarioGenerator::~ScenarioGenerator()
+{
+}
+
+ScenarioStatistics ScenarioGenerator::build(Scene& scene, const ScenarioSettings& settings)
+{
+    if (!settings.m_vertiportCount) {
+        throw std::invalid_argument("Error, a scenario needs at least one vertiport");
+    }
+
+    Timer timer;
+    timer.start();
+    if (settings.m_vertiportCount == 1) {
+        scene.setChargerCount(settings.m_chargerCount);
+    }
+    else {
+        for (size_t i = 0; i < settings.m_vertiportCount; i++) {
+            scene.addVertiport(JString::Format("Vertiport %d", int(i + 1)), settings.m_chargerCount);
+        }
+    }
+
+    if (!settings.m_fleetPath.empty()) {
+        LoadFleet(settings.m_fleetPath, scene, settings.m_seed, settings.m_antithetic);
+    }
+    else {
+        scene.addAircraft(settings.m_aircraftCount, settings.m_seed, settings.m_antithetic, settings.m_companyWeights,
+            &m_threadPool);
+    }
+    scene.setDemand(settings.m_demand, settings.m_seed, settings.m_antithetic);
+
+    ScenarioStatistics statistics;
+    statistics.m_elapsedSec = timer.getElapsed<double>();
+    statistics.m_memoryBytes = scene.memoryFootprint();
+    return statistics;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
@@ -0,0 +1,119 @@
+#ifndef J_SCENARIO_GENERATOR_H
+#define J_SCENARIO_GENERATOR_H
+/** @file JScenarioGenerator.h 
+    Defines a generator that populates scenes of any size, for scale testing
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <core/threading/JThreadPool.h>
+#include <apps/eVTOL/entities/vertiport/JTripQueue.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class Scene;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief The size and makeup of a generated scene
+struct ScenarioSettings {
+    size_t m_aircraftCount = 20;
+    size_t m_vertiportCount = 1;
+    size_t m_chargerCount = 3; // The number of chargers at each vertiport
+
+    /// @brief The relative chance of each company building an aircraft, or empty for an even chance
+    std::vector<double> m_companyWeights;
+
+    uint64_t m_seed = 0;
+    bool m_antithetic = false;
+
+    /// @brief A CSV file of aircraft to add instead of drawing them, or empty to draw them, see LoadFleet()
+    std::string m_fleetPath;
+
+    /// @brief How passengers ask for trips at every vertiport, which is not at all by default
+    DemandSettings m_demand;
+};
+
+/// @brief How long a scene took to generate, and how much memory it holds
+struct ScenarioStatistics {
+    double m_elapsedSec = 0.0;
+    size_t m_memoryBytes = 0;
+};
+
+/// @class ScenarioGenerator
+/// @brief Populates a scene with vertiports and chargers, and with aircraft from the scene's companies
+/// @details Every container is sized up front, and aircraft are drawn in chunks across a thread pool. Each
+/// aircraft is drawn by its ID, so the scene is the same for any number of threads, and the same as one
+/// populated by Scene::addAircraft directly
+class ScenarioGenerator {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Methods
+    /// @{
+
+    /// @brief Add the aircraft listed in a fleet file to a scene, returning how many were added
+    /// @details Each line of the file is the name of a company in the scene and the index of the vertiport
+    /// the aircraft is first bound for, separated by a comma, e.g. "Alpha,3". A "company,vertiport" header
+    /// line is skipped. The file is memory-mapped and parsed in place
+    static size_t LoadFleet(const std::string& path, Scene& scene, uint64_t seed, bool antithetic = false);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    /// @param[in] threadCount The number of threads to draw aircraft on. With one or none, they are drawn on the
+    /// calling thread
+    ScenarioGenerator(size_t threadCount = std::thread::hardware_concurrency());
+    ~ScenarioGenerator();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    size_t threadCount() const { return m_threadPool.numThreads(); }
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Add the vertiports and aircraft described by the settings to a scene that already has its companies
+    /// @details A single vertiport replaces any the scene had, as with Scene::setChargerCount. Otherwise,
+    /// vertiports are added after any existing ones. Aircraft are loaded from the fleet file if there is one
+    ScenarioStatistics build(Scene& scene, const ScenarioSettings& settings);
+
+	/// @}
+
+protected:
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    /// @brief The pool that aircraft are drawn on
+    ThreadPool m_threadPool;
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
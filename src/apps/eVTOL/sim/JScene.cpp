@@ -1,8 +1,48 @@
 #include "JScene.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <apps/eVTOL/sim/JFleetProcess.h>
+#include <core/diagnostics/JLogger.h>
+#include <core/diagnostics/JRunHash.h>
+#include <core/physics/JUnits.h>
+#include <core/serialization/JBinaryStream.h>
+#include <core/sim/JPartitionedSimulator.h>
+#include <core/sim/JSimulator.h>
+#include <core/threading/JThreadPool.h>
 
 namespace joby {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+TraceSchema Scene::AircraftTraceSchema()
+{
+    TraceSchema schema;
+    schema.m_entityName = "aircraft";
+    schema.m_locationName = "vertiport";
+    schema.m_stateNames = { "flying", "waiting", "charging", "idle" };
+    return schema;
+}
+
+std::vector<TableColumn> Scene::SummaryColumns()
+{
+    return {
+        { "company", TableColumnType::kText },
+        { "flights", TableColumnType::kInteger },
+        { "flight hours", TableColumnType::kReal },
+        { "miles", TableColumnType::kReal },
+        { "charges", TableColumnType::kInteger },
+        { "charge hours", TableColumnType::kReal },
+        { "wait hours", TableColumnType::kReal },
+        { "faults", TableColumnType::kInteger },
+        { "passenger miles", TableColumnType::kReal },
+        { "flight hours sd", TableColumnType::kReal },
+        { "charge hours sd", TableColumnType::kReal },
+        { "wait hours p50", TableColumnType::kReal },
+        { "wait hours p95", TableColumnType::kReal },
+        { "wait hours p99", TableColumnType::kReal }
+    };
+}
+
 Scene::Scene()
 {
 }
@@ -11,11 +51,693 @@ Scene::~Scene()
 {
 }
 
+void Scene::setChargerQueuePolicy(ChargerQueuePolicy policy)
+{
+    m_chargerQueuePolicy = policy;
+    for (Vertiport& vertiport : m_vertiports) {
+        vertiport.chargerAllocator().setPolicy(policy);
+    }
+}
+
+size_t Scene::waitingCount() const
+{
+    size_t count = 0;
+    for (const Vertiport& vertiport : m_vertiports) {
+        count += vertiport.waitingCount();
+    }
+    return count;
+}
+
+void Scene::setDemand(const DemandSettings & settings, uint64_t seed, bool antithetic)
+{
+    if (!(settings.m_tripsPerHour >= 0.0) || !std::isfinite(settings.m_tripsPerHour)) {
+        throw std::invalid_argument("Error, the rate of trip requests must be finite and non-negative");
+    }
+    if (!(settings.m_dispatchInterval > 0.0)) {
+        throw std::invalid_argument("Error, the dispatch interval must be positive");
+    }
+    if (!(settings.m_maxWait >= 0.0)) {
+        throw std::invalid_argument("Error, the longest wait for a trip cannot be negative");
+    }
+    if (settings.m_maxPartySize < 1 || settings.m_maxPartySize > TripQueue::s_maxCapacity) {
+        throw std::invalid_argument("Error, invalid party size for trip requests");
+    }
+    m_demandSettings = settings;
+    m_demandSeed = seed;
+    m_demandAntithetic = antithetic;
+}
+
+DemandStatistics Scene::demandStatistics() const
+{
+    DemandStatistics statistics;
+    for (const Vertiport& vertiport : m_vertiports) {
+        statistics += vertiport.tripQueue().statistics();
+    }
+    return statistics;
+}
+
+Vertiport & Scene::addVertiport(const std::string & name, size_t chargerCount)
+{
+    Vertiport& vertiport = m_vertiports.emplace_back(name, chargerCount);
+    vertiport.chargerAllocator().setPolicy(m_chargerQueuePolicy);
+    return vertiport;
+}
+
 void Scene::setChargerCount(size_t count)
 {
-    // Clear chargers so they can all be reinitialized to default values
-    m_chargers.clear();
-    m_chargers.resize(count);
+    m_vertiports.clear();
+    addVertiport("Vertiport", count);
+}
+
+void Scene::addAircraft(size_t count, uint64_t seed, bool antithetic, const std::vector<double>& companyWeights,
+    ThreadPool* threadPool)
+{
+    if (m_companies.empty()) {
+        throw std::logic_error("Error, cannot add aircraft to a scene without companies");
+    }
+
+    // Take a specification from any companies added since the last aircraft
+    while (m_fleet.specificationCount() < m_companies.size()) {
+        m_fleet.addSpecification(m_companies[m_fleet.specificationCount()].aircraftSpec());
+    }
+
+    // Weights are turned into cumulative fractions, so that each draw picks a company by binary search
+    std::vector<double> cumulativeWeights;
+    if (!companyWeights.empty()) {
+        if (companyWeights.size() != m_companies.size()) {
+            throw std::invalid_argument("Error, need one weight per company");
+        }
+        double total = 0.0;
+        for (double weight : companyWeights) {
+            if (!(weight >= 0.0)) {
+                throw std::invalid_argument("Error, company weights cannot be negative");
+            }
+            total += weight;
+            cumulativeWeights.push_back(total);
+        }
+        if (!(total > 0.0)) {
+            throw std::invalid_argument("Error, at least one company weight must be positive");
+        }
+        for (double& weight : cumulativeWeights) {
+            weight /= total;
+        }
+    }
+
+    // Draw the company and the vertiport of every new aircraft, in chunks that may be drawn in parallel. Aircraft
+    // use the pair of scene draws indexed by their ID, so the choices for an aircraft don't depend on how many were
+    // added before it, or when, or how the draws were split between threads
+    const uint32_t firstId = uint32_t(m_fleet.size());
+    const size_t companyCount = m_companies.size();
+    const size_t vertiportCount = m_vertiports.size();
+    std::vector<uint32_t> companyIds(count);
+    std::vector<uint32_t> vertiportIds(count);
+    m_aircraftStreams.resize(firstId + count);
+    const size_t chunkCount = (count + s_aircraftChunkSize - 1) / s_aircraftChunkSize;
+    auto drawChunk = [&](size_t chunk) {
+        size_t begin = chunk * s_aircraftChunkSize;
+        size_t end = std::min(begin + s_aircraftChunkSize, count);
+        RandomStream sceneStream(seed, s_sceneStreamId);
+        sceneStream.setAntithetic(antithetic);
+        sceneStream.setIndex(2 * uint64_t(firstId + begin));
+        std::vector<double> draws(2 * (end - begin));
+        sceneStream.uniforms(draws.data(), draws.size());
+        for (size_t i = begin; i < end; i++) {
+            double companyDraw = draws[2 * (i - begin)];
+            double vertiportDraw = draws[2 * (i - begin) + 1];
+            if (cumulativeWeights.empty()) {
+                companyIds[i] = uint32_t(RandomStream::ToIndex(companyDraw, companyCount));
+            }
+            else {
+                auto chosen = std::upper_bound(cumulativeWeights.begin(), cumulativeWeights.end(), companyDraw);
+                companyIds[i] = uint32_t(std::min(size_t(chosen - cumulativeWeights.begin()), companyCount - 1));
+            }
+            vertiportIds[i] = vertiportCount > 1 ? uint32_t(RandomStream::ToIndex(vertiportDraw, vertiportCount)) : 0;
+            RandomStream& stream = m_aircraftStreams[firstId + i];
+            stream.reseed(seed, firstId + i);
+            stream.setAntithetic(antithetic);
+        }
+    };
+    if (threadPool) {
+        threadPool->parallelFor(chunkCount, drawChunk);
+    }
+    else {
+        for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+            drawChunk(chunk);
+        }
+    }
+    m_fleet.add(companyIds.data(), vertiportIds.data(), count);
+}
+
+void Scene::addAircraft(const uint32_t * companyIds, const uint32_t * vertiportIds, size_t count, uint64_t seed,
+    bool antithetic)
+{
+    while (m_fleet.specificationCount() < m_companies.size()) {
+        m_fleet.addSpecification(m_companies[m_fleet.specificationCount()].aircraftSpec());
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (vertiportIds[i] >= m_vertiports.size()) {
+            throw std::invalid_argument("Error, aircraft bound for a vertiport that isn't in the scene");
+        }
+    }
+    uint32_t firstId = m_fleet.add(companyIds, vertiportIds, count);
+    m_aircraftStreams.reserve(firstId + count);
+    for (size_t i = 0; i < count; i++) {
+        m_aircraftStreams.emplace_back(seed, firstId + i).setAntithetic(antithetic);
+    }
+}
+
+size_t Scene::memoryFootprint() const
+{
+    size_t bytes = sizeof(Scene) + m_fleet.memoryFootprint()
+        + m_aircraftStreams.capacity() * sizeof(RandomStream)
+        + m_companies.capacity() * sizeof(Company)
+        + m_vertiports.capacity() * sizeof(Vertiport);
+    for (const Vertiport& vertiport : m_vertiports) {
+        bytes += vertiport.chargerAllocator().memoryFootprint() + vertiport.tripQueue().memoryFootprint();
+    }
+    return bytes;
+}
+
+void Scene::initialize(Simulator& simulator)
+{
+    if (m_vertiports.empty()) {
+        throw std::logic_error("Error, cannot initialize a scene without vertiports");
+    }
+    if (m_demandSettings.enabled() && m_flightModel != FlightModel::kAnalytic) {
+        throw std::logic_error("Error, only analytic flight can model passenger demand");
+    }
+    m_simulator = &simulator;
+    m_simulator->eventDispatcher().setHandler<SceneEventType>(*this);
+    m_startTime = simulator.simulationTime();
+
+    if (m_flightModel == FlightModel::kFixedStep) {
+        m_fleetProcess = std::make_shared<FleetProcess>(*this, simulator);
+        m_simulator->processQueue().attachProcess(m_fleetProcess, true);
+    }
+    else {
+        // Each analytic aircraft has a landing or a charge pending, and at most one fault
+        m_simulator->eventQueue().reserve(2 * m_fleet.size() + m_vertiports.size());
+    }
+    startDemand(simulator.simulationTime());
+    launchAircraft(simulator.simulationTime());
+}
+
+void Scene::initialize(PartitionedSimulator & simulator)
+{
+    if (m_flightModel != FlightModel::kAnalytic) {
+        throw std::logic_error("Error, only analytic flight can be partitioned");
+    }
+    if (simulator.partitionCount() != m_vertiports.size()) {
+        throw std::invalid_argument("Error, a partitioned scene needs one partition per vertiport");
+    }
+    if (m_traceRecorder && m_traceRecorder->bufferCount() < m_vertiports.size()) {
+        throw std::invalid_argument("Error, a partitioned scene needs a trace buffer per vertiport");
+    }
+    m_partitionedSimulator = &simulator;
+    m_partitionedSimulator->eventDispatcher().setHandler<SceneEventType>(*this);
+    m_startTime = simulator.simulationTime();
+
+    // Partitions change aircraft states from several threads, and have their own copies of the statistics
+    m_fleet.setCountsFlying(false);
+    VertiportTotals totals;
+    totals.m_statistics.resize(m_companies.size());
+    totals.m_distributions.resize(m_companies.size());
+    m_vertiportTotals.assign(m_vertiports.size(), totals);
+
+    // Every flight starts on a full battery, so none can land sooner than the shortest of these after takeoff
+    double shortestFlight = std::numeric_limits<double>::infinity();
+    for (uint32_t i = 0; i < m_fleet.specificationCount(); i++) {
+        shortestFlight = std::min(shortestFlight, m_fleet.fullChargeHours(i));
+    }
+    simulator.setLookahead(Units::Convert<TimeUnits::kHours, TimeUnits::kSeconds>(shortestFlight));
+    startDemand(simulator.simulationTime());
+    launchAircraft(simulator.simulationTime());
+}
+
+double Scene::drawHoursToFault(uint32_t aircraftIndex)
+{
+    // Faults arrive at a constant rate per hour of flight, so the time between them is exponential
+    return m_aircraftStreams[aircraftIndex].exponential(m_fleet.specification(aircraftIndex).failureRate());
+}
+
+void Scene::finalize(double time)
+{
+    m_endTime = time;
+    for (uint32_t i = 0; i < m_fleet.size(); i++) {
+        double hours = Units::Convert<TimeUnits::kSeconds, TimeUnits::kHours>(time - m_fleet.stateStartTime(i));
+        CompanyStatistics& statistics = this->statistics(i);
+        switch (m_fleet.state(i)) {
+        case AircraftState::kFlying:
+            // Fixed-step flight time is tallied as the aircraft flies, but analytic flights are tallied on landing
+            if (m_flightModel == FlightModel::kAnalytic) {
+                tallyFlight(i, hours);
+            }
+
+            // Partitioned flights count their faults on landing, so count those already due
+            if (!m_vertiportTotals.empty()) {
+                while (m_fleet.hoursToFault(i) <= hours) {
+                    statistics.m_faultCount++;
+                    m_fleet.setHoursToFault(i, m_fleet.hoursToFault(i) + drawHoursToFault(i));
+                }
+            }
+            break;
+        case AircraftState::kWaiting:
+            statistics.m_waitTime += hours;
+            m_fleet.addWaitTime(i, hours);
+            break;
+        case AircraftState::kCharging:
+            statistics.m_chargeTime += hours;
+            break;
+        case AircraftState::kIdle:
+            m_vertiports[m_fleet.vertiportId(i)].tripQueue().statistics().m_idleTime += hours;
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Add up the statistics of every vertiport in a fixed order, so totals don't depend on the number of threads
+    if (!m_vertiportTotals.empty()) {
+        m_vertiportTotals.mergeInto(m_companies, [](std::vector<Company>& companies, const VertiportTotals& totals) {
+            for (size_t i = 0; i < companies.size(); i++) {
+                companies[i].statistics() += totals.m_statistics[i];
+                companies[i].distributions().merge(totals.m_distributions[i]);
+            }
+        });
+        m_vertiportTotals.clear();
+        m_fleet.setCountsFlying(true);
+    }
+}
+
+void Scene::report() const
+{
+    // Formats are registered once, so that reporting a network of vertiports only queues their numbers
+    static const LogFormat s_companyFormat("%s: %d flights, %.3f hours and %.2f miles per flight, %.3f hours per charge, %.3f hours waiting, %d faults, %.1f passenger miles");
+    static const LogFormat s_distributionFormat("%s: %zu completed flights of %.3f hours (sd %.3f), %zu completed charges of %.3f hours (sd %.3f), waits of %.3f hours at the median, %.3f at the 95th percentile and %.3f at the 99th");
+    static const LogFormat s_vertiportFormat("%s: %zu arrivals, %zu departures, %zu charges, %.1f%% mean charger utilization, %.1f%% for the busiest charger");
+    static const LogFormat s_demandFormat("Demand: %zu trips requested, %zu flown and %zu given up on, carrying %zu passengers, waits of %.3f hours at the median and %.3f at the 95th percentile, %.1f aircraft hours idle");
+
+    for (const Company& company : m_companies) {
+        const CompanyStatistics& statistics = company.statistics();
+        double flightCount = std::max(statistics.m_flightCount, size_t(1));
+        double chargeCount = std::max(statistics.m_chargeCount, size_t(1));
+        Logger::LogInfo(s_companyFormat,
+            company.name(),
+            statistics.m_flightCount,
+            statistics.m_flightTime / flightCount,
+            statistics.m_distance / flightCount,
+            statistics.m_chargeTime / chargeCount,
+            statistics.m_waitTime,
+            statistics.m_faultCount,
+            statistics.m_passengerMiles);
+
+        // Totals include flights and charges still under way at the end, while distributions only hold those that
+        // finished, so the second line says how many it covers
+        const CompanyDistributions& distributions = company.distributions();
+        Logger::LogInfo(s_distributionFormat,
+            company.name(),
+            distributions.m_flightTime.count(),
+            distributions.m_flightTime.mean(),
+            distributions.m_flightTime.statistics().standardDeviation(),
+            distributions.m_chargeTime.count(),
+            distributions.m_chargeTime.mean(),
+            distributions.m_chargeTime.statistics().standardDeviation(),
+            distributions.m_waitTime.quantile(0.5),
+            distributions.m_waitTime.quantile(0.95),
+            distributions.m_waitTime.quantile(0.99));
+    }
+
+    for (const Vertiport& vertiport : m_vertiports) {
+        const std::vector<Charger>& chargers = vertiport.chargers();
+        size_t chargeCount = 0;
+        double utilization = 0.0;
+        double busiestUtilization = 0.0;
+        for (const Charger& charger : chargers) {
+            double chargerUtilization = charger.utilization(m_endTime, m_endTime - m_startTime);
+            chargeCount += charger.chargeCount();
+            utilization += chargerUtilization / chargers.size();
+            busiestUtilization = std::max(busiestUtilization, chargerUtilization);
+        }
+        Logger::LogInfo(s_vertiportFormat, vertiport.name(), vertiport.arrivalCount(), vertiport.departureCount(),
+            chargeCount, 100.0 * utilization, 100.0 * busiestUtilization);
+    }
+
+    if (m_demandSettings.enabled()) {
+        DemandStatistics statistics = demandStatistics();
+        Logger::LogInfo(s_demandFormat, statistics.m_requestCount, statistics.m_tripCount, statistics.m_abandonedCount,
+            statistics.m_passengerCount, statistics.m_waitTime.quantile(0.5), statistics.m_waitTime.quantile(0.95),
+            statistics.m_idleTime);
+    }
+}
+
+void Scene::exportSummary(TableWriter & writer) const
+{
+    for (const Company& company : m_companies) {
+        const CompanyStatistics& statistics = company.statistics();
+        const CompanyDistributions& distributions = company.distributions();
+        writer.add(company.name())
+            .add(uint64_t(statistics.m_flightCount))
+            .add(statistics.m_flightTime)
+            .add(statistics.m_distance)
+            .add(uint64_t(statistics.m_chargeCount))
+            .add(statistics.m_chargeTime)
+            .add(statistics.m_waitTime)
+            .add(uint64_t(statistics.m_faultCount))
+            .add(statistics.m_passengerMiles)
+            .add(distributions.m_flightTime.statistics().standardDeviation())
+            .add(distributions.m_chargeTime.statistics().standardDeviation())
+            .add(distributions.m_waitTime.quantile(0.5))
+            .add(distributions.m_waitTime.quantile(0.95))
+            .add(distributions.m_waitTime.quantile(0.99));
+        writer.endRow();
+    }
+}
+
+void Scene::hashState(RunHash & hash) const
+{
+    for (const Company& company : m_companies) {
+        hash.add(company.statistics());
+        const CompanyDistributions& distributions = company.distributions();
+        for (const Distribution* distribution : { &distributions.m_flightTime, &distributions.m_distance, &distributions.m_chargeTime, &distributions.m_waitTime }) {
+            hash.add(distribution->count());
+            hash.add(distribution->mean());
+            hash.add(distribution->statistics().variance());
+        }
+    }
+    for (uint32_t i = 0; i < m_fleet.size(); i++) {
+        hash.add(m_fleet.vertiportId(i));
+        hash.add(m_fleet.state(i));
+        hash.add(m_fleet.batteryCharge(i));
+        hash.add(m_fleet.stateStartTime(i));
+        hash.add(m_fleet.hoursToFault(i));
+    }
+    if (m_demandSettings.enabled()) {
+        for (const Vertiport& vertiport : m_vertiports) {
+            const DemandStatistics& statistics = vertiport.tripQueue().statistics();
+            hash.add(uint64_t(statistics.m_requestCount));
+            hash.add(uint64_t(statistics.m_tripCount));
+            hash.add(uint64_t(statistics.m_abandonedCount));
+            hash.add(uint64_t(statistics.m_passengerCount));
+            hash.add(statistics.m_idleTime);
+            hash.add(statistics.m_waitTime.mean());
+        }
+    }
+}
+
+void Scene::save(BinaryWriter & writer) const
+{
+    if (m_partitionedSimulator) {
+        throw std::logic_error("Error, partitioned scenes cannot be checkpointed");
+    }
+    writer.write(m_flightModel);
+    writer.write(uint64_t(m_companies.size()));
+    for (const Company& company : m_companies) {
+        writer.write(company.statistics());
+        company.distributions().save(writer);
+    }
+
+    m_fleet.save(writer);
+    for (const RandomStream& stream : m_aircraftStreams) {
+        writer.write(stream.state());
+    }
+
+    writer.write(uint64_t(m_vertiports.size()));
+    for (const Vertiport& vertiport : m_vertiports) {
+        vertiport.save(writer);
+    }
+    writer.write(m_startTime);
+}
+
+void Scene::load(BinaryReader & reader)
+{
+    if (reader.read<FlightModel>() != m_flightModel) {
+        throw std::runtime_error("Error, checkpoint does not match the scene's flight model");
+    }
+    if (reader.read<uint64_t>() != m_companies.size()) {
+        throw std::runtime_error("Error, checkpoint does not match the scene's companies");
+    }
+    for (Company& company : m_companies) {
+        reader.read(company.statistics());
+        company.distributions().load(reader);
+    }
+
+    m_fleet.load(reader);
+    for (RandomStream& stream : m_aircraftStreams) {
+        stream.setState(reader.read<RandomStream::State>());
+    }
+
+    if (reader.read<uint64_t>() != m_vertiports.size()) {
+        throw std::runtime_error("Error, checkpoint does not match the scene's vertiports");
+    }
+    for (Vertiport& vertiport : m_vertiports) {
+        vertiport.load(reader);
+    }
+    reader.read(m_startTime);
+}
+
+template<>
+void Scene::onEvent<SceneEventType::kChargeComplete>(const Event& event)
+{
+    uint32_t aircraftIndex = event.m_target;
+    uint32_t chargerIndex = event.payload<uint32_t>();
+    uint32_t vertiportId = m_fleet.vertiportId(aircraftIndex);
+
+    double hours = Units::Convert<TimeUnits::kSeconds, TimeUnits::kHours>(event.m_time - m_fleet.stateStartTime(aircraftIndex));
+    statistics(aircraftIndex).m_chargeTime += hours;
+    distributions(aircraftIndex).m_chargeTime.add(hours);
+    m_fleet.recharge(aircraftIndex);
+    if (m_demandSettings.enabled()) {
+        becomeIdle(aircraftIndex, event.m_time);
+    }
+    else {
+        startFlight(aircraftIndex, event.m_time, chooseVertiport(m_aircraftStreams[aircraftIndex]));
+    }
+
+    // Hand the charger to the next aircraft in line
+    uint32_t nextIndex;
+    if (m_vertiports[vertiportId].chargerAllocator().release(chargerIndex, event.m_time, nextIndex)) {
+        startCharging(nextIndex, chargerIndex, event.m_time);
+    }
+}
+
+template<>
+void Scene::onEvent<SceneEventType::kBatteryDepleted>(const Event& event)
+{
+    uint32_t aircraftIndex = event.m_target;
+    double hours = m_fleet.flyUntilDepleted(aircraftIndex);
+    tallyFlight(aircraftIndex, hours);
+    m_vertiports[m_fleet.vertiportId(aircraftIndex)].addArrival();
+
+    // Faults during a partitioned flight weren't scheduled as events, so count them from takeoff just as the
+    // events would have
+    while (m_fleet.hoursToFault(aircraftIndex) < hours) {
+        statistics(aircraftIndex).m_faultCount++;
+        m_fleet.setHoursToFault(aircraftIndex, m_fleet.hoursToFault(aircraftIndex) + drawHoursToFault(aircraftIndex));
+    }
+
+    // Count down to the next fault from landing rather than takeoff, picking up a fault due at the very
+    // moment the battery ran out
+    double hoursToFault = m_fleet.hoursToFault(aircraftIndex) - hours;
+    while (hoursToFault <= 0.0) {
+        statistics(aircraftIndex).m_faultCount++;
+        hoursToFault += drawHoursToFault(aircraftIndex);
+    }
+    m_fleet.setHoursToFault(aircraftIndex, hoursToFault);
+
+    onBatteryDepleted(aircraftIndex, event.m_time);
+}
+
+template<>
+void Scene::onEvent<SceneEventType::kFault>(const Event& event)
+{
+    // A fault rounded to the moment the battery runs out may land after the depletion event, which counts it instead
+    uint32_t aircraftIndex = event.m_target;
+    if (m_fleet.state(aircraftIndex) != AircraftState::kFlying || m_fleet.stateStartTime(aircraftIndex) != event.payload<double>()) {
+        return;
+    }
+    statistics(aircraftIndex).m_faultCount++;
+    m_fleet.setHoursToFault(aircraftIndex, m_fleet.hoursToFault(aircraftIndex) + drawHoursToFault(aircraftIndex));
+    scheduleFault(aircraftIndex);
+}
+
+template<>
+void Scene::onEvent<SceneEventType::kDispatch>(const Event& event)
+{
+    // Send each matched aircraft off with its passengers, counting the time it sat idle towards the vertiport
+    uint32_t vertiportId = event.m_target;
+    TripQueue& tripQueue = m_vertiports[vertiportId].tripQueue();
+    for (const TripMatch& match : tripQueue.dispatch(event.m_time)) {
+        tripQueue.statistics().m_idleTime += Units::Convert<TimeUnits::kSeconds, TimeUnits::kHours>(event.m_time - m_fleet.stateStartTime(match.m_aircraft));
+        m_fleet.setPassengerCount(match.m_aircraft, match.m_request.m_passengerCount);
+        startFlight(match.m_aircraft, event.m_time, match.m_request.m_destination);
+    }
+
+    Event nextDispatch = event;
+    nextDispatch.m_time += m_demandSettings.m_dispatchInterval;
+    schedule(nextDispatch, vertiportId, vertiportId);
+}
+
+void Scene::onBatteryDepleted(uint32_t aircraftIndex, double time)
+{
+    double flightHours = Units::Convert<TimeUnits::kSeconds, TimeUnits::kHours>(time - m_fleet.stateStartTime(aircraftIndex));
+    CompanyDistributions& distributions = this->distributions(aircraftIndex);
+    distributions.m_flightTime.add(flightHours);
+    distributions.m_distance.add(flightHours * m_fleet.specification(aircraftIndex).cruiseSpeed());
+
+    m_fleet.setState(aircraftIndex, AircraftState::kWaiting);
+    m_fleet.setStateStartTime(aircraftIndex, time);
+    trace(aircraftIndex, m_fleet.vertiportId(aircraftIndex), time);
+
+    // Under the priority policy, the aircraft with the shortest charge goes first
+    ChargerAllocator& chargerAllocator = m_vertiports[m_fleet.vertiportId(aircraftIndex)].chargerAllocator();
+    uint32_t chargerIndex;
+    if (chargerAllocator.tryAcquire(time, chargerIndex)) {
+        startCharging(aircraftIndex, chargerIndex, time);
+    }
+    else {
+        chargerAllocator.enqueue(aircraftIndex, m_fleet.specification(aircraftIndex).chargeTime());
+    }
+}
+
+void Scene::startFlight(uint32_t aircraftIndex, double time, uint32_t destination)
+{
+    // The flight counts towards the vertiport it leaves, then the aircraft belongs to the one it flies to
+    uint32_t origin = m_fleet.vertiportId(aircraftIndex);
+    statistics(aircraftIndex).m_flightCount++;
+    m_vertiports[origin].addDeparture();
+    m_fleet.setVertiportId(aircraftIndex, destination);
+
+    m_fleet.setState(aircraftIndex, AircraftState::kFlying);
+    m_fleet.setStateStartTime(aircraftIndex, time);
+    trace(aircraftIndex, origin, time);
+
+    if (m_flightModel == FlightModel::kAnalytic) {
+        // The battery runs out at a known time, and faults due before then are scheduled one at a time,
+        // unless the scene is partitioned
+        if (!m_partitionedSimulator) {
+            scheduleFault(aircraftIndex);
+        }
+        double hours = m_fleet.hoursToDepletion(aircraftIndex);
+        if (std::isfinite(hours)) {
+            schedule(Event{ time + Units::Convert<TimeUnits::kHours, TimeUnits::kSeconds>(hours),
+                (uint32_t)SceneEventType::kBatteryDepleted, aircraftIndex }, origin, destination);
+        }
+    }
+    else if (m_fleetProcess && m_fleetProcess->isPaused()) {
+        // Wake the fleet process, in case everything else was grounded
+        m_fleetProcess->unPause();
+    }
+}
+
+void Scene::becomeIdle(uint32_t aircraftIndex, double time)
+{
+    m_fleet.setState(aircraftIndex, AircraftState::kIdle);
+    m_fleet.setStateStartTime(aircraftIndex, time);
+    trace(aircraftIndex, m_fleet.vertiportId(aircraftIndex), time);
+    m_vertiports[m_fleet.vertiportId(aircraftIndex)].tripQueue().addIdle(aircraftIndex,
+        uint32_t(m_fleet.specification(aircraftIndex).maxPassengerCount()));
+}
+
+void Scene::startCharging(uint32_t aircraftIndex, uint32_t chargerIndex, double time)
+{
+    double waitHours = Units::Convert<TimeUnits::kSeconds, TimeUnits::kHours>(time - m_fleet.stateStartTime(aircraftIndex));
+    CompanyStatistics& statistics = this->statistics(aircraftIndex);
+    statistics.m_waitTime += waitHours;
+    statistics.m_chargeCount++;
+    distributions(aircraftIndex).m_waitTime.add(waitHours);
+    m_fleet.addWaitTime(aircraftIndex, waitHours);
+
+    m_fleet.setState(aircraftIndex, AircraftState::kCharging);
+    m_fleet.setStateStartTime(aircraftIndex, time);
+    trace(aircraftIndex, m_fleet.vertiportId(aircraftIndex), time);
+
+    Event chargeComplete{ time + Units::Convert<TimeUnits::kHours, TimeUnits::kSeconds>(m_fleet.specification(aircraftIndex).chargeTime()),
+        (uint32_t)SceneEventType::kChargeComplete, aircraftIndex };
+    chargeComplete.setPayload(chargerIndex);
+    uint32_t vertiportId = m_fleet.vertiportId(aircraftIndex);
+    schedule(chargeComplete, vertiportId, vertiportId);
+}
+
+void Scene::scheduleFault(uint32_t aircraftIndex)
+{
+    // A fault due at the very moment the battery runs out is left for the depletion event, which fires first
+    double hoursToFault = m_fleet.hoursToFault(aircraftIndex);
+    if (hoursToFault < m_fleet.hoursToDepletion(aircraftIndex)) {
+        double takeoffTime = m_fleet.stateStartTime(aircraftIndex);
+        Event fault{ takeoffTime + Units::Convert<TimeUnits::kHours, TimeUnits::kSeconds>(hoursToFault), (uint32_t)SceneEventType::kFault, aircraftIndex };
+        fault.setPayload(takeoffTime);
+        uint32_t vertiportId = m_fleet.vertiportId(aircraftIndex);
+        schedule(fault, vertiportId, vertiportId);
+    }
+}
+
+void Scene::tallyFlight(uint32_t aircraftIndex, double hours)
+{
+    const Aircraft& spec = m_fleet.specification(aircraftIndex);
+    double miles = spec.cruiseSpeed() * hours;
+    CompanyStatistics& statistics = this->statistics(aircraftIndex);
+    statistics.m_flightTime += hours;
+    statistics.m_distance += miles;
+    statistics.m_passengerMiles += miles * m_fleet.passengerCount(aircraftIndex);
+}
+
+CompanyStatistics & Scene::statistics(uint32_t aircraftIndex)
+{
+    uint32_t companyId = m_fleet.companyId(aircraftIndex);
+    if (m_vertiportTotals.empty()) {
+        return m_companies[companyId].statistics();
+    }
+    return m_vertiportTotals[m_fleet.vertiportId(aircraftIndex)].m_statistics[companyId];
+}
+
+CompanyDistributions & Scene::distributions(uint32_t aircraftIndex)
+{
+    uint32_t companyId = m_fleet.companyId(aircraftIndex);
+    if (m_vertiportTotals.empty()) {
+        return m_companies[companyId].distributions();
+    }
+    return m_vertiportTotals[m_fleet.vertiportId(aircraftIndex)].m_distributions[companyId];
+}
+
+void Scene::schedule(const Event & event, uint32_t fromVertiport, uint32_t toVertiport)
+{
+    if (m_partitionedSimulator) {
+        m_partitionedSimulator->send(fromVertiport, toVertiport, event);
+    }
+    else {
+        m_simulator->eventQueue().schedule(event);
+    }
+}
+
+uint32_t Scene::chooseVertiport(RandomStream & stream) const
+{
+    return m_vertiports.size() > 1 ? uint32_t(stream.uniformIndex(m_vertiports.size())) : 0;
+}
+
+void Scene::launchAircraft(double time)
+{
+    for (uint32_t i = 0; i < m_fleet.size(); i++) {
+        m_fleet.recharge(i);
+        m_fleet.setHoursToFault(i, drawHoursToFault(i));
+        if (m_demandSettings.enabled()) {
+            becomeIdle(i, time);
+        }
+        else {
+            startFlight(i, time, chooseVertiport(m_aircraftStreams[i]));
+        }
+    }
+}
+
+void Scene::startDemand(double time)
+{
+    if (!m_demandSettings.enabled()) {
+        return;
+    }
+    for (uint32_t i = 0; i < m_vertiports.size(); i++) {
+        m_vertiports[i].tripQueue().reset(m_demandSettings, m_demandSeed, s_firstDemandStreamId - i, m_demandAntithetic,
+            i, uint32_t(m_vertiports.size()), time);
+        schedule(Event{ time + m_demandSettings.m_dispatchInterval, (uint32_t)SceneEventType::kDispatch, i }, i, i);
+    }
 }
 
 
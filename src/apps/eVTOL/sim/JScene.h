@@ -6,11 +6,17 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Includes
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <memory>
 #include <vector>
 
-#include <apps/eVTOL/entities/charger/JCharger.h>
+#include <core/diagnostics/JTrace.h>
+#include <core/serialization/JTable.h>
+#include <core/events/JEvent.h>
+#include <core/random/JRandomStream.h>
+#include <core/threading/JShards.h>
 #include <apps/eVTOL/entities/company/JCompany.h>
-#include <apps/eVTOL/entities/vehicle/JeVTOL.h>
+#include <apps/eVTOL/entities/vehicle/JFleet.h>
+#include <apps/eVTOL/entities/vertiport/JVertiport.h>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Namespace Definitions
@@ -20,19 +26,63 @@ namespace joby {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Forward Declarations
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class Simulator;
+class PartitionedSimulator;
+class FleetProcess;
+class RunHash;
+class BinaryWriter;
+class BinaryReader;
+class ThreadPool;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Class Definitions
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief The discrete events handled by a scene
+enum class SceneEventType {
+    kChargeComplete = 0, // An aircraft finished charging. The target is the aircraft, the payload the charger
+    kBatteryDepleted, // An aircraft's battery ran out in flight. The target is the aircraft
+    kFault, // An aircraft faulted in flight. The target is the aircraft, the payload the takeoff time of the flight
+    kDispatch, // A vertiport matches its trip requests to its idle aircraft. The target is the vertiport
+    COUNT
+};
+
+/// @brief The ways in which a scene can fly its aircraft
+enum class FlightModel : uint8_t {
+    kAnalytic = 0, // Depletion and faults are predicted in closed form at takeoff, and scheduled as events
+    kFixedStep, // A FleetProcess integrates every airborne aircraft at the simulator's fixed step
+    COUNT
+};
+
 /// @class Scene
 /// @brief Contains all entities required to simulate eVTOL operations
+/// @details Aircraft cruise at a constant speed and rate of energy use, so the moment each battery runs out
+/// is known at takeoff, as is the moment of each fault given the flight time drawn until it. By default the
+/// scene schedules these as events, along with the moment each charge completes, so an aircraft costs a
+/// handful of events per flight however long the flight is, and flight time and distance carry no step
+/// error. Flight can instead be integrated at a fixed step by a FleetProcess.
+/// Each flight is bound for a vertiport, chosen at random at takeoff, where the aircraft lands once its battery
+/// runs out and charges. Every vertiport has its own chargers, and aircraft that find them all busy wait in
+/// the vertiport's own line, served first-come, first-served or by priority. Since vertiports only affect one
+/// another through flights, which last at least the shortest time any aircraft can fly on a full battery, an
+/// analytic scene can also be run on a PartitionedSimulator with one partition per vertiport.
+/// Aircraft take off again as soon as they are charged, unless the scene models passenger demand. Charged aircraft
+/// then idle at their vertiport, which matches them to the trips requested there once every dispatch interval, and
+/// each flight is bound for the vertiport its passengers asked for
 /// @note I have intentionally avoided storing aircraft instantiations within the Company
-/// objects themselves, since vectorization of objects is more cache-friendly
+/// objects themselves. Aircraft state lives in a Fleet, one array per field, so the fleet
+/// process streams through only the fields it needs
 class Scene {
 public:
     //-----------------------------------------------------------------------------------------------------------------
     /// @name Static Methods
     /// @{
+
+    /// @brief The schema of the traces that scenes record, with aircraft for entities and vertiports for locations
+    static TraceSchema AircraftTraceSchema();
+
+    /// @brief The columns of the table written by exportSummary()
+    static std::vector<TableColumn> SummaryColumns();
+
     /// @}
 
     //-----------------------------------------------------------------------------------------------------------------
@@ -47,6 +97,49 @@ public:
     //-----------------------------------------------------------------------------------------------------------------
     /// @name Properties
     /// @{
+
+    std::vector<Company>& companies() { return m_companies; }
+    const std::vector<Company>& companies() const { return m_companies; }
+
+    Fleet& fleet() { return m_fleet; }
+    const Fleet& fleet() const { return m_fleet; }
+
+    /// @brief The vertiports in the scene, indexed by vertiport ID
+    const std::vector<Vertiport>& vertiports() const { return m_vertiports; }
+
+    /// @brief The order in which waiting aircraft are handed chargers at every vertiport
+    /// @details Under the priority policy, aircraft with the shortest charge time go first
+    ChargerQueuePolicy chargerQueuePolicy() const { return m_chargerQueuePolicy; }
+    void setChargerQueuePolicy(ChargerQueuePolicy policy);
+
+    /// @brief How aircraft are flown, which must be chosen before the scene is initialized
+    FlightModel flightModel() const { return m_flightModel; }
+    void setFlightModel(FlightModel model) { m_flightModel = model; }
+
+    /// @brief The number of aircraft waiting in line for a charger, over every vertiport
+    size_t waitingCount() const;
+
+    /// @brief How passengers ask for trips at every vertiport
+    const DemandSettings& demandSettings() const { return m_demandSettings; }
+
+    /// @brief Model passenger demand, which must be set before the scene is initialized, and only with analytic flight
+    /// @param[in] seed Keys the random stream of each vertiport's requests
+    /// @param[in] antithetic Whether to mirror every draw of the requests
+    void setDemand(const DemandSettings& settings, uint64_t seed, bool antithetic = false);
+
+    /// @brief The totals for the trips requested at every vertiport
+    DemandStatistics demandStatistics() const;
+
+    /// @brief The random stream for an aircraft's stochastic behavior
+    /// @details Each aircraft draws from its own stream, keyed by the scene's seed and the aircraft's ID
+    RandomStream& randomStream(size_t aircraftIndex) { return m_aircraftStreams[aircraftIndex]; }
+
+    /// @brief The recorder that every change in an aircraft's state is traced to, or null to trace nothing
+    /// @details Flights are traced with the vertiport they are bound for. A partitioned scene records into
+    /// the buffer of the partition handling each change, so the recorder needs a buffer per vertiport
+    TraceRecorder* traceRecorder() const { return m_traceRecorder; }
+    void setTraceRecorder(TraceRecorder* recorder) { m_traceRecorder = recorder; }
+
     /// @}
 
     //-----------------------------------------------------------------------------------------------------------------
@@ -61,13 +154,138 @@ public:
         return m_companies.emplace_back(std::forward<Args>(args)...);
     }
 
-    /// @brief Set the number of chargers in the scene
+    /// @brief Add a vertiport to the scene, with the given number of chargers
+    Vertiport& addVertiport(const std::string& name, size_t chargerCount);
+
+    /// @brief Give the scene a single vertiport with the given number of chargers, replacing any others
     void setChargerCount(size_t count);
 
+    /// @brief Add aircraft to the scene, each built by a company chosen at random
+    /// @param[in] count The number of aircraft to add
+    /// @param[in] seed Keys the random streams used to choose companies, and those of the new aircraft
+    /// @param[in] antithetic Whether to mirror every random draw, for the antithetic twin of the scene with the same seed
+    /// @param[in] companyWeights The relative chance of each company building an aircraft, or empty for an even chance
+    /// @param[in] threadPool The pool to draw the aircraft on, or null to draw them on the calling thread
+    /// @details Each aircraft starts out bound for a vertiport chosen at random, so vertiports should be added first.
+    /// The company and vertiport of an aircraft are drawn by its ID, and every later random choice about it comes
+    /// from its own stream, so scenes with the same seed but
+    /// different configurations, e.g. charger counts, see common random numbers. Faults are drawn as the flight
+    /// time until the next fault, so each aircraft's faults line up with its hours flown in every configuration.
+    /// For the same reason, the aircraft are the same however many threads draw them
+    void addAircraft(size_t count, uint64_t seed, bool antithetic = false,
+        const std::vector<double>& companyWeights = {}, ThreadPool* threadPool = nullptr);
+
+    /// @brief Add aircraft with given companies and vertiports, e.g. from a fleet file
+    /// @param[in] companyIds The company that built each aircraft
+    /// @param[in] vertiportIds The vertiport that each aircraft is first bound for
+    /// @details Every later random choice about an aircraft comes from its own stream, as for drawn aircraft
+    void addAircraft(const uint32_t* companyIds, const uint32_t* vertiportIds, size_t count, uint64_t seed,
+        bool antithetic = false);
+
+    /// @brief The number of bytes allocated for the scene's entities, not counting queued events
+    size_t memoryFootprint() const;
+
+    /// @brief Prepare the scene to be run by the given simulator
+    /// @details Routes the simulator's events to the scene, and for fixed-step flight attaches the process that
+    /// flies the aircraft. All aircraft take off fully charged at the current simulation time
+    void initialize(Simulator& simulator);
+
+    /// @brief Prepare the scene to be run by the given partitioned simulator, with one partition per vertiport
+    /// @details Only analytic flight can be partitioned. Faults are counted when each aircraft lands rather than
+    /// as events of their own, since they may fall within the simulator's lookahead, which is set to the
+    /// shortest flight on a full battery. Statistics are kept per vertiport, and added up by finalize()
+    /// @note Partitioned scenes cannot be checkpointed
+    void initialize(PartitionedSimulator& simulator);
+
+    /// @brief Tally the time spent by aircraft that are still flying, waiting or charging when the simulation ends
+    void finalize(double time);
+
+    /// @brief Log the statistics for each company, and the traffic and charger utilization of each vertiport
+    void report() const;
+
+    /// @brief Add a row to a table for each company, with its totals and the spread of its flights, charges and waits
+    /// @details The table must have the columns given by SummaryColumns()
+    void exportSummary(TableWriter& writer) const;
+
+    /// @brief Fold the state of every entity into a run hash
+    void hashState(RunHash& hash) const;
+
+    /// @brief Write the state of every entity, and their random streams, for a checkpoint
+    void save(BinaryWriter& writer) const;
+
+    /// @brief Restore state written by save()
+    /// @details The scene must have been set up with the same companies and number of aircraft and chargers
+    void load(BinaryReader& reader);
+
+    /// @brief Handle a simulation event
+    template<SceneEventType Type>
+    void onEvent(const Event& event);
+
+    /// @brief Draw the flight time until an aircraft's next fault, in hours
+    double drawHoursToFault(uint32_t aircraftIndex);
+
+    /// @brief Called when an aircraft runs out of battery, to send it to a charger
+    /// @param[in] aircraftIndex The index of the aircraft in the scene
+    /// @param[in] time The simulation time at which the battery ran out, in seconds
+    void onBatteryDepleted(uint32_t aircraftIndex, double time);
+
 	/// @}
 
 protected:
 
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Methods
+    /// @{
+
+    /// @brief Send an aircraft flying to the given vertiport at the given time, with its current charge
+    void startFlight(uint32_t aircraftIndex, double time, uint32_t destination);
+
+    /// @brief Leave a charged aircraft at its vertiport until it is handed a trip
+    void becomeIdle(uint32_t aircraftIndex, double time);
+
+    /// @brief Connect an aircraft to a free charger at the given time, and schedule the end of its charge
+    void startCharging(uint32_t aircraftIndex, uint32_t chargerIndex, double time);
+
+    /// @brief Schedule an aircraft's next fault, if it comes before its battery runs out
+    /// @details During an analytic flight, the aircraft's time to fault is counted from takeoff
+    void scheduleFault(uint32_t aircraftIndex);
+
+    /// @brief Add flight time, and the distance covered during it, to the statistics of an aircraft's company
+    void tallyFlight(uint32_t aircraftIndex, double hours);
+
+    /// @brief The statistics that an aircraft's activity is added to
+    /// @details These are the statistics of the aircraft's company, kept by the vertiport the aircraft is
+    /// at or bound for when the scene is partitioned
+    CompanyStatistics& statistics(uint32_t aircraftIndex);
+
+    /// @brief The distributions that an aircraft's flights and charges are added to, kept like its statistics
+    CompanyDistributions& distributions(uint32_t aircraftIndex);
+
+    /// @brief Schedule an event handled at one vertiport, from a handler running at another
+    void schedule(const Event& event, uint32_t fromVertiport, uint32_t toVertiport);
+
+    /// @brief Choose a vertiport at random from the given stream
+    /// @details Draws nothing when there is only one vertiport, so that a scene's aircraft see the same random
+    /// numbers for any charger count at a single vertiport
+    uint32_t chooseVertiport(RandomStream& stream) const;
+
+    /// @brief Send every aircraft off fully charged from the vertiport it starts at, or leave it idle there if the
+    /// scene models demand
+    void launchAircraft(double time);
+
+    /// @brief Start generating trip requests at every vertiport, and schedule each vertiport's first dispatch
+    void startDemand(double time);
+
+    /// @brief Trace an aircraft's change to its current state, from the partition of the given vertiport
+    void trace(uint32_t aircraftIndex, uint32_t partitionVertiport, double time) {
+        if (m_traceRecorder) {
+            m_traceRecorder->record(m_partitionedSimulator ? partitionVertiport : 0, TraceRecord{ time, aircraftIndex,
+                m_fleet.vertiportId(aircraftIndex), uint8_t(m_fleet.state(aircraftIndex)) });
+        }
+    }
+
+    /// @}
+
     //-----------------------------------------------------------------------------------------------------------------
     /// @name Members
     /// @{
@@ -80,15 +298,69 @@ protected:
     std::vector<Company> m_companies;
 
     /// @brief The vehicles in the scene
-    std::vector<Aircraft> m_aircraft;
+    Fleet m_fleet;
+
+    /// @brief How aircraft are flown
+    FlightModel m_flightModel = FlightModel::kAnalytic;
+
+    /// @brief The vertiports in the scene, each with its chargers and the aircraft waiting for them
+    std::vector<Vertiport> m_vertiports;
+
+    /// @brief The order in which waiting aircraft are handed chargers at every vertiport
+    ChargerQueuePolicy m_chargerQueuePolicy = ChargerQueuePolicy::kFirstComeFirstServed;
+
+    /// @brief How passengers ask for trips at every vertiport, and the seed of their requests
+    DemandSettings m_demandSettings;
+    uint64_t m_demandSeed = 0;
+    bool m_demandAntithetic = false;
+
+    /// @brief The simulation times at which the scene was initialized and finalized, in seconds
+    double m_startTime = 0.0;
+    double m_endTime = 0.0;
+
+    /// @brief The simulator running the scene
+    Simulator* m_simulator = nullptr;
+
+    /// @brief The partitioned simulator running the scene, if it is partitioned by vertiport
+    PartitionedSimulator* m_partitionedSimulator = nullptr;
 
-    /// @brief The chargers in the scene
-    std::vector<Charger> m_chargers;
+    /// @brief The recorder tracing aircraft states, if any
+    TraceRecorder* m_traceRecorder = nullptr;
+
+    /// @brief What a partition adds up for each company, indexed by company
+    struct VertiportTotals {
+        std::vector<CompanyStatistics> m_statistics;
+        std::vector<CompanyDistributions> m_distributions;
+    };
+
+    /// @brief The totals of each vertiport while the scene is partitioned, each written only by the thread
+    /// running its partition
+    Shards<VertiportTotals> m_vertiportTotals;
+
+    /// @brief The process flying the aircraft
+    std::shared_ptr<FleetProcess> m_fleetProcess;
+
+    /// @brief The random stream of each aircraft
+    std::vector<RandomStream> m_aircraftStreams;
+
+    /// @brief The stream ID reserved for choices made by the scene itself, which no aircraft ID reaches
+    static constexpr uint64_t s_sceneStreamId = uint64_t(-1);
+
+    /// @brief The stream IDs of the vertiports' requests count down from the scene's
+    static constexpr uint64_t s_firstDemandStreamId = s_sceneStreamId - 1;
+
+    /// @brief The number of aircraft drawn by each task when adding aircraft in parallel
+    static constexpr size_t s_aircraftChunkSize = 1 << 16;
 
     /// @}
 
 };
 
+template<> void Scene::onEvent<SceneEventType::kChargeComplete>(const Event& event);
+template<> void Scene::onEvent<SceneEventType::kBatteryDepleted>(const Event& event);
+template<> void Scene::onEvent<SceneEventType::kFault>(const Event& event);
+template<> void Scene::onEvent<SceneEventType::kDispatch>(const Event& event);
+
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 } // end namespacing
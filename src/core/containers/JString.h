@@ -6,7 +6,9 @@
 #define J_STRING_H
 
 // std
+#include <charconv>
 #include <string>
+#include <string_view>
 
 
 namespace joby {
@@ -40,36 +42,34 @@ public:
         return strtoul(s, nullptr, 16);
     }
 
-    /// @brief Reentrant version of string tokenization
-    /// @param[in] savePtr A pointer used to avoid a static char* in the implementation of strtok, must be passed as a reference to modify the original ptr
-    static char* Strtok_r(char* str, const char* delim, char*& savePtr) {
-        char* tok = nullptr;
-        char* match = nullptr;
-
-        // If the delimiter is invalid, return nullptr
-        if (delim == nullptr) {
-            return nullptr;
-        }
-
-        // If the input string is null, strtok resumes from the most recent location (saveptr)
-        tok = (str) ? str : savePtr;
-        if (tok == nullptr) {
-            return nullptr;
-        }
-
-        // Find the first match of the delimiter token in the string
-        match = strstr(tok, delim);
+    /// @brief Split the next token off the front of some text, without copying or modifying it
+    /// @param[in,out] text The text to tokenize, which is left holding everything after the delimiter
+    /// @details Returns the whole of the text if there is no delimiter, leaving it empty. Tokens are views
+    /// into the text, so they are only valid for as long as the text itself
+    static std::string_view NextToken(std::string_view& text, char delimiter) {
+        size_t end = text.find(delimiter);
+        std::string_view token = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        return token;
+    }
 
-        // TODO: Create a strtok version that doesn't even modify the original str
-        if (match) {
-            savePtr = match + strlen(delim);
-            match[0] = '\0';
-        }
-        else {
-            savePtr = nullptr;
+    /// @brief The text without any leading or trailing whitespace
+    static std::string_view Trim(std::string_view text) {
+        const char* whitespace = " \t\r\n";
+        size_t begin = text.find_first_not_of(whitespace);
+        if (begin == std::string_view::npos) {
+            return std::string_view();
         }
+        return text.substr(begin, text.find_last_not_of(whitespace) - begin + 1);
+    }
 
-        return tok;
+    /// @brief Parse the whole of some text as a number, returning false if it isn't one
+    /// @details Uses std::from_chars, so it never allocates, and ignores the locale
+    template<typename T>
+    static bool ToNumber(std::string_view text, T& outValue) {
+        const char* end = text.data() + text.size();
+        std::from_chars_result result = std::from_chars(text.data(), end, outValue);
+        return result.ec == std::errc() && result.ptr == end;
     }
 
     /// @brief Format a std::string like a const char*        
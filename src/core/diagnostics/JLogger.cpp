@@ -4,14 +4,86 @@
 #include "JLogger.h"
 
 #include <memory>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <exception>
 #include <iostream>
 #include <fstream>
+#include <stdexcept>
+#include <core/containers/JString.h>
 #include <core/memory/JMemoryCommon.h>
 #include <core/diagnostics/JLogger.h>
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 namespace joby {
 
+/// @brief The most text the background writer gathers before writing it out
+static constexpr size_t s_batchBytes = 1 << 16;
+
+/// @brief How long the background writer sleeps when there is nothing to write. Logging never wakes it, so that
+/// it never takes a lock
+static constexpr std::chrono::milliseconds s_idleWait(1);
+
+/// @brief How many times the crash handler yields to let the background writer finish its batch
+static constexpr size_t s_crashWaitCount = 1000;
+
+/// @brief How many times a fatal signal handler checks whether the background writer has finished its batch.
+/// Yielding isn't safe in a signal handler, so it spins instead
+static constexpr size_t s_signalWaitCount = size_t(1) << 24;
+
+/// @brief Whether the current thread is the background writer, which may read in a signal handler
+static thread_local bool s_isWriterThread = false;
+
+/// @brief The name of each LogLevel, as plain strings that a signal handler may read
+static const char* const s_levelNameText[(size_t)LogLevel::COUNT] = { "Debug", "Info", "Warning", "Error", "Critical" };
+
+/// @brief Write bytes straight to standard output, bypassing every buffer, which is safe in a signal handler
+static void WriteRaw(const char* text, size_t length)
+{
+    while (length) {
+#ifdef _WIN32
+        int written = _write(1, text, unsigned(length));
+#else
+        ssize_t written = ::write(STDOUT_FILENO, text, length);
+#endif
+        if (written <= 0) {
+            return;
+        }
+        text += written;
+        length -= size_t(written);
+    }
+}
+
+/// @brief The terminate handler in place before the crash handler was installed
+static std::terminate_handler s_previousTerminate = nullptr;
+
+/// @brief The longest line a message record is formatted into, including the null terminator
+static constexpr size_t s_maxLineLength = 1024;
+
+/// @brief Format a value onto the end of a line, cutting it short if the line is full
+template<typename T>
+static void AppendValue(const char* spec, T value, char* outText, size_t capacity, size_t& inOutLength)
+{
+    int written = std::snprintf(outText + inOutLength, capacity - inOutLength, spec, value);
+    if (written > 0) {
+        inOutLength = std::min(inOutLength + size_t(written), capacity - 1);
+    }
+}
+
+LogFormat::LogFormat(const char * format):
+    m_id(Logger::Get().registerFormat(format))
+{
+}
+
 Logger & Logger::Get()
 {
     return *s_instance;
@@ -47,11 +119,199 @@ void Logger::LogCritical(const char * msg)
     Get().logMessage(msg, LogLevel::kCritical);
 }
 
+void Logger::InstallCrashHandler()
+{
+    s_previousTerminate = std::set_terminate(&Logger::OnTerminate);
+    for (int signal : { SIGSEGV, SIGABRT, SIGFPE, SIGILL }) {
+        std::signal(signal, &Logger::OnFatalSignal);
+    }
+}
+
 void Logger::logMessage(const char * message, LogLevel level)
 {
-    // Want to be able to be thread-safe
+    if (!m_queue) {
+        // Want to be able to be thread-safe
+        std::unique_lock lock(m_loggerMutex);
+        std::cout << s_levelNames[(size_t)level] << ":: " << message << std::endl;
+        return;
+    }
+
+    // Copy the message straight into its record, marking it if it had to be cut short
+    size_t length = std::strlen(message);
+    pushRecord([message, length, level](LogRecord& record) {
+        record.m_kind = LogRecord::Kind::kMessage;
+        record.m_level = level;
+        record.m_length = uint32_t(std::min(length, sizeof(record.m_text)));
+        std::memcpy(record.m_text, message, record.m_length);
+        if (length > sizeof(record.m_text)) {
+            std::memcpy(record.m_text + sizeof(record.m_text) - 3, "...", 3);
+        }
+    });
+}
+
+uint32_t Logger::registerFormat(const char * format)
+{
+    std::unique_lock lock(m_loggerMutex);
+    if (m_formatCount == s_maxFormatCount) {
+        throw std::length_error("Error, too many log formats registered");
+    }
+    m_formats[m_formatCount] = format;
+    return m_formatCount++;
+}
+
+size_t Logger::formatRecord(const LogRecord & record, char * outText, size_t capacity) const
+{
+    if (record.m_kind != LogRecord::Kind::kBinary) {
+        size_t length = std::min(size_t(record.m_length), capacity - 1);
+        std::memcpy(outText, record.m_text, length);
+        outText[length] = '\0';
+        return length;
+    }
+
+    // Copy the format, replacing each conversion with the next argument. The length modifiers of the format are
+    // replaced by the type recorded for the argument, and the conversion adapted to it if they disagree
+    static constexpr const char* s_integerConversions = "diouxX";
+    static constexpr const char* s_floatConversions = "fFeEgGaA";
+    const char* argument = record.m_text;
+    const char* argumentsEnd = record.m_text + record.m_length;
+    char spec[32];
+    char text[sizeof(LogRecord::m_text) + 1];
+    size_t length = 0;
+    for (const char* c = m_formats[record.m_format]; *c && length + 1 < capacity; c++) {
+        if (*c != '%' || c[1] == '%') {
+            outText[length++] = *c;
+            c += *c == '%' ? 1 : 0;
+            continue;
+        }
+
+        size_t specLength = 0;
+        spec[specLength++] = *c++;
+        while (*c && std::strchr("-+ #0123456789.", *c) && specLength + 4 < sizeof(spec)) {
+            spec[specLength++] = *c++;
+        }
+        while (*c && std::strchr("hlLjzt", *c)) {
+            c++;
+        }
+        if (!*c) {
+            break;
+        }
+        if (argument >= argumentsEnd) {
+            continue;
+        }
+
+        char conversion = *c;
+        bool isInteger = std::strchr(s_integerConversions, conversion) != nullptr;
+        bool isFloat = std::strchr(s_floatConversions, conversion) != nullptr;
+        LogArgumentType type = LogArgumentType(*argument++);
+        if (type == LogArgumentType::kTruncated) {
+            // The arguments stopped fitting here, so write a marker in place of this one and leave out the rest
+            argument = argumentsEnd;
+            AppendValue("%s", "...", outText, capacity, length);
+        }
+        else if (type == LogArgumentType::kString) {
+            uint16_t textLength;
+            std::memcpy(&textLength, argument, sizeof(textLength));
+            std::memcpy(text, argument + sizeof(textLength), textLength);
+            text[textLength] = '\0';
+            argument += sizeof(textLength) + textLength;
+            std::memcpy(spec + specLength, "s", 2);
+            AppendValue(spec, text, outText, capacity, length);
+        }
+        else if (type == LogArgumentType::kDouble) {
+            double value;
+            std::memcpy(&value, argument, sizeof(value));
+            argument += sizeof(value);
+            if (isInteger) {
+                std::memcpy(spec + specLength, "ll", 2);
+                spec[specLength + 2] = conversion;
+                spec[specLength + 3] = '\0';
+                AppendValue(spec, (long long)value, outText, capacity, length);
+            }
+            else {
+                spec[specLength] = isFloat ? conversion : 'g';
+                spec[specLength + 1] = '\0';
+                AppendValue(spec, value, outText, capacity, length);
+            }
+        }
+        else {
+            uint64_t value;
+            std::memcpy(&value, argument, sizeof(value));
+            argument += sizeof(value);
+            bool isSigned = type == LogArgumentType::kSigned;
+            if (isFloat) {
+                spec[specLength] = conversion;
+                spec[specLength + 1] = '\0';
+                AppendValue(spec, isSigned ? double(int64_t(value)) : double(value), outText, capacity, length);
+            }
+            else if (conversion == 'c') {
+                std::memcpy(spec + specLength, "c", 2);
+                AppendValue(spec, int(value), outText, capacity, length);
+            }
+            else {
+                std::memcpy(spec + specLength, "ll", 2);
+                spec[specLength + 2] = isInteger ? conversion : (isSigned ? 'd' : 'u');
+                spec[specLength + 3] = '\0';
+                AppendValue(spec, (unsigned long long)value, outText, capacity, length);
+            }
+        }
+    }
+    outText[length] = '\0';
+    return length;
+}
+
+void Logger::startAsync(size_t capacity, LogOverflowPolicy policy)
+{
+    if (m_queue) {
+        throw std::logic_error("Error, logger is already asynchronous");
+    }
+    m_queue = std::make_unique<MpscQueue<LogRecord>>(capacity);
+    m_overflowPolicy = policy;
+    m_droppedCount.store(0, std::memory_order_relaxed);
+    m_reportedDropCount = 0;
+    m_stopping = false;
+    m_writer = std::thread(&Logger::writeLoop, this);
+}
+
+void Logger::stopAsync()
+{
+    if (!m_queue) {
+        return;
+    }
+    flush();
+    {
+        std::unique_lock lock(m_loggerMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_writer.join();
+    m_queue.reset();
+}
+
+void Logger::flush()
+{
+    if (!m_queue) {
+        std::unique_lock lock(m_loggerMutex);
+        std::cout.flush();
+        return;
+    }
+
+    // Everything this thread logged was queued before the marker, so is written by the time the writer reaches it
+    uint64_t sequence;
+    {
+        std::unique_lock lock(m_loggerMutex);
+        sequence = ++m_flushRequested;
+    }
+    auto write = [sequence](LogRecord& record) {
+        record.m_kind = LogRecord::Kind::kFlush;
+        record.m_sequence = sequence;
+        record.m_length = 0;
+    };
+    while (!m_queue->tryPushWith(write)) {
+        std::this_thread::yield();
+    }
+    m_wake.notify_one();
     std::unique_lock lock(m_loggerMutex);
-    std::cout << s_levelNames[(size_t)level] << ":: " << message << std::endl;
+    m_flushed.wait(lock, [this, sequence]() { return m_flushCompleted >= sequence || m_crashing.load(); });
 }
 
 Logger::Logger()
@@ -59,11 +319,175 @@ Logger::Logger()
 }
 Logger::~Logger()
 {
+    stopAsync();
+}
+
+void Logger::writeRecord(const LogRecord & record)
+{
+    char line[s_maxLineLength];
+    formatRecord(record, line, s_maxLineLength);
+    std::unique_lock lock(m_loggerMutex);
+    std::cout << s_levelNames[(size_t)record.m_level] << ":: " << line << std::endl;
+}
+
+void Logger::writeLoop()
+{
+    s_isWriterThread = true;
+    std::string text;
+    LogRecord record;
+    while (true) {
+        // The crash handler pops whatever is left once the writer has let go of the queue
+        m_consuming.store(true);
+        if (m_crashing.load()) {
+            m_consuming.store(false);
+            return;
+        }
+
+        bool popped = false;
+        uint64_t flushed = 0;
+        while (text.size() < s_batchBytes && m_queue->tryPop(record)) {
+            popped = true;
+            if (record.m_kind == LogRecord::Kind::kFlush) {
+                flushed = std::max(flushed, record.m_sequence);
+            }
+            else {
+                appendRecord(record, text);
+            }
+        }
+
+        // Report messages discarded under the counting policy once the writer has caught up
+        size_t droppedCount = m_droppedCount.load(std::memory_order_relaxed);
+        if (!popped && m_overflowPolicy == LogOverflowPolicy::kCount && droppedCount != m_reportedDropCount) {
+            text += JString::Format("%s:: Logger queue was full, dropped %zu messages\n",
+                s_levelNames[(size_t)LogLevel::kWarning].c_str(), droppedCount - m_reportedDropCount);
+            m_reportedDropCount = droppedCount;
+        }
+        if (!text.empty()) {
+            std::cout.write(text.data(), text.size());
+            std::cout.flush();
+            text.clear();
+        }
+        m_consuming.store(false);
+
+        std::unique_lock lock(m_loggerMutex);
+        if (flushed) {
+            m_flushCompleted = std::max(m_flushCompleted, flushed);
+            m_flushed.notify_all();
+        }
+        if (!popped) {
+            if (m_stopping) {
+                return;
+            }
+            m_wake.wait_for(lock, s_idleWait);
+        }
+    }
+}
+
+void Logger::appendRecord(const LogRecord & record, std::string & outText) const
+{
+    const std::string& levelName = s_levelNames[(size_t)record.m_level];
+    outText.append(levelName);
+    outText.append(":: ", 3);
+    if (record.m_kind == LogRecord::Kind::kBinary) {
+        char line[s_maxLineLength];
+        outText.append(line, formatRecord(record, line, s_maxLineLength));
+    }
+    else {
+        outText.append(record.m_text, record.m_length);
+    }
+    outText.push_back('\n');
+}
+
+void Logger::EncodeString(std::string_view value, char *& inOutCursor, const char * end)
+{
+    // Leave room for the type, the length and a truncation marker
+    size_t available = size_t(end - inOutCursor);
+    if (available < 2 + sizeof(uint16_t)) {
+        MarkTruncated(inOutCursor, end);
+        return;
+    }
+    uint16_t length = uint16_t(std::min(value.size(), available - 2 - sizeof(uint16_t)));
+    *inOutCursor++ = char(LogArgumentType::kString);
+    std::memcpy(inOutCursor, &length, sizeof(length));
+    std::memcpy(inOutCursor + sizeof(length), value.data(), length);
+    inOutCursor += sizeof(length) + length;
+    if (length < value.size()) {
+        MarkTruncated(inOutCursor, end);
+    }
+}
+
+void Logger::flushOnCrash(bool isSignal)
+{
+    if (m_crashFlushed.exchange(true)) {
+        return;
+    }
+    if (m_queue) {
+        // Only one thread may pop at a time, so give the writer a moment to let go of the queue, unless the
+        // writer is the thread that crashed
+        m_crashing.store(true);
+        if (isSignal) {
+            for (size_t i = 0; i < s_signalWaitCount && !s_isWriterThread && m_consuming.load(); i++) {
+            }
+        }
+        else {
+            for (size_t i = 0; i < s_crashWaitCount && !s_isWriterThread && m_consuming.load(); i++) {
+                std::this_thread::yield();
+            }
+        }
+
+        if (s_isWriterThread || !m_consuming.load()) {
+            LogRecord record;
+            char line[s_maxLineLength];
+            while (m_queue->tryPop(record)) {
+                if (record.m_kind == LogRecord::Kind::kFlush) {
+                    continue;
+                }
+                const char* levelName = s_levelNameText[(size_t)record.m_level];
+                if (isSignal) {
+                    // Only raw bytes may be written from a signal handler, so messages logged with a registered
+                    // format are written as the format itself, without their arguments
+                    const char* text = record.m_kind == LogRecord::Kind::kBinary ? m_formats[record.m_format] : record.m_text;
+                    size_t length = record.m_kind == LogRecord::Kind::kBinary ? std::strlen(text) : record.m_length;
+                    WriteRaw(levelName, std::strlen(levelName));
+                    WriteRaw(":: ", 3);
+                    WriteRaw(text, length);
+                    WriteRaw("\n", 1);
+                }
+                else {
+                    // Write without allocating, straight to the C stream that std::cout is synchronized with
+                    std::fputs(levelName, stdout);
+                    std::fwrite(":: ", 1, 3, stdout);
+                    std::fwrite(line, 1, formatRecord(record, line, s_maxLineLength), stdout);
+                    std::fputc('\n', stdout);
+                }
+            }
+        }
+    }
+    if (!isSignal) {
+        std::fflush(stdout);
+    }
+}
+
+void Logger::OnTerminate()
+{
+    Get().flushOnCrash(false);
+    if (s_previousTerminate) {
+        s_previousTerminate();
+    }
+    std::abort();
+}
+
+void Logger::OnFatalSignal(int signal)
+{
+    Get().flushOnCrash(true);
+    std::signal(signal, SIG_DFL);
+    std::raise(signal);
 }
 
 std::unique_ptr<Logger> Logger::s_instance = prot_make_unique<Logger>();
 
-std::array<std::string, (size_t)LogLevel::COUNT> Logger::s_levelNames{ "Debug", "Info", "Warning", "Error", "Critical" };
+std::array<std::string, (size_t)LogLevel::COUNT> Logger::s_levelNames{ s_levelNameText[0], s_levelNameText[1],
+    s_levelNameText[2], s_levelNameText[3], s_levelNameText[4] };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-} // end namespaces
\ No newline at end of file
+} // end namespaces
@@ -1,6 +1,6 @@
 #ifndef J_LOGGER_H
 #define J_LOGGER_H
-/** @file JLogger.h 
+/** @file JLogger.h
     Defines a basic message logging system.
 */
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -9,7 +9,17 @@
 // Standard
 #include <string>
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+#include <core/threading/JMpscQueue.h>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Namespace Definitions
@@ -35,11 +45,73 @@ enum class LogLevel : unsigned int {
     COUNT
 };
 
+/// @brief What an asynchronous logger does with a message when its queue is full
+enum class LogOverflowPolicy : uint8_t {
+    kDrop = 0, // Discard the message
+    kBlock, // Wait for the writer to make room
+    kCount, // Discard the message, and log how many were discarded once the writer catches up
+    COUNT
+};
+
+/// @brief The types of argument stored in a binary log record, each as a type byte followed by its value
+/// @details Strings are stored as a 16-bit length followed by their characters
+enum class LogArgumentType : uint8_t {
+    kSigned = 0, // An int64_t
+    kUnsigned, // A uint64_t
+    kDouble, // A double
+    kString, // Characters copied from the argument
+    kTruncated, // No value. Marks where arguments stopped fitting in the record, and ends them
+    COUNT
+};
+
+/// @brief A message queued for the background writer of an asynchronous logger
+/// @details Records are fixed-size so that they can live in a preallocated ring. Longer messages are truncated
+struct LogRecord {
+    /// @brief The kinds of record
+    enum class Kind : uint8_t {
+        kMessage = 0, // A message to write
+        kBinary, // A registered format, with its raw arguments in place of text
+        kFlush // A request to write everything queued before it, identified by its sequence number
+    };
+
+    Kind m_kind;
+    LogLevel m_level;
+    uint64_t m_sequence;
+    uint32_t m_length;
+    uint32_t m_format;
+    char m_text[500];
+};
+
+/// @class LogFormat
+/// @brief A printf-style format string registered once with the logger, so that messages using it can be logged
+/// as raw arguments and formatted later by the background writer
+/// @details Declare these as function-local statics at the call site, so that each format is registered the first
+/// time it is used, e.g. static const LogFormat s_format("%s: %zu arrivals"); Logger::LogInfo(s_format, name, count);
+/// Arguments may be integers, floating point numbers, or strings. Width, precision and flags are honored, and
+/// length modifiers are ignored, since each argument records its own type
+class LogFormat {
+public:
+    /// @param[in] format The format string, which must outlive the logger, as a string literal does
+    explicit LogFormat(const char* format);
+
+    /// @brief The index of the format with the logger
+    uint32_t id() const { return m_id; }
+
+private:
+    uint32_t m_id;
+};
+
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// @class Logger
 /// @brief A singleton Logger class to be used for standardized message logging
+/// @details By default, each message is written and flushed to std::cout before logging returns, under a lock
+/// shared by every thread. In asynchronous mode, messages are instead copied into a lock-free ring of records,
+/// and a background thread writes them out in batches, flushing once per batch. Logging then never takes a lock
+/// or touches the stream, unless the ring is full under the blocking overflow policy.
+/// Messages with a registered LogFormat skip formatting in the caller altogether. Only their arguments are copied
+/// into the record, and the background writer formats them
 class Logger {
 public:
     //-----------------------------------------------------------------------------------------------------------------
@@ -58,6 +130,41 @@ public:
     static void LogError(const char* msg);
     static void LogCritical(const char* msg);
 
+    /// @brief Convenience methods for logging a registered format, without formatting the message in the caller
+    template<typename ...Args>
+    static void LogDebug(const LogFormat& format, const Args&... args) {
+#ifdef DEBUG_MODE
+        Get().logFormat(LogLevel::kDebug, format, args...);
+#else
+        // Avoid unused arguments
+        (void)format;
+        ((void)args, ...);
+#endif
+    }
+    template<typename ...Args>
+    static void LogInfo(const LogFormat& format, const Args&... args) {
+        Get().logFormat(LogLevel::kInfo, format, args...);
+    }
+    template<typename ...Args>
+    static void LogWarning(const LogFormat& format, const Args&... args) {
+        Get().logFormat(LogLevel::kWarning, format, args...);
+    }
+    template<typename ...Args>
+    static void LogError(const LogFormat& format, const Args&... args) {
+        Get().logFormat(LogLevel::kError, format, args...);
+    }
+    template<typename ...Args>
+    static void LogCritical(const LogFormat& format, const Args&... args) {
+        Get().logFormat(LogLevel::kCritical, format, args...);
+    }
+
+    /// @brief Write out every queued message if the program crashes, on a fatal signal or std::terminate
+    /// @details Best effort. The background writer is given a moment to finish its batch, then whatever is left is
+    /// written from the crashing thread. On std::terminate, messages are formatted as usual. On a fatal signal,
+    /// only raw bytes are written straight to standard output, so messages with a registered format are written
+    /// as the format, without their arguments
+    static void InstallCrashHandler();
+
     /// @}
 
     //-----------------------------------------------------------------------------------------------------------------
@@ -71,6 +178,16 @@ public:
     //-----------------------------------------------------------------------------------------------------------------
     /// @name Properties
     /// @{
+
+    /// @brief Whether messages are written by a background thread
+    bool isAsync() const { return m_queue != nullptr; }
+
+    /// @brief What asynchronous logging does with a message when the queue is full
+    LogOverflowPolicy overflowPolicy() const { return m_overflowPolicy; }
+
+    /// @brief The number of messages discarded because the queue was full
+    size_t droppedCount() const { return m_droppedCount.load(std::memory_order_relaxed); }
+
     /// @}
 
     //-----------------------------------------------------------------------------------------------------------------
@@ -81,6 +198,42 @@ public:
     /// @param[in] level The level for the message.  The higher the value, the more severe the issue.
     void logMessage(const char* message, LogLevel level);
 
+    /// @brief Output a log message with a registered format
+    /// @details Only the arguments are copied, straight into the queue, and the background writer formats them.
+    /// Without a background writer, the message is formatted and written at once
+    template<typename ...Args>
+    void logFormat(LogLevel level, const LogFormat& format, const Args&... args) {
+        pushRecord([level, &format, &args...](LogRecord& record) {
+            record.m_kind = LogRecord::Kind::kBinary;
+            record.m_level = level;
+            record.m_format = format.id();
+            char* cursor = record.m_text;
+            (EncodeArgument(args, cursor, record.m_text + sizeof(record.m_text)), ...);
+            record.m_length = uint32_t(cursor - record.m_text);
+        });
+    }
+
+    /// @brief Register a format string, returning its index
+    /// @note Prefer constructing a LogFormat
+    uint32_t registerFormat(const char* format);
+
+    /// @brief Write the text of a message record into the given buffer, formatting its arguments if it has any
+    /// @details Doesn't allocate, so that it is safe to use while crashing. Text that doesn't fit is cut short
+    /// @return The length of the text, which is always null-terminated
+    size_t formatRecord(const LogRecord& record, char* outText, size_t capacity) const;
+
+    /// @brief Write messages from a background thread from now on
+    /// @param[in] capacity The number of messages that can be queued, rounded up to a power of two
+    /// @note Modes must not be switched while other threads may be logging
+    void startAsync(size_t capacity = s_defaultCapacity, LogOverflowPolicy policy = LogOverflowPolicy::kBlock);
+
+    /// @brief Write out every queued message, stop the background thread, and go back to writing each message
+    /// as it is logged
+    void stopAsync();
+
+    /// @brief Wait until every message logged so far has been written and flushed
+    void flush();
+
 	/// @}
 protected:
 
@@ -92,12 +245,136 @@ protected:
 
     /// @}
 
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Methods
+    /// @{
+
+    /// @brief Queue a record written in place by the given function, or write it at once without a background
+    /// writer, following the overflow policy if the queue is full
+    template<typename Function>
+    void pushRecord(const Function& write) {
+        if (!m_queue) {
+            LogRecord record;
+            write(record);
+            writeRecord(record);
+            return;
+        }
+        if (m_queue->tryPushWith(write)) {
+            return;
+        }
+        if (m_overflowPolicy == LogOverflowPolicy::kBlock) {
+            while (!m_queue->tryPushWith(write)) {
+                std::this_thread::yield();
+            }
+            return;
+        }
+        m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// @brief Write a message record to the stream at once
+    void writeRecord(const LogRecord& record);
+
+    /// @brief The loop run by the background writer
+    void writeLoop();
+
+    /// @brief Append a message record to the text of a batch
+    void appendRecord(const LogRecord& record, std::string& outText) const;
+
+    /// @brief Append an argument to the arguments of a binary record
+    /// @details Every argument leaves room for a truncation marker after it. An argument that doesn't fit is
+    /// replaced by the marker, and every argument after it is left out, so the writer never mistakes one
+    /// argument for another
+    template<typename T>
+    static void EncodeArgument(const T& value, char*& inOutCursor, const char* end) {
+        if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            EncodeValue(LogArgumentType::kSigned, int64_t(value), inOutCursor, end);
+        }
+        else if constexpr (std::is_integral_v<T>) {
+            EncodeValue(LogArgumentType::kUnsigned, uint64_t(value), inOutCursor, end);
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+            EncodeValue(LogArgumentType::kDouble, double(value), inOutCursor, end);
+        }
+        else if constexpr (std::is_pointer_v<std::decay_t<T>>) {
+            // Null strings are written as printf writes them on most platforms
+            const char* text = value;
+            EncodeString(text ? std::string_view(text) : std::string_view("(null)"), inOutCursor, end);
+        }
+        else {
+            EncodeString(std::string_view(value), inOutCursor, end);
+        }
+    }
+
+    template<typename T>
+    static void EncodeValue(LogArgumentType type, T value, char*& inOutCursor, const char* end) {
+        if (size_t(end - inOutCursor) < 2 + sizeof(T)) {
+            MarkTruncated(inOutCursor, end);
+            return;
+        }
+        *inOutCursor++ = char(type);
+        std::memcpy(inOutCursor, &value, sizeof(T));
+        inOutCursor += sizeof(T);
+    }
+
+    /// @brief Append a string argument, cutting it short and marking the arguments truncated if there isn't room
+    /// for all of it
+    static void EncodeString(std::string_view value, char*& inOutCursor, const char* end);
+
+    /// @brief Mark the arguments of a binary record as truncated, unless they already are, and leave no room for
+    /// any more
+    static void MarkTruncated(char*& inOutCursor, const char* end) {
+        if (inOutCursor < end) {
+            *inOutCursor = char(LogArgumentType::kTruncated);
+            inOutCursor = const_cast<char*>(end);
+        }
+    }
+
+    /// @brief Write out whatever is still queued from the crashing thread
+    /// @param[in] isSignal Whether this runs in a fatal signal handler. Formatting and stdio aren't safe there, so
+    /// the records are written as raw bytes instead
+    void flushOnCrash(bool isSignal);
+
+    /// @brief The handlers installed by InstallCrashHandler
+    static void OnTerminate();
+    static void OnFatalSignal(int signal);
+
+    /// @}
+
     //-----------------------------------------------------------------------------------------------------------------
     /// @name Members
     /// @{
 
     std::mutex m_loggerMutex;
 
+    /// @brief The queue of records for the background writer, which only exists in asynchronous mode
+    std::unique_ptr<MpscQueue<LogRecord>> m_queue;
+    LogOverflowPolicy m_overflowPolicy = LogOverflowPolicy::kBlock;
+
+    /// @brief The number of messages discarded, and the number of those the writer has reported
+    std::atomic<size_t> m_droppedCount{ 0 };
+    size_t m_reportedDropCount = 0;
+
+    /// @brief The sequence number of the last flush requested, and of the last one the writer reached
+    uint64_t m_flushRequested = 0;
+    uint64_t m_flushCompleted = 0;
+
+    /// @brief Whether the writer is popping records, which the crash handler must not do at the same time
+    std::atomic<bool> m_consuming{ false };
+    std::atomic<bool> m_crashing{ false };
+    std::atomic<bool> m_crashFlushed{ false };
+
+    bool m_stopping = false;
+    std::condition_variable m_wake;
+    std::condition_variable m_flushed;
+    std::thread m_writer;
+
+    /// @brief The most formats that can be registered
+    static constexpr size_t s_maxFormatCount = 1024;
+
+    /// @brief The registered format strings. These never move, so the writer may read them without a lock
+    std::array<const char*, s_maxFormatCount> m_formats{};
+    uint32_t m_formatCount = 0;
+
     /// @}
 
     //-----------------------------------------------------------------------------------------------------------------
@@ -110,6 +387,9 @@ protected:
     /// @brief The header strings to be prepended to messages of each LogLevel
     static std::array<std::string, (size_t)LogLevel::COUNT> s_levelNames;
 
+    /// @brief The number of messages queued by default in asynchronous mode
+    static constexpr size_t s_defaultCapacity = 4096;
+
     /// @}
 
 
@@ -118,4 +398,4 @@ protected:
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 } // end namespacing
 
-#endif
\ No newline at end of file
+#endif
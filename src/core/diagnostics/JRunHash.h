@@ -0,0 +1,91 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef J_RUN_HASH_H
+#define J_RUN_HASH_H
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace joby {
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Class definitions
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @class RunHash
+/// @brief A running FNV-1a hash of everything that happened in a simulation run
+/// @details Two runs with the same hash took bit-identical paths, so printing the hash at the end of
+/// a run is a cheap way to check that a change did not alter results, or that a run is reproducible
+class RunHash {
+public:
+    //--------------------------------------------------------------------------------------------
+    /// @name Constructors/Destructor
+    /// @{
+
+    RunHash() {}
+    ~RunHash() {}
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    uint64_t value() const { return m_value; }
+
+    /// @brief Resume hashing from a value, e.g. one restored from a checkpoint
+    void setValue(uint64_t value) { m_value = value; }
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Public methods
+    /// @{
+
+    /// @brief Fold raw bytes into the hash
+    void add(const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            m_value = (m_value ^ bytes[i]) * s_prime;
+        }
+    }
+
+    /// @brief Fold the bytes of a value into the hash
+    /// @note The type should have no padding, since padding bytes are indeterminate
+    template<typename T>
+    void add(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Error, can only hash trivially copyable values");
+        add(&value, sizeof(T));
+    }
+
+    void reset() { m_value = s_offsetBasis; }
+
+    /// @}
+
+private:
+    //--------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    static constexpr uint64_t s_offsetBasis = 0xCBF29CE484222325ull;
+    static constexpr uint64_t s_prime = 0x100000001B3ull;
+
+    uint64_t m_value = s_offsetBasis;
+
+    /// @}
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+} // End namespaces
+
+#endif
@@ -0,0 +1,311 @@
+#include "JTrace.h"
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <core/serialization/JLz4.h>
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// TraceRecorder
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TraceRecorder::TraceRecorder(const std::string & path, const TraceSchema & schema, size_t bufferCount, bool compress,
+    size_t blockSize):
+    m_file(path, std::ios::binary | std::ios::trunc),
+    m_path(path),
+    m_compress(compress),
+    m_blockSize(blockSize)
+{
+    if (!m_file) {
+        throw std::runtime_error("Error, could not open trace file " + path);
+    }
+    if (!bufferCount || !blockSize) {
+        throw std::invalid_argument("Error, a trace recorder needs buffers to record into");
+    }
+
+    BinaryWriter header;
+    header.write(Trace::s_magic);
+    header.write(Trace::s_version);
+    header.writeString(schema.m_entityName);
+    header.writeString(schema.m_locationName);
+    header.write(uint64_t(schema.m_stateNames.size()));
+    for (const std::string& name : schema.m_stateNames) {
+        header.writeString(name);
+    }
+    m_file.write(header.buffer().data(), header.size());
+    m_writtenBytes = header.size();
+
+    m_buffers.assign(bufferCount);
+    for (size_t i = 0; i < bufferCount; i++) {
+        m_buffers[i].reserve(m_blockSize);
+    }
+    m_thread = std::thread(&TraceRecorder::writeLoop, this);
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    try {
+        flush();
+    }
+    catch (const std::exception&) {
+        // Errors can't leave a destructor, and flush() is there to see them
+    }
+    {
+        std::unique_lock lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+size_t TraceRecorder::writtenCount() const
+{
+    std::unique_lock lock(m_mutex);
+    return m_writtenCount;
+}
+
+size_t TraceRecorder::writtenBytes() const
+{
+    std::unique_lock lock(m_mutex);
+    return m_writtenBytes;
+}
+
+void TraceRecorder::flush()
+{
+    for (size_t i = 0; i < m_buffers.size(); i++) {
+        if (!m_buffers[i].empty()) {
+            submit(m_buffers[i]);
+        }
+    }
+
+    std::unique_lock lock(m_mutex);
+    m_written.wait(lock, [this]() { return m_pending.empty() && !m_writing; });
+    m_file.flush();
+    if (m_exception) {
+        std::exception_ptr exception = m_exception;
+        m_exception = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
+
+void TraceRecorder::submit(std::vector<TraceRecord>& records)
+{
+    std::vector<TraceRecord> empty;
+    {
+        std::unique_lock lock(m_mutex);
+        m_written.wait(lock, [this]() { return m_pending.size() < s_maxPendingBlocks; });
+        m_pending.push_back(std::move(records));
+        if (!m_free.empty()) {
+            empty = std::move(m_free.back());
+            m_free.pop_back();
+        }
+    }
+    m_wake.notify_one();
+
+    if (!empty.capacity()) {
+        empty.reserve(m_blockSize);
+    }
+    records = std::move(empty);
+}
+
+void TraceRecorder::writeLoop()
+{
+    std::unique_lock lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this]() { return m_shutdown || !m_pending.empty(); });
+        if (m_pending.empty()) {
+            return;
+        }
+        std::vector<TraceRecord> records = std::move(m_pending.front());
+        m_pending.pop_front();
+        m_writing = true;
+        lock.unlock();
+
+        // Write outside of the lock, so that threads can keep handing over blocks
+        std::exception_ptr exception;
+        try {
+            writeBlock(records);
+        }
+        catch (...) {
+            exception = std::current_exception();
+        }
+        size_t recordCount = records.size();
+        records.clear();
+
+        lock.lock();
+        m_free.push_back(std::move(records));
+        m_writing = false;
+        if (exception && !m_exception) {
+            m_exception = exception;
+        }
+        else if (!exception) {
+            m_writtenCount += recordCount;
+            m_writtenBytes += m_block.size();
+        }
+        m_written.notify_all();
+    }
+}
+
+void TraceRecorder::writeBlock(const std::vector<TraceRecord>& records)
+{
+    const size_t count = records.size();
+    m_block.clear();
+    m_block.write(uint64_t(count));
+
+    m_times.resize(count);
+    m_entities.resize(count);
+    m_locations.resize(count);
+    m_states.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        m_times[i] = records[i].m_time;
+        m_entities[i] = records[i].m_entity;
+        m_locations[i] = records[i].m_location;
+        m_states[i] = records[i].m_state;
+    }
+    writeColumn(m_times.data(), count * sizeof(double));
+    writeColumn(m_entities.data(), count * sizeof(uint32_t));
+    writeColumn(m_locations.data(), count * sizeof(uint32_t));
+    writeColumn(m_states.data(), count * sizeof(uint8_t));
+
+    m_file.write(m_block.buffer().data(), m_block.size());
+    if (!m_file) {
+        throw std::runtime_error("Error, failed to write trace file " + m_path);
+    }
+}
+
+void TraceRecorder::writeColumn(const void * data, size_t size)
+{
+    // A column the size of its raw data is stored raw, so the reader can tell the two apart
+    m_column.clear();
+    if (m_compress) {
+        Lz4::Compress(static_cast<const char*>(data), size, m_column);
+    }
+    if (m_compress && m_column.size() < size) {
+        m_block.write(uint64_t(m_column.size()));
+        m_block.write(m_column.data(), m_column.size());
+    }
+    else {
+        m_block.write(uint64_t(size));
+        m_block.write(data, size);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// TraceReader
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t TraceReader::ToCsv(const std::string & tracePath, const std::string & csvPath)
+{
+    TraceReader reader(tracePath);
+    std::ofstream file(csvPath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Error, could not open " + csvPath);
+    }
+    const TraceSchema& schema = reader.schema();
+    file << "time," << schema.m_entityName << "," << schema.m_locationName << ",state\n";
+
+    // Rows are formatted into a buffer with to_chars, which is exact and far faster than streams
+    std::vector<std::string> stateNames;
+    size_t longestStateName = 0;
+    for (size_t state = 0; state < 256; state++) {
+        stateNames.push_back(reader.stateName(uint8_t(state)));
+        longestStateName = std::max(longestStateName, stateNames.back().size());
+    }
+
+    // The shortest round-trip form of a double takes at most 24 characters, and a 32-bit integer 10
+    const size_t maxRowSize = 24 + 2 * 10 + longestStateName + 4;
+    std::vector<TraceRecord> records;
+    std::vector<char> text;
+    size_t rowCount = 0;
+    while (reader.readBlock(records)) {
+        text.resize(records.size() * maxRowSize);
+        char* out = text.data();
+        char* end = text.data() + text.size();
+        for (const TraceRecord& record : records) {
+            out = std::to_chars(out, end, record.m_time).ptr;
+            *out++ = ',';
+            out = std::to_chars(out, end, record.m_entity).ptr;
+            *out++ = ',';
+            out = std::to_chars(out, end, record.m_location).ptr;
+            *out++ = ',';
+            const std::string& state = stateNames[record.m_state];
+            out = std::copy(state.begin(), state.end(), out);
+            *out++ = '\n';
+        }
+        file.write(text.data(), out - text.data());
+        rowCount += records.size();
+    }
+    if (!file) {
+        throw std::runtime_error("Error, failed to write " + csvPath);
+    }
+    return rowCount;
+}
+
+TraceReader::TraceReader(const std::string & path):
+    m_file(path),
+    m_reader(m_file.data(), m_file.size())
+{
+    if (m_reader.remaining() < 2 * sizeof(uint32_t) || m_reader.read<uint32_t>() != Trace::s_magic) {
+        throw std::runtime_error("Error, " + path + " is not a trace file");
+    }
+    if (m_reader.read<uint32_t>() != Trace::s_version) {
+        throw std::runtime_error("Error, trace " + path + " is from an unsupported version");
+    }
+    m_schema.m_entityName = m_reader.readString();
+    m_schema.m_locationName = m_reader.readString();
+    uint64_t stateCount = m_reader.read<uint64_t>();
+    for (uint64_t i = 0; i < stateCount; i++) {
+        m_schema.m_stateNames.push_back(m_reader.readString());
+    }
+}
+
+TraceReader::~TraceReader()
+{
+}
+
+std::string TraceReader::stateName(uint8_t state) const
+{
+    return state < m_schema.m_stateNames.size() ? m_schema.m_stateNames[state] : std::to_string(state);
+}
+
+bool TraceReader::readBlock(std::vector<TraceRecord>& outRecords)
+{
+    if (m_reader.atEnd()) {
+        outRecords.clear();
+        return false;
+    }
+    size_t count = size_t(m_reader.read<uint64_t>());
+    if (count > m_reader.remaining()) {
+        throw std::runtime_error("Error, corrupt trace block");
+    }
+    std::vector<double> times(count);
+    std::vector<uint32_t> entities(count);
+    std::vector<uint32_t> locations(count);
+    std::vector<uint8_t> states(count);
+    readColumn(m_reader, times.data(), count * sizeof(double));
+    readColumn(m_reader, entities.data(), count * sizeof(uint32_t));
+    readColumn(m_reader, locations.data(), count * sizeof(uint32_t));
+    readColumn(m_reader, states.data(), count * sizeof(uint8_t));
+
+    outRecords.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        outRecords[i] = TraceRecord{ times[i], entities[i], locations[i], states[i] };
+    }
+    return true;
+}
+
+void TraceReader::readColumn(BinaryReader & reader, void * out, size_t size)
+{
+    size_t encodedSize = size_t(reader.read<uint64_t>());
+    if (encodedSize == size) {
+        reader.read(out, size);
+        return;
+    }
+    m_column.resize(encodedSize);
+    reader.read(m_column.data(), encodedSize);
+    Lz4::Decompress(m_column.data(), encodedSize, static_cast<char*>(out), size);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
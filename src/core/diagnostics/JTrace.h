@@ -0,0 +1,272 @@
+#ifndef J_TRACE_H
+#define J_TRACE_H
+/** @file JTrace.h
+    Defines a recorder that writes the state changes of entities to a columnar binary trace file in the
+    background, and a reader that converts trace files to CSV
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <core/serialization/JBinaryStream.h>
+#include <core/serialization/JMappedFile.h>
+#include <core/threading/JShards.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief An entity entering a state, at a location
+struct TraceRecord {
+    double m_time;
+    uint32_t m_entity;
+    uint32_t m_location;
+    uint8_t m_state;
+};
+
+/// @brief What the entities, locations and states of a trace are, written to the head of the file
+struct TraceSchema {
+    std::string m_entityName = "entity";
+    std::string m_locationName = "location";
+    std::vector<std::string> m_stateNames;
+};
+
+/// @class Trace
+/// @brief The layout of trace files
+/// @details A trace file is a header, holding a magic number, the format version and the schema, followed by
+/// blocks of records. Each block holds its record count and then one column per field of a record: times,
+/// entities, locations and states. Each column is prefixed by its size in bytes, and is LZ4-compressed if that
+/// made it smaller. Records within a block are in the order they were recorded, but blocks recorded on different
+/// threads interleave, so a trace is only in time order overall if it was recorded by a single thread
+class Trace {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Members
+    /// @{
+
+    /// @brief Identifies trace files, reading "JTRC" in a hex dump
+    static constexpr uint32_t s_magic = 0x4352544A;
+
+    /// @brief The format version, bumped whenever the layout changes
+    static constexpr uint32_t s_version = 1;
+
+    /// @}
+};
+
+/// @class TraceRecorder
+/// @brief Records state changes into per-thread buffers, and writes them out in blocks on a background thread
+/// @details Each thread records into its own buffer, e.g. the buffer of the partition it is running, so recording
+/// is a lock-free append of a fixed-width record. Full buffers are swapped for empty ones under a lock, which
+/// happens once per block, and the background thread transposes each block into columns, compresses them and
+/// writes them out. Buffers are recycled, so a steady recording doesn't allocate. Recording only waits if the
+/// writer falls several blocks behind
+class TraceRecorder {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    /// @param[in] path The trace file to write, which is replaced
+    /// @param[in] bufferCount The number of threads, or partitions, that may record at once
+    /// @param[in] compress Whether to LZ4-compress each column
+    /// @param[in] blockSize The number of records in each block
+    TraceRecorder(const std::string& path, const TraceSchema& schema, size_t bufferCount = 1, bool compress = true,
+        size_t blockSize = s_defaultBlockSize);
+
+    /// @brief Writes out any recorded state changes
+    ~TraceRecorder();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    size_t bufferCount() const { return m_buffers.size(); }
+
+    /// @brief The number of records written to the file so far
+    size_t writtenCount() const;
+
+    /// @brief The number of bytes written to the file so far
+    size_t writtenBytes() const;
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Record a state change, from the only thread using the given buffer
+    void record(size_t buffer, const TraceRecord& record) {
+        std::vector<TraceRecord>& records = m_buffers[buffer];
+        records.push_back(record);
+        if (records.size() == m_blockSize) {
+            submit(records);
+        }
+    }
+
+    /// @brief Write out every record so far, and wait for them to reach the file
+    /// @details Must not be called while other threads are recording. Rethrows any error from writing
+    void flush();
+
+	/// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Members
+    /// @{
+
+    static constexpr size_t s_defaultBlockSize = 1 << 16;
+
+    /// @brief The number of blocks that may wait to be written before recording waits for the writer
+    static constexpr size_t s_maxPendingBlocks = 8;
+
+    /// @}
+
+protected:
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Methods
+    /// @{
+
+    /// @brief Hand a buffer's records to the writer, and give the buffer an empty one
+    void submit(std::vector<TraceRecord>& records);
+
+    /// @brief The loop run by the background thread
+    void writeLoop();
+
+    /// @brief Transpose a block into columns and write it out
+    void writeBlock(const std::vector<TraceRecord>& records);
+
+    /// @brief Append a column to the block being written, compressing it if that makes it smaller
+    void writeColumn(const void* data, size_t size);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    std::ofstream m_file;
+    std::string m_path;
+    bool m_compress;
+    size_t m_blockSize;
+
+    /// @brief The buffer of each recording thread, each on its own cache line
+    Shards<std::vector<TraceRecord>> m_buffers;
+
+    /// @brief Full blocks waiting to be written, and empty ones to recycle
+    std::deque<std::vector<TraceRecord>> m_pending;
+    std::vector<std::vector<TraceRecord>> m_free;
+
+    /// @brief The writer's scratch space for the columns of a block, and the encoded block
+    std::vector<double> m_times;
+    std::vector<uint32_t> m_entities;
+    std::vector<uint32_t> m_locations;
+    std::vector<uint8_t> m_states;
+    std::vector<char> m_column;
+    BinaryWriter m_block;
+
+    size_t m_writtenCount = 0;
+    size_t m_writtenBytes = 0;
+
+    /// @brief Whether the writer is partway through a block
+    bool m_writing = false;
+    bool m_shutdown = false;
+
+    /// @brief The first error thrown while writing, rethrown by flush()
+    std::exception_ptr m_exception;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_written;
+    std::thread m_thread;
+
+    /// @}
+
+};
+
+/// @class TraceReader
+/// @brief Reads a trace file back block by block, from a memory-mapped view of the file
+class TraceReader {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Methods
+    /// @{
+
+    /// @brief Convert a trace file to CSV, with a header row and state names, returning the number of rows
+    static size_t ToCsv(const std::string& tracePath, const std::string& csvPath);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    /// @brief Open a trace file and read its header, throwing if it isn't a trace or is from another version
+    TraceReader(const std::string& path);
+    ~TraceReader();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    const TraceSchema& schema() const { return m_schema; }
+
+    /// @brief The name of a state, or its number if the schema doesn't name it
+    std::string stateName(uint8_t state) const;
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Read the next block of records, returning false at the end of the file
+    bool readBlock(std::vector<TraceRecord>& outRecords);
+
+	/// @}
+
+protected:
+
+    /// @brief Read a column of the current block into the given buffer of exactly its decoded size
+    void readColumn(BinaryReader& reader, void* out, size_t size);
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    MappedFile m_file;
+    BinaryReader m_reader;
+    TraceSchema m_schema;
+
+    /// @brief Scratch space for decoding columns
+    std::vector<char> m_column;
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
@@ -0,0 +1,213 @@
+#include "JCalendarQueue.h"
+#include <algorithm>
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+CalendarQueue::CalendarQueue():
+    m_buckets(s_minBucketCount, s_nullNode),
+    m_freeNodes(s_nullNode),
+    m_size(0),
+    m_width(1.0),
+    m_inverseWidth(1.0),
+    m_currentDay(0),
+    m_minNode(s_nullNode)
+{
+}
+
+CalendarQueue::~CalendarQueue()
+{
+}
+
+void CalendarQueue::push(const EventKey & key)
+{
+    uint32_t node = acquireNode();
+    m_nodes[node].m_key = key;
+
+    // Searches for the minimum resume from the current day, so move it back if the key is earlier
+    uint64_t day = dayOf(key.m_time);
+    if (m_size == 0 || day < m_currentDay) {
+        m_currentDay = day;
+    }
+    link(node);
+
+    // Keep the cached minimum valid if there is one
+    if (m_minNode != s_nullNode && key < m_nodes[m_minNode].m_key) {
+        m_minNode = node;
+    }
+
+    m_size++;
+    if (m_size > 2 * m_buckets.size()) {
+        resize(2 * m_buckets.size());
+    }
+}
+
+void CalendarQueue::pop()
+{
+    // The minimum is always at the head of its bucket
+    uint32_t node = findMin();
+    unlink(&m_buckets[bucketOf(dayOf(m_nodes[node].m_key.m_time))]);
+}
+
+void CalendarQueue::erase(const EventKey & key)
+{
+    uint32_t* link = &m_buckets[bucketOf(dayOf(key.m_time))];
+    while (m_nodes[*link].m_key.m_slot != key.m_slot) {
+        link = &m_nodes[*link].m_next;
+    }
+    unlink(link);
+}
+
+void CalendarQueue::replace(const EventKey & key, const EventKey & replacement)
+{
+    erase(key);
+    push(replacement);
+}
+
+void CalendarQueue::clear()
+{
+    std::fill(m_buckets.begin(), m_buckets.end(), s_nullNode);
+    m_nodes.clear();
+    m_freeNodes = s_nullNode;
+    m_size = 0;
+    m_currentDay = 0;
+    m_minNode = s_nullNode;
+}
+
+void CalendarQueue::reserve(size_t count)
+{
+    m_nodes.reserve(count);
+    m_scratch.reserve(count);
+}
+
+uint32_t CalendarQueue::findMin() const
+{
+    if (m_minNode != s_nullNode) {
+        return m_minNode;
+    }
+
+    // Scan one year of the calendar, starting at the current day. The head of a bucket is the
+    // earliest key if it falls on the day being visited, since no key lies on an earlier day
+    const size_t bucketCount = m_buckets.size();
+    uint64_t day = m_currentDay;
+    for (size_t i = 0; i < bucketCount; i++, day++) {
+        uint32_t head = m_buckets[bucketOf(day)];
+        if (head != s_nullNode && dayOf(m_nodes[head].m_key.m_time) <= day) {
+            m_currentDay = day;
+            m_minNode = head;
+            return head;
+        }
+    }
+
+    // The next key is more than a year away, so fall back to a direct search over the bucket heads
+    uint32_t best = s_nullNode;
+    for (uint32_t head : m_buckets) {
+        if (head != s_nullNode && (best == s_nullNode || m_nodes[head].m_key < m_nodes[best].m_key)) {
+            best = head;
+        }
+    }
+    m_currentDay = dayOf(m_nodes[best].m_key.m_time);
+    m_minNode = best;
+    return best;
+}
+
+void CalendarQueue::link(uint32_t node)
+{
+    const EventKey& key = m_nodes[node].m_key;
+    uint32_t* next = &m_buckets[bucketOf(dayOf(key.m_time))];
+    while (*next != s_nullNode && !(key < m_nodes[*next].m_key)) {
+        next = &m_nodes[*next].m_next;
+    }
+    m_nodes[node].m_next = *next;
+    *next = node;
+}
+
+void CalendarQueue::unlink(uint32_t * link)
+{
+    uint32_t node = *link;
+    *link = m_nodes[node].m_next;
+
+    // Return the node to the pool
+    m_nodes[node].m_next = m_freeNodes;
+    m_freeNodes = node;
+    if (m_minNode == node) {
+        m_minNode = s_nullNode;
+    }
+    m_size--;
+
+    if (m_size < m_buckets.size() / 2 && m_buckets.size() > s_minBucketCount) {
+        resize(m_buckets.size() / 2);
+    }
+}
+
+uint32_t CalendarQueue::acquireNode()
+{
+    if (m_freeNodes != s_nullNode) {
+        uint32_t node = m_freeNodes;
+        m_freeNodes = m_nodes[node].m_next;
+        return node;
+    }
+    m_nodes.push_back(Node{});
+    return uint32_t(m_nodes.size() - 1);
+}
+
+void CalendarQueue::resize(size_t bucketCount)
+{
+    // Gather every live node
+    m_scratch.clear();
+    for (uint32_t head : m_buckets) {
+        for (uint32_t node = head; node != s_nullNode; node = m_nodes[node].m_next) {
+            m_scratch.push_back(node);
+        }
+    }
+
+    m_width = estimateWidth();
+    m_inverseWidth = 1.0 / m_width;
+
+    // Rehash the nodes into the new buckets
+    m_buckets.assign(bucketCount, s_nullNode);
+    for (uint32_t node : m_scratch) {
+        link(node);
+    }
+
+    m_minNode = s_nullNode;
+    m_currentDay = m_scratch.empty() ? 0 : dayOf(m_nodes[m_scratch.front()].m_key.m_time);
+}
+
+double CalendarQueue::estimateWidth()
+{
+    // Sort the earliest few keys, which also leaves the overall minimum at the front of the scratch list
+    const size_t sampleCount = std::min(m_scratch.size(), size_t(25));
+    if (sampleCount < 2) {
+        return m_width;
+    }
+    std::partial_sort(m_scratch.begin(), m_scratch.begin() + sampleCount, m_scratch.end(),
+        [this](uint32_t a, uint32_t b) {
+            return m_nodes[a].m_key < m_nodes[b].m_key;
+        });
+
+    // Average the separation between consecutive keys, ignoring outliers as suggested by Brown
+    double span = m_nodes[m_scratch[sampleCount - 1]].m_key.m_time - m_nodes[m_scratch[0]].m_key.m_time;
+    double averageSeparation = span / double(sampleCount - 1);
+    double total = 0.0;
+    size_t count = 0;
+    for (size_t i = 1; i < sampleCount; i++) {
+        double separation = m_nodes[m_scratch[i]].m_key.m_time - m_nodes[m_scratch[i - 1]].m_key.m_time;
+        if (separation <= 2.0 * averageSeparation) {
+            total += separation;
+            count++;
+        }
+    }
+    double separation = count ? total / double(count) : averageSeparation;
+
+    // Keep the current width if every sampled key has the same time
+    if (separation <= 0.0) {
+        return m_width;
+    }
+    return 3.0 * separation;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
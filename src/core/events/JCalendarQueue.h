@@ -0,0 +1,181 @@
+#ifndef J_CALENDAR_QUEUE_H
+#define J_CALENDAR_QUEUE_H
+/** @file JCalendarQueue.h
+    Defines a calendar queue of event keys, with amortized O(1) enqueue and dequeue
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <vector>
+#include <core/events/JEvent.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @class CalendarQueue
+/// @brief A calendar queue, as described by R. Brown, "Calendar Queues: A Fast O(1) Priority Queue
+/// Implementation for the Simulation Event Set Problem" (1988)
+/// @details Time is divided into "days" of a fixed width, and each day maps onto one of a power-of-two
+/// number of buckets, like the days of a year on a desk calendar. Each bucket holds a sorted list of keys.
+/// The bucket count and width are re-estimated whenever the queue grows or shrinks by a factor of two,
+/// so that each bucket holds O(1) keys on average.
+/// @note List nodes are pooled and recycled through a free list, so a queue of steady size does not allocate
+class CalendarQueue {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    CalendarQueue();
+    ~CalendarQueue();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    /// @brief The number of buckets in the calendar
+    size_t bucketCount() const { return m_buckets.size(); }
+
+    /// @brief The width of each bucket, in seconds
+    double bucketWidth() const { return m_width; }
+
+    /// @brief The key with the earliest time
+    const EventKey& top() const { return m_nodes[findMin()].m_key; }
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Add a key to the calendar
+    void push(const EventKey& key);
+
+    /// @brief Remove the key with the earliest time
+    void pop();
+
+    /// @brief Remove the given key from the calendar
+    /// @details Only the bucket containing the key is searched, so this is O(1) on average
+    void erase(const EventKey& key);
+
+    /// @brief Replace a key with another key for the same slot
+    void replace(const EventKey& key, const EventKey& replacement);
+
+    /// @brief Remove all keys, retaining allocated memory
+    void clear();
+
+    /// @brief Preallocate space for the given number of keys
+    void reserve(size_t count);
+
+	/// @}
+
+protected:
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Types
+    /// @{
+
+    /// @brief A node in the sorted, singly-linked list of a bucket
+    struct Node {
+        EventKey m_key;
+        uint32_t m_next;
+    };
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Methods
+    /// @{
+
+    /// @brief The absolute index of the day containing the given time
+    /// @note Simulation time starts at zero, so any earlier times are lumped into the first day
+    uint64_t dayOf(double time) const { return time > 0.0 ? uint64_t(time * m_inverseWidth) : 0; }
+
+    /// @brief The bucket that a day maps onto
+    size_t bucketOf(uint64_t day) const { return size_t(day & (m_buckets.size() - 1)); }
+
+    /// @brief Find the node containing the earliest key, caching the result
+    uint32_t findMin() const;
+
+    /// @brief Insert a pooled node into the sorted list of its bucket
+    void link(uint32_t node);
+
+    /// @brief Remove a node, given the link that points at it
+    void unlink(uint32_t* link);
+
+    /// @brief Grab a node from the free list, or grow the pool
+    uint32_t acquireNode();
+
+    /// @brief Resize the calendar to the given number of buckets, re-estimating the bucket width
+    void resize(size_t bucketCount);
+
+    /// @brief Estimate a bucket width from the separation between the earliest keys in the queue
+    double estimateWidth();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    /// @brief The head node of each bucket's sorted list
+    std::vector<uint32_t> m_buckets;
+
+    /// @brief Pool of list nodes
+    std::vector<Node> m_nodes;
+
+    /// @brief Head of the free list of nodes in the pool
+    uint32_t m_freeNodes;
+
+    /// @brief The number of keys in the queue
+    size_t m_size;
+
+    /// @brief The width of each bucket (day), in seconds, and its inverse
+    double m_width;
+    double m_inverseWidth;
+
+    /// @brief The day at which the search for the earliest key resumes
+    /// @details No key in the queue lies on an earlier day
+    mutable uint64_t m_currentDay;
+
+    /// @brief The node holding the earliest key, if known
+    mutable uint32_t m_minNode;
+
+    /// @brief Reusable scratch space for resizing
+    std::vector<uint32_t> m_scratch;
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static
+    /// @{
+
+    /// @brief Marks the end of a list
+    static constexpr uint32_t s_nullNode = uint32_t(-1);
+
+    /// @brief The minimum number of buckets in the calendar
+    static constexpr size_t s_minBucketCount = 2;
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
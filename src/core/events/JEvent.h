@@ -0,0 +1,120 @@
+#ifndef J_EVENT_H
+#define J_EVENT_H
+/** @file JEvent.h
+    Defines the records stored in the simulation event queue
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @struct Event
+/// @brief A discrete simulation event
+/// @details Events are small tagged records rather than polymorphic objects, so that they can be stored by
+/// value in pooled storage and copied freely. The type tag selects a handler via an EventDispatcher, and the
+/// meaning of the target and payload is up to that handler, e.g. the target may be the index of the entity
+/// that the event applies to
+struct Event {
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Public Methods
+    /// @{
+
+    /// @brief Reinterpret the payload as the given type
+    template<typename T>
+    T payload() const {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(m_payload), "Error, invalid payload type");
+        T value;
+        std::memcpy(&value, &m_payload, sizeof(T));
+        return value;
+    }
+
+    /// @brief Store a value in the payload
+    template<typename T>
+    void setPayload(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(m_payload), "Error, invalid payload type");
+        m_payload = 0;
+        std::memcpy(&m_payload, &value, sizeof(T));
+    }
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    /// @brief Simulation time at which the event fires, in seconds
+    double m_time = 0.0;
+
+    /// @brief Application-defined type of the event, used to select its handler
+    uint32_t m_type = 0;
+
+    /// @brief Application-defined target of the event
+    uint32_t m_target = 0;
+
+    /// @brief Application-defined data for the event
+    uint64_t m_payload = 0;
+
+    /// @}
+};
+static_assert(std::is_trivially_copyable_v<Event> && sizeof(Event) == 24, "Error, events must be small POD records");
+
+/// @struct EventKey
+/// @brief The ordering key for an event, as stored in the priority structures of an EventQueue
+/// @details Keys are kept small so that priority structures stay cache-friendly, and the event itself
+/// lives in a side table indexed by m_slot. Ties in time are broken by the sequence number, so that
+/// events scheduled for the same time fire in the order in which they were scheduled
+struct EventKey {
+    /// @brief Simulation time at which the event fires, in seconds
+    double m_time;
+
+    /// @brief Monotonically increasing sequence number, assigned when the event is scheduled
+    uint64_t m_sequence;
+
+    /// @brief Index of the event in the event queue's storage
+    uint32_t m_slot;
+
+    bool operator<(const EventKey& other) const {
+        return m_time < other.m_time || (m_time == other.m_time && m_sequence < other.m_sequence);
+    }
+};
+
+/// @struct EventHandle
+/// @brief A stable reference to a scheduled event, used to cancel or reschedule it
+/// @details Event storage slots are recycled, so each slot carries a generation that is bumped whenever
+/// its event fires or is cancelled. A handle whose generation no longer matches its slot is stale, and
+/// operations on it are skipped
+struct EventHandle {
+    /// @brief Index of the event in the event queue's storage
+    uint32_t m_slot = s_invalidSlot;
+
+    /// @brief Generation of the slot when the event was scheduled
+    uint32_t m_generation = 0;
+
+    /// @brief Whether the handle was ever assigned to an event
+    /// @note A valid handle may still be stale, see EventQueue::isPending
+    bool isValid() const { return m_slot != s_invalidSlot; }
+
+    /// @brief Marks a handle that does not refer to any event
+    static constexpr uint32_t s_invalidSlot = uint32_t(-1);
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef J_EVENT_DISPATCHER_H
+#define J_EVENT_DISPATCHER_H
+/** @file JEventDispatcher.h
+    Defines a dispatcher that routes events to their handlers by type
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <array>
+#include <utility>
+#include <assert.h>
+#include <core/events/JEvent.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @class EventDispatcher
+/// @brief Routes events to a handler object, using a table of functions generated at compile time
+/// @details The event types are given by an enum class with a COUNT entry, and the handler provides
+/// a member function template with a specialization (or a generic implementation) for each type, e.g.
+///     enum class MyEventType { kArrive, kDepart, COUNT };
+///     struct MyHandler { template<MyEventType Type> void onEvent(const Event& event); };
+/// Dispatching an event is then a single indexed call, with no virtual functions or allocations involved
+class EventDispatcher {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Public Types
+    /// @{
+
+    typedef void(*HandlerFunction)(void* handler, const Event& event);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    EventDispatcher() {}
+    ~EventDispatcher() {}
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    /// @brief Whether a handler has been set
+    bool hasHandler() const { return m_handler != nullptr; }
+
+    /// @brief The number of event types that the handler accepts
+    size_t typeCount() const { return m_typeCount; }
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Route events to the given handler, which must outlive the dispatcher
+    template<typename EventType, typename Handler>
+    void setHandler(Handler& handler) {
+        m_handler = &handler;
+        m_functions = HandlerTable<EventType, Handler>::s_functions.data();
+        m_typeCount = size_t(EventType::COUNT);
+    }
+
+    /// @brief Invoke the handler function for the event's type
+    void dispatch(const Event& event) const {
+        assert(event.m_type < m_typeCount && "Error, unrecognized event type");
+        m_functions[event.m_type](m_handler, event);
+    }
+
+	/// @}
+
+protected:
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Types
+    /// @{
+
+    /// @brief The table of handler functions for a handler type, indexed by event type
+    template<typename EventType, typename Handler>
+    struct HandlerTable {
+        static constexpr size_t s_typeCount = size_t(EventType::COUNT);
+
+        template<EventType Type>
+        static void Invoke(void* handler, const Event& event) {
+            static_cast<Handler*>(handler)->template onEvent<Type>(event);
+        }
+
+        template<size_t... Types>
+        static constexpr std::array<HandlerFunction, s_typeCount> Build(std::index_sequence<Types...>) {
+            return { { &Invoke<EventType(Types)>... } };
+        }
+
+        static constexpr std::array<HandlerFunction, s_typeCount> s_functions = Build(std::make_index_sequence<s_typeCount>{});
+    };
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    /// @brief The object handling events
+    void* m_handler = nullptr;
+
+    /// @brief The handler function for each event type
+    const HandlerFunction* m_functions = nullptr;
+
+    /// @brief The number of entries in the function table
+    size_t m_typeCount = 0;
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
@@ -0,0 +1,199 @@
+#ifndef J_EVENT_HEAP_H
+#define J_EVENT_HEAP_H
+/** @file JEventHeap.h
+    Defines an implicit d-ary min-heap of event keys
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <vector>
+#include <core/events/JEvent.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @class EventHeap
+/// @brief An indexed min-heap of event keys with a configurable number of children per node
+/// @details An arity of 2 gives a classic binary heap. An arity of 4 halves the depth of the tree,
+/// and the children of a node are contiguous in memory, so sift-down touches fewer cache lines.
+/// The heap position of every key is tracked by slot, so that any key may be removed or updated in O(log n)
+template<size_t Arity>
+class EventHeap {
+public:
+    static_assert(Arity >= 2, "Error, heap arity must be at least two");
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    EventHeap() {}
+    ~EventHeap() {}
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    size_t size() const { return m_keys.size(); }
+    bool empty() const { return m_keys.empty(); }
+
+    /// @brief The key with the earliest time
+    const EventKey& top() const { return m_keys.front(); }
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Add a key to the heap
+    void push(const EventKey& key) {
+        if (key.m_slot >= m_positions.size()) {
+            m_positions.resize(size_t(key.m_slot) + 1);
+        }
+        m_keys.push_back(key);
+        siftUp(m_keys.size() - 1);
+    }
+
+    /// @brief Remove the key with the earliest time
+    void pop() {
+        removeAt(0);
+    }
+
+    /// @brief Remove the given key from the heap
+    void erase(const EventKey& key) {
+        removeAt(m_positions[key.m_slot]);
+    }
+
+    /// @brief Replace a key with another key for the same slot
+    void replace(const EventKey& key, const EventKey& replacement) {
+        size_t index = m_positions[key.m_slot];
+        bool earlier = replacement < m_keys[index];
+        m_keys[index] = replacement;
+        if (earlier) {
+            siftUp(index);
+        }
+        else {
+            siftDown(index);
+        }
+    }
+
+    /// @brief Remove all keys, retaining allocated memory
+    void clear() { m_keys.clear(); }
+
+    /// @brief Preallocate space for the given number of keys
+    void reserve(size_t count) {
+        m_keys.reserve(count);
+        m_positions.reserve(count);
+    }
+
+	/// @}
+
+protected:
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Methods
+    /// @{
+
+    /// @brief Place a key at the given index, recording its position
+    void place(size_t index, const EventKey& key) {
+        m_keys[index] = key;
+        m_positions[key.m_slot] = uint32_t(index);
+    }
+
+    /// @brief Remove the key at the given index, filling the hole with the last key
+    void removeAt(size_t index) {
+        EventKey last = m_keys.back();
+        m_keys.pop_back();
+        if (index == m_keys.size()) {
+            return;
+        }
+
+        bool earlier = last < m_keys[index];
+        place(index, last);
+        if (earlier) {
+            siftUp(index);
+        }
+        else {
+            siftDown(index);
+        }
+    }
+
+    /// @brief Move the key at the given index towards the root until the heap property holds
+    /// @details Uses a hole rather than swaps, so each level costs a single copy
+    void siftUp(size_t index) {
+        EventKey key = m_keys[index];
+        while (index > 0) {
+            size_t parent = (index - 1) / Arity;
+            if (!(key < m_keys[parent])) {
+                break;
+            }
+            place(index, m_keys[parent]);
+            index = parent;
+        }
+        place(index, key);
+    }
+
+    /// @brief Move the key at the given index towards the leaves until the heap property holds
+    void siftDown(size_t index) {
+        const size_t count = m_keys.size();
+        EventKey key = m_keys[index];
+        while (true) {
+            size_t first = index * Arity + 1;
+            if (first >= count) {
+                break;
+            }
+
+            // Find the smallest child
+            size_t last = first + Arity < count ? first + Arity : count;
+            size_t best = first;
+            for (size_t child = first + 1; child < last; child++) {
+                if (m_keys[child] < m_keys[best]) {
+                    best = child;
+                }
+            }
+
+            if (!(m_keys[best] < key)) {
+                break;
+            }
+            place(index, m_keys[best]);
+            index = best;
+        }
+        place(index, key);
+    }
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    /// @brief The implicit tree of keys, with the children of node i at [Arity*i + 1, Arity*i + Arity]
+    std::vector<EventKey> m_keys;
+
+    /// @brief The index in m_keys of the key for each slot
+    std::vector<uint32_t> m_positions;
+
+    /// @}
+
+};
+
+/// @brief Aliases for the heap configurations supported by the event queue
+typedef EventHeap<2> BinaryEventHeap;
+typedef EventHeap<4> QuaternaryEventHeap;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
@@ -1,17 +1,258 @@
 #include "JEventQueue.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <core/serialization/JBinaryStream.h>
 
 namespace joby {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+const char * EventQueue::TypeName(EventQueueType type)
+{
+    switch (type) {
+    case EventQueueType::kBinaryHeap:
+        return "Binary heap";
+    case EventQueueType::kQuaternaryHeap:
+        return "4-ary heap";
+    case EventQueueType::kCalendarQueue:
+        return "Calendar queue";
+    default:
+        return "Unknown";
+    }
+}
 
-EventQueue::EventQueue()
+EventQueue::EventQueue(EventQueueType type, size_t inboxCapacity):
+    m_type(type),
+    m_nextSequence(0),
+    m_inbox(inboxCapacity)
 {
+    m_inboxBatch.reserve(m_inbox.capacity());
+    resetKeys(type);
 }
 
 EventQueue::~EventQueue()
 {
 }
 
+size_t EventQueue::size() const
+{
+    return std::visit([](const auto& keys) { return keys.size(); }, m_keys);
+}
+
+double EventQueue::nextTime() const
+{
+    return std::visit([](const auto& keys) {
+        return keys.empty() ? std::numeric_limits<double>::infinity() : keys.top().m_time;
+    }, m_keys);
+}
+
+EventHandle EventQueue::schedule(const Event & event)
+{
+    uint32_t slot = acquireSlot();
+    EventSlot& eventSlot = m_slots[slot];
+    eventSlot.m_event = event;
+    eventSlot.m_sequence = m_nextSequence++;
+
+    EventKey key = keyOf(slot);
+    std::visit([&key](auto& keys) { keys.push(key); }, m_keys);
+    m_statistics.m_scheduledCount++;
+
+    return EventHandle{ slot, eventSlot.m_generation };
+}
+
+bool EventQueue::cancel(const EventHandle & handle)
+{
+    if (!isPending(handle)) {
+        m_statistics.m_staleSkippedCount++;
+        return false;
+    }
+
+    EventKey key = keyOf(handle.m_slot);
+    std::visit([&key](auto& keys) { keys.erase(key); }, m_keys);
+    releaseSlot(handle.m_slot);
+    m_statistics.m_cancelledCount++;
+    return true;
+}
+
+bool EventQueue::reschedule(const EventHandle & handle, double time)
+{
+    if (!isPending(handle)) {
+        m_statistics.m_staleSkippedCount++;
+        return false;
+    }
+
+    EventKey key = keyOf(handle.m_slot);
+    EventSlot& eventSlot = m_slots[handle.m_slot];
+    eventSlot.m_event.m_time = time;
+    eventSlot.m_sequence = m_nextSequence++;
+    EventKey replacement = keyOf(handle.m_slot);
+    std::visit([&key, &replacement](auto& keys) { keys.replace(key, replacement); }, m_keys);
+    m_statistics.m_rescheduledCount++;
+    return true;
+}
+
+bool EventQueue::isPending(const EventHandle & handle) const
+{
+    // Released slots have their generation bumped, so a matching generation means the event is still queued
+    return handle.m_slot < m_slots.size() && m_slots[handle.m_slot].m_generation == handle.m_generation;
+}
+
+bool EventQueue::pop(Event & outEvent)
+{
+    bool popped = std::visit([this, &outEvent](auto& keys) {
+        if (keys.empty()) {
+            return false;
+        }
+        uint32_t slot = keys.top().m_slot;
+        keys.pop();
+
+        outEvent = m_slots[slot].m_event;
+        releaseSlot(slot);
+        return true;
+    }, m_keys);
+
+    if (popped) {
+        m_statistics.m_poppedCount++;
+    }
+    return popped;
+}
+
+bool EventQueue::post(const Event & event, uint32_t producerId, uint64_t producerSequence)
+{
+    return m_inbox.tryPush(PostedEvent{ event, producerSequence, producerId });
+}
+
+void EventQueue::postLocal(const Event & event, uint32_t producerId, uint64_t producerSequence)
+{
+    m_inboxBatch.push_back(PostedEvent{ event, producerSequence, producerId });
+}
+
+size_t EventQueue::drainInbox()
+{
+    PostedEvent posted;
+    while (m_inbox.tryPop(posted)) {
+        m_inboxBatch.push_back(posted);
+    }
+    if (m_inboxBatch.empty()) {
+        return 0;
+    }
+
+    // Sort the batch, since the order in which producers reached the inbox is arbitrary
+    std::sort(m_inboxBatch.begin(), m_inboxBatch.end());
+    for (const PostedEvent& batchEvent : m_inboxBatch) {
+        schedule(batchEvent.m_event);
+    }
+
+    size_t count = m_inboxBatch.size();
+    m_statistics.m_postedCount += count;
+    m_inboxBatch.clear();
+    return count;
+}
+
+void EventQueue::clear()
+{
+    std::visit([](auto& keys) { keys.clear(); }, m_keys);
+
+    // Release every slot, rather than discarding them, so that outstanding handles become stale
+    m_freeSlots.clear();
+    for (uint32_t slot = 0; slot < m_slots.size(); slot++) {
+        m_slots[slot].m_generation++;
+        m_freeSlots.push_back(slot);
+    }
+}
+
+void EventQueue::reserve(size_t count)
+{
+    std::visit([count](auto& keys) { keys.reserve(count); }, m_keys);
+    m_slots.reserve(count);
+    m_freeSlots.reserve(count);
+}
+
+void EventQueue::save(BinaryWriter & writer) const
+{
+    writer.write(m_type);
+    writer.write(m_nextSequence);
+    writer.write(m_statistics);
+
+    // Write slot fields individually, so that no padding bytes end up in the file
+    writer.write(uint64_t(m_slots.size()));
+    for (const EventSlot& slot : m_slots) {
+        writer.write(slot.m_event);
+        writer.write(slot.m_sequence);
+        writer.write(slot.m_generation);
+    }
+    writer.writeVector(m_freeSlots);
+}
+
+void EventQueue::load(BinaryReader & reader)
+{
+    EventQueueType type = reader.read<EventQueueType>();
+    resetKeys(type);
+    reader.read(m_nextSequence);
+    reader.read(m_statistics);
+
+    uint64_t slotCount = reader.read<uint64_t>();
+    m_slots.resize(size_t(slotCount));
+    for (EventSlot& slot : m_slots) {
+        reader.read(slot.m_event);
+        reader.read(slot.m_sequence);
+        reader.read(slot.m_generation);
+    }
+    reader.readVector(m_freeSlots);
+
+    // Every slot that isn't free holds a pending event. Keys order by time and sequence alone, so
+    // rebuilding the priority structure from them restores the exact popping order
+    std::vector<bool> isFree(m_slots.size(), false);
+    for (uint32_t slot : m_freeSlots) {
+        if (slot >= m_slots.size()) {
+            throw std::runtime_error("Error, invalid event queue state");
+        }
+        isFree[slot] = true;
+    }
+    for (uint32_t slot = 0; slot < m_slots.size(); slot++) {
+        if (!isFree[slot]) {
+            EventKey key = keyOf(slot);
+            std::visit([&key](auto& keys) { keys.push(key); }, m_keys);
+        }
+    }
+}
+
+void EventQueue::resetKeys(EventQueueType type)
+{
+    m_type = type;
+    switch (type) {
+    case EventQueueType::kBinaryHeap:
+        m_keys.emplace<BinaryEventHeap>();
+        break;
+    case EventQueueType::kQuaternaryHeap:
+        m_keys.emplace<QuaternaryEventHeap>();
+        break;
+    case EventQueueType::kCalendarQueue:
+        m_keys.emplace<CalendarQueue>();
+        break;
+    default:
+        throw std::invalid_argument("Invalid event queue type");
+    }
+}
+
+uint32_t EventQueue::acquireSlot()
+{
+    if (m_freeSlots.size()) {
+        uint32_t slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        return slot;
+    }
+    m_slots.emplace_back();
+    return uint32_t(m_slots.size() - 1);
+}
+
+void EventQueue::releaseSlot(uint32_t slot)
+{
+    m_slots[slot].m_generation++;
+    m_freeSlots.push_back(slot);
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 } // end namespacing
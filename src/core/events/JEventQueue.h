@@ -1,11 +1,18 @@
 #ifndef J_EVENT_QUEUE_H
 #define J_EVENT_QUEUE_H
-/** @file JEventQueue.h 
+/** @file JEventQueue.h
     Defines an event queue for processing simulation events
 */
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Includes
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <vector>
+#include <variant>
+
+#include <core/events/JEvent.h>
+#include <core/events/JEventHeap.h>
+#include <core/events/JCalendarQueue.h>
+#include <core/threading/JMpscQueue.h>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Namespace Definitions
@@ -15,23 +22,74 @@ namespace joby {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Forward Declarations
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class BinaryWriter;
+class BinaryReader;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Class Definitions
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief The priority structures that an event queue may be backed by
+/// @details All structures pop events in exactly the same order, so they may be swapped freely to suit
+/// the scenario. Heaps are O(log n), and the calendar queue is amortized O(1) when event times are
+/// reasonably well spread out
+enum class EventQueueType {
+    kBinaryHeap = 0,
+    kQuaternaryHeap,
+    kCalendarQueue,
+    COUNT
+};
+
+/// @struct EventQueueStatistics
+/// @brief Counters describing the traffic through an event queue
+struct EventQueueStatistics {
+    /// @brief The number of events that were scheduled
+    uint64_t m_scheduledCount = 0;
+
+    /// @brief The number of events that were popped from the queue
+    uint64_t m_poppedCount = 0;
+
+    /// @brief The number of events that were cancelled before firing
+    uint64_t m_cancelledCount = 0;
+
+    /// @brief The number of events that were moved to a new time
+    uint64_t m_rescheduledCount = 0;
+
+    /// @brief The number of cancel or reschedule requests that were skipped, because the event they
+    /// referred to had already fired or been cancelled
+    uint64_t m_staleSkippedCount = 0;
+
+    /// @brief The number of events that were drained from the inbox, having been posted from other threads
+    uint64_t m_postedCount = 0;
+};
+
 /// @class EventQueue
+/// @brief A time-ordered queue of simulation events
+/// @details Events scheduled for the same time are popped in the order in which they were scheduled.
+/// Scheduling an event returns a handle, which can be used to cancel or reschedule the event in O(log n),
+/// so that invalidated events never linger in the queue.
+/// @note Events are stored by value in a pool of slots that are recycled as events fire, and every other
+/// container only grows to its high-water mark, so a simulation with a steady number of pending events
+/// performs no allocations. Use reserve() to avoid allocations during warm-up as well
+/// @note Only post() may be called from threads other than the one that owns the queue. Posted events wait
+/// in a lock-free inbox until the owning thread calls drainInbox()
 class EventQueue {
 public:
     //-----------------------------------------------------------------------------------------------------------------
     /// @name Static Methods
     /// @{
+
+    /// @brief The display name of a queue type
+    static const char* TypeName(EventQueueType type);
+
     /// @}
 
     //-----------------------------------------------------------------------------------------------------------------
     /// @name Constructor/Destructor
     /// @{
 
-    EventQueue();
+    /// @param[in] type The priority structure backing the queue
+    /// @param[in] inboxCapacity The number of posted events that may await draining
+    EventQueue(EventQueueType type = EventQueueType::kQuaternaryHeap, size_t inboxCapacity = 4096);
     ~EventQueue();
 
     /// @}
@@ -39,19 +97,169 @@ public:
     //-----------------------------------------------------------------------------------------------------------------
     /// @name Properties
     /// @{
+
+    /// @brief The type of priority structure backing the queue
+    EventQueueType type() const { return m_type; }
+
+    /// @brief The number of pending events
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+
+    /// @brief The number of events that can be pending before the event pool grows
+    size_t capacity() const { return m_slots.capacity(); }
+
+    /// @brief The time of the earliest pending event, or infinity if there are none
+    double nextTime() const;
+
+    /// @brief Counters for the events that have passed through the queue
+    const EventQueueStatistics& statistics() const { return m_statistics; }
+
     /// @}
 
     //-----------------------------------------------------------------------------------------------------------------
 	/// @name Public Methods
 	/// @{
 
+    /// @brief Add an event to the queue
+    /// @return A handle that remains valid until the event fires or is cancelled
+    EventHandle schedule(const Event& event);
+
+    /// @brief Remove a pending event from the queue
+    /// @return False if the event had already fired or been cancelled
+    bool cancel(const EventHandle& handle);
+
+    /// @brief Move a pending event to a new time
+    /// @details The event is ordered as if it had just been scheduled, so it fires after any other
+    /// events at the same time
+    /// @return False if the event had already fired or been cancelled
+    bool reschedule(const EventHandle& handle, double time);
+
+    /// @brief Whether the event referred to by the handle has yet to fire or be cancelled
+    bool isPending(const EventHandle& handle) const;
+
+    /// @brief Remove the earliest event from the queue
+    /// @return False if the queue was empty
+    bool pop(Event& outEvent);
+
+    /// @brief Add an event to the inbox, from any thread
+    /// @details The event is not scheduled until the next call to drainInbox()
+    /// @param[in] producerId Identifies the posting thread or process, and must be unique to it
+    /// @param[in] producerSequence Increases with each event posted by the producer
+    /// @return False if the inbox is full
+    bool post(const Event& event, uint32_t producerId, uint64_t producerSequence);
+
+    /// @brief Add an event to the next drained batch, from the thread that owns the queue
+    /// @details Unlike post(), this never fails, since it bypasses the inbox. The event is ordered among
+    /// posted events exactly as if it had been posted
+    void postLocal(const Event& event, uint32_t producerId, uint64_t producerSequence);
+
+    /// @brief Schedule all events posted to the inbox, from the thread that owns the queue
+    /// @details The drained batch is scheduled in order of time, then producer, then producer sequence,
+    /// so the resulting order does not depend on how the producer threads happened to interleave
+    /// @return The number of events drained
+    size_t drainInbox();
+
+    /// @brief Remove all pending events
+    /// @note Events that are still in the inbox are unaffected
+    void clear();
+
+    /// @brief Preallocate space for the given number of pending events
+    void reserve(size_t count);
+
+    /// @brief Write the pending events, along with the slot and sequence bookkeeping behind their handles
+    /// @note The inbox is not saved, so it should be drained first
+    void save(BinaryWriter& writer) const;
+
+    /// @brief Replace the contents of the queue with saved state
+    /// @details Events pop in exactly the same order as they would have from the saved queue, and handles
+    /// taken before the save remain valid
+    void load(BinaryReader& reader);
+
 	/// @}
 
 protected:
 
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Types
+    /// @{
+
+    /// @brief Storage for a pending event
+    struct EventSlot {
+        /// @brief The event, including its current time
+        Event m_event;
+
+        /// @brief The sequence number of the event's current key
+        uint64_t m_sequence = 0;
+
+        /// @brief Bumped whenever the slot is released, invalidating outstanding handles
+        uint32_t m_generation = 0;
+    };
+
+    /// @brief An event posted from another thread
+    struct PostedEvent {
+        Event m_event;
+        uint64_t m_producerSequence;
+        uint32_t m_producerId;
+
+        bool operator<(const PostedEvent& other) const {
+            if (m_event.m_time != other.m_event.m_time) {
+                return m_event.m_time < other.m_event.m_time;
+            }
+            if (m_producerId != other.m_producerId) {
+                return m_producerId < other.m_producerId;
+            }
+            return m_producerSequence < other.m_producerSequence;
+        }
+    };
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Methods
+    /// @{
+
+    /// @brief Obtain a free index in the event storage
+    uint32_t acquireSlot();
+
+    /// @brief Return a slot to the free list, invalidating its handles
+    void releaseSlot(uint32_t slot);
+
+    /// @brief Replace the priority structure with an empty one of the given type
+    void resetKeys(EventQueueType type);
+
+    /// @brief The key for the event currently held in a slot
+    EventKey keyOf(uint32_t slot) const { return EventKey{ m_slots[slot].m_event.m_time, m_slots[slot].m_sequence, slot }; }
+
+    /// @}
+
     //-----------------------------------------------------------------------------------------------------------------
     /// @name Members
     /// @{
+
+    /// @brief The type of priority structure backing the queue
+    EventQueueType m_type;
+
+    /// @brief The priority structure, which orders the keys of pending events
+    std::variant<BinaryEventHeap, QuaternaryEventHeap, CalendarQueue> m_keys;
+
+    /// @brief Storage for pending events, indexed by the slot in each key
+    std::vector<EventSlot> m_slots;
+
+    /// @brief Slots in the event storage that are available for reuse
+    std::vector<uint32_t> m_freeSlots;
+
+    /// @brief The sequence number to assign to the next scheduled event
+    uint64_t m_nextSequence;
+
+    /// @brief Counters for the events that have passed through the queue
+    EventQueueStatistics m_statistics;
+
+    /// @brief Events posted from other threads, awaiting a drain
+    MpscQueue<PostedEvent> m_inbox;
+
+    /// @brief Reusable storage for sorting a drained batch of posted events
+    std::vector<PostedEvent> m_inboxBatch;
+
     /// @}
 
 };
@@ -60,4 +268,4 @@ protected:
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 } // end namespacing
 
-#endif
\ No newline at end of file
+#endif
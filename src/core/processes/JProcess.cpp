@@ -1,10 +1,23 @@
 #include "JProcess.h"
 #include <core/diagnostics/JLogger.h>
+#include <core/serialization/JBinaryStream.h>
 
 namespace joby {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+void Process::save(BinaryWriter & writer) const
+{
+    writer.write(getState());
+    writer.write(m_sortingLayer);
+}
+
+void Process::load(BinaryReader & reader)
+{
+    setState(reader.read<ProcessState>());
+    reader.read(m_sortingLayer);
+}
+
 bool Process::runProcess(double sec)
 {
     // Process is uninitialized, so checkValidity it
@@ -17,6 +17,8 @@ namespace joby {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Forward Declarations
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class BinaryWriter;
+class BinaryReader;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Class Definitions
@@ -100,6 +102,13 @@ public:
     virtual void onFail() {}
     virtual void onAbort() {}
 
+    /// @brief Write the state of the process for a checkpoint
+    /// @details Subclasses with state of their own should extend this, calling the base class first
+    virtual void save(BinaryWriter& writer) const;
+
+    /// @brief Restore state written by save()
+    virtual void load(BinaryReader& reader);
+
     /// @brief Run the process update loop
     /// @details Returns true if the process has died, else false
     bool runProcess(double sec);
@@ -168,11 +177,11 @@ protected:
 
     /// @brief Determines the priority of the process via the sorting order each frame,
     /// @details A lower value means a higher priority
-    int m_sortingLayer;
+    int m_sortingLayer = 0;
 
     /// @brief The status of the process
     /// @details This needs to be atomic to avoid undefined behavior when querying
-    std::atomic<ProcessState> m_state;
+    std::atomic<ProcessState> m_state{ ProcessState::kUninitialized };
 
     /// @}
 
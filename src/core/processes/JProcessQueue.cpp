@@ -1,6 +1,9 @@
 #include "JProcessQueue.h"
 #include "JProcess.h"
 #include "JThreadedProcess.h"
+#include <algorithm>
+#include <stdexcept>
+#include <core/serialization/JBinaryStream.h>
 
 namespace joby {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -8,7 +11,10 @@ namespace joby {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 bool CompareBySortingLayer::operator()(const std::shared_ptr<Process>& a, const std::shared_ptr<Process>& b) const
 {
-    return a->getSortingLayer() < b->getSortingLayer();
+    if (a->getSortingLayer() != b->getSortingLayer()) {
+        return a->getSortingLayer() < b->getSortingLayer();
+    }
+    return a->id() < b->id();
 }
 CompareBySortingLayer CompareBySortingLayer::s_compareBySortingLayer = CompareBySortingLayer();
 
@@ -111,13 +117,38 @@ void ProcessQueue::reorderProcesses()
     std::sort(m_processQueue.begin(), m_processQueue.end(), CompareBySortingLayer::s_compareBySortingLayer);
 }
 
-void ProcessQueue::updateProcesses(unsigned long deltaMs)
+bool ProcessQueue::hasActiveProcesses() const
 {
-    //// Update all processes on the main thread
-    if (!m_processes.size()) {
-        return;
+    auto isActive = [](const std::shared_ptr<Process>& process) {
+        ProcessState state = process->getState();
+        return state == ProcessState::kRunning || state == ProcessState::kUninitialized;
+    };
+
+    // Newly attached processes wait in the staging queue until the next update
+    if (std::any_of(m_processes.begin(), m_processes.end(), isActive) ||
+        std::any_of(m_processQueue.begin(), m_processQueue.end(), isActive)) {
+        return true;
     }
 
+    // Lock-step threaded processes are stepped alongside the others
+    return m_deterministic && std::any_of(m_threadedProcesses.begin(), m_threadedProcesses.end(), isActive);
+}
+
+void ProcessQueue::setDeterministic(bool deterministic)
+{
+    std::unique_lock lock(m_threadedProcessMutex);
+    if (m_threadedProcesses.size()) {
+        throw std::logic_error("Error, cannot change execution mode with threaded processes attached");
+    }
+    m_deterministic = deterministic;
+}
+
+void ProcessQueue::updateProcesses(double deltaSec)
+{
+    //// Update all processes on the main thread
+    // Newly attached processes are staged in the process queue, so bring them in to run from this update on
+    stageAttachedProcesses();
+
     std::vector<std::shared_ptr<Process>>::iterator it = m_processes.begin();
     while (it != m_processes.end())
     {
@@ -125,7 +156,7 @@ void ProcessQueue::updateProcesses(unsigned long deltaMs)
         std::shared_ptr<Process> currentProcess = (*it);
 
         // Run process
-        bool isDead = currentProcess->runProcess(deltaMs);
+        bool isDead = currentProcess->runProcess(deltaSec);
 
         // Only queue process to run again if it hasn't died
         if (!isDead) {
@@ -143,6 +174,12 @@ void ProcessQueue::updateProcesses(unsigned long deltaMs)
     m_processQueue.clear();
 
 
+    //// Step threaded processes alongside the others, if they aren't running freely
+    if (m_deterministic) {
+        updateThreadedProcesses(deltaSec);
+        return;
+    }
+
     //// Check that threaded processes haven't failed, and delete any that have completed
     {
         std::unique_lock lock(m_threadedProcessMutex);
@@ -168,8 +205,9 @@ void ProcessQueue::updateProcesses(unsigned long deltaMs)
     }
 }
 
-void ProcessQueue::fixedUpdateProcesses(unsigned long deltaMs)
+void ProcessQueue::fixedUpdateProcesses(double deltaSec)
 {
+    stageAttachedProcesses();
     std::vector<std::shared_ptr<Process>>::iterator it = m_processes.begin();
     while (it != m_processes.end())
     {
@@ -177,7 +215,7 @@ void ProcessQueue::fixedUpdateProcesses(unsigned long deltaMs)
         std::shared_ptr<Process> currentProcess = (*it);
 
         // Run process fixed update for process
-        bool isDead = currentProcess->runFixed(deltaMs);
+        bool isDead = currentProcess->runFixed(deltaSec);
 
         // Only queue process to run again if it hasn't died
         if (!isDead) {
@@ -197,6 +235,38 @@ void ProcessQueue::fixedUpdateProcesses(unsigned long deltaMs)
     return;
 }
 
+void ProcessQueue::updateThreadedProcesses(double deltaSec)
+{
+    std::unique_lock lock(m_threadedProcessMutex);
+    if (!m_threadedProcesses.size()) {
+        return;
+    }
+
+    // Any exception is rethrown here, once every process has finished its step
+    m_threadPool.parallelFor(m_threadedProcesses.size(), [this, deltaSec](size_t index) {
+        m_threadedProcesses[index]->runProcess(deltaSec);
+    });
+
+    // The processes held their posted events, since this thread couldn't drain the inbox until they finished
+    for (const std::shared_ptr<Process>& process : m_threadedProcesses) {
+        std::static_pointer_cast<ThreadedProcess>(process)->releaseHeldEvents();
+    }
+
+    // Drop processes that died during the step, keeping the rest in a fixed order
+    m_threadedProcesses.erase(std::remove_if(m_threadedProcesses.begin(), m_threadedProcesses.end(),
+        [](const std::shared_ptr<Process>& process) {
+            return process->isDead();
+        }), m_threadedProcesses.end());
+}
+
+void ProcessQueue::stageAttachedProcesses()
+{
+    if (m_processQueue.size()) {
+        m_processes.insert(m_processes.end(), m_processQueue.begin(), m_processQueue.end());
+        m_processQueue.clear();
+    }
+}
+
 void ProcessQueue::attachProcess(const std::shared_ptr<Process>& process, bool initialize)
 {
     if (!process->as<ThreadedProcess>()) {
@@ -217,11 +287,21 @@ void ProcessQueue::attachProcess(const std::shared_ptr<Process>& process, bool i
             throw("Wrong process type passed");
         }
 #endif
+        threadedProcess->setEventQueue(m_eventQueue);
+        threadedProcess->setHoldsPostedEvents(m_deterministic);
         m_threadedProcesses.emplace_back(threadedProcess);
+        std::sort(m_threadedProcesses.begin(), m_threadedProcesses.end(), CompareBySortingLayer::s_compareBySortingLayer);
         m_threadedProcessMutex.unlock();
 
+        if (initialize) {
+            process->onInit();
+        }
+
         // Start the threaded process, or at least queue it if no threads are available
-        m_threadPool.addTask(std::bind(&ThreadedProcess::run, threadedProcess));
+        // In deterministic mode, it is instead stepped by each update
+        if (!m_deterministic) {
+            m_threadPool.addTask(std::bind(&ThreadedProcess::run, threadedProcess));
+        }
     }
 }
 
@@ -256,6 +336,46 @@ void ProcessQueue::abortAllProcesses(bool immediate)
     }
 }
 
+void ProcessQueue::save(BinaryWriter & writer)
+{
+    // Fix the order of newly attached processes, so that it matches on load
+    stageAttachedProcesses();
+    std::sort(m_processes.begin(), m_processes.end(), CompareBySortingLayer::s_compareBySortingLayer);
+
+    std::unique_lock lock(m_threadedProcessMutex);
+    for (const std::vector<std::shared_ptr<Process>>* processes : { &m_processes, &m_threadedProcesses }) {
+        writer.write(uint64_t(processes->size()));
+        for (const std::shared_ptr<Process>& process : *processes) {
+            process->save(writer);
+        }
+    }
+}
+
+void ProcessQueue::load(BinaryReader & reader)
+{
+    stageAttachedProcesses();
+    std::sort(m_processes.begin(), m_processes.end(), CompareBySortingLayer::s_compareBySortingLayer);
+
+    std::unique_lock lock(m_threadedProcessMutex);
+    for (std::vector<std::shared_ptr<Process>>* processes : { &m_processes, &m_threadedProcesses }) {
+        if (reader.read<uint64_t>() != processes->size()) {
+            throw std::runtime_error("Error, checkpoint does not match the attached processes");
+        }
+        for (const std::shared_ptr<Process>& process : *processes) {
+            process->load(reader);
+        }
+    }
+}
+
+void ProcessQueue::setEventQueue(EventQueue* queue)
+{
+    std::unique_lock lock(m_threadedProcessMutex);
+    m_eventQueue = queue;
+    for (const std::shared_ptr<Process>& process : m_threadedProcesses) {
+        std::static_pointer_cast<ThreadedProcess>(process)->setEventQueue(queue);
+    }
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 } // end namespacing
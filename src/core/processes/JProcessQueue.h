@@ -18,12 +18,16 @@ namespace joby {
 // Forward Declarations
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 class Process;
+class EventQueue;
+class BinaryWriter;
+class BinaryReader;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Class Definitions
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// @struct CompareBySortingLayer
 /// @brief Struct containing a comparator for sorting processes list by sorting layer
+/// @details Processes within a layer are ordered by ID, so that the update order is fixed from run to run
 struct CompareBySortingLayer {
     bool operator()(const std::shared_ptr<Process>& a, const std::shared_ptr<Process>& b) const;
 
@@ -33,6 +37,11 @@ struct CompareBySortingLayer {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// @class ProcessQueue
+/// @details By default, threaded processes run freely on the thread pool against the wall clock. In
+/// deterministic mode they are instead stepped in lock-step with the simulation: each update runs every
+/// threaded process once across the pool, and waits for all of them to finish before returning. As long
+/// as threaded processes only touch their own state and communicate by posting events, results are then
+/// identical regardless of the number of threads
 class ProcessQueue {
 public:
     //-----------------------------------------------------------------------------------------------------------------
@@ -52,6 +61,17 @@ public:
     //-----------------------------------------------------------------------------------------------------------------
     /// @name Properties
     /// @{
+
+    /// @brief Whether any unthreaded process needs updating, i.e. is running or has yet to be initialized
+    /// @details Paused and dead processes do not count, so a process can pause itself to let the simulator
+    /// skip fixed steps while there is nothing to integrate
+    bool hasActiveProcesses() const;
+
+    /// @brief Whether threaded processes are stepped in lock-step with the simulation
+    /// @note This must be set before any threaded processes are attached
+    bool isDeterministic() const { return m_deterministic; }
+    void setDeterministic(bool deterministic);
+
     /// @}
 
     //-----------------------------------------------------------------------------------------------------------------
@@ -65,10 +85,12 @@ public:
     void reorderProcesses();
 
     /// @brief Updates all attached processes
-    void updateProcesses(unsigned long deltaMs);
+    /// @param[in] deltaSec The time to advance the processes by, in seconds
+    void updateProcesses(double deltaSec);
 
     /// @brief Fixed-updates all attached processes
-    void fixedUpdateProcesses(unsigned long deltaMs);
+    /// @param[in] deltaSec The time to advance the processes by, in seconds
+    void fixedUpdateProcesses(double deltaSec);
 
     /// @brief Attach a process to the process manager
     void attachProcess(const std::shared_ptr<Process>& process, bool initialize = false);
@@ -76,6 +98,18 @@ public:
     /// @brief Aborts all processes
     void abortAllProcesses(bool immediate);
 
+    /// @brief Write the state of every attached process, in update order
+    void save(BinaryWriter& writer);
+
+    /// @brief Restore the state of every attached process
+    /// @details Processes can't be created from a checkpoint, so the same processes must already be attached,
+    /// in the same order, as when the checkpoint was saved
+    void load(BinaryReader& reader);
+
+    /// @brief Set the queue that threaded processes post their events to
+    /// @note Applies to threaded processes that are already attached, as well as any attached later
+    void setEventQueue(EventQueue* queue);
+
 	/// @}
 
 protected:
@@ -89,6 +123,12 @@ protected:
     /// @brief Delete the threaded process with the given ID from the queue
     void deleteThreadedProcess(size_t id);
 
+    /// @brief Move newly attached processes from the staging queue into the list of processes to update
+    void stageAttachedProcesses();
+
+    /// @brief Run every threaded process once across the thread pool, waiting for all of them to finish
+    void updateThreadedProcesses(double deltaSec);
+
     /// @}
 
     //-----------------------------------------------------------------------------------------------------------------
@@ -111,6 +151,12 @@ protected:
     /// @brief All asynchronous processes
     std::vector<std::shared_ptr<Process>> m_threadedProcesses;
 
+    /// @brief The queue that threaded processes post their events to
+    EventQueue* m_eventQueue = nullptr;
+
+    /// @brief Whether threaded processes are stepped in lock-step with the simulation
+    bool m_deterministic = false;
+
     /// @}
 
 };
@@ -1,5 +1,8 @@
 #include "JThreadedProcess.h"
+#include <thread>
 #include <core/time/JTimer.h>
+#include <core/events/JEventQueue.h>
+#include <core/serialization/JBinaryStream.h>
 
 namespace joby {
 
@@ -18,6 +21,18 @@ void ThreadedProcess::onSuccess()
 {
 }
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void ThreadedProcess::save(BinaryWriter & writer) const
+{
+    Process::save(writer);
+    writer.write(m_postedEventCount);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void ThreadedProcess::load(BinaryReader & reader)
+{
+    Process::load(reader);
+    reader.read(m_postedEventCount);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void ThreadedProcess::run()
 {
     // Initialize a timer for the threaded process
@@ -37,6 +52,31 @@ void ThreadedProcess::run()
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void ThreadedProcess::postEvent(const Event & event)
+{
+    if (!m_eventQueue) {
+        throw std::logic_error("Error, threaded process has no event queue to post to");
+    }
+    uint64_t sequence = m_postedEventCount++;
+    if (m_holdsPostedEvents) {
+        m_heldEvents.emplace_back(event, sequence);
+        return;
+    }
+    while (!m_eventQueue->post(event, uint32_t(id()), sequence)) {
+        std::this_thread::yield();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void ThreadedProcess::releaseHeldEvents()
+{
+    for (const std::pair<Event, uint64_t>& held : m_heldEvents) {
+        m_eventQueue->postLocal(held.first, uint32_t(id()), held.second);
+    }
+    m_heldEvents.clear();
+}
+
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -9,14 +9,17 @@
 #include <exception>
 #include <stdexcept>
 #include <mutex>
+#include <vector>
 
 // Internal
 #include "JProcess.h"
+#include <core/events/JEvent.h>
 
 namespace joby {
 /////////////////////////////////////////////////////////////////////////////////////////////
 // Forward Declarations
 /////////////////////////////////////////////////////////////////////////////////////////////
+class EventQueue;
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 // Typedefs
@@ -50,6 +53,15 @@ public:
     std::mutex& exceptionMutex() { return m_exceptionLock; }
     const std::exception_ptr& exception() const { return m_exceptionPtr; }
 
+    /// @brief The queue that events posted by this process are sent to
+    /// @note This should be set before the process starts running
+    void setEventQueue(EventQueue* queue) { m_eventQueue = queue; }
+
+    /// @brief Whether posted events are held by the process until the simulation thread hands them over
+    /// @note This is set for processes stepped in lock-step by the simulation thread, which can't drain the
+    /// inbox while it waits for them
+    void setHoldsPostedEvents(bool holdsPostedEvents) { m_holdsPostedEvents = holdsPostedEvents; }
+
     /// @}
 
 	//--------------------------------------------------------------------------------------------
@@ -63,8 +75,20 @@ public:
     virtual void onFail() override { }
     virtual void onAbort() override{}
 
+    virtual void save(BinaryWriter& writer) const override;
+    virtual void load(BinaryReader& reader) override;
+
     /// @brief Required override for QRunnable for threaded process
     virtual void run();
+
+    /// @brief Send an event to the simulation thread, where it will be scheduled at the start of the next step
+    /// @details This is the only safe way for a threaded process to hand results back to the simulation.
+    /// If the event queue's inbox is full, this waits for the simulation thread to drain it. Processes that hold
+    /// their posted events never wait
+    void postEvent(const Event& event);
+
+    /// @brief Hand the events held since the last call over to the event queue, from the simulation thread
+    void releaseHeldEvents();
 	
     /// @}
 
@@ -93,6 +117,18 @@ protected:
     /// @details This needs to be cached locally, or
     double m_previousElapsedTime;
 
+    /// @brief The queue receiving posted events
+    EventQueue* m_eventQueue = nullptr;
+
+    /// @brief The number of events posted so far, used to order ties between this process's events
+    uint64_t m_postedEventCount = 0;
+
+    /// @brief Whether posted events are held in m_heldEvents rather than sent to the inbox
+    bool m_holdsPostedEvents = false;
+
+    /// @brief Events posted during the current lock-step, with their sequence numbers
+    std::vector<std::pair<Event, uint64_t>> m_heldEvents;
+
     /// @}
 };
 
@@ -0,0 +1,130 @@
+#include "JPhilox.h"
+#include <cmath>
+#include <limits>
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef J_SIMD_X86
+/// @brief Convert four lanes of 64 random bits to uniform doubles, exactly as Philox::ToUniform() does
+J_TARGET_AVX2 static inline __m256d ToUniformAvx2(__m256i bits, bool antithetic)
+{
+    // Integers below 2^53 convert exactly, by way of two halves placed in the mantissa of 2^52
+    const __m256i exponentBits = _mm256_set1_epi64x(0x4330000000000000ll);
+    const __m256d twoTo52 = _mm256_set1_pd(0x1.0p52);
+    bits = _mm256_srli_epi64(bits, 11);
+    __m256d high = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(bits, 32), exponentBits)), twoTo52);
+    __m256d low = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(0xFFFFFFFFll)), exponentBits)), twoTo52);
+    __m256d value = _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(high, _mm256_set1_pd(0x1.0p32)), low), _mm256_set1_pd(0x1.0p-53));
+    return antithetic ? _mm256_sub_pd(_mm256_set1_pd(1.0 - 0x1.0p-53), value) : value;
+}
+#endif
+
+void Philox::GenerateUniforms(uint64_t key, uint64_t streamId, uint64_t firstIndex, bool antithetic,
+    double* outValues, size_t count, SimdLevel level)
+{
+    // Short runs aren't worth setting up the vector registers for
+    if (level >= SimdLevel::kAvx2 && count >= 8 && Simd::IsSupported(SimdLevel::kAvx2)) {
+        GenerateUniformsAvx2(key, streamId, firstIndex, antithetic, outValues, count);
+    }
+    else {
+        GenerateUniformsScalar(key, streamId, firstIndex, antithetic, outValues, count);
+    }
+}
+
+void Philox::GenerateExponentials(uint64_t key, uint64_t streamId, uint64_t firstIndex, bool antithetic,
+    double rate, double* outValues, size_t count, SimdLevel level)
+{
+    if (rate <= 0.0) {
+        for (size_t i = 0; i < count; i++) {
+            outValues[i] = std::numeric_limits<double>::infinity();
+        }
+        return;
+    }
+    GenerateUniforms(key, streamId, firstIndex, antithetic, outValues, count, level);
+    for (size_t i = 0; i < count; i++) {
+        outValues[i] = -std::log(1.0 - outValues[i]) / rate;
+    }
+}
+
+void Philox::GenerateUniformsScalar(uint64_t key, uint64_t streamId, uint64_t firstIndex, bool antithetic,
+    double* outValues, size_t count)
+{
+    // Use both halves of every whole block
+    size_t i = 0;
+    if ((firstIndex & 1) && count) {
+        outValues[i++] = ToUniform(Bits(key, streamId, firstIndex), antithetic);
+    }
+    for (; i + 2 <= count; i += 2) {
+        Counter bits = Block(key, streamId, (firstIndex + i) >> 1);
+        outValues[i] = ToUniform(BlockHalf(bits, 0), antithetic);
+        outValues[i + 1] = ToUniform(BlockHalf(bits, 1), antithetic);
+    }
+    if (i < count) {
+        outValues[i] = ToUniform(Bits(key, streamId, firstIndex + i), antithetic);
+    }
+}
+
+J_TARGET_AVX2 void Philox::GenerateUniformsAvx2(uint64_t key, uint64_t streamId, uint64_t firstIndex, bool antithetic,
+    double* outValues, size_t count)
+{
+    size_t i = 0;
+#ifdef J_SIMD_X86
+    // Start on a block boundary, so that each block fills a pair of outputs
+    if ((firstIndex & 1) && count) {
+        outValues[i++] = ToUniform(Bits(key, streamId, firstIndex), antithetic);
+    }
+
+    // Each 64-bit lane holds one 32-bit word of a block's counter, which is what the 32-bit multiplies read
+    const __m256i lowWords = _mm256_set1_epi64x(0xFFFFFFFFll);
+    const __m256i multiplier0 = _mm256_set1_epi64x(s_multipliers[0]);
+    const __m256i multiplier1 = _mm256_set1_epi64x(s_multipliers[1]);
+    const __m256i streamLow = _mm256_set1_epi64x(uint32_t(streamId));
+    const __m256i streamHigh = _mm256_set1_epi64x(uint32_t(streamId >> 32));
+    __m256i roundKeys[s_roundCount][2];
+    Key roundKey{ uint32_t(key), uint32_t(key >> 32) };
+    for (size_t round = 0; round < s_roundCount; round++) {
+        if (round) {
+            roundKey[0] += s_keyIncrements[0];
+            roundKey[1] += s_keyIncrements[1];
+        }
+        roundKeys[round][0] = _mm256_set1_epi64x(roundKey[0]);
+        roundKeys[round][1] = _mm256_set1_epi64x(roundKey[1]);
+    }
+
+    // Four blocks, so eight draws, at a time
+    uint64_t block = (firstIndex + i) >> 1;
+    for (; i + 8 <= count; i += 8, block += 4) {
+        __m256i blocks = _mm256_add_epi64(_mm256_set1_epi64x(int64_t(block)), _mm256_set_epi64x(3, 2, 1, 0));
+        __m256i word0 = _mm256_and_si256(blocks, lowWords);
+        __m256i word1 = _mm256_srli_epi64(blocks, 32);
+        __m256i word2 = streamLow;
+        __m256i word3 = streamHigh;
+        for (size_t round = 0; round < s_roundCount; round++) {
+            __m256i product0 = _mm256_mul_epu32(word0, multiplier0);
+            __m256i product1 = _mm256_mul_epu32(word2, multiplier1);
+            word0 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(product1, 32), word1), roundKeys[round][0]);
+            word1 = _mm256_and_si256(product1, lowWords);
+            word2 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(product0, 32), word3), roundKeys[round][1]);
+            word3 = _mm256_and_si256(product0, lowWords);
+        }
+
+        // The even draws of the four blocks, then the odd ones, interleaved back into draw order
+        __m256d even = ToUniformAvx2(_mm256_or_si256(_mm256_slli_epi64(word1, 32), word0), antithetic);
+        __m256d odd = ToUniformAvx2(_mm256_or_si256(_mm256_slli_epi64(word3, 32), word2), antithetic);
+        __m256d low = _mm256_unpacklo_pd(even, odd);
+        __m256d high = _mm256_unpackhi_pd(even, odd);
+        _mm256_storeu_pd(outValues + i, _mm256_permute2f128_pd(low, high, 0x20));
+        _mm256_storeu_pd(outValues + i + 4, _mm256_permute2f128_pd(low, high, 0x31));
+    }
+
+    // Clear the upper halves of the registers, which compilers don't always do here, since SSE code that runs
+    // while they are dirty can be many times slower, e.g. std::log
+    _mm256_zeroupper();
+#endif
+    GenerateUniformsScalar(key, streamId, firstIndex + i, antithetic, outValues + i, count - i);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
@@ -0,0 +1,140 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef J_PHILOX_H
+#define J_PHILOX_H
+
+// std
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Internal
+#include <core/simd/JSimd.h>
+
+namespace joby {
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Class definitions
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @class Philox
+/// @brief The Philox4x32-10 counter-based random number generator (Salmon et al., "Parallel random numbers:
+/// as easy as 1, 2, 3", 2011)
+/// @details Rather than stepping a state, Philox scrambles a 128-bit counter under a 64-bit key with ten rounds
+/// of multiplies and xors. Any draw can therefore be computed directly from the seed, the stream ID and the index
+/// of the draw, in any order and on any thread, and neighboring draws have no dependency on each other, so whole
+/// runs of them can be generated at once in vector registers.
+/// Each block of 128 bits makes two 64-bit draws: draw i of a stream is half (i % 2) of the block whose counter
+/// holds i / 2 in its low 64 bits and the stream ID in its high 64 bits.
+class Philox {
+public:
+    typedef std::array<uint32_t, 4> Counter;
+    typedef std::array<uint32_t, 2> Key;
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Static
+    /// @{
+
+    /// @brief Scramble a counter under a key, returning 128 random bits
+    static constexpr Counter Generate(Counter counter, Key key) {
+        for (size_t round = 0; round < s_roundCount; round++) {
+            if (round) {
+                key[0] += s_keyIncrements[0];
+                key[1] += s_keyIncrements[1];
+            }
+            uint64_t product0 = uint64_t(s_multipliers[0]) * counter[0];
+            uint64_t product1 = uint64_t(s_multipliers[1]) * counter[2];
+            counter = Counter{
+                uint32_t(product1 >> 32) ^ counter[1] ^ key[0],
+                uint32_t(product1),
+                uint32_t(product0 >> 32) ^ counter[3] ^ key[1],
+                uint32_t(product0)
+            };
+        }
+        return counter;
+    }
+
+    /// @brief The key used for the given seed
+    /// @details The seed is scrambled so that neighboring seeds do not give keys that differ in a single bit
+    static constexpr uint64_t KeyFromSeed(uint64_t seed) {
+        seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ull;
+        seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBull;
+        return seed ^ (seed >> 31);
+    }
+
+    /// @brief The 64 random bits of the given draw from a stream
+    static constexpr uint64_t Bits(uint64_t key, uint64_t streamId, uint64_t index) {
+        return BlockHalf(Block(key, streamId, index >> 1), index & 1);
+    }
+
+    /// @brief Convert 64 random bits to a uniformly distributed double in [0, 1)
+    /// @details Antithetic values are mirrored within [0, 1), so that they keep the same range
+    static constexpr double ToUniform(uint64_t bits, bool antithetic) {
+        double value = double(bits >> 11) * 0x1.0p-53;
+        return antithetic ? (1.0 - 0x1.0p-53) - value : value;
+    }
+
+    /// @brief Generate a run of uniformly distributed doubles in [0, 1) from a stream
+    /// @details Gives exactly the values of ToUniform(Bits(key, streamId, firstIndex + i), antithetic), whichever
+    /// kernel is used
+    /// @param[in] level The kernel to use, which falls back to the next best one if unsupported
+    static void GenerateUniforms(uint64_t key, uint64_t streamId, uint64_t firstIndex, bool antithetic,
+        double* outValues, size_t count, SimdLevel level = Simd::SupportedLevel());
+
+    /// @brief Generate a run of exponentially distributed doubles with the given rate from a stream
+    /// @details Each value is -log(1 - u) / rate for the uniform u of the same draw, so it can be used for the
+    /// time to the next of a series of events that happen at the given rate. A rate of zero gives infinity
+    static void GenerateExponentials(uint64_t key, uint64_t streamId, uint64_t firstIndex, bool antithetic,
+        double rate, double* outValues, size_t count, SimdLevel level = Simd::SupportedLevel());
+
+    /// @}
+
+private:
+    //--------------------------------------------------------------------------------------------
+    /// @name Methods
+    /// @{
+
+    /// @brief The 128 random bits of a block, which make a pair of draws
+    static constexpr Counter Block(uint64_t key, uint64_t streamId, uint64_t block) {
+        return Generate(
+            Counter{ uint32_t(block), uint32_t(block >> 32), uint32_t(streamId), uint32_t(streamId >> 32) },
+            Key{ uint32_t(key), uint32_t(key >> 32) });
+    }
+
+    /// @brief One of the two draws made by a block
+    static constexpr uint64_t BlockHalf(const Counter& bits, uint64_t half) {
+        return half ? (uint64_t(bits[3]) << 32) | bits[2] : (uint64_t(bits[1]) << 32) | bits[0];
+    }
+
+    static void GenerateUniformsScalar(uint64_t key, uint64_t streamId, uint64_t firstIndex, bool antithetic,
+        double* outValues, size_t count);
+    static void GenerateUniformsAvx2(uint64_t key, uint64_t streamId, uint64_t firstIndex, bool antithetic,
+        double* outValues, size_t count);
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    static constexpr size_t s_roundCount = 10;
+    static constexpr uint32_t s_multipliers[2] = { 0xD2511F53u, 0xCD9E8D57u };
+
+    /// @brief The Weyl sequence that the key is bumped by between rounds, from the golden ratio and sqrt(3) - 1
+    static constexpr uint32_t s_keyIncrements[2] = { 0x9E3779B9u, 0xBB67AE85u };
+
+    /// @}
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+} // End namespaces
+
+#endif
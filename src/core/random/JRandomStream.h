@@ -0,0 +1,167 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef J_RANDOM_STREAM_H
+#define J_RANDOM_STREAM_H
+
+// std
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Internal
+#include <core/random/JPhilox.h>
+
+namespace joby {
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Class definitions
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @class RandomStream
+/// @brief A small, fast random number generator that is keyed by a seed and a stream ID
+/// @details Each entity in a simulation draws from its own stream, keyed by the run's seed and the
+/// entity's ID, so the numbers an entity sees do not depend on how many other entities there are or
+/// on the order in which threads happen to run them. The generator is counter-based (see Philox), so its only
+/// state is the index of the next draw: a stream can jump straight to any draw, and can fill a buffer with a run
+/// of draws in vector registers.
+/// A stream may be made antithetic, so that uniform() returns the mirror image 1 - u of every value u that
+/// the stream would otherwise return. Pairing a run with its antithetic twin negatively correlates their
+/// results, which can shrink the variance of their average well below that of two independent runs.
+/// @note This satisfies UniformRandomBitGenerator, so it can drive the std distributions, but those
+/// are implementation-defined. Use uniform() where results must match across platforms
+class RandomStream {
+public:
+    typedef uint64_t result_type;
+    typedef std::array<uint64_t, 3> State;
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Static
+    /// @{
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    /// @brief Scale a uniform value in [0, 1) to an integer in [0, count)
+    static uint64_t ToIndex(double uniform, uint64_t count) {
+        return uint64_t(uniform * double(count)) % count;
+    }
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Constructors/Destructor
+    /// @{
+
+    RandomStream(uint64_t seed = 0, uint64_t streamId = 0) {
+        reseed(seed, streamId);
+    }
+    ~RandomStream() {}
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Operators
+    /// @{
+
+    bool operator==(const RandomStream& other) const { return state() == other.state(); }
+    bool operator!=(const RandomStream& other) const { return state() != other.state(); }
+
+    /// @brief Generate the next 64 random bits
+    result_type operator()() {
+        return Philox::Bits(m_key, m_streamId, m_index++);
+    }
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Public methods
+    /// @{
+
+    /// @brief Restart the stream for the given key
+    void reseed(uint64_t seed, uint64_t streamId) {
+        m_key = Philox::KeyFromSeed(seed);
+        m_streamId = streamId;
+        m_index = 0;
+    }
+
+    /// @brief A uniformly distributed double in [0, 1)
+    double uniform() {
+        return Philox::ToUniform((*this)(), m_antithetic);
+    }
+
+    /// @brief A uniformly distributed integer in [0, count)
+    uint64_t uniformIndex(uint64_t count) {
+        return ToIndex(uniform(), count);
+    }
+
+    /// @brief An exponentially distributed double, e.g. the time to the next of a series of events that happen at
+    /// the given rate. A rate of zero gives infinity
+    double exponential(double rate) {
+        double value = uniform();
+        return rate > 0.0 ? -std::log(1.0 - value) / rate : std::numeric_limits<double>::infinity();
+    }
+
+    /// @brief Fill a buffer with the next count values that uniform() would return, generated all at once
+    void uniforms(double* outValues, size_t count) {
+        Philox::GenerateUniforms(m_key, m_streamId, m_index, m_antithetic, outValues, count);
+        m_index += count;
+    }
+
+    /// @brief Fill a buffer with the next count values that exponential() would return, generated all at once
+    void exponentials(double rate, double* outValues, size_t count) {
+        Philox::GenerateExponentials(m_key, m_streamId, m_index, m_antithetic, rate, outValues, count);
+        m_index += count;
+    }
+
+    /// @brief The index of the next draw from the stream
+    /// @details Setting this jumps straight to that draw, without generating the ones in between
+    uint64_t index() const { return m_index; }
+    void setIndex(uint64_t index) { m_index = index; }
+
+    /// @brief Whether uniform values are mirrored, see class description
+    bool isAntithetic() const { return m_antithetic; }
+    void setAntithetic(bool antithetic) { m_antithetic = antithetic; }
+
+    /// @brief The internal state of the generator, e.g. for checkpointing
+    State state() const { return State{ m_key, m_streamId, m_index }; }
+    void setState(const State& state) {
+        m_key = state[0];
+        m_streamId = state[1];
+        m_index = state[2];
+    }
+
+    /// @}
+
+private:
+    //--------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    /// @brief The Philox key, made from the seed
+    uint64_t m_key;
+
+    uint64_t m_streamId;
+
+    /// @brief The index of the next draw
+    uint64_t m_index;
+
+    /// @brief Whether uniform values are mirrored
+    bool m_antithetic = false;
+
+    /// @}
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+} // End namespaces
+
+#endif
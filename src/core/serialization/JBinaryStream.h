@@ -0,0 +1,214 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef J_BINARY_STREAM_H
+#define J_BINARY_STREAM_H
+
+// std
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace joby {
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Class definitions
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @class BinaryWriter
+/// @brief Appends values to a growable byte buffer, in native byte order
+/// @details Values are copied bit-for-bit, so that state read back with a BinaryReader is identical to the
+/// state that was written. The buffer keeps its capacity when cleared, so repeated snapshots of the same
+/// state do not allocate
+class BinaryWriter {
+public:
+    //--------------------------------------------------------------------------------------------
+    /// @name Constructors/Destructor
+    /// @{
+
+    BinaryWriter() {}
+    ~BinaryWriter() {}
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    std::vector<char>& buffer() { return m_buffer; }
+    const std::vector<char>& buffer() const { return m_buffer; }
+
+    size_t size() const { return m_buffer.size(); }
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Public methods
+    /// @{
+
+    /// @brief Empty the buffer, retaining its capacity
+    void clear() { m_buffer.clear(); }
+
+    /// @brief Exchange buffers with another writer, without copying
+    void swap(BinaryWriter& other) { m_buffer.swap(other.m_buffer); }
+
+    /// @brief Append raw bytes
+    void write(const void* data, size_t size) {
+        size_t offset = m_buffer.size();
+        m_buffer.resize(offset + size);
+        if (size) {
+            std::memcpy(m_buffer.data() + offset, data, size);
+        }
+    }
+
+    /// @brief Append the bytes of a value
+    template<typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Error, can only write trivially copyable values");
+        write(&value, sizeof(T));
+    }
+
+    /// @brief Append a string, prefixed by its length
+    void writeString(const std::string& value) {
+        write(uint64_t(value.size()));
+        write(value.data(), value.size());
+    }
+
+    /// @brief Append a vector of values, prefixed by its length
+    template<typename T>
+    void writeVector(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>, "Error, can only write trivially copyable values");
+        write(uint64_t(values.size()));
+        write(values.data(), values.size() * sizeof(T));
+    }
+
+    /// @}
+
+private:
+    //--------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    std::vector<char> m_buffer;
+
+    /// @}
+};
+
+
+/// @class BinaryReader
+/// @brief Reads values written by a BinaryWriter back out of a byte buffer
+/// @details Reading past the end of the buffer throws, so that truncated or corrupt data is never
+/// silently turned into state
+class BinaryReader {
+public:
+    //--------------------------------------------------------------------------------------------
+    /// @name Constructors/Destructor
+    /// @{
+
+    BinaryReader(const char* data, size_t size):
+        m_data(data),
+        m_size(size)
+    {
+    }
+    BinaryReader(const std::vector<char>& buffer):
+        BinaryReader(buffer.data(), buffer.size())
+    {
+    }
+
+    /// @note The reader does not own its data, so it may not be constructed from a temporary buffer
+    BinaryReader(std::vector<char>&& buffer) = delete;
+    ~BinaryReader() {}
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    /// @brief The number of bytes left to read
+    size_t remaining() const { return m_size - m_position; }
+    bool atEnd() const { return m_position == m_size; }
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Public methods
+    /// @{
+
+    /// @brief Read raw bytes
+    void read(void* data, size_t size) {
+        if (size > remaining()) {
+            throw std::runtime_error("Error, unexpected end of binary data");
+        }
+        if (size) {
+            std::memcpy(data, m_data + m_position, size);
+        }
+        m_position += size;
+    }
+
+    /// @brief Read the bytes of a value
+    template<typename T>
+    void read(T& outValue) {
+        static_assert(std::is_trivially_copyable_v<T>, "Error, can only read trivially copyable values");
+        read(&outValue, sizeof(T));
+    }
+
+    template<typename T>
+    T read() {
+        static_assert(std::is_default_constructible_v<T>, "Error, use read(T&) for types without a default constructor");
+        T value;
+        read(value);
+        return value;
+    }
+
+    /// @brief Read a length-prefixed string
+    std::string readString() {
+        uint64_t size = read<uint64_t>();
+        if (size > remaining()) {
+            throw std::runtime_error("Error, unexpected end of binary data");
+        }
+        std::string value(m_data + m_position, size_t(size));
+        m_position += size_t(size);
+        return value;
+    }
+
+    /// @brief Read a length-prefixed vector of values
+    template<typename T>
+    void readVector(std::vector<T>& outValues) {
+        static_assert(std::is_trivially_copyable_v<T>, "Error, can only read trivially copyable values");
+        uint64_t count = read<uint64_t>();
+        if (count > remaining() / sizeof(T)) {
+            throw std::runtime_error("Error, unexpected end of binary data");
+        }
+        outValues.resize(size_t(count));
+        read(outValues.data(), size_t(count) * sizeof(T));
+    }
+
+    /// @}
+
+private:
+    //--------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    const char* m_data;
+    size_t m_size;
+    size_t m_position = 0;
+
+    /// @}
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+} // End namespaces
+
+#endif
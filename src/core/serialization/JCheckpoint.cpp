@@ -0,0 +1,167 @@
+#include "JCheckpoint.h"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <core/diagnostics/JRunHash.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Checkpoint
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief The header at the start of every checkpoint file
+struct CheckpointHeader {
+    uint32_t m_magic;
+    uint32_t m_version;
+    uint64_t m_payloadSize;
+    uint64_t m_payloadHash;
+};
+
+void Checkpoint::Write(const std::string & path, const std::vector<char>& payload)
+{
+    RunHash hash;
+    hash.add(payload.data(), payload.size());
+    CheckpointHeader header{ s_magic, s_version, payload.size(), hash.value() };
+
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(payload.data(), payload.size());
+        if (!file) {
+            throw std::runtime_error("Error, failed to write checkpoint " + temporaryPath);
+        }
+    }
+
+    // Replace the old checkpoint only once the new one is complete, in a single step, so that one of the two is
+    // always in place
+#ifdef _WIN32
+    bool moved = MoveFileExA(temporaryPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    bool moved = std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+#endif
+    if (!moved) {
+        throw std::runtime_error("Error, failed to move checkpoint into place at " + path);
+    }
+}
+
+std::vector<char> Checkpoint::Read(const std::string & path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Error, could not open checkpoint " + path);
+    }
+
+    CheckpointHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.m_magic != s_magic) {
+        throw std::runtime_error("Error, " + path + " is not a checkpoint file");
+    }
+    if (header.m_version != s_version) {
+        throw std::runtime_error("Error, checkpoint " + path + " is from an unsupported version");
+    }
+
+    std::vector<char> payload(size_t(header.m_payloadSize));
+    file.read(payload.data(), payload.size());
+    RunHash hash;
+    hash.add(payload.data(), payload.size());
+    if (!file || hash.value() != header.m_payloadHash) {
+        throw std::runtime_error("Error, checkpoint " + path + " is corrupt");
+    }
+    return payload;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// CheckpointWriter
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+CheckpointWriter::CheckpointWriter():
+    m_thread(&CheckpointWriter::writeLoop, this)
+{
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_controller.notify_all();
+    m_thread.join();
+}
+
+size_t CheckpointWriter::writtenCount() const
+{
+    std::unique_lock lock(m_mutex);
+    return m_writtenCount;
+}
+
+BinaryWriter & CheckpointWriter::beginSnapshot()
+{
+    // The front buffer is only ever touched by the simulation thread
+    m_front.clear();
+    return m_front;
+}
+
+void CheckpointWriter::commit(const std::string & path)
+{
+    std::unique_lock lock(m_mutex);
+    m_controller.wait(lock, [this] { return !m_pending; });
+    m_front.swap(m_back);
+    m_backPath = path;
+    m_pending = true;
+    lock.unlock();
+    m_controller.notify_all();
+}
+
+void CheckpointWriter::flush()
+{
+    std::unique_lock lock(m_mutex);
+    m_controller.wait(lock, [this] { return !m_pending; });
+    if (m_exceptionPtr) {
+        std::exception_ptr exceptionPtr = m_exceptionPtr;
+        m_exceptionPtr = nullptr;
+        std::rethrow_exception(exceptionPtr);
+    }
+}
+
+void CheckpointWriter::writeLoop()
+{
+    std::unique_lock lock(m_mutex);
+    while (true) {
+        m_controller.wait(lock, [this] { return m_pending || m_shutdown; });
+        if (!m_pending) {
+            break;
+        }
+
+        // Write without holding the lock, so that the simulation thread can keep serializing
+        lock.unlock();
+        std::exception_ptr exceptionPtr;
+        try {
+            Checkpoint::Write(m_backPath, m_back.buffer());
+        }
+        catch (...) {
+            exceptionPtr = std::current_exception();
+        }
+        lock.lock();
+
+        if (exceptionPtr && !m_exceptionPtr) {
+            m_exceptionPtr = exceptionPtr;
+        }
+        else if (!exceptionPtr) {
+            m_writtenCount++;
+        }
+        m_pending = false;
+        m_controller.notify_all();
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
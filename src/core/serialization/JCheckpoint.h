@@ -0,0 +1,156 @@
+#ifndef J_CHECKPOINT_H
+#define J_CHECKPOINT_H
+/** @file JCheckpoint.h
+    Defines a versioned checkpoint file format, and a writer that saves checkpoints in the background
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <core/serialization/JBinaryStream.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @class Checkpoint
+/// @brief Reads and writes checkpoint files
+/// @details A checkpoint file is a small header, holding a magic number, the format version, the payload
+/// size and a hash of the payload, followed by the payload itself. Files are written to a temporary path and
+/// then renamed, so a crash mid-write never clobbers the previous checkpoint
+class Checkpoint {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Methods
+    /// @{
+
+    /// @brief Write a payload to a checkpoint file
+    static void Write(const std::string& path, const std::vector<char>& payload);
+
+    /// @brief Read the payload of a checkpoint file
+    /// @details Throws if the file is missing, from a different format version, or corrupt
+    static std::vector<char> Read(const std::string& path);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Members
+    /// @{
+
+    /// @brief Identifies checkpoint files, reading "JCKP" in a hex dump
+    static constexpr uint32_t s_magic = 0x504B434A;
+
+    /// @brief The format version, bumped whenever the layout of any saved state changes
+    static constexpr uint32_t s_version = 9;
+
+    /// @}
+};
+
+
+/// @class CheckpointWriter
+/// @brief Writes checkpoints on a background thread, so that the simulation loop does not wait on the disk
+/// @details The writer is double-buffered. The simulation thread serializes its state into the front buffer,
+/// which is a fast in-memory copy, and then commits it. The front and back buffers are swapped, and the
+/// background thread writes the back buffer out while the simulation carries on. Buffers are reused, so
+/// snapshots of a steady-size state do not allocate. Committing only waits if the previous checkpoint is
+/// still being written.
+class CheckpointWriter {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    CheckpointWriter();
+
+    /// @brief Finishes writing any committed checkpoint
+    ~CheckpointWriter();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    /// @brief The number of checkpoints written to disk
+    size_t writtenCount() const;
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief An empty buffer to serialize the next snapshot into, from the simulation thread
+    BinaryWriter& beginSnapshot();
+
+    /// @brief Hand the snapshot over to the background thread, to be written to the given path
+    void commit(const std::string& path);
+
+    /// @brief Wait for any committed checkpoint to be written, rethrowing any error from writing it
+    void flush();
+
+	/// @}
+
+protected:
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Methods
+    /// @{
+
+    /// @brief The loop run by the background thread
+    void writeLoop();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    /// @brief The buffer being filled by the simulation thread
+    BinaryWriter m_front;
+
+    /// @brief The buffer being written by the background thread
+    BinaryWriter m_back;
+
+    /// @brief The path to write the back buffer to
+    std::string m_backPath;
+
+    /// @brief Whether the back buffer holds a checkpoint waiting to be written
+    bool m_pending = false;
+
+    /// @brief Whether the background thread should exit
+    bool m_shutdown = false;
+
+    /// @brief The number of checkpoints written
+    size_t m_writtenCount = 0;
+
+    /// @brief The first error raised while writing
+    std::exception_ptr m_exceptionPtr;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_controller;
+    std::thread m_thread;
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
@@ -0,0 +1,103 @@
+#include "JConfigFile.h"
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ConfigSection
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+const ConfigEntry * ConfigSection::entry(std::string_view key) const
+{
+    for (const ConfigEntry& entry : m_entries) {
+        if (entry.m_key == key) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+std::string_view ConfigSection::value(std::string_view key) const
+{
+    const ConfigEntry* found = entry(key);
+    if (!found) {
+        throw error(m_line, "missing " + std::string(key));
+    }
+    return found->m_value;
+}
+
+std::runtime_error ConfigSection::error(size_t line, const std::string & message) const
+{
+    return std::runtime_error("Error, " + *m_source + ":" + std::to_string(line) + ": " + message);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ConfigFile
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+ConfigFile ConfigFile::Load(const std::string & path)
+{
+    ConfigFile file;
+    file.m_sourceName = std::make_unique<std::string>(path);
+    file.m_file.open(path);
+    file.parse(file.m_file.view());
+    return file;
+}
+
+ConfigFile ConfigFile::Parse(std::string text, const std::string & sourceName)
+{
+    ConfigFile file;
+    file.m_sourceName = std::make_unique<std::string>(sourceName);
+    file.m_text = std::make_unique<std::string>(std::move(text));
+    file.parse(*file.m_text);
+    return file;
+}
+
+const ConfigSection * ConfigFile::section(std::string_view name) const
+{
+    for (const ConfigSection& section : m_sections) {
+        if (section.name() == name) {
+            return &section;
+        }
+    }
+    return nullptr;
+}
+
+void ConfigFile::parse(std::string_view text)
+{
+    // Entries before the first header belong to an unnamed section
+    m_sections.emplace_back(std::string_view(), 0, m_sourceName.get());
+    size_t lineNumber = 0;
+    while (!text.empty()) {
+        lineNumber++;
+        std::string_view line = JString::NextToken(text, '\n');
+        line = JString::Trim(line.substr(0, line.find_first_of("#;")));
+        if (line.empty()) {
+            continue;
+        }
+
+        if (line.front() == '[') {
+            if (line.back() != ']') {
+                throw m_sections.back().error(lineNumber, "unterminated section header");
+            }
+            m_sections.emplace_back(JString::Trim(line.substr(1, line.size() - 2)), lineNumber, m_sourceName.get());
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string_view::npos) {
+            throw m_sections.back().error(lineNumber, "expected key = value");
+        }
+        ConfigEntry entry{ JString::Trim(line.substr(0, equals)), JString::Trim(line.substr(equals + 1)), lineNumber };
+        if (entry.m_key.empty()) {
+            throw m_sections.back().error(lineNumber, "missing key");
+        }
+        m_sections.back().addEntry(entry);
+    }
+
+    if (m_sections.front().entries().empty()) {
+        m_sections.erase(m_sections.begin());
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
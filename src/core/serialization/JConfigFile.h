@@ -0,0 +1,212 @@
+#ifndef J_CONFIG_FILE_H
+#define J_CONFIG_FILE_H
+/** @file JConfigFile.h
+    Defines a parser for INI-style configuration files
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <core/containers/JString.h>
+#include <core/serialization/JMappedFile.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief A "key = value" line of a configuration file
+struct ConfigEntry {
+    std::string_view m_key;
+    std::string_view m_value;
+    size_t m_line; // The line number in the file, counting from one
+};
+
+/// @class ConfigSection
+/// @brief The entries under a "[name]" header of a configuration file, in the order they appear
+class ConfigSection {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    ConfigSection(std::string_view name, size_t line, const std::string* source):
+        m_name(name),
+        m_line(line),
+        m_source(source)
+    {
+    }
+    ~ConfigSection() {}
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    std::string_view name() const { return m_name; }
+    size_t line() const { return m_line; }
+    const std::vector<ConfigEntry>& entries() const { return m_entries; }
+
+    /// @brief The entry with the given key, or null if there is none
+    const ConfigEntry* entry(std::string_view key) const;
+
+    bool has(std::string_view key) const { return entry(key) != nullptr; }
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief The value of a key, throwing if it is missing
+    std::string_view value(std::string_view key) const;
+
+    /// @brief The value of a key, or the fallback if it is missing
+    std::string_view value(std::string_view key, std::string_view fallback) const {
+        const ConfigEntry* found = entry(key);
+        return found ? found->m_value : fallback;
+    }
+
+    /// @brief The value of a key as a number, throwing if it is missing or not a number
+    template<typename T>
+    T number(std::string_view key) const {
+        const ConfigEntry* found = entry(key);
+        if (!found) {
+            throw error(m_line, "missing " + std::string(key));
+        }
+        return toNumber<T>(*found);
+    }
+
+    /// @brief The value of a key as a number, or the fallback if it is missing. Throws if it isn't a number
+    template<typename T>
+    T number(std::string_view key, T fallback) const {
+        const ConfigEntry* found = entry(key);
+        return found ? toNumber<T>(*found) : fallback;
+    }
+
+    /// @brief An error about the given line of the file the section is from
+    std::runtime_error error(size_t line, const std::string& message) const;
+
+    void addEntry(const ConfigEntry& entry) { m_entries.push_back(entry); }
+
+	/// @}
+
+protected:
+
+    template<typename T>
+    T toNumber(const ConfigEntry& entry) const {
+        T result;
+        if (!JString::ToNumber(entry.m_value, result)) {
+            throw error(entry.m_line, std::string(entry.m_key) + " is not a valid number: " + std::string(entry.m_value));
+        }
+        return result;
+    }
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    std::string_view m_name;
+    size_t m_line;
+
+    /// @brief The name of the file the section is from, for errors
+    const std::string* m_source;
+
+    std::vector<ConfigEntry> m_entries;
+
+    /// @}
+
+};
+
+/// @class ConfigFile
+/// @brief Parses INI-style configuration files, made up of "[section]" headers followed by "key = value" lines
+/// @details Sections may repeat, e.g. one per company, and keep the order of the file. Anything after a '#' or
+/// ';' is a comment, and whitespace around keys and values is ignored. Files are memory-mapped and parsed in a
+/// single pass, and every name, key and value is a view into the mapped file, so nothing is copied. Views are
+/// valid for as long as the ConfigFile that they came from
+class ConfigFile {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Methods
+    /// @{
+
+    /// @brief Map and parse the file at the given path
+    static ConfigFile Load(const std::string& path);
+
+    /// @brief Parse configuration text held in memory, e.g. for tests
+    static ConfigFile Parse(std::string text, const std::string& sourceName = "<text>");
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    ConfigFile() {}
+    ~ConfigFile() {}
+
+    ConfigFile(ConfigFile&&) = default;
+    ConfigFile& operator=(ConfigFile&&) = default;
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    /// @brief The path of the file, or the name given to parsed text
+    const std::string& sourceName() const { return *m_sourceName; }
+
+    const std::vector<ConfigSection>& sections() const { return m_sections; }
+
+    /// @brief The first section with the given name, or null if there is none
+    const ConfigSection* section(std::string_view name) const;
+
+    /// @}
+
+protected:
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Methods
+    /// @{
+
+    /// @brief Split the text into sections and entries
+    void parse(std::string_view text);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    /// @brief The mapped file, or the parsed text, that every view points into
+    MappedFile m_file;
+    std::unique_ptr<std::string> m_text;
+
+    /// @brief Kept on the heap, so that sections can refer to it however the file is moved
+    std::unique_ptr<std::string> m_sourceName;
+
+    std::vector<ConfigSection> m_sections;
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
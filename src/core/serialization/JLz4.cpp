@@ -0,0 +1,149 @@
+#include "JLz4.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t Read32(const char* data)
+{
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+/// @brief Append a length that doesn't fit in its four bits of the token, as a run of 255s and a remainder
+static void WriteLength(size_t length, char*& out)
+{
+    for (; length >= 255; length -= 255) {
+        *out++ = char(255);
+    }
+    *out++ = char(length);
+}
+
+/// @brief Read the rest of a length whose four bits in the token were all set
+static size_t ReadLength(const uint8_t*& in, const uint8_t* end)
+{
+    size_t length = 0;
+    uint8_t byte;
+    do {
+        if (in == end) {
+            throw std::runtime_error("Error, truncated LZ4 block");
+        }
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return length;
+}
+
+/// @brief Append a sequence of literals followed by a match, or just literals if the match length is zero
+static void WriteSequence(const char* literals, size_t literalCount, size_t offset, size_t matchLength, char*& out)
+{
+    char* token = out++;
+    size_t matchCode = matchLength ? matchLength - 4 : 0;
+    *token = char(((literalCount < 15 ? literalCount : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+    if (literalCount >= 15) {
+        WriteLength(literalCount - 15, out);
+    }
+    std::memcpy(out, literals, literalCount);
+    out += literalCount;
+    if (!matchLength) {
+        return;
+    }
+    *out++ = char(offset & 0xFF);
+    *out++ = char(offset >> 8);
+    if (matchCode >= 15) {
+        WriteLength(matchCode - 15, out);
+    }
+}
+
+size_t Lz4::Compress(const char * data, size_t size, std::vector<char>& out)
+{
+    size_t start = out.size();
+    out.resize(start + MaxCompressedSize(size));
+    char* output = out.data() + start;
+
+    // Positions are stored plus one, so that zero means empty
+    std::vector<uint32_t> table(size_t(1) << s_hashBits, 0);
+    size_t anchor = 0;
+    if (size > s_matchStartLimit) {
+        const size_t matchStartLimit = size - s_matchStartLimit;
+        const size_t matchEndLimit = size - s_lastLiterals;
+        size_t position = 0;
+        while (position < matchStartLimit) {
+            uint32_t sequence = Read32(data + position);
+            uint32_t hash = (sequence * 2654435761u) >> (32 - s_hashBits);
+            size_t candidate = table[hash];
+            table[hash] = uint32_t(position + 1);
+            if (!candidate || position - (candidate - 1) > 0xFFFF || Read32(data + candidate - 1) != sequence) {
+                position++;
+                continue;
+            }
+            candidate--;
+
+            size_t matchLength = s_minMatch;
+            while (position + matchLength < matchEndLimit && data[candidate + matchLength] == data[position + matchLength]) {
+                matchLength++;
+            }
+            WriteSequence(data + anchor, position - anchor, position - candidate, matchLength, output);
+            position += matchLength;
+            anchor = position;
+        }
+    }
+    WriteSequence(data + anchor, size - anchor, 0, 0, output);
+
+    size_t written = size_t(output - (out.data() + start));
+    out.resize(start + written);
+    return written;
+}
+
+void Lz4::Decompress(const char * data, size_t size, char * out, size_t outSize)
+{
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* inEnd = in + size;
+    size_t written = 0;
+    while (in < inEnd) {
+        uint8_t token = *in++;
+        size_t literalCount = token >> 4;
+        if (literalCount == 15) {
+            literalCount += ReadLength(in, inEnd);
+        }
+        if (literalCount > size_t(inEnd - in) || literalCount > outSize - written) {
+            throw std::runtime_error("Error, corrupt LZ4 block");
+        }
+        std::memcpy(out + written, in, literalCount);
+        in += literalCount;
+        written += literalCount;
+
+        // The last sequence has no match
+        if (in == inEnd) {
+            break;
+        }
+        if (inEnd - in < 2) {
+            throw std::runtime_error("Error, truncated LZ4 block");
+        }
+        size_t offset = size_t(in[0]) | (size_t(in[1]) << 8);
+        in += 2;
+        size_t matchLength = (token & 0xF) + s_minMatch;
+        if ((token & 0xF) == 15) {
+            matchLength += ReadLength(in, inEnd);
+        }
+        if (!offset || offset > written || matchLength > outSize - written) {
+            throw std::runtime_error("Error, corrupt LZ4 block");
+        }
+
+        // Matches may overlap the bytes they produce, e.g. a run of one repeated byte, so copy forwards
+        const char* match = out + written - offset;
+        for (size_t i = 0; i < matchLength; i++) {
+            out[written + i] = match[i];
+        }
+        written += matchLength;
+    }
+    if (written != outSize) {
+        throw std::runtime_error("Error, LZ4 block decompressed to the wrong size");
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
@@ -0,0 +1,74 @@
+#ifndef J_LZ4_H
+#define J_LZ4_H
+/** @file JLz4.h
+    Defines a compressor for blocks of bytes, in the LZ4 block format
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @class Lz4
+/// @brief Compresses blocks of bytes in the LZ4 block format (Collet), trading ratio for speed
+/// @details Each block is a run of sequences, each some literal bytes followed by a copy of at least four
+/// earlier bytes, up to 64KB back. Matches are found with a single-probe hash table, so compression makes one
+/// pass and decompression is little more than memcpy. Suits columns of small integers, e.g. IDs and states,
+/// far better than raw floating point values
+class Lz4 {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Methods
+    /// @{
+
+    /// @brief Compress a block, appending it to the output
+    /// @return The number of bytes appended, which may be a little more than the input for incompressible data
+    static size_t Compress(const char* data, size_t size, std::vector<char>& out);
+
+    /// @brief Decompress a block into a buffer of exactly its original size
+    /// @details Throws if the block is corrupt, or doesn't decompress to exactly the given size
+    static void Decompress(const char* data, size_t size, char* out, size_t outSize);
+
+    /// @brief The most bytes that compressing a block of the given size can produce
+    static size_t MaxCompressedSize(size_t size) { return size + size / 255 + 16; }
+
+    /// @}
+
+protected:
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Members
+    /// @{
+
+    /// @brief The shortest match worth encoding
+    static constexpr size_t s_minMatch = 4;
+
+    /// @brief The format requires the last five bytes to be literals, and the last match to start twelve before the end
+    static constexpr size_t s_lastLiterals = 5;
+    static constexpr size_t s_matchStartLimit = 12;
+
+    /// @brief The number of bits hashed to index the table of earlier positions
+    static constexpr uint32_t s_hashBits = 12;
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
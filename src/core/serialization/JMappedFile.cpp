@@ -0,0 +1,144 @@
+#include "JMappedFile.h"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+MappedFile::MappedFile(const std::string & path)
+{
+    open(path);
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile && other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile & MappedFile::operator=(MappedFile && other) noexcept
+{
+    if (this != &other) {
+        close();
+        m_path = std::move(other.m_path);
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_fileHandle = std::exchange(other.m_fileHandle, nullptr);
+        m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+        other.m_path.clear();
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+void MappedFile::open(const std::string & path)
+{
+    close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Error, could not open " + path);
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("Error, could not read the size of " + path);
+    }
+    m_path = path;
+    m_fileHandle = file;
+    m_size = size_t(size.QuadPart);
+    if (!m_size) {
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    m_mappingHandle = mapping;
+    if (!data) {
+        close();
+        throw std::runtime_error("Error, could not map " + path);
+    }
+    m_data = static_cast<const char*>(data);
+}
+
+void MappedFile::close()
+{
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mappingHandle) {
+        CloseHandle(m_mappingHandle);
+    }
+    if (m_fileHandle) {
+        CloseHandle(m_fileHandle);
+    }
+    m_path.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_fileHandle = nullptr;
+    m_mappingHandle = nullptr;
+}
+
+#else
+
+void MappedFile::open(const std::string & path)
+{
+    close();
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        throw std::runtime_error("Error, could not open " + path);
+    }
+    struct stat status;
+    if (fstat(file, &status) != 0) {
+        ::close(file);
+        throw std::runtime_error("Error, could not read the size of " + path);
+    }
+    m_size = size_t(status.st_size);
+    if (m_size) {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (data == MAP_FAILED) {
+            ::close(file);
+            m_size = 0;
+            throw std::runtime_error("Error, could not map " + path);
+        }
+        madvise(data, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char*>(data);
+    }
+
+    // The mapping keeps the file alive, so the descriptor isn't needed past here
+    ::close(file);
+    m_path = path;
+}
+
+void MappedFile::close()
+{
+    if (m_data) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+    m_path.clear();
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
@@ -0,0 +1,97 @@
+#ifndef J_MAPPED_FILE_H
+#define J_MAPPED_FILE_H
+/** @file JMappedFile.h
+    Defines a read-only view of a file that is mapped into memory
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <string>
+#include <string_view>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @class MappedFile
+/// @brief Maps the whole of a file into memory, read-only, for as long as the object lives
+/// @details Pages are read in by the OS as they are first touched, so parsing a mapped file makes a single
+/// pass over it, with no copy into a buffer of our own. Views of the contents stay valid until the file is
+/// closed, or the object destroyed. Empty files map to an empty view
+class MappedFile {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    MappedFile() {}
+
+    /// @brief Map the file at the given path, throwing if it can't be opened
+    MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    const std::string& path() const { return m_path; }
+
+    /// @brief The contents of the file
+    std::string_view view() const { return std::string_view(m_data, m_size); }
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool isOpen() const { return !m_path.empty(); }
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Map the file at the given path, closing any file already mapped
+    void open(const std::string& path);
+
+    /// @brief Unmap the file, invalidating any views of it
+    void close();
+
+	/// @}
+
+protected:
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    std::string m_path;
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+
+    /// @brief The OS handles of the file and its mapping, where the OS needs them to be kept open
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
@@ -0,0 +1,388 @@
+#include "JTable.h"
+#include <algorithm>
+#include <charconv>
+#include <core/serialization/JLz4.h>
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Table
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TableFormat Table::FormatOf(const std::string & path)
+{
+    const std::string extension = ".csv";
+    bool isCsv = path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+    return isCsv ? TableFormat::kCsv : TableFormat::kColumnar;
+}
+
+/// @brief Append text to a CSV row, quoting it if it holds a delimiter, quote or line break
+static void AppendCsvText(std::string& row, std::string_view text)
+{
+    if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+        row.append(text);
+        return;
+    }
+    row.push_back('"');
+    for (char character : text) {
+        if (character == '"') {
+            row.push_back('"');
+        }
+        row.push_back(character);
+    }
+    row.push_back('"');
+}
+
+/// @brief Append a number to a CSV row with to_chars, which is exact, ignores the locale, and never allocates
+template<typename T>
+static void AppendCsvNumber(std::string& row, T value)
+{
+    // The shortest round-trip form of a double takes at most 24 characters, and a 64-bit integer 20
+    char buffer[32];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    row.append(buffer, result.ptr);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// TableWriter
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TableWriter::TableWriter(const std::string & path, const std::vector<TableColumn>& columns, TableFormat format, bool append,
+    size_t batchRowCount):
+    m_file(path, std::ios::binary | (append ? std::ios::app : std::ios::trunc)),
+    m_path(path),
+    m_columns(columns),
+    m_format(format),
+    m_batchRowCount(std::max(batchRowCount, size_t(1)))
+{
+    if (!m_file) {
+        throw std::runtime_error("Error, could not open " + path + " for writing");
+    }
+    if (columns.empty()) {
+        throw std::invalid_argument("Error, table " + path + " needs columns");
+    }
+
+    m_file.seekp(0, std::ios::end);
+    if (m_file.tellp() == std::streampos(0)) {
+        if (m_format == TableFormat::kCsv) {
+            for (size_t i = 0; i < m_columns.size(); i++) {
+                if (i) {
+                    m_text.push_back(',');
+                }
+                AppendCsvText(m_text, m_columns[i].m_name);
+            }
+            m_text.push_back('\n');
+            m_file.write(m_text.data(), m_text.size());
+            m_writtenBytes = m_text.size();
+        }
+        else {
+            BinaryWriter header;
+            header.write(Table::s_magic);
+            header.write(Table::s_version);
+            header.write(uint64_t(m_columns.size()));
+            for (const TableColumn& column : m_columns) {
+                header.writeString(column.m_name);
+                header.write(uint8_t(column.m_type));
+            }
+            m_file.write(header.buffer().data(), header.size());
+            m_writtenBytes = header.size();
+        }
+    }
+
+    m_front.m_columns.resize(m_columns.size());
+    m_back.m_columns.resize(m_columns.size());
+    m_thread = std::thread(&TableWriter::writeLoop, this);
+}
+
+TableWriter::~TableWriter()
+{
+    try {
+        flush();
+    }
+    catch (const std::exception&) {
+        // Errors can't leave a destructor, and flush() is there to see them
+    }
+    {
+        std::unique_lock lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+size_t TableWriter::writtenBytes() const
+{
+    std::unique_lock lock(m_mutex);
+    return m_writtenBytes;
+}
+
+void TableWriter::endRow()
+{
+    if (m_nextColumn != m_columns.size()) {
+        throw std::logic_error("Error, row is missing values for the columns of table " + m_path);
+    }
+    m_nextColumn = 0;
+    m_rowCount++;
+    if (++m_front.m_rowCount == m_batchRowCount) {
+        submit();
+    }
+}
+
+void TableWriter::flush()
+{
+    if (m_front.m_rowCount) {
+        submit();
+    }
+
+    std::unique_lock lock(m_mutex);
+    m_written.wait(lock, [this]() { return !m_backPending; });
+    m_file.flush();
+    if (!m_file && !m_exception) {
+        m_exception = std::make_exception_ptr(std::runtime_error("Error, failed to write " + m_path));
+    }
+    if (m_exception) {
+        std::exception_ptr exception = m_exception;
+        m_exception = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
+
+void TableWriter::submit()
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_written.wait(lock, [this]() { return !m_backPending; });
+        std::swap(m_front, m_back);
+        m_backPending = true;
+    }
+    m_wake.notify_one();
+    m_front.clear();
+}
+
+void TableWriter::writeLoop()
+{
+    std::unique_lock lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this]() { return m_shutdown || m_backPending; });
+        if (!m_backPending) {
+            return;
+        }
+        lock.unlock();
+
+        // Write outside of the lock, while the next batch fills
+        std::exception_ptr exception;
+        size_t writtenBytes = 0;
+        try {
+            writeBatch(m_back);
+            writtenBytes = m_format == TableFormat::kCsv ? m_text.size() : m_encoded.size();
+        }
+        catch (...) {
+            exception = std::current_exception();
+        }
+
+        lock.lock();
+        m_backPending = false;
+        m_writtenBytes += writtenBytes;
+        if (exception && !m_exception) {
+            m_exception = exception;
+        }
+        m_written.notify_all();
+    }
+}
+
+void TableWriter::writeBatch(const TableBatch & batch)
+{
+    if (m_format == TableFormat::kCsv) {
+        writeCsv(batch);
+        m_file.write(m_text.data(), m_text.size());
+    }
+    else {
+        writeColumnar(batch);
+        m_file.write(m_encoded.buffer().data(), m_encoded.size());
+    }
+    if (!m_file) {
+        throw std::runtime_error("Error, failed to write " + m_path);
+    }
+}
+
+void TableWriter::writeCsv(const TableBatch & batch)
+{
+    m_text.clear();
+    for (size_t row = 0; row < batch.m_rowCount; row++) {
+        for (size_t i = 0; i < m_columns.size(); i++) {
+            if (i) {
+                m_text.push_back(',');
+            }
+            const TableColumnData& column = batch.m_columns[i];
+            switch (m_columns[i].m_type) {
+            case TableColumnType::kInteger:
+                AppendCsvNumber(m_text, column.m_integers[row]);
+                break;
+            case TableColumnType::kReal:
+                AppendCsvNumber(m_text, column.m_reals[row]);
+                break;
+            case TableColumnType::kText:
+                AppendCsvText(m_text, column.text(row));
+                break;
+            }
+        }
+        m_text.push_back('\n');
+    }
+}
+
+void TableWriter::writeColumnar(const TableBatch & batch)
+{
+    m_encoded.clear();
+    m_encoded.write(uint64_t(batch.m_rowCount));
+    for (size_t i = 0; i < m_columns.size(); i++) {
+        const TableColumnData& column = batch.m_columns[i];
+        switch (m_columns[i].m_type) {
+        case TableColumnType::kInteger:
+            writeColumn(column.m_integers.data(), column.m_integers.size() * sizeof(uint64_t));
+            break;
+        case TableColumnType::kReal:
+            writeColumn(column.m_reals.data(), column.m_reals.size() * sizeof(double));
+            break;
+        case TableColumnType::kText:
+            writeColumn(column.m_textEnds.data(), column.m_textEnds.size() * sizeof(uint32_t));
+            writeColumn(column.m_text.data(), column.m_text.size());
+            break;
+        }
+    }
+}
+
+void TableWriter::writeColumn(const void * data, size_t size)
+{
+    // A column whose encoded size is its raw size is stored raw, so the reader can tell the two apart
+    m_compressed.clear();
+    Lz4::Compress(static_cast<const char*>(data), size, m_compressed);
+    m_encoded.write(uint64_t(size));
+    if (m_compressed.size() < size) {
+        m_encoded.write(uint64_t(m_compressed.size()));
+        m_encoded.write(m_compressed.data(), m_compressed.size());
+    }
+    else {
+        m_encoded.write(uint64_t(size));
+        m_encoded.write(data, size);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// TableReader
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t TableReader::ToCsv(const std::string & tablePath, const std::string & csvPath)
+{
+    TableReader reader(tablePath);
+    TableWriter writer(csvPath, reader.columns(), TableFormat::kCsv);
+    TableBatch batch;
+    while (reader.readBatch(batch)) {
+        for (size_t row = 0; row < batch.m_rowCount; row++) {
+            for (size_t i = 0; i < reader.columns().size(); i++) {
+                const TableColumnData& column = batch.m_columns[i];
+                switch (reader.columns()[i].m_type) {
+                case TableColumnType::kInteger:
+                    writer.add(column.m_integers[row]);
+                    break;
+                case TableColumnType::kReal:
+                    writer.add(column.m_reals[row]);
+                    break;
+                case TableColumnType::kText:
+                    writer.add(column.text(row));
+                    break;
+                }
+            }
+            writer.endRow();
+        }
+    }
+    writer.flush();
+    return writer.rowCount();
+}
+
+TableReader::TableReader(const std::string & path):
+    m_file(path),
+    m_reader(m_file.data(), m_file.size())
+{
+    if (m_reader.remaining() < 2 * sizeof(uint32_t) || m_reader.read<uint32_t>() != Table::s_magic) {
+        throw std::runtime_error("Error, " + path + " is not a table file");
+    }
+    if (m_reader.read<uint32_t>() != Table::s_version) {
+        throw std::runtime_error("Error, table " + path + " is from an unsupported version");
+    }
+    uint64_t columnCount = m_reader.read<uint64_t>();
+    if (columnCount > m_reader.remaining()) {
+        throw std::runtime_error("Error, corrupt header in table " + path);
+    }
+    for (uint64_t i = 0; i < columnCount; i++) {
+        TableColumn column;
+        column.m_name = m_reader.readString();
+        uint8_t type = m_reader.read<uint8_t>();
+        if (type > uint8_t(TableColumnType::kText)) {
+            throw std::runtime_error("Error, unknown column type in table " + path);
+        }
+        column.m_type = TableColumnType(type);
+        m_columns.push_back(column);
+    }
+}
+
+TableReader::~TableReader()
+{
+}
+
+bool TableReader::readBatch(TableBatch & outBatch)
+{
+    outBatch.m_columns.resize(m_columns.size());
+    outBatch.clear();
+    if (m_reader.atEnd()) {
+        return false;
+    }
+    size_t rowCount = size_t(m_reader.read<uint64_t>());
+    if (rowCount > m_reader.remaining()) {
+        throw std::runtime_error("Error, corrupt table batch");
+    }
+    for (size_t i = 0; i < m_columns.size(); i++) {
+        TableColumnData& column = outBatch.m_columns[i];
+        switch (m_columns[i].m_type) {
+        case TableColumnType::kInteger:
+            column.m_integers.resize(rowCount);
+            readColumn(column.m_integers.data(), rowCount * sizeof(uint64_t));
+            break;
+        case TableColumnType::kReal:
+            column.m_reals.resize(rowCount);
+            readColumn(column.m_reals.data(), rowCount * sizeof(double));
+            break;
+        case TableColumnType::kText:
+            column.m_textEnds.resize(rowCount);
+            readColumn(column.m_textEnds.data(), rowCount * sizeof(uint32_t));
+            column.m_text.resize(rowCount ? column.m_textEnds.back() : 0);
+            readColumn(column.m_text.data(), column.m_text.size());
+            for (size_t row = 0; row < rowCount; row++) {
+                if (column.m_textEnds[row] > column.m_text.size() || (row && column.m_textEnds[row] < column.m_textEnds[row - 1])) {
+                    throw std::runtime_error("Error, corrupt text column in table batch");
+                }
+            }
+            break;
+        }
+    }
+    outBatch.m_rowCount = rowCount;
+    return true;
+}
+
+void TableReader::readColumn(void * out, size_t size)
+{
+    size_t rawSize = size_t(m_reader.read<uint64_t>());
+    size_t encodedSize = size_t(m_reader.read<uint64_t>());
+    if (rawSize != size || encodedSize > m_reader.remaining()) {
+        throw std::runtime_error("Error, corrupt column in table batch");
+    }
+    if (encodedSize == size) {
+        m_reader.read(out, size);
+        return;
+    }
+    m_column.resize(encodedSize);
+    m_reader.read(m_column.data(), encodedSize);
+    Lz4::Decompress(m_column.data(), encodedSize, static_cast<char*>(out), size);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
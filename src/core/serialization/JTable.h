@@ -0,0 +1,331 @@
+#ifndef J_TABLE_H
+#define J_TABLE_H
+/** @file JTable.h
+    Defines a writer that exports summary tables to CSV or to a compact columnar binary format in the
+    background, and a reader for the binary format
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <core/serialization/JBinaryStream.h>
+#include <core/serialization/JMappedFile.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief The formats a table can be written in
+enum class TableFormat {
+    kCsv, ///< Text, with a header row
+    kColumnar ///< Binary, in batches of LZ4-compressed columns
+};
+
+/// @brief The type of the values in a column
+enum class TableColumnType : uint8_t {
+    kInteger, ///< Unsigned 64-bit integers, e.g. counts and indices
+    kReal, ///< Doubles, written in their shortest exact form
+    kText ///< Strings, e.g. names
+};
+
+/// @brief The name and type of a column of a table
+struct TableColumn {
+    std::string m_name;
+    TableColumnType m_type = TableColumnType::kReal;
+};
+
+/// @brief The values of a column for a batch of rows, of which only those of the column's type are used
+struct TableColumnData {
+    /// @brief The text of a row in a text column
+    std::string_view text(size_t row) const {
+        size_t begin = row ? m_textEnds[row - 1] : 0;
+        return std::string_view(m_text).substr(begin, m_textEnds[row] - begin);
+    }
+
+    void clear() {
+        m_integers.clear();
+        m_reals.clear();
+        m_textEnds.clear();
+        m_text.clear();
+    }
+
+    std::vector<uint64_t> m_integers;
+    std::vector<double> m_reals;
+
+    /// @brief Where each row's text ends in the column's text, which holds every row's text back to back
+    std::vector<uint32_t> m_textEnds;
+    std::string m_text;
+};
+
+/// @brief A batch of rows, held column by column
+struct TableBatch {
+    void clear() {
+        m_rowCount = 0;
+        for (TableColumnData& column : m_columns) {
+            column.clear();
+        }
+    }
+
+    size_t m_rowCount = 0;
+    std::vector<TableColumnData> m_columns;
+};
+
+/// @class Table
+/// @brief The layout of columnar table files
+/// @details A table file is a header, holding a magic number, the format version and the name and type of each
+/// column, followed by batches of rows. Each batch holds its row count and then each column in turn. Integer and
+/// real columns are their raw values, and text columns are the offset at which each row's text ends followed by
+/// the text itself. Every column is prefixed by its raw and encoded sizes in bytes, and is LZ4-compressed if that
+/// made it smaller
+class Table {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Members
+    /// @{
+
+    /// @brief Identifies table files, reading "JTBL" in a hex dump
+    static constexpr uint32_t s_magic = 0x4C42544A;
+
+    /// @brief The format version, bumped whenever the layout changes
+    static constexpr uint32_t s_version = 1;
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Methods
+    /// @{
+
+    /// @brief The format for a path, which is CSV for a ".csv" extension and columnar otherwise
+    static TableFormat FormatOf(const std::string& path);
+
+    /// @}
+};
+
+/// @class TableWriter
+/// @brief Exports rows of a table, formatting and writing them on a background thread
+/// @details Rows are added a value at a time into a batch held column by column, which only appends to vectors.
+/// Full batches are swapped with the batch the background thread last wrote, which formats each row as CSV with
+/// std::to_chars, or encodes and compresses each column, and writes it out. The thread that adds rows only waits
+/// if the writer is still busy with the previous batch when the next one fills, and never formats anything
+/// @note Rows must be added from one thread at a time
+class TableWriter {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    /// @param[in] path The file to write
+    /// @param[in] append Whether to append to the file rather than replace it. The header is only written if
+    /// the file is empty, so appending to a file with different columns is up to the caller to prevent
+    /// @param[in] batchRowCount The number of rows handed to the background thread at a time
+    TableWriter(const std::string& path, const std::vector<TableColumn>& columns, TableFormat format = TableFormat::kCsv,
+        bool append = false, size_t batchRowCount = s_defaultBatchRowCount);
+
+    /// @brief Writes out any rows added so far
+    ~TableWriter();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    const std::vector<TableColumn>& columns() const { return m_columns; }
+    TableFormat format() const { return m_format; }
+
+    /// @brief The number of complete rows added so far
+    size_t rowCount() const { return m_rowCount; }
+
+    /// @brief The number of bytes written to the file so far
+    size_t writtenBytes() const;
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Add the next value of the current row, which must match the type of its column
+    TableWriter& add(uint64_t value) {
+        nextColumn(TableColumnType::kInteger).m_integers.push_back(value);
+        return *this;
+    }
+    TableWriter& add(double value) {
+        nextColumn(TableColumnType::kReal).m_reals.push_back(value);
+        return *this;
+    }
+    TableWriter& add(std::string_view text) {
+        TableColumnData& column = nextColumn(TableColumnType::kText);
+        column.m_text.append(text);
+        column.m_textEnds.push_back(uint32_t(column.m_text.size()));
+        return *this;
+    }
+
+    /// @brief Finish the current row, which must have a value for every column
+    void endRow();
+
+    /// @brief Write out every row so far, and wait for them to reach the file
+    /// @details Rethrows any error from writing
+    void flush();
+
+	/// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Members
+    /// @{
+
+    static constexpr size_t s_defaultBatchRowCount = 4096;
+
+    /// @}
+
+protected:
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Methods
+    /// @{
+
+    /// @brief The column taking the next value of the current row, checking that it has the given type
+    TableColumnData& nextColumn(TableColumnType type) {
+        if (m_nextColumn >= m_columns.size() || m_columns[m_nextColumn].m_type != type) {
+            throw std::logic_error("Error, value does not match the columns of table " + m_path);
+        }
+        return m_front.m_columns[m_nextColumn++];
+    }
+
+    /// @brief Hand the batch being filled to the writer, once it has finished the last one
+    void submit();
+
+    /// @brief The loop run by the background thread
+    void writeLoop();
+
+    /// @brief Format or encode a batch, and write it out
+    void writeBatch(const TableBatch& batch);
+    void writeCsv(const TableBatch& batch);
+    void writeColumnar(const TableBatch& batch);
+
+    /// @brief Append a column to the batch being encoded, compressing it if that makes it smaller
+    void writeColumn(const void* data, size_t size);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    std::ofstream m_file;
+    std::string m_path;
+    std::vector<TableColumn> m_columns;
+    TableFormat m_format;
+    size_t m_batchRowCount;
+    size_t m_rowCount = 0;
+
+    /// @brief The column taking the next value of the current row
+    size_t m_nextColumn = 0;
+
+    /// @brief The batch being filled, and the batch being written by the background thread
+    TableBatch m_front;
+    TableBatch m_back;
+    bool m_backPending = false;
+
+    /// @brief The writer's scratch space for formatted text, and for encoded columns
+    std::string m_text;
+    std::vector<char> m_compressed;
+    BinaryWriter m_encoded;
+
+    size_t m_writtenBytes = 0;
+    bool m_shutdown = false;
+
+    /// @brief The first error thrown while writing, rethrown by flush()
+    std::exception_ptr m_exception;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_written;
+    std::thread m_thread;
+
+    /// @}
+};
+
+/// @class TableReader
+/// @brief Reads a columnar table file back batch by batch, from a memory-mapped view of the file
+class TableReader {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Methods
+    /// @{
+
+    /// @brief Convert a columnar table file to CSV, returning the number of rows
+    static size_t ToCsv(const std::string& tablePath, const std::string& csvPath);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    /// @brief Open a table file and read its header, throwing if it isn't a table or is from another version
+    TableReader(const std::string& path);
+    ~TableReader();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    const std::vector<TableColumn>& columns() const { return m_columns; }
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Read the next batch of rows, returning false at the end of the file
+    bool readBatch(TableBatch& outBatch);
+
+	/// @}
+
+protected:
+
+    /// @brief Read a column of the current batch into the given buffer of exactly its raw size
+    void readColumn(void* out, size_t size);
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    MappedFile m_file;
+    BinaryReader m_reader;
+    std::vector<TableColumn> m_columns;
+
+    /// @brief Scratch space for decoding columns
+    std::vector<char> m_column;
+
+    /// @}
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
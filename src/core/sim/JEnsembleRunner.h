@@ -0,0 +1,326 @@
+#ifndef J_ENSEMBLE_RUNNER_H
+#define J_ENSEMBLE_RUNNER_H
+/** @file JEnsembleRunner.h
+    Defines a runner for Monte Carlo ensembles of independent simulation replicas
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include <core/statistics/JRunningStatistics.h>
+#include <core/threading/JThreadPool.h>
+#include <core/time/JTimer.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @struct EnsembleSummary
+/// @brief The statistics of each metric over an ensemble of replicas
+struct EnsembleSummary {
+    /// @brief The number of replicas run per second of wall-clock time
+    double replicasPerSecond() const { return m_elapsedSec > 0.0 ? double(m_replicaCount) / m_elapsedSec : 0.0; }
+
+    /// @brief The statistics of each metric, in the order the replicas reported them
+    std::vector<RunningStatistics> m_metrics;
+
+    /// @brief The number of replicas run
+    size_t m_replicaCount = 0;
+
+    /// @brief The wall-clock time taken to run and reduce the ensemble, in seconds
+    double m_elapsedSec = 0.0;
+
+    /// @brief Whether every metric met the stopping rule, for ensembles run until convergence
+    bool m_converged = false;
+
+    /// @brief The statistics of each metric over individual replicas, for ensembles of antithetic pairs
+    /// @details m_metrics then holds the statistics of the pair averages
+    std::vector<RunningStatistics> m_replicaMetrics;
+
+    /// @brief How many times smaller the variance of a metric's mean is than it would have been with the same
+    /// number of independent replicas, for ensembles of antithetic pairs
+    /// @details Independent replicas are unaffected, so this is one for ensembles that are not antithetic
+    double varianceReductionFactor(size_t metric) const {
+        if (m_replicaMetrics.empty() || m_metrics[metric].variance() <= 0.0) {
+            return 1.0;
+        }
+
+        // The average of a pair would have half the variance of a replica, were the pair independent
+        return m_replicaMetrics[metric].variance() / (2.0 * m_metrics[metric].variance());
+    }
+
+    /// @brief How many times smaller the variance of a difference between two metrics is than it would have
+    /// been had they come from independent replicas, e.g. for common random numbers
+    /// @param[in] first, second The statistics of the two metrics being compared
+    /// @param[in] difference The statistics of their difference, computed in each replica
+    static double PairedVarianceReductionFactor(const RunningStatistics& first, const RunningStatistics& second, const RunningStatistics& difference) {
+        if (difference.variance() <= 0.0) {
+            return 1.0;
+        }
+        return (first.variance() + second.variance()) / difference.variance();
+    }
+};
+
+/// @struct StoppingRule
+/// @brief When to stop running replicas, based on the precision of the estimated means
+struct StoppingRule {
+    /// @brief Whether the statistics of a metric are precise enough
+    /// @details The half-width of the confidence interval must be within the relative tolerance of the mean,
+    /// or within the absolute tolerance, which keeps metrics whose mean is near zero from running forever
+    bool isMet(const RunningStatistics& statistics) const {
+        double halfWidth = statistics.confidenceHalfWidth(m_zScore);
+        return halfWidth <= m_absoluteHalfWidth || halfWidth <= m_relativeHalfWidth * std::abs(statistics.mean());
+    }
+
+    /// @brief The target half-width of each confidence interval, as a fraction of the mean
+    double m_relativeHalfWidth = 0.05;
+
+    /// @brief A half-width that is always small enough, in the units of the metric
+    double m_absoluteHalfWidth = 0.0;
+
+    /// @brief The critical value of the confidence intervals, 1.96 for 95% confidence
+    double m_zScore = 1.96;
+
+    /// @brief The number of replicas to run before checking the intervals, which are unreliable for few samples
+    size_t m_minReplicaCount = 30;
+
+    /// @brief The number of replicas after which to give up on converging
+    /// @details Antithetic ensembles run whole pairs, so round this down to even, to no fewer than one pair
+    size_t m_maxReplicaCount = 100000;
+};
+
+/// @class EnsembleRunner
+/// @brief Runs many independent replicas of a simulation across a thread pool, and merges their results
+/// @details Each replica is a function of its index alone, e.g. one that builds its own Simulator and Scene
+/// seeded by the index, runs it, and writes out a fixed number of metrics. Every worker runs one replica at
+/// a time, pulling the next index as it finishes, and writes into the replica's own row of the results, so
+/// replicas share no mutable state. The rows are then reduced in fixed blocks and merged pairwise, so the
+/// summary is bit-identical for any number of threads.
+/// @note Replicas should not use the runner's pool themselves, e.g. their simulators should have no
+/// threads of their own, since the pool is already saturated with replicas
+class EnsembleRunner {
+public:
+    /// @brief Called as handler(firstReplica, replicaCount, metricCount, samples) after each batch of replicas,
+    /// with a row of metricCount samples for each replica in the batch
+    typedef std::function<void(size_t, size_t, size_t, const double*)> ReplicaHandler;
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    /// @param[in] threadCount The number of worker threads. With none, replicas run on the calling thread
+    EnsembleRunner(size_t threadCount = std::thread::hardware_concurrency()):
+        m_threadPool(threadCount)
+    {
+    }
+    ~EnsembleRunner() {}
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    size_t threadCount() const { return m_threadPool.numThreads(); }
+
+    /// @brief Whether replicas run in antithetic pairs
+    /// @details Replicas 2k and 2k + 1 should then share their seed, with the second mirroring every random draw
+    /// of the first, see RandomStream. Each pair's average counts as a single sample, and replica counts are
+    /// rounded up to whole pairs
+    bool isAntithetic() const { return m_antithetic; }
+    void setAntithetic(bool antithetic) { m_antithetic = antithetic; }
+
+    /// @brief A function to hand the samples of every replica to as each batch finishes, e.g. to export them
+    /// @details Called on the thread running the ensemble, in replica order, once the batch's workers are done
+    void setReplicaHandler(const ReplicaHandler& handler) { m_replicaHandler = handler; }
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Run an ensemble of replicas
+    /// @param[in] replicaCount The number of replicas to run
+    /// @param[in] metricCount The number of metrics that each replica reports
+    /// @param[in] runReplica Called as runReplica(replicaIndex, outMetrics) from the worker threads, and must
+    /// write metricCount values to outMetrics
+    /// @details The first exception thrown by a replica is rethrown here, once the others have finished
+    template<typename ReplicaFunction>
+    EnsembleSummary run(size_t replicaCount, size_t metricCount, const ReplicaFunction& runReplica) {
+        Timer timer;
+        timer.start();
+        EnsembleSummary summary = createSummary(metricCount);
+        runBatch(replicaCount + (m_antithetic ? replicaCount % 2 : 0), runReplica, summary);
+        summary.m_elapsedSec = timer.getElapsed<double>();
+        return summary;
+    }
+
+    /// @brief Run batches of replicas until every metric meets the stopping rule
+    /// @details After each batch, the number of replicas still needed is estimated from how far each
+    /// interval is from its target, since half-widths shrink with the square root of the replica count.
+    /// The next batch runs that many, but never more than have been run so far, so the ensemble overshoots
+    /// the replicas it needs by at most a batch that was sized from a reasonable estimate. Batches are always
+    /// whole multiples of the batch granularity.
+    /// @param[in] batchGranularity The multiple of replicas in each batch, which defaults to the thread count
+    /// to keep every worker busy. Summaries only depend on the thread count through this value
+    template<typename ReplicaFunction>
+    EnsembleSummary runUntil(const StoppingRule& rule, size_t metricCount, const ReplicaFunction& runReplica, size_t batchGranularity = 0) {
+        Timer timer;
+        timer.start();
+        EnsembleSummary summary = createSummary(metricCount);
+
+        size_t granularity = batchGranularity ? batchGranularity : std::max(threadCount(), size_t(1));
+        size_t maxReplicaCount = rule.m_maxReplicaCount;
+        if (m_antithetic) {
+            granularity += granularity % 2;
+            maxReplicaCount = std::max(maxReplicaCount - maxReplicaCount % 2, size_t(2));
+        }
+        size_t batchSize = std::max(rule.m_minReplicaCount, size_t(1));
+        while (true) {
+            // Granularity is even for antithetic ensembles, and so is the remaining allowance, so batches are
+            // always whole pairs
+            batchSize = (batchSize + granularity - 1) / granularity * granularity;
+            batchSize = std::min(batchSize, maxReplicaCount - summary.m_replicaCount);
+            runBatch(batchSize, runReplica, summary);
+
+            // Estimate the replicas still needed by the least precise metric
+            double requiredCount = 0.0;
+            summary.m_converged = true;
+            for (const RunningStatistics& statistics : summary.m_metrics) {
+                if (!rule.isMet(statistics)) {
+                    summary.m_converged = false;
+                    double targetHalfWidth = std::max(rule.m_absoluteHalfWidth, rule.m_relativeHalfWidth * std::abs(statistics.mean()));
+                    double ratio = statistics.confidenceHalfWidth(rule.m_zScore) / targetHalfWidth;
+                    requiredCount = std::max(requiredCount, summary.m_replicaCount * ratio * ratio);
+                }
+            }
+            if (summary.m_converged || summary.m_replicaCount >= maxReplicaCount) {
+                break;
+            }
+            double remainingCount = std::min(requiredCount - summary.m_replicaCount, double(summary.m_replicaCount));
+            batchSize = std::max(size_t(remainingCount), size_t(1));
+        }
+
+        summary.m_elapsedSec = timer.getElapsed<double>();
+        return summary;
+    }
+
+	/// @}
+
+protected:
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Methods
+    /// @{
+
+    /// @brief An empty summary for the given number of metrics
+    EnsembleSummary createSummary(size_t metricCount) const {
+        EnsembleSummary summary;
+        summary.m_metrics.resize(metricCount);
+        if (m_antithetic) {
+            summary.m_replicaMetrics.resize(metricCount);
+        }
+        return summary;
+    }
+
+    /// @brief Run a batch of replicas, numbered on from those already in the summary, and merge their metrics into it
+    template<typename ReplicaFunction>
+    void runBatch(size_t replicaCount, const ReplicaFunction& runReplica, EnsembleSummary& summary) {
+        const size_t firstReplica = summary.m_replicaCount;
+        const size_t metricCount = summary.m_metrics.size();
+
+        // Run the replicas, one per worker at a time
+        m_samples.assign(replicaCount * metricCount, 0.0);
+        std::atomic<size_t> nextReplica{ 0 };
+        m_threadPool.parallelFor(std::max(threadCount(), size_t(1)), [&](size_t) {
+            for (size_t replica = nextReplica++; replica < replicaCount; replica = nextReplica++) {
+                runReplica(firstReplica + replica, m_samples.data() + replica * metricCount);
+            }
+        });
+        if (m_replicaHandler) {
+            m_replicaHandler(firstReplica, replicaCount, metricCount, m_samples.data());
+        }
+
+        // Accumulate fixed blocks of replicas, then merge the blocks pairwise. For antithetic pairs, blocks hold
+        // the statistics of pair averages followed by those of individual replicas
+        const size_t statisticsCount = m_antithetic ? 2 * metricCount : metricCount;
+        size_t blockCount = std::max((replicaCount + s_reductionBlockSize - 1) / s_reductionBlockSize, size_t(1));
+        std::vector<std::vector<RunningStatistics>> blocks(blockCount, std::vector<RunningStatistics>(statisticsCount));
+        m_threadPool.parallelFor(blockCount, [&](size_t block) {
+            size_t end = std::min((block + 1) * s_reductionBlockSize, replicaCount);
+            for (size_t replica = block * s_reductionBlockSize; replica < end; replica++) {
+                const double* samples = m_samples.data() + replica * metricCount;
+                for (size_t metric = 0; metric < metricCount; metric++) {
+                    if (!m_antithetic) {
+                        blocks[block][metric].add(samples[metric]);
+                        continue;
+                    }
+                    blocks[block][metricCount + metric].add(samples[metric]);
+                    if (replica % 2) {
+                        blocks[block][metric].add(0.5 * ((samples - metricCount)[metric] + samples[metric]));
+                    }
+                }
+            }
+        });
+        for (size_t stride = 1; stride < blockCount; stride *= 2) {
+            m_threadPool.parallelFor((blockCount + 2 * stride - 1) / (2 * stride), [&](size_t pair) {
+                size_t left = pair * 2 * stride;
+                if (left + stride < blockCount) {
+                    for (size_t statistic = 0; statistic < statisticsCount; statistic++) {
+                        blocks[left][statistic].merge(blocks[left + stride][statistic]);
+                    }
+                }
+            });
+        }
+
+        for (size_t metric = 0; metric < metricCount; metric++) {
+            summary.m_metrics[metric].merge(blocks[0][metric]);
+            if (m_antithetic) {
+                summary.m_replicaMetrics[metric].merge(blocks[0][metricCount + metric]);
+            }
+        }
+        summary.m_replicaCount += replicaCount;
+    }
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    /// @brief The number of replicas accumulated by a single task before merging
+    static constexpr size_t s_reductionBlockSize = 64;
+
+    /// @brief The workers running replicas
+    ThreadPool m_threadPool;
+
+    /// @brief The metrics reported by each replica, one row per replica
+    std::vector<double> m_samples;
+
+    /// @brief Whether replicas run in antithetic pairs
+    bool m_antithetic = false;
+
+    /// @brief The function that every batch's samples are handed to, if any
+    ReplicaHandler m_replicaHandler;
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
@@ -0,0 +1,176 @@
+#include "JParameterSweep.h"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <core/diagnostics/JRunHash.h>
+#include <core/random/JRandomStream.h>
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+std::vector<SweepPoint> ParameterSweep::GridDesign(const std::vector<SweepParameter>& parameters)
+{
+    size_t pointCount = 1;
+    for (const SweepParameter& parameter : parameters) {
+        pointCount *= std::max(parameter.m_levelCount, size_t(1));
+    }
+
+    // Count through the points like an odometer, with the last parameter varying fastest
+    std::vector<SweepPoint> design(pointCount, SweepPoint(parameters.size()));
+    for (size_t i = 0; i < pointCount; i++) {
+        size_t remainder = i;
+        for (size_t j = parameters.size(); j-- > 0;) {
+            const SweepParameter& parameter = parameters[j];
+            size_t levelCount = std::max(parameter.m_levelCount, size_t(1));
+            size_t level = remainder % levelCount;
+            remainder /= levelCount;
+            double fraction = levelCount > 1 ? double(level) / double(levelCount - 1) : 0.0;
+            design[i][j] = parameter.m_min + fraction * (parameter.m_max - parameter.m_min);
+        }
+    }
+    return design;
+}
+
+std::vector<SweepPoint> ParameterSweep::LatinHypercubeDesign(const std::vector<SweepParameter>& parameters, size_t pointCount, uint64_t seed)
+{
+    std::vector<SweepPoint> design(pointCount, SweepPoint(parameters.size()));
+    std::vector<size_t> strata(pointCount);
+    for (size_t j = 0; j < parameters.size(); j++) {
+        const SweepParameter& parameter = parameters[j];
+        RandomStream stream(seed, j);
+
+        // Shuffle the strata, so that each point lands in a different one
+        std::iota(strata.begin(), strata.end(), size_t(0));
+        for (size_t i = pointCount; i > 1; i--) {
+            std::swap(strata[i - 1], strata[size_t(stream.uniformIndex(i))]);
+        }
+        for (size_t i = 0; i < pointCount; i++) {
+            double fraction = (double(strata[i]) + stream.uniform()) / double(pointCount);
+            design[i][j] = parameter.m_min + fraction * (parameter.m_max - parameter.m_min);
+        }
+    }
+    return design;
+}
+
+uint64_t ParameterSweep::PointKey(const SweepPoint& point, uint64_t settingsKey)
+{
+    RunHash hash;
+    hash.add(settingsKey);
+    for (double value : point) {
+        hash.add(value);
+    }
+    return hash.value();
+}
+
+ParameterSweep::ParameterSweep(const std::vector<SweepParameter>& parameters, const std::vector<std::string>& metricNames,
+    const std::string& resultsPath, uint64_t settingsKey):
+    m_parameters(parameters),
+    m_metricNames(metricNames),
+    m_resultsPath(resultsPath),
+    m_settingsKey(settingsKey)
+{
+    openResults();
+}
+
+ParameterSweep::~ParameterSweep()
+{
+}
+
+std::vector<TableColumn> ParameterSweep::columns() const
+{
+    std::vector<TableColumn> columns = { { "key", TableColumnType::kText } };
+    for (const SweepParameter& parameter : m_parameters) {
+        columns.push_back({ parameter.m_name, TableColumnType::kReal });
+    }
+    for (const std::string& metricName : m_metricNames) {
+        columns.push_back({ metricName, TableColumnType::kReal });
+        columns.push_back({ metricName + " half-width", TableColumnType::kReal });
+    }
+    columns.push_back({ "replicas", TableColumnType::kInteger });
+    return columns;
+}
+
+std::string ParameterSweep::header() const
+{
+    std::string header;
+    for (const TableColumn& column : columns()) {
+        header += (header.empty() ? "" : ",") + column.m_name;
+    }
+    return header;
+}
+
+void ParameterSweep::openResults()
+{
+    // Keep only complete rows, since the last one may have been cut off when a sweep was interrupted
+    const std::string expectedHeader = header();
+    const size_t columnCount = 2 + m_parameters.size() + 2 * m_metricNames.size();
+    std::vector<std::string> rows;
+    bool discarded = false;
+    {
+        std::ifstream file(m_resultsPath);
+        std::string line;
+        if (std::getline(file, line) && line != expectedHeader) {
+            throw std::runtime_error("Error, " + m_resultsPath + " holds results for a different sweep");
+        }
+        while (std::getline(file, line)) {
+            bool complete = !file.eof() && size_t(std::count(line.begin(), line.end(), ',')) + 1 == columnCount;
+            uint64_t key = 0;
+            std::istringstream keyStream(line.substr(0, line.find(',')));
+            if (!complete || !(keyStream >> std::hex >> key)) {
+                discarded = true;
+                continue;
+            }
+            m_finishedKeys.insert(key);
+            rows.push_back(line);
+        }
+    }
+
+    if (discarded) {
+        // Rewrite the file from the rows that survived
+        std::ofstream file(m_resultsPath, std::ios::trunc);
+        file << expectedHeader << '\n';
+        for (const std::string& row : rows) {
+            file << row << '\n';
+        }
+        if (!file) {
+            throw std::runtime_error("Error, could not rewrite " + m_resultsPath);
+        }
+    }
+
+    // The writer only adds the header to an empty file
+    m_results = std::make_unique<TableWriter>(m_resultsPath, columns(), TableFormat::kCsv, !rows.empty() || discarded);
+}
+
+void ParameterSweep::writeResult(uint64_t key, const SweepPoint& point, const EnsembleSummary& summary)
+{
+    if (point.size() != m_parameters.size() || summary.m_metrics.size() != m_metricNames.size()) {
+        throw std::invalid_argument("Error, sweep results do not match its parameters and metrics");
+    }
+
+    // Keys are sixteen hex digits. Values are written in their shortest exact form, so the row reproduces the point
+    char keyText[16];
+    std::fill(keyText, keyText + sizeof(keyText), '0');
+    char* keyEnd = std::to_chars(keyText, keyText + sizeof(keyText), key, 16).ptr;
+    std::rotate(keyText, keyEnd, keyText + sizeof(keyText));
+    m_results->add(std::string_view(keyText, sizeof(keyText)));
+    for (double value : point) {
+        m_results->add(value);
+    }
+    for (const RunningStatistics& statistics : summary.m_metrics) {
+        m_results->add(statistics.mean()).add(statistics.confidenceHalfWidth());
+    }
+    m_results->add(uint64_t(summary.m_replicaCount));
+    m_results->endRow();
+
+    // Flush every row, so that finished points survive an interruption
+    m_results->flush();
+    m_finishedKeys.insert(key);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
@@ -0,0 +1,177 @@
+#ifndef J_PARAMETER_SWEEP_H
+#define J_PARAMETER_SWEEP_H
+/** @file JParameterSweep.h
+    Defines a sweep of ensembles over a design of parameter values, with results cached on disk
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <core/serialization/JTable.h>
+#include <core/sim/JEnsembleRunner.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @struct SweepParameter
+/// @brief A parameter varied by a sweep, and the range it is varied over
+struct SweepParameter {
+    /// @brief The name of the parameter, used as its column header in the results
+    std::string m_name;
+
+    /// @brief The smallest value of the parameter
+    double m_min = 0.0;
+
+    /// @brief The largest value of the parameter
+    double m_max = 0.0;
+
+    /// @brief The number of evenly spaced values taken by the parameter in a grid design
+    size_t m_levelCount = 3;
+};
+
+/// @brief A point in a design, holding a value for each parameter of the sweep
+typedef std::vector<double> SweepPoint;
+
+/// @class ParameterSweep
+/// @brief Runs an ensemble at every point of a design, streaming each point's results to a CSV file
+/// @details Each row of the results file is keyed by a hash of the point's parameter values and of a key for
+/// the sweep's settings, e.g. the simulated duration and the ensemble's stopping rule. Points whose key is
+/// already in the file are skipped, so an interrupted sweep picks up where it left off, and sweeps with
+/// overlapping designs share their results. Rows are written by a TableWriter and flushed as each point
+/// finishes, and a row that was cut off mid-write is discarded when the file is next opened.
+class ParameterSweep {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Methods
+    /// @{
+
+    /// @brief Every combination of the levels of each parameter
+    static std::vector<SweepPoint> GridDesign(const std::vector<SweepParameter>& parameters);
+
+    /// @brief A Latin hypercube design, which splits the range of each parameter into as many strata as there
+    /// are points, and takes a value from each stratum exactly once
+    /// @details This covers every parameter's range evenly with far fewer points than a grid
+    static std::vector<SweepPoint> LatinHypercubeDesign(const std::vector<SweepParameter>& parameters, size_t pointCount, uint64_t seed);
+
+    /// @brief The key of a point's results
+    static uint64_t PointKey(const SweepPoint& point, uint64_t settingsKey);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    /// @param[in] parameters The parameters varied by the sweep
+    /// @param[in] metricNames The names of the metrics reported by each ensemble
+    /// @param[in] resultsPath The CSV file to read cached results from, and to append new results to
+    /// @param[in] settingsKey Identifies everything besides the parameters that affects the results
+    /// @details Throws if the results file was written by a sweep with different parameters or metrics
+    ParameterSweep(const std::vector<SweepParameter>& parameters, const std::vector<std::string>& metricNames,
+        const std::string& resultsPath, uint64_t settingsKey = 0);
+    ~ParameterSweep();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    const std::vector<SweepParameter>& parameters() const { return m_parameters; }
+
+    /// @brief The number of points with results in the file
+    size_t finishedCount() const { return m_finishedKeys.size(); }
+
+    /// @brief Whether the point already has results in the file
+    bool isFinished(const SweepPoint& point) const { return m_finishedKeys.count(PointKey(point, m_settingsKey)) != 0; }
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Run an ensemble at every point of the design that does not yet have results
+    /// @param[in] runPoint Called as runPoint(point), returning an EnsembleSummary with a statistic for each metric
+    /// @return The number of points that were run, rather than taken from the file
+    template<typename PointFunction>
+    size_t run(const std::vector<SweepPoint>& design, const PointFunction& runPoint) {
+        size_t runCount = 0;
+        for (const SweepPoint& point : design) {
+            uint64_t key = PointKey(point, m_settingsKey);
+            if (m_finishedKeys.count(key)) {
+                continue;
+            }
+            writeResult(key, point, runPoint(point));
+            runCount++;
+        }
+        return runCount;
+    }
+
+	/// @}
+
+protected:
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Methods
+    /// @{
+
+    /// @brief The columns of the results file: the key, each parameter, the mean and half-width of each metric,
+    /// and the number of replicas
+    std::vector<TableColumn> columns() const;
+
+    /// @brief The header row of the results file
+    std::string header() const;
+
+    /// @brief Read the keys of finished points from the results file, and open it for appending
+    void openResults();
+
+    /// @brief Append the results of a point to the file
+    void writeResult(uint64_t key, const SweepPoint& point, const EnsembleSummary& summary);
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    /// @brief The parameters varied by the sweep
+    std::vector<SweepParameter> m_parameters;
+
+    /// @brief The names of the metrics reported by each ensemble
+    std::vector<std::string> m_metricNames;
+
+    /// @brief The path of the results file
+    std::string m_resultsPath;
+
+    /// @brief Identifies everything besides the parameters that affects the results
+    uint64_t m_settingsKey;
+
+    /// @brief The keys of points with results in the file
+    std::unordered_set<uint64_t> m_finishedKeys;
+
+    /// @brief The results file, open for appending
+    std::unique_ptr<TableWriter> m_results;
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
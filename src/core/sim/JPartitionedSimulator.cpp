@@ -0,0 +1,125 @@
+#include "JPartitionedSimulator.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+
+namespace joby {
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+PartitionedSimulator::PartitionedSimulator(size_t partitionCount, size_t threadCount):
+    m_threadPool(threadCount)
+{
+    if (!partitionCount) {
+        throw std::invalid_argument("Error, a partitioned simulator needs at least one partition");
+    }
+    for (size_t i = 0; i < partitionCount; i++) {
+        m_partitions.push_back(std::make_unique<Partition>());
+    }
+}
+
+PartitionedSimulator::~PartitionedSimulator()
+{
+}
+
+void PartitionedSimulator::setLookahead(double lookahead)
+{
+    if (!(lookahead > 0.0)) {
+        throw std::invalid_argument("Error, the lookahead of a partitioned simulator must be positive");
+    }
+    m_lookahead = lookahead;
+}
+
+RunHash PartitionedSimulator::runHash() const
+{
+    RunHash hash;
+    for (const std::unique_ptr<Partition>& partition : m_partitions) {
+        hash.add(partition->m_runHash.value());
+    }
+    return hash;
+}
+
+void PartitionedSimulator::send(size_t fromPartition, size_t toPartition, const Event & event)
+{
+    if (!m_running || fromPartition == toPartition) {
+        m_partitions[toPartition]->m_eventQueue.schedule(event);
+        return;
+    }
+    if (event.m_time < m_windowEnd) {
+        throw std::logic_error("Error, event sent to another partition within the lookahead");
+    }
+    m_partitions[fromPartition]->m_outbox.emplace_back(toPartition, event);
+}
+
+void PartitionedSimulator::simulateUntil(double endTime)
+{
+    const size_t workerCount = std::max(std::min(threadCount(), m_partitions.size()), size_t(1));
+    m_running = true;
+    try {
+        while (true) {
+            // Start each window at the earliest pending event, skipping over idle time
+            double windowStart = std::numeric_limits<double>::infinity();
+            for (const std::unique_ptr<Partition>& partition : m_partitions) {
+                windowStart = std::min(windowStart, partition->m_eventQueue.nextTime());
+            }
+            if (windowStart > endTime) {
+                break;
+            }
+            m_windowEnd = windowStart + m_lookahead;
+            m_simulationTime = std::max(m_simulationTime, windowStart);
+
+            // Each worker pulls partitions until none are left, so a few busy partitions don't hold up the rest
+            std::atomic<size_t> nextPartition{ 0 };
+            m_threadPool.parallelFor(workerCount, [&](size_t) {
+                for (size_t i = nextPartition++; i < m_partitions.size(); i = nextPartition++) {
+                    runPartition(*m_partitions[i], endTime);
+                }
+            });
+            deliverSent();
+            m_statistics.m_windowCount++;
+        }
+    }
+    catch (...) {
+        // Drop events sent during the failed window, so that a later run doesn't deliver them
+        for (const std::unique_ptr<Partition>& partition : m_partitions) {
+            partition->m_outbox.clear();
+        }
+        m_running = false;
+        throw;
+    }
+    m_running = false;
+    m_simulationTime = std::max(m_simulationTime, endTime);
+
+    m_statistics.m_eventCount = 0;
+    for (const std::unique_ptr<Partition>& partition : m_partitions) {
+        m_statistics.m_eventCount += partition->m_eventCount;
+    }
+}
+
+void PartitionedSimulator::runPartition(Partition& partition, double endTime)
+{
+    Event event;
+    while (partition.m_eventQueue.nextTime() < m_windowEnd && partition.m_eventQueue.nextTime() <= endTime) {
+        partition.m_eventQueue.pop(event);
+        partition.m_runHash.add(event);
+        if (m_eventDispatcher.hasHandler()) {
+            m_eventDispatcher.dispatch(event);
+        }
+        partition.m_eventCount++;
+    }
+}
+
+void PartitionedSimulator::deliverSent()
+{
+    for (const std::unique_ptr<Partition>& partition : m_partitions) {
+        for (const std::pair<size_t, Event>& sent : partition->m_outbox) {
+            m_partitions[sent.first]->m_eventQueue.schedule(sent.second);
+        }
+        m_statistics.m_sentCount += partition->m_outbox.size();
+        partition->m_outbox.clear();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
@@ -0,0 +1,192 @@
+#ifndef J_PARTITIONED_SIMULATOR_H
+#define J_PARTITIONED_SIMULATOR_H
+/** @file JPartitionedSimulator.h
+
+    File defining a discrete event simulation split into partitions that run in parallel
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <memory>
+#include <vector>
+
+#include <core/events/JEventQueue.h>
+#include <core/events/JEventDispatcher.h>
+#include <core/diagnostics/JRunHash.h>
+#include <core/threading/JThreadPool.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @struct PartitionedSimulatorStatistics
+/// @brief Counters describing how a partitioned simulator advanced time
+struct PartitionedSimulatorStatistics {
+    /// @brief The number of windows run, each ending at a barrier between the partitions
+    uint64_t m_windowCount = 0;
+
+    /// @brief The number of events dispatched
+    uint64_t m_eventCount = 0;
+
+    /// @brief The number of events sent from one partition to another
+    uint64_t m_sentCount = 0;
+};
+
+/// @class PartitionedSimulator
+/// @brief Runs a discrete event simulation whose state is split into partitions, each with its own event
+/// queue, across a thread pool
+/// @details Each event belongs to a single partition, and its handler may only touch that partition's state.
+/// Partitions affect one another only by sending events, which must fire at least the lookahead after the
+/// time of the event that sent them. Time is advanced in windows of one lookahead from the earliest pending
+/// event, within which every partition can run independently, since nothing sent during a window can fall
+/// inside it. Sent events are held by their sender until the barrier at the end of the window, then scheduled
+/// in order of sending partition and then order of sending, so results do not depend on the number of threads.
+/// Unlike the Simulator, there are no fixed-step processes, only events.
+/// @note Handlers run on the pool's threads, so must not share mutable state across partitions
+class PartitionedSimulator {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Methods
+    /// @{
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Constructor/Destructor
+    /// @{
+
+    /// @param[in] partitionCount The number of partitions, each with its own event queue
+    /// @param[in] threadCount The number of worker threads. With none, partitions run on the calling thread
+    PartitionedSimulator(size_t partitionCount, size_t threadCount = std::thread::hardware_concurrency());
+    ~PartitionedSimulator();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    size_t partitionCount() const { return m_partitions.size(); }
+
+    size_t threadCount() const { return m_threadPool.numThreads(); }
+
+    /// @brief The queue of pending events for a partition
+    /// @note Only to be used from the partition's own handlers, or between runs
+    EventQueue& eventQueue(size_t partition) { return m_partitions[partition]->m_eventQueue; }
+
+    /// @brief Routes simulation events to their handler, which is shared by every partition
+    EventDispatcher& eventDispatcher() { return m_eventDispatcher; }
+
+    /// @brief The shortest delay between an event and any event it sends to another partition, in seconds
+    /// @details Longer lookaheads mean fewer windows, and so fewer barriers
+    double lookahead() const { return m_lookahead; }
+    void setLookahead(double lookahead);
+
+    /// @brief The current simulation time, in seconds
+    double simulationTime() const { return m_simulationTime; }
+
+    /// @brief Counters for the windows and events that have been run
+    const PartitionedSimulatorStatistics& statistics() const { return m_statistics; }
+
+    /// @brief The number of events dispatched by a partition, to judge how evenly work is spread
+    uint64_t eventCount(size_t partition) const { return m_partitions[partition]->m_eventCount; }
+
+    /// @brief A hash of every event dispatched so far, combining the hashes of the partitions in order
+    /// @details Partitions see their events in the same order for any number of threads, so the hash does not
+    /// depend on the number of threads
+    RunHash runHash() const;
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+	/// @name Public Methods
+	/// @{
+
+    /// @brief Send an event from one partition to another
+    /// @details Events sent to the sending partition itself are scheduled straight away. Outside of a run, e.g.
+    /// while setting up, every event is scheduled straight away
+    /// @param[in] fromPartition The partition whose handler is sending the event
+    void send(size_t fromPartition, size_t toPartition, const Event& event);
+
+    /// @brief Run the simulation as fast as possible, until the given simulation time
+    /// @details Events scheduled for exactly the end time are dispatched before returning. If a handler throws,
+    /// the exception is rethrown and events sent during that window are discarded
+    /// @param[in] endTime The simulation time to stop at, in seconds
+    void simulateUntil(double endTime);
+
+	/// @}
+
+protected:
+
+    /// @brief The events and bookkeeping of a partition, aligned so that partitions run by different threads
+    /// never share a cache line
+    struct alignas(64) Partition {
+        /// @brief Pending events of the partition
+        EventQueue m_eventQueue;
+
+        /// @brief Events sent to other partitions during the current window, with their destinations
+        std::vector<std::pair<size_t, Event>> m_outbox;
+
+        /// @brief A hash of every event dispatched by the partition
+        RunHash m_runHash;
+
+        /// @brief The number of events dispatched by the partition
+        uint64_t m_eventCount = 0;
+    };
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Methods
+    /// @{
+
+    /// @brief Dispatch a partition's events that fall within the current window
+    void runPartition(Partition& partition, double endTime);
+
+    /// @brief Schedule the events sent during the window just run
+    void deliverSent();
+
+    /// @}
+
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    /// @brief The partitions, held by pointer so that each sits at its own address
+    std::vector<std::unique_ptr<Partition>> m_partitions;
+
+    /// @brief Routes events to their handler
+    EventDispatcher m_eventDispatcher;
+
+    /// @brief The threads that run the partitions
+    ThreadPool m_threadPool;
+
+    /// @brief The shortest delay between an event and any event it sends to another partition, in seconds
+    double m_lookahead = 1.0;
+
+    /// @brief Whether partitions are being run, so that events sent between them must wait for a barrier
+    bool m_running = false;
+
+    /// @brief The time before which every event belongs to the current window
+    double m_windowEnd = 0.0;
+
+    /// @brief The current simulation time, in seconds
+    double m_simulationTime = 0.0;
+
+    /// @brief Counters for the windows and events that have been run
+    PartitionedSimulatorStatistics m_statistics;
+
+    /// @}
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
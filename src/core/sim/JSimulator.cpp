@@ -1,5 +1,8 @@
 #include "JSimulator.h"
+#include <algorithm>
+#include <cmath>
 #include <core/time/JTimer.h>
+#include <core/serialization/JBinaryStream.h>
 
 namespace joby {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -8,6 +11,7 @@ namespace joby {
 Simulator::Simulator(size_t numHelperThreads):
     m_processQueue(numHelperThreads)
 {
+    m_processQueue.setEventQueue(&m_eventQueue);
 }
 
 Simulator::~Simulator()
@@ -17,10 +21,8 @@ Simulator::~Simulator()
 void Simulator::simulate(std::function<bool(double)> pred, const double timeStepSec)
 {
     // Initialize timing-related locals
-    double simulationTime = 0.0;
     double totalElapsedTime = 0.0;
-    double previousTime = 0.0;
-    double accumulator = 0.0;
+    double startTime = m_simulationTime;
 
     // Start the simulation timer
     Timer timer;
@@ -31,27 +33,107 @@ void Simulator::simulate(std::function<bool(double)> pred, const double timeStep
     {
         // Input/event handling logic would go here in production code
 
-        double timeSinceLastFrame = totalElapsedTime - previousTime;
-        accumulator += timeSinceLastFrame;
-
-        // Perform fixed-step simulation until up-to-date
-        while (accumulator >= timeStepSec)
-        {
-            // Update all simulation processes
-            m_processQueue.updateProcesses(timeStepSec);
-
-            // Increment simulation time one step forward
-            accumulator -= timeStepSec;
-            simulationTime += timeStepSec;
+        // Catch up with the wall clock, to the last whole step
+        double elapsedSteps = std::floor((startTime + totalElapsedTime) / timeStepSec);
+        double targetTime = elapsedSteps * timeStepSec;
+        if (targetTime > m_simulationTime) {
+            advanceTo(targetTime, timeStepSec);
         }
 
         // Rendering logic would go here in production code
 
         // Update total elapsed time
-        previousTime = totalElapsedTime;
         totalElapsedTime = timer.getElapsed<double>();
     }
 }
 
+void Simulator::simulateUntil(double endTime, const double timeStepSec)
+{
+    advanceTo(endTime, timeStepSec);
+}
+
+void Simulator::save(BinaryWriter & writer)
+{
+    // Posted events aren't saved, so bring them into the queue first
+    m_eventQueue.drainInbox();
+
+    writer.write(m_simulationTime);
+    writer.write(m_stepIndex);
+    writer.write(m_statistics);
+    writer.write(m_runHash.value());
+    m_eventQueue.save(writer);
+    m_processQueue.save(writer);
+}
+
+void Simulator::load(BinaryReader & reader)
+{
+    reader.read(m_simulationTime);
+    reader.read(m_stepIndex);
+    reader.read(m_statistics);
+    m_runHash.setValue(reader.read<uint64_t>());
+    m_eventQueue.load(reader);
+    m_processQueue.load(reader);
+}
+
+void Simulator::processEvents(double simulationTime)
+{
+    // Merge the inbox in one batch, so that posted events are ordered deterministically
+    m_eventQueue.drainInbox();
+
+    Event event;
+    while (m_eventQueue.nextTime() <= simulationTime) {
+        m_eventQueue.pop(event);
+        m_runHash.add(event);
+        if (m_eventDispatcher.hasHandler()) {
+            m_eventDispatcher.dispatch(event);
+        }
+        m_statistics.m_eventCount++;
+    }
+}
+
+void Simulator::advanceTo(double endTime, double timeStepSec)
+{
+    while (true) {
+        // Fire everything that is due, including events scheduled by the handlers themselves
+        processEvents(m_simulationTime);
+        if (m_simulationTime >= endTime) {
+            break;
+        }
+
+        // Advance to whichever comes first, the next event or the next grid point
+        double nextGridTime = double(m_stepIndex + 1) * timeStepSec;
+        double targetTime = std::min(m_eventQueue.nextTime(), endTime);
+        bool active = m_processQueue.hasActiveProcesses();
+        if (active) {
+            targetTime = std::min(targetTime, nextGridTime);
+            m_processQueue.updateProcesses(targetTime - m_simulationTime);
+
+            bool fromGridPoint = m_simulationTime == double(m_stepIndex) * timeStepSec;
+            if (fromGridPoint && targetTime == nextGridTime) {
+                m_statistics.m_fixedStepCount++;
+            }
+            else {
+                m_statistics.m_partialStepCount++;
+            }
+        }
+
+        // Keep the step index on the grid, counting the grid points that were jumped over while idle
+        if (targetTime >= nextGridTime) {
+            uint64_t stepIndex = std::max(m_stepIndex + 1, uint64_t(targetTime / timeStepSec));
+            while (double(stepIndex + 1) * timeStepSec <= targetTime) {
+                stepIndex++;
+            }
+            while (double(stepIndex) * timeStepSec > targetTime) {
+                stepIndex--;
+            }
+            if (!active) {
+                m_statistics.m_skippedStepCount += stepIndex - m_stepIndex;
+            }
+            m_stepIndex = stepIndex;
+        }
+        m_simulationTime = targetTime;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 } // end namespacing
@@ -9,6 +9,9 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #include <functional>
 #include <core/processes/JProcessQueue.h>
+#include <core/events/JEventQueue.h>
+#include <core/events/JEventDispatcher.h>
+#include <core/diagnostics/JRunHash.h>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Namespace Definitions
@@ -22,7 +25,31 @@ namespace joby {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Class Definitions
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @struct SimulatorStatistics
+/// @brief Counters describing how the simulator advanced time
+struct SimulatorStatistics {
+    /// @brief The number of full fixed steps taken, from one grid point to the next
+    uint64_t m_fixedStepCount = 0;
+
+    /// @brief The number of partial steps taken, to bring processes up to the time of an event
+    uint64_t m_partialStepCount = 0;
+
+    /// @brief The number of fixed steps skipped because no continuous process was active
+    uint64_t m_skippedStepCount = 0;
+
+    /// @brief The number of events dispatched
+    uint64_t m_eventCount = 0;
+};
+
 /// @class Simulator
+/// @brief Advances the simulation, mixing fixed-step processes with discrete events
+/// @details Continuous processes are updated on a fixed grid of steps at multiples of the time step, while
+/// discrete events fire at their exact times. The simulator always advances to whichever comes first, the
+/// next grid point or the next event, so an event falling mid-step splits the step in two and processes
+/// see the state exactly as of the event. Events due at a grid point fire before the step that starts there.
+/// Whenever no continuous process is active, the simulator jumps straight from event to event.
+/// Every dispatched event is folded into a run hash, which applications may extend with their own state,
+/// so that two runs can be checked for bit-identical results.
 class Simulator {
 public:
     //-----------------------------------------------------------------------------------------------------------------
@@ -42,6 +69,31 @@ public:
     //-----------------------------------------------------------------------------------------------------------------
     /// @name Properties
     /// @{
+
+    /// @brief The queue of pending simulation events
+    EventQueue& eventQueue() { return m_eventQueue; }
+
+    /// @brief Routes simulation events to their handler
+    EventDispatcher& eventDispatcher() { return m_eventDispatcher; }
+
+    ProcessQueue& processQueue() { return m_processQueue; }
+
+    /// @brief The current simulation time, in seconds
+    double simulationTime() const { return m_simulationTime; }
+
+    /// @brief Counters for the steps and events that have been run
+    const SimulatorStatistics& statistics() const { return m_statistics; }
+
+    /// @brief A hash of every event dispatched so far, along with anything else folded in by the application
+    RunHash& runHash() { return m_runHash; }
+    const RunHash& runHash() const { return m_runHash; }
+
+    /// @brief Whether threaded processes are stepped in lock-step, so that results are reproducible
+    /// regardless of the number of threads
+    /// @note This must be set before any threaded processes are attached
+    bool isDeterministic() const { return m_processQueue.isDeterministic(); }
+    void setDeterministic(bool deterministic) { m_processQueue.setDeterministic(deterministic); }
+
     /// @}
 
     //-----------------------------------------------------------------------------------------------------------------
@@ -56,17 +108,64 @@ public:
     /// does not need to be run at a fixed time step
     void simulate(std::function<bool(double)> pred, const double timeStepSec);
 
+    /// @brief Write the simulation clock, pending events and process states for a checkpoint
+    /// @note Application state, such as the scene, should be written alongside this
+    void save(BinaryWriter& writer);
+
+    /// @brief Restore state written by save()
+    /// @details The same processes must already be attached, and the event dispatcher set up, as when the
+    /// checkpoint was saved. The run then resumes exactly where the saved run left off
+    void load(BinaryReader& reader);
+
+    /// @brief Run the simulation as fast as possible, until the given simulation time
+    /// @details Events scheduled for exactly the end time are dispatched before returning
+    /// @param[in] endTime The simulation time to stop at, in seconds
+    /// @param[in] timeStepSec The fixed time-step, in seconds
+    void simulateUntil(double endTime, const double timeStepSec);
+
 	/// @}
 
 protected:
 
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Protected Methods
+    /// @{
+
+    /// @brief Schedule events posted by threaded processes, then dispatch all events due by the given time
+    /// @note Events posted with a time that has already passed are dispatched immediately
+    void processEvents(double simulationTime);
+
+    /// @brief Advance the simulation to the given time, stepping processes and dispatching events along the way
+    void advanceTo(double endTime, double timeStepSec);
+
+    /// @}
+
     //-----------------------------------------------------------------------------------------------------------------
     /// @name Members
     /// @{
 
+    /// @brief Pending simulation events
+    /// @note Declared before the process queue, since threaded processes may post to it until they are torn down
+    EventQueue m_eventQueue;
+
+    /// @brief Routes events to their handler
+    EventDispatcher m_eventDispatcher;
+
     /// @brief Handles processes
     ProcessQueue m_processQueue;
 
+    /// @brief The current simulation time, in seconds
+    double m_simulationTime = 0.0;
+
+    /// @brief The index of the last grid point reached, so that grid times are computed rather than accumulated
+    uint64_t m_stepIndex = 0;
+
+    /// @brief Counters for the steps and events that have been run
+    SimulatorStatistics m_statistics;
+
+    /// @brief A hash of every event dispatched so far
+    RunHash m_runHash;
+
     /// @}
 
 };
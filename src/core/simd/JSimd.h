@@ -0,0 +1,102 @@
+#ifndef J_SIMD_H
+#define J_SIMD_H
+/** @file JSimd.h
+    Defines runtime detection of the SIMD instruction sets supported by the CPU
+*/
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#if defined(_M_X64) || defined(__x86_64__)
+    #define J_SIMD_X86 1
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #endif
+    #include <immintrin.h>
+#endif
+
+/// @brief Marks a function as compiled for AVX2, so that it can be dispatched to at runtime without compiling
+/// the rest of the program for AVX2. MSVC accepts AVX2 intrinsics anywhere, so needs no attribute
+#if defined(J_SIMD_X86) && !defined(_MSC_VER)
+    #define J_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define J_TARGET_AVX2
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Namespace Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace joby {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief The instruction sets that vectorized kernels are written for, from least to most capable
+enum class SimdLevel {
+    kScalar = 0, // Plain C++, for any CPU
+    kSse2, // 128-bit vectors, which every x64 CPU supports
+    kAvx2, // 256-bit vectors with gathers
+    COUNT
+};
+
+/// @class Simd
+/// @brief Reports the SIMD instruction sets available at runtime
+class Simd {
+public:
+    //-----------------------------------------------------------------------------------------------------------------
+    /// @name Static Methods
+    /// @{
+
+    /// @brief The most capable instruction set supported by both the build and the CPU
+    static SimdLevel SupportedLevel() {
+        static const SimdLevel s_level = DetectLevel();
+        return s_level;
+    }
+
+    /// @brief Whether kernels for the given instruction set can run on this CPU
+    static bool IsSupported(SimdLevel level) { return level <= SupportedLevel(); }
+
+    static const char* LevelName(SimdLevel level) {
+        switch (level) {
+        case SimdLevel::kScalar:
+            return "Scalar";
+        case SimdLevel::kSse2:
+            return "SSE2";
+        case SimdLevel::kAvx2:
+            return "AVX2";
+        default:
+            return "Unknown";
+        }
+    }
+
+    /// @}
+
+private:
+
+    static SimdLevel DetectLevel() {
+#if defined(J_SIMD_X86) && defined(_MSC_VER)
+        // AVX2 needs both the CPU flag, and the OS saving the upper halves of the registers on a context switch
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] >= 7) {
+            __cpuid(info, 1);
+            bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+            __cpuidex(info, 7, 0);
+            if (osSavesYmm && (info[1] & (1 << 5))) {
+                return SimdLevel::kAvx2;
+            }
+        }
+        return SimdLevel::kSse2;
+#elif defined(J_SIMD_X86)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? SimdLevel::kAvx2 : SimdLevel::kSse2;
+#else
+        return SimdLevel::kScalar;
+#endif
+    }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // end namespacing
+
+#endif
@@ -0,0 +1,111 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef J_DISTRIBUTION_H
+#define J_DISTRIBUTION_H
+
+// std
+#include <cstdint>
+
+// Internal
+#include <core/serialization/JBinaryStream.h>
+#include <core/statistics/JLogHistogram.h>
+#include <core/statistics/JRunningStatistics.h>
+
+namespace joby {
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Class definitions
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @class Distribution
+/// @brief The moments and the shape of a stream of non-negative samples, e.g. durations
+/// @details Pairs running statistics, for the mean and variance, with a log histogram, for quantiles of
+/// long-tailed samples such as waits. Both merge, so a distribution may be accumulated in shards and reduced
+class Distribution {
+public:
+    //--------------------------------------------------------------------------------------------
+    /// @name Constructors/Destructor
+    /// @{
+
+    /// @param[in] unit The smallest difference between values that the histogram tells apart
+    /// @param[in] significantBits The relative precision of the histogram, see LogHistogram
+    Distribution(double unit = 1.0, uint32_t significantBits = 6):
+        m_histogram(unit, significantBits)
+    {
+    }
+    ~Distribution() {}
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    const RunningStatistics& statistics() const { return m_statistics; }
+    const LogHistogram& histogram() const { return m_histogram; }
+
+    uint64_t count() const { return m_statistics.count(); }
+    double mean() const { return m_statistics.mean(); }
+
+    /// @brief The value below which the given fraction of samples lie, see LogHistogram
+    double quantile(double fraction) const { return m_histogram.quantile(fraction); }
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Public methods
+    /// @{
+
+    void add(double value) {
+        m_statistics.add(value);
+        m_histogram.add(value);
+    }
+
+    /// @brief Fold in another distribution, which must have the same histogram unit and precision
+    void merge(const Distribution& other) {
+        m_statistics.merge(other.m_statistics);
+        m_histogram.merge(other.m_histogram);
+    }
+
+    void clear() {
+        m_statistics.clear();
+        m_histogram.clear();
+    }
+
+    /// @brief Write the distribution for a checkpoint
+    void save(BinaryWriter& writer) const {
+        m_statistics.save(writer);
+        m_histogram.save(writer);
+    }
+
+    /// @brief Restore a distribution written by save()
+    void load(BinaryReader& reader) {
+        m_statistics.load(reader);
+        m_histogram.load(reader);
+    }
+
+    /// @}
+
+private:
+    //--------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    RunningStatistics m_statistics;
+    LogHistogram m_histogram;
+
+    /// @}
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+} // End namespaces
+
+#endif
@@ -0,0 +1,177 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef J_LINEAR_HISTOGRAM_H
+#define J_LINEAR_HISTOGRAM_H
+
+// std
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// Internal
+#include <core/serialization/JBinaryStream.h>
+
+namespace joby {
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Class definitions
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @class LinearHistogram
+/// @brief Counts samples in a fixed number of equal buckets spanning a range, with samples outside of
+/// the range counted separately
+/// @details Suits values with known bounds, e.g. utilizations. Histograms with the same range and number
+/// of buckets merge by adding counts, which gives the same result in any order
+class LinearHistogram {
+public:
+    //--------------------------------------------------------------------------------------------
+    /// @name Constructors/Destructor
+    /// @{
+
+    LinearHistogram(double lowest = 0.0, double highest = 1.0, size_t bucketCount = 10):
+        m_lowest(lowest),
+        m_highest(highest),
+        m_buckets(bucketCount, 0)
+    {
+        if (!(highest > lowest) || !bucketCount) {
+            throw std::invalid_argument("Error, a linear histogram needs buckets, and a range that isn't empty");
+        }
+        m_bucketsPerUnit = double(bucketCount) / (highest - lowest);
+    }
+    ~LinearHistogram() {}
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    double lowest() const { return m_lowest; }
+    double highest() const { return m_highest; }
+
+    /// @brief The number of samples added, including those out of range
+    uint64_t count() const { return m_count; }
+
+    size_t bucketCount() const { return m_buckets.size(); }
+
+    /// @brief The number of samples in a bucket
+    uint64_t bucketSampleCount(size_t bucket) const { return m_buckets[bucket]; }
+
+    /// @brief The smallest value counted in a bucket
+    double bucketLowerBound(size_t bucket) const { return m_lowest + double(bucket) / m_bucketsPerUnit; }
+
+    /// @brief The number of samples below the lowest value, and at or above the highest
+    uint64_t underflowCount() const { return m_underflowCount; }
+    uint64_t overflowCount() const { return m_overflowCount; }
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Public methods
+    /// @{
+
+    /// @brief Add a sample, or several with the same value
+    void add(double value, uint64_t count = 1) {
+        m_count += count;
+        if (!(value >= m_lowest)) {
+            m_underflowCount += count;
+            return;
+        }
+        size_t bucket = size_t(std::min((value - m_lowest) * m_bucketsPerUnit, double(m_buckets.size())));
+        if (bucket >= m_buckets.size()) {
+            m_overflowCount += count;
+            return;
+        }
+        m_buckets[bucket] += count;
+    }
+
+    /// @brief The value below which the given fraction of samples lie, interpolated within its bucket
+    /// @details Samples out of range count as the end of the range they fall off, and no samples give the lowest value
+    double quantile(double fraction) const {
+        double rank = std::min(std::max(fraction, 0.0), 1.0) * double(m_count);
+        double seen = double(m_underflowCount);
+        if (!m_count || rank < seen) {
+            return m_lowest;
+        }
+        for (size_t i = 0; i < m_buckets.size(); i++) {
+            double bucketCount = double(m_buckets[i]);
+            if (bucketCount > 0.0 && rank < seen + bucketCount) {
+                return bucketLowerBound(i) + (rank - seen) / bucketCount / m_bucketsPerUnit;
+            }
+            seen += bucketCount;
+        }
+        return m_highest;
+    }
+
+    /// @brief Add the counts of another histogram with the same range and number of buckets
+    void merge(const LinearHistogram& other) {
+        if (other.m_lowest != m_lowest || other.m_highest != m_highest || other.m_buckets.size() != m_buckets.size()) {
+            throw std::invalid_argument("Error, can only merge linear histograms with the same buckets");
+        }
+        for (size_t i = 0; i < m_buckets.size(); i++) {
+            m_buckets[i] += other.m_buckets[i];
+        }
+        m_underflowCount += other.m_underflowCount;
+        m_overflowCount += other.m_overflowCount;
+        m_count += other.m_count;
+    }
+
+    void clear() {
+        std::fill(m_buckets.begin(), m_buckets.end(), 0);
+        m_underflowCount = 0;
+        m_overflowCount = 0;
+        m_count = 0;
+    }
+
+    /// @brief Write the counts for a checkpoint
+    void save(BinaryWriter& writer) const {
+        writer.writeVector(m_buckets);
+        writer.write(m_underflowCount);
+        writer.write(m_overflowCount);
+        writer.write(m_count);
+    }
+
+    /// @brief Restore counts written by save(), from a histogram with the same buckets
+    void load(BinaryReader& reader) {
+        size_t bucketCount = m_buckets.size();
+        reader.readVector(m_buckets);
+        if (m_buckets.size() != bucketCount) {
+            throw std::runtime_error("Error, checkpoint does not match the histogram's buckets");
+        }
+        reader.read(m_underflowCount);
+        reader.read(m_overflowCount);
+        reader.read(m_count);
+    }
+
+    /// @}
+
+private:
+    //--------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    double m_lowest;
+    double m_highest;
+    double m_bucketsPerUnit;
+
+    std::vector<uint64_t> m_buckets;
+    uint64_t m_underflowCount = 0;
+    uint64_t m_overflowCount = 0;
+    uint64_t m_count = 0;
+
+    /// @}
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+} // End namespaces
+
+#endif
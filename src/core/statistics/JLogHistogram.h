@@ -0,0 +1,210 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef J_LOG_HISTOGRAM_H
+#define J_LOG_HISTOGRAM_H
+
+// std
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// Internal
+#include <core/serialization/JBinaryStream.h>
+
+namespace joby {
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Class definitions
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @class LogHistogram
+/// @brief Counts non-negative samples in buckets whose width grows with their value, in the style of
+/// HdrHistogram (Tene), so that any value from the unit upwards is recorded to the same relative precision
+/// @details Values are measured in whole units. Those below 2^bits units each get their own bucket, and every
+/// power of two above that is split into 2^(bits - 1) buckets, so a bucket is never wider than 2^(1 - bits) of
+/// its lower bound. Buckets are only allocated up to the largest value seen, so there is no upper limit to set.
+/// Histograms with the same unit and precision merge by adding counts, which gives the same result in any order
+class LogHistogram {
+public:
+    //--------------------------------------------------------------------------------------------
+    /// @name Constructors/Destructor
+    /// @{
+
+    /// @param[in] unit The smallest difference between values that is told apart, e.g. 1e-3 hours
+    /// @param[in] significantBits The precision of each bucket, from 1 to 32
+    LogHistogram(double unit = 1.0, uint32_t significantBits = 6):
+        m_unit(unit),
+        m_significantBits(significantBits)
+    {
+        if (!(unit > 0.0) || significantBits < 1 || significantBits > 32) {
+            throw std::invalid_argument("Error, a log histogram needs a positive unit and from 1 to 32 significant bits");
+        }
+    }
+    ~LogHistogram() {}
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    double unit() const { return m_unit; }
+    uint32_t significantBits() const { return m_significantBits; }
+
+    /// @brief The number of samples added
+    uint64_t count() const { return m_count; }
+
+    /// @brief The number of buckets allocated so far
+    size_t bucketCount() const { return m_buckets.size(); }
+
+    /// @brief The number of samples in a bucket
+    uint64_t bucketSampleCount(size_t bucket) const { return m_buckets[bucket]; }
+
+    /// @brief The smallest value counted in a bucket
+    double bucketLowerBound(size_t bucket) const { return double(BucketStart(bucket, m_significantBits)) * m_unit; }
+
+    /// @brief The value that the next bucket starts at
+    double bucketUpperBound(size_t bucket) const { return double(BucketStart(bucket + 1, m_significantBits)) * m_unit; }
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Public methods
+    /// @{
+
+    /// @brief Add a sample, or several with the same value. Values that aren't positive are counted as zero
+    void add(double value, uint64_t count = 1) {
+        // Stay well within 64 bits, where the buckets would be far too wide to matter anyway
+        double units = value > 0.0 ? std::min(value / m_unit, s_maxUnits) : 0.0;
+        size_t bucket = BucketIndex(uint64_t(units), m_significantBits);
+        if (bucket >= m_buckets.size()) {
+            m_buckets.resize(bucket + 1, 0);
+        }
+        m_buckets[bucket] += count;
+        m_count += count;
+    }
+
+    /// @brief The value below which the given fraction of samples lie, to within the precision of a bucket
+    /// @details Returns the middle of the bucket holding that sample, or zero when there are no samples
+    double quantile(double fraction) const {
+        if (!m_count) {
+            return 0.0;
+        }
+        uint64_t rank = std::min(uint64_t(std::max(fraction, 0.0) * double(m_count)), m_count - 1);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < m_buckets.size(); i++) {
+            seen += m_buckets[i];
+            if (seen > rank) {
+                return 0.5 * (bucketLowerBound(i) + bucketUpperBound(i));
+            }
+        }
+        return bucketLowerBound(m_buckets.size() - 1);
+    }
+
+    /// @brief Add the counts of another histogram with the same unit and precision
+    void merge(const LogHistogram& other) {
+        if (other.m_unit != m_unit || other.m_significantBits != m_significantBits) {
+            throw std::invalid_argument("Error, can only merge log histograms with the same unit and precision");
+        }
+        if (other.m_buckets.size() > m_buckets.size()) {
+            m_buckets.resize(other.m_buckets.size(), 0);
+        }
+        for (size_t i = 0; i < other.m_buckets.size(); i++) {
+            m_buckets[i] += other.m_buckets[i];
+        }
+        m_count += other.m_count;
+    }
+
+    void clear() {
+        m_buckets.clear();
+        m_count = 0;
+    }
+
+    /// @brief Write the counts for a checkpoint
+    void save(BinaryWriter& writer) const {
+        writer.writeVector(m_buckets);
+        writer.write(m_count);
+    }
+
+    /// @brief Restore counts written by save(), from a histogram with the same unit and precision
+    void load(BinaryReader& reader) {
+        reader.readVector(m_buckets);
+        reader.read(m_count);
+    }
+
+    /// @}
+
+private:
+    //--------------------------------------------------------------------------------------------
+    /// @name Methods
+    /// @{
+
+    /// @brief The index of the bucket holding the given number of units
+    static size_t BucketIndex(uint64_t units, uint32_t significantBits) {
+        uint64_t linearCount = uint64_t(1) << significantBits;
+        if (units < linearCount) {
+            return size_t(units);
+        }
+
+        // Keep the top bits of the value, and count how many were dropped
+        uint32_t shift = HighestBit(units) - significantBits + 1;
+        uint64_t halfCount = linearCount >> 1;
+        return size_t(linearCount + (shift - 1) * halfCount + ((units >> shift) - halfCount));
+    }
+
+    /// @brief The number of units at which a bucket starts
+    static uint64_t BucketStart(size_t bucket, uint32_t significantBits) {
+        uint64_t linearCount = uint64_t(1) << significantBits;
+        if (bucket < linearCount) {
+            return bucket;
+        }
+        uint64_t halfCount = linearCount >> 1;
+        uint64_t offset = bucket - linearCount;
+        return (halfCount + offset % halfCount) << (offset / halfCount + 1);
+    }
+
+    /// @brief The position of the highest set bit of a non-zero value
+    static uint32_t HighestBit(uint64_t value) {
+        uint32_t bit = 0;
+        for (uint32_t shift = 32; shift; shift >>= 1) {
+            if (value >> shift) {
+                value >>= shift;
+                bit += shift;
+            }
+        }
+        return bit;
+    }
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    double m_unit;
+    uint32_t m_significantBits;
+
+    /// @brief The number of samples in each bucket, up to the highest one that has been reached
+    std::vector<uint64_t> m_buckets;
+
+    uint64_t m_count = 0;
+
+    /// @brief The largest number of units recorded, above which values share a bucket
+    static constexpr double s_maxUnits = 0x1.0p62;
+
+    /// @}
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+} // End namespaces
+
+#endif
@@ -0,0 +1,149 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef J_RUNNING_STATISTICS_H
+#define J_RUNNING_STATISTICS_H
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// Internal
+#include <core/serialization/JBinaryStream.h>
+
+namespace joby {
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Class definitions
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @class RunningStatistics
+/// @brief The mean, variance and range of a stream of samples, accumulated in a single pass
+/// @details Samples are added with Welford's update, which stays accurate where the naive sum of squares
+/// cancels catastrophically. Two sets of statistics can be merged with the pairwise update of Chan et al.,
+/// so samples may be accumulated in separate shards on separate threads and then reduced
+class RunningStatistics {
+public:
+    //--------------------------------------------------------------------------------------------
+    /// @name Constructors/Destructor
+    /// @{
+
+    RunningStatistics() {}
+    ~RunningStatistics() {}
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    uint64_t count() const { return m_count; }
+    double mean() const { return m_mean; }
+    double min() const { return m_min; }
+    double max() const { return m_max; }
+
+    /// @brief The unbiased sample variance, or zero for fewer than two samples
+    double variance() const {
+        return m_count > 1 ? m_sumSquaredDeviations / double(m_count - 1) : 0.0;
+    }
+
+    double standardDeviation() const { return std::sqrt(variance()); }
+
+    /// @brief The standard error of the mean
+    double standardError() const {
+        return m_count ? std::sqrt(variance() / double(m_count)) : 0.0;
+    }
+
+    /// @brief The half-width of a confidence interval for the mean, using the normal approximation
+    /// @param[in] zScore The critical value of the interval, 1.96 for 95% confidence
+    /// @note The normal approximation is poor for a handful of samples, where the interval is too narrow
+    double confidenceHalfWidth(double zScore = 1.96) const {
+        return zScore * standardError();
+    }
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Public methods
+    /// @{
+
+    /// @brief Add a sample
+    void add(double value) {
+        m_count++;
+        double delta = value - m_mean;
+        m_mean += delta / double(m_count);
+        m_sumSquaredDeviations += delta * (value - m_mean);
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+
+    /// @brief Fold in the statistics of another set of samples
+    void merge(const RunningStatistics& other) {
+        if (!other.m_count) {
+            return;
+        }
+        if (!m_count) {
+            *this = other;
+            return;
+        }
+        double count = double(m_count + other.m_count);
+        double delta = other.m_mean - m_mean;
+        m_mean += delta * double(other.m_count) / count;
+        m_sumSquaredDeviations += other.m_sumSquaredDeviations + delta * delta * double(m_count) * double(other.m_count) / count;
+        m_count += other.m_count;
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+    }
+
+    void clear() { *this = RunningStatistics(); }
+
+    /// @brief Write the statistics for a checkpoint
+    void save(BinaryWriter& writer) const {
+        writer.write(m_count);
+        writer.write(m_mean);
+        writer.write(m_sumSquaredDeviations);
+        writer.write(m_min);
+        writer.write(m_max);
+    }
+
+    /// @brief Restore statistics written by save()
+    void load(BinaryReader& reader) {
+        reader.read(m_count);
+        reader.read(m_mean);
+        reader.read(m_sumSquaredDeviations);
+        reader.read(m_min);
+        reader.read(m_max);
+    }
+
+    /// @}
+
+private:
+    //--------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    uint64_t m_count = 0;
+    double m_mean = 0.0;
+
+    /// @brief The sum of squared deviations from the mean
+    double m_sumSquaredDeviations = 0.0;
+
+    double m_min = std::numeric_limits<double>::infinity();
+    double m_max = -std::numeric_limits<double>::infinity();
+
+    /// @}
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+} // End namespaces
+
+#endif
@@ -0,0 +1,170 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef J_MPSC_QUEUE_H
+#define J_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace joby {
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Class definitions
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @class MpscQueue
+/// @brief A bounded, lock-free queue with any number of producer threads and a single consumer thread
+/// @details This is D. Vyukov's bounded queue: each cell carries a sequence number that tells producers
+/// and the consumer whether the cell is ready for them, so a push is a single compare-and-swap on the
+/// shared write position and a pop is uncontended. All storage is allocated up front.
+/// @note Values must be trivially copyable, since cells are reused without destruction
+template<typename T>
+class MpscQueue {
+public:
+    //--------------------------------------------------------------------------------------------
+    /// @name Static
+    /// @{
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Constructors/Destructor
+    /// @{
+
+    /// @param[in] capacity The maximum number of queued values, rounded up to a power of two
+    MpscQueue(size_t capacity = 1024)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Error, queued values must be trivially copyable");
+        if (!capacity) {
+            throw std::invalid_argument("Queue capacity must be nonzero");
+        }
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_cells = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; i++) {
+            m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    ~MpscQueue() {}
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    size_t capacity() const {
+        return m_mask + 1;
+    }
+
+    /// @}
+    //--------------------------------------------------------------------------------------------
+    /// @name Public methods
+    /// @{
+
+    /// @brief Add a value to the queue, from any thread
+    /// @return False if the queue is full
+    bool tryPush(const T& value) {
+        return tryPushWith([&value](T& outValue) { outValue = value; });
+    }
+
+    /// @brief Add a value to the queue by writing it straight into its cell, from any thread
+    /// @details Saves building a large value on the stack only to copy it in
+    /// @param[in] write Called with the claimed cell, which holds whatever value it last held
+    /// @return False if the queue is full, in which case write is not called
+    template<typename Function>
+    bool tryPushWith(const Function& write) {
+        size_t position = m_writePosition.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = m_cells[position & m_mask];
+            size_t sequence = cell.m_sequence.load(std::memory_order_acquire);
+            intptr_t difference = intptr_t(sequence) - intptr_t(position);
+            if (difference == 0) {
+                // The cell is free, so try to claim it
+                if (m_writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    write(cell.m_value);
+                    cell.m_sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0) {
+                // The consumer has yet to empty the cell from the previous lap
+                return false;
+            }
+            else {
+                // Another producer claimed the cell first
+                position = m_writePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @brief Remove the oldest value from the queue, from the consumer thread only
+    /// @return False if the queue is empty
+    bool tryPop(T& outValue) {
+        Cell& cell = m_cells[m_readPosition & m_mask];
+        size_t sequence = cell.m_sequence.load(std::memory_order_acquire);
+        if (sequence != m_readPosition + 1) {
+            return false;
+        }
+        outValue = cell.m_value;
+
+        // Hand the cell back to producers for the next lap
+        cell.m_sequence.store(m_readPosition + m_mask + 1, std::memory_order_release);
+        m_readPosition++;
+        return true;
+    }
+
+    /// @}
+
+private:
+    //--------------------------------------------------------------------------------------------
+    /// @name Types
+    /// @{
+
+    struct Cell {
+        std::atomic<size_t> m_sequence;
+        T m_value;
+    };
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    /// @brief The ring of cells
+    std::unique_ptr<Cell[]> m_cells;
+
+    /// @brief The capacity minus one, for wrapping positions
+    size_t m_mask;
+
+    /// @brief The next position to write to, shared by producers
+    /// @note Kept on its own cache line, away from the consumer's position
+    alignas(64) std::atomic<size_t> m_writePosition{ 0 };
+
+    /// @brief The next position to read from, owned by the consumer
+    alignas(64) size_t m_readPosition = 0;
+
+    /// @}
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+} // End namespaces
+
+#endif
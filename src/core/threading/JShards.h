@@ -0,0 +1,107 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef J_SHARDS_H
+#define J_SHARDS_H
+
+#include <cstddef>
+#include <vector>
+
+namespace joby {
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Forward Declarations
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Class definitions
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @class Shards
+/// @brief A set of accumulators that are each written by a single thread, and merged once the threads are done
+/// @details Each shard starts on its own cache line, so threads writing to neighboring shards don't contend for
+/// the same line, and need no locks. Shards are merged in index order, so the result doesn't depend on which
+/// thread finished first.
+/// @note Only the shard itself is padded. Anything it allocates, e.g. the buffer of a vector, is a separate
+/// allocation, which should be large enough that sharing a line at its ends doesn't matter
+template<typename T>
+class Shards {
+public:
+    //--------------------------------------------------------------------------------------------
+    /// @name Static
+    /// @{
+
+    /// @brief The size of a cache line on the CPUs this runs on
+    static constexpr size_t s_cacheLineSize = 64;
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Constructors/Destructor
+    /// @{
+
+    Shards() {}
+    Shards(size_t count, const T& value = T()) { assign(count, value); }
+    ~Shards() {}
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Operators
+    /// @{
+
+    T& operator[](size_t index) { return m_shards[index].m_value; }
+    const T& operator[](size_t index) const { return m_shards[index].m_value; }
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Properties
+    /// @{
+
+    size_t size() const { return m_shards.size(); }
+    bool empty() const { return m_shards.empty(); }
+
+    /// @}
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Public methods
+    /// @{
+
+    /// @brief Replace the shards with copies of the given value
+    void assign(size_t count, const T& value = T()) { m_shards.assign(count, Shard{ value }); }
+
+    void clear() { m_shards.clear(); }
+
+    /// @brief Merge every shard into a value in index order, with merge(value, shard)
+    template<typename Result, typename Merge>
+    void mergeInto(Result& value, const Merge& merge) const {
+        for (const Shard& shard : m_shards) {
+            merge(value, shard.m_value);
+        }
+    }
+
+    /// @}
+
+private:
+
+    struct alignas(s_cacheLineSize) Shard {
+        T m_value;
+    };
+
+    //--------------------------------------------------------------------------------------------
+    /// @name Members
+    /// @{
+
+    std::vector<Shard> m_shards;
+
+    /// @}
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+} // End namespaces
+
+#endif
@@ -11,6 +11,7 @@
 #include <queue>
 #include <unordered_map>
 #include <mutex>
+#include <condition_variable>
 #include <functional>
 #include <exception>
 
@@ -91,6 +92,51 @@ public:
 		addTask_impl(std::bind(args...));
 	}
 	
+	/// @brief Run a function for every index in [0, count) across the pool, returning once all calls have finished
+	/// @details Runs inline on the calling thread if the pool has no threads. The first exception thrown
+	/// by any call is rethrown here, once the others have completed
+	/// @note Must not be called while long-running tasks occupy every thread, or it will wait on them
+	template<typename Function>
+	void parallelFor(size_t count, const Function& function){
+		if(!m_numThreads){
+			for(size_t i = 0; i < count; i++){
+				function(i);
+			}
+			return;
+		}
+
+		std::mutex doneMutex;
+		std::condition_variable done;
+		size_t remaining = count;
+		std::exception_ptr exceptionPtr;
+		for(size_t i = 0; i < count; i++){
+			addTask_impl([&, i](){
+				std::exception_ptr taskException;
+				try{
+					function(i);
+				}
+				catch(...){
+					taskException = std::current_exception();
+				}
+
+				// Notify while holding the lock, since the waiting thread owns the condition variable
+				std::unique_lock lock(doneMutex);
+				if(taskException && !exceptionPtr){
+					exceptionPtr = taskException;
+				}
+				if(--remaining == 0){
+					done.notify_one();
+				}
+			});
+		}
+
+		std::unique_lock lock(doneMutex);
+		done.wait(lock, [&remaining]{return remaining == 0;});
+		if(exceptionPtr){
+			std::rethrow_exception(exceptionPtr);
+		}
+	}
+
 	/// @brief Shutdown all of the threads in the pool
 	inline void shutdown(){
 		// Break each thread's while loop
@@ -215,7 +261,7 @@ private:
     std::string m_exceptionStr;
 
     /// @brief Whether or not to shutdown the threadpool
-    std::atomic<bool> m_shutdown;
+    std::atomic<bool> m_shutdown{ false };
 
     /// @}
 };
@@ -0,0 +1,64 @@
+#include "JAllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Allocation functions
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<size_t> s_allocationCount{ 0 };
+
+void* operator new(size_t size)
+{
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Begin namespace
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace joby {
+
+
+size_t AllocationCounter::Count()
+{
+    return s_allocationCount.load(std::memory_order_relaxed);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// End namespace
+/////////////////////////////////////////////////////////////////////////////////////////////
+}
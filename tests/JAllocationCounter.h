@@ -0,0 +1,49 @@
+/* @file JAllocationCounter.h
+   @brief Counts heap allocations made by the test executable
+
+   The global allocation functions are replaced in JAllocationCounter.cpp, so that tests can check that
+   a code path does not touch the heap
+*/
+
+#ifndef J_ALLOCATION_COUNTER_H
+#define J_ALLOCATION_COUNTER_H
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+/////////////////////////////////////////////////////////////////////////////////////////////
+#include <cstddef>
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Begin namespace
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace joby {
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+
+/// @class AllocationCounter
+class AllocationCounter {
+public:
+    /// @name Static
+    /// @{
+
+    /// @brief The number of calls to operator new since the program started, across all threads
+    static size_t Count();
+
+    /// @}
+
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// End namespace
+/////////////////////////////////////////////////////////////////////////////////////////////
+}
+
+
+#endif
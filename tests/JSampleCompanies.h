@@ -0,0 +1,86 @@
+/* @file JSampleCompanies.h
+   @brief The companies of the default eVTOL scenario, shared by the tests and benchmarks that set up scenes
+
+   Keeping them in one place means that every fixture flies the same aircraft as the application does by default
+*/
+
+#ifndef J_SAMPLE_COMPANIES_H
+#define J_SAMPLE_COMPANIES_H
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+/////////////////////////////////////////////////////////////////////////////////////////////
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <apps/eVTOL/entities/vehicle/JeVTOL.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Begin namespace
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace joby {
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definitions
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+
+/// @class SampleCompanies
+class SampleCompanies {
+public:
+    /// @name Static
+    /// @{
+
+    /// @brief The aircraft flown by the sample company of the given name, from "Alpha" to "Echo"
+    static Aircraft Specification(const std::string& name) {
+        for (const SampleCompany& company : s_companies) {
+            if (name == company.m_name) {
+                return company.m_specification;
+            }
+        }
+        throw std::invalid_argument("Error, no sample company named " + name);
+    }
+
+    /// @brief Add the sample companies of the given names to a scene, in order, or all of them if none are named
+    static void AddTo(Scene& scene, std::initializer_list<const char*> names = {}) {
+        if (!names.size()) {
+            for (const SampleCompany& company : s_companies) {
+                scene.addCompany(company.m_name, company.m_specification);
+            }
+        }
+        for (const char* name : names) {
+            scene.addCompany(name, Specification(name));
+        }
+    }
+
+    /// @}
+
+private:
+
+    struct SampleCompany {
+        const char* m_name;
+        Aircraft m_specification;
+    };
+
+    inline static const SampleCompany s_companies[] = {
+        { "Alpha",   Aircraft{ 120.0, 320.0, 0.6, 1.6, 4, 0.25 } },
+        { "Beta",    Aircraft{ 100, 100, 0.2, 1.5, 5, 0.1 } },
+        { "Charlie", Aircraft{ 160, 220, 0.8, 2.2, 3, 0.05 } },
+        { "Delta",   Aircraft{ 90, 120, 0.62, 0.8, 2, 0.22 } },
+        { "Echo",    Aircraft{ 30, 150, 0.3, 5.8, 2, 0.61 } }
+    };
+
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// End namespace
+/////////////////////////////////////////////////////////////////////////////////////////////
+}
+
+
+#endif
@@ -11,6 +11,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////
 // Includes
 /////////////////////////////////////////////////////////////////////////////////////////////
+#include <exception>
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 // Begin namespace
@@ -56,6 +57,18 @@ protected:
         }
     }
 
+    /// @brief Whether the function throws
+    template<typename Function>
+    static bool throws(const Function& function) {
+        try {
+            function();
+        }
+        catch (const std::exception&) {
+            return true;
+        }
+        return false;
+    }
+
     template<typename T>
     bool approxEqual(const T& t1, const T& t2, double tolerance = 1e-8) {
         return abs(t1 - t2) < tolerance;
@@ -0,0 +1,112 @@
+#ifndef BENCHMARK_CHARGERS_H
+#define BENCHMARK_CHARGERS_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include <vector>
+#include <core/random/JRandomStream.h>
+#include <core/time/JTimer.h>
+#include <core/containers/JString.h>
+#include <core/diagnostics/JLogger.h>
+#include <apps/eVTOL/entities/charger/JChargerAllocator.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Benchmarks the charger allocator with many chargers, and with a long line of waiting aircraft
+/// @details Claims and frees chargers in random order while half are busy, then drains a line of one million
+/// aircraft through every charger under each queue policy. Results are reported in nanoseconds per operation
+class ChargerBenchmark : public Test
+{
+public:
+
+    ChargerBenchmark(): Test(){}
+    ~ChargerBenchmark() {}
+
+    /// @brief Time charger assignment for increasing numbers of chargers, and the line under each policy
+    virtual void perform() {
+        const std::vector<size_t> sizes{ 100, 10000, 1000000 };
+        for (size_t size : sizes) {
+            Logger::LogInfo(JString::Format("Charger assignment, %8zu chargers, %6.2f ns/operation",
+                size, runAssignment(size)).c_str());
+        }
+        for (size_t policy = 0; policy < (size_t)ChargerQueuePolicy::COUNT; policy++) {
+            Logger::LogInfo(JString::Format("Charger line (%-24s), %8zu aircraft, %6.2f ns/aircraft",
+                ChargerAllocator::PolicyName(ChargerQueuePolicy(policy)), s_aircraftCount,
+                runLine(ChargerQueuePolicy(policy))).c_str());
+        }
+    }
+
+private:
+
+    /// @brief Alternately claim a charger and free a random busy one, returning the time per operation in nanoseconds
+    double runAssignment(size_t chargerCount) {
+        ChargerAllocator allocator;
+        allocator.resize(chargerCount);
+        std::vector<uint32_t> occupied;
+        uint32_t charger = 0;
+        uint32_t aircraft = 0;
+        for (size_t i = 0; i < chargerCount / 2; i++) {
+            allocator.tryAcquire(0.0, charger);
+            occupied.push_back(charger);
+        }
+
+        // Draw the chargers to free up front, so that only the allocator is timed
+        RandomStream stream(3, 0);
+        std::vector<uint32_t> positions(s_operationCount);
+        for (uint32_t& position : positions) {
+            position = uint32_t(stream.uniformIndex(occupied.size()));
+        }
+
+        Timer timer;
+        timer.start();
+        for (size_t i = 0; i < s_operationCount; i++) {
+            uint32_t& slot = occupied[positions[i]];
+            allocator.release(slot, double(i), aircraft);
+            allocator.tryAcquire(double(i), slot);
+        }
+        return timer.getElapsed<double>() * 1e9 / double(2 * s_operationCount);
+    }
+
+    /// @brief Queue a million aircraft behind ten thousand busy chargers and hand each one a charger,
+    /// returning the time per aircraft in nanoseconds
+    double runLine(ChargerQueuePolicy policy) {
+        ChargerAllocator allocator;
+        allocator.resize(s_chargerCount);
+        allocator.setPolicy(policy);
+        uint32_t charger = 0;
+        uint32_t aircraft = 0;
+        while (allocator.tryAcquire(0.0, charger)) {}
+
+        RandomStream stream(5, 0);
+        Timer timer;
+        timer.start();
+        for (uint32_t i = 0; i < s_aircraftCount; i++) {
+            allocator.enqueue(i, stream.uniform());
+        }
+        for (size_t i = 0; allocator.waitingCount(); i++) {
+            allocator.release(uint32_t(i % s_chargerCount), double(i), aircraft);
+        }
+        return timer.getElapsed<double>() * 1e9 / double(s_aircraftCount);
+    }
+
+    /// @brief The number of claims and frees to time for each number of chargers
+    static constexpr size_t s_operationCount = 5000000;
+
+    /// @brief The number of chargers and aircraft when timing the line
+    static constexpr size_t s_chargerCount = 10000;
+    static constexpr size_t s_aircraftCount = 1000000;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
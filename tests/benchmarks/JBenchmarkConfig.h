@@ -0,0 +1,117 @@
+#ifndef BENCHMARK_CONFIG_H
+#define BENCHMARK_CONFIG_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <core/containers/JString.h>
+#include <core/diagnostics/JLogger.h>
+#include <core/time/JTimer.h>
+#include <apps/eVTOL/sim/JScenarioGenerator.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Benchmarks loading a million-row fleet file, against reading it line by line with streams
+/// @details Results are reported in nanoseconds per row, and megabytes per second
+class ConfigBenchmark : public Test
+{
+public:
+
+    ConfigBenchmark(): Test(){}
+    ~ConfigBenchmark() {}
+
+    /// @brief Write out a fleet file, and then load it into scenes
+    virtual void perform() {
+        const char* companies[] = { "Alpha", "Beta", "Charlie", "Delta", "Echo" };
+        size_t fileSize = 0;
+        {
+            std::ofstream file(s_path, std::ios::trunc | std::ios::binary);
+            file << "company,vertiport\n";
+            for (size_t i = 0; i < s_rowCount; i++) {
+                file << companies[(i * 7) % 5] << ',' << (i % s_vertiportCount) << '\n';
+            }
+            fileSize = size_t(file.tellp());
+        }
+
+        double mappedSec = runMapped();
+        double streamSec = runStream();
+        Logger::LogInfo(JString::Format("Fleet file, %zu rows, mapped:  %6.2f ns/row, %7.1f MB/s",
+            s_rowCount, mappedSec * 1e9 / s_rowCount, fileSize / mappedSec / (1024.0 * 1024.0)).c_str());
+        Logger::LogInfo(JString::Format("Fleet file, %zu rows, streams: %6.2f ns/row, %7.1f MB/s",
+            s_rowCount, streamSec * 1e9 / s_rowCount, fileSize / streamSec / (1024.0 * 1024.0)).c_str());
+        std::remove(s_path);
+    }
+
+private:
+
+    /// @brief Load the fleet file into a scene, returning the time taken in seconds
+    double runMapped() {
+        Scene scene;
+        addScene(scene);
+        Timer timer;
+        timer.start();
+        size_t rowCount = ScenarioGenerator::LoadFleet(s_path, scene, 1);
+        double elapsed = timer.getElapsed<double>();
+        assert_(rowCount == s_rowCount && scene.fleet().size() == s_rowCount);
+        return elapsed;
+    }
+
+    /// @brief Read the fleet file with getline and stringstreams, as a baseline, returning the time taken in seconds
+    double runStream() {
+        Scene scene;
+        addScene(scene);
+        Timer timer;
+        timer.start();
+        std::vector<uint32_t> companyIds;
+        std::vector<uint32_t> vertiportIds;
+        std::ifstream file(s_path);
+        std::string line;
+        std::getline(file, line);
+        while (std::getline(file, line)) {
+            std::stringstream row(line);
+            std::string company;
+            std::string vertiport;
+            std::getline(row, company, ',');
+            std::getline(row, vertiport);
+            for (uint32_t i = 0; i < scene.companies().size(); i++) {
+                if (scene.companies()[i].name() == company) {
+                    companyIds.push_back(i);
+                }
+            }
+            vertiportIds.push_back(uint32_t(std::stoul(vertiport)));
+        }
+        scene.addAircraft(companyIds.data(), vertiportIds.data(), companyIds.size(), 1);
+        double elapsed = timer.getElapsed<double>();
+        assert_(scene.fleet().size() == s_rowCount);
+        return elapsed;
+    }
+
+    static void addScene(Scene& scene) {
+        SampleCompanies::AddTo(scene);
+        for (size_t i = 0; i < s_vertiportCount; i++) {
+            scene.addVertiport("Vertiport " + std::to_string(i), 4);
+        }
+    }
+
+    static constexpr const char* s_path = "config_benchmark_fleet.csv";
+    static constexpr size_t s_rowCount = 1000000;
+    static constexpr size_t s_vertiportCount = 64;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
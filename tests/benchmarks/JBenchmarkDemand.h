@@ -0,0 +1,101 @@
+#ifndef BENCHMARK_DEMAND_H
+#define BENCHMARK_DEMAND_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <string>
+#include <core/containers/JString.h>
+#include <core/diagnostics/JLogger.h>
+#include <core/sim/JSimulator.h>
+#include <core/time/JTimer.h>
+#include <apps/eVTOL/entities/vertiport/JTripQueue.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Benchmarks generating trip requests and matching them to idle aircraft, for a single busy vertiport and
+/// for a day of a network of vertiports
+/// @details Results are reported in nanoseconds per request, and for the network in requests per second of wall time
+class DemandBenchmark : public Test
+{
+public:
+
+    DemandBenchmark(): Test(){}
+    ~DemandBenchmark() {}
+
+    virtual void perform() {
+        runQueue();
+        runScene();
+    }
+
+private:
+
+    /// @brief Generate and dispatch ten million requests at one vertiport, topping its idle aircraft back up after
+    /// every dispatch
+    void runQueue() {
+        DemandSettings settings;
+        settings.m_tripsPerHour = 1e6;
+        TripQueue queue;
+        queue.reset(settings, 5, 0, false, 0, 16, 0.0);
+
+        Timer timer;
+        timer.start();
+        uint32_t nextAircraft = 0;
+        for (double time = settings.m_dispatchInterval; time <= 10.0 * 3600.0; time += settings.m_dispatchInterval) {
+            while (queue.idleCount() < s_idleCount) {
+                queue.addIdle(nextAircraft, 2 + nextAircraft % 4);
+                nextAircraft++;
+            }
+            queue.dispatch(time);
+        }
+        double elapsedSec = timer.getElapsed<double>();
+        const DemandStatistics& statistics = queue.statistics();
+        Logger::LogInfo(JString::Format("Trip queue, %zu requests, %zu trips, %.1f ns/request",
+            statistics.m_requestCount, statistics.m_tripCount, elapsedSec * 1e9 / statistics.m_requestCount).c_str());
+    }
+
+    /// @brief Simulate a day of a network of vertiports with millions of requests
+    void runScene() {
+        Scene scene;
+        for (size_t i = 0; i < s_vertiportCount; i++) {
+            scene.addVertiport("Vertiport " + std::to_string(i), 20);
+        }
+        SampleCompanies::AddTo(scene, { "Alpha", "Beta", "Echo" });
+        scene.addAircraft(s_vertiportCount * 200, 42);
+        DemandSettings settings;
+        settings.m_tripsPerHour = 2000.0;
+        scene.setDemand(settings, 42);
+
+        Timer timer;
+        timer.start();
+        Simulator sim(0);
+        scene.initialize(sim);
+        sim.simulateUntil(24.0 * 3600.0, 1.0);
+        scene.finalize(sim.simulationTime());
+        double elapsedSec = timer.getElapsed<double>();
+        DemandStatistics statistics = scene.demandStatistics();
+        Logger::LogInfo(JString::Format("Demand, %zu vertiports, %zu requests and %zu trips in a day, %.3f seconds, %.0f requests/s",
+            s_vertiportCount, statistics.m_requestCount, statistics.m_tripCount, elapsedSec,
+            double(statistics.m_requestCount) / elapsedSec).c_str());
+    }
+
+    /// @brief The number of aircraft idle at the busy vertiport before each dispatch
+    static constexpr size_t s_idleCount = 2000;
+
+    static constexpr size_t s_vertiportCount = 64;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef BENCHMARK_EVENT_QUEUE_H
+#define BENCHMARK_EVENT_QUEUE_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include <random>
+#include <vector>
+#include <core/events/JEventQueue.h>
+#include <core/time/JTimer.h>
+#include <core/containers/JString.h>
+#include <core/diagnostics/JLogger.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Benchmarks the event queue types using the classic hold model
+/// @details The queue is first filled to a fixed size. Each hold operation then pops the earliest event
+/// and schedules a new one at that event's time plus a random increment, so the size stays constant.
+/// Results are reported in nanoseconds per hold, for several queue sizes and increment distributions
+class EventQueueBenchmark : public Test
+{
+public:
+
+    EventQueueBenchmark(): Test(){}
+    ~EventQueueBenchmark() {}
+
+    /// @brief Run the hold model for each queue type
+    virtual void perform() {
+        const std::vector<size_t> sizes{ 1000, 10000, 100000, 1000000 };
+        for (size_t distribution = 0; distribution < (size_t)Distribution::COUNT; distribution++) {
+            std::vector<double> increments = generateIncrements(Distribution(distribution));
+            for (size_t size : sizes) {
+                for (size_t type = 0; type < (size_t)EventQueueType::COUNT; type++) {
+                    double nsPerHold = runHoldModel(EventQueueType(type), size, increments);
+                    Logger::LogInfo(JString::Format("Hold model (%s increments), %8zu events, %-15s %8.1f ns/hold",
+                        s_distributionNames[distribution], size, EventQueue::TypeName(EventQueueType(type)), nsPerHold).c_str());
+                }
+            }
+        }
+    }
+
+private:
+
+    /// @brief The distributions that increments are drawn from
+    enum class Distribution {
+        kExponential = 0,
+        kUniform,
+        kBimodal,
+        COUNT
+    };
+
+    /// @brief Pre-generate increments, so that random number generation is not timed
+    std::vector<double> generateIncrements(Distribution distribution) {
+        std::mt19937_64 generator(42);
+        std::exponential_distribution<double> exponential(1.0);
+        std::uniform_real_distribution<double> uniform(0.0, 2.0);
+        std::vector<double> increments(s_incrementCount);
+        for (double& increment : increments) {
+            switch (distribution) {
+            case Distribution::kExponential:
+                increment = exponential(generator);
+                break;
+            case Distribution::kUniform:
+                increment = uniform(generator);
+                break;
+            case Distribution::kBimodal:
+                // Mostly near-term events, with occasional events far in the future
+                increment = uniform(generator) < 1.8 ? 0.5 * uniform(generator) : 50.0 * uniform(generator);
+                break;
+            default:
+                break;
+            }
+        }
+        return increments;
+    }
+
+    /// @brief Run the hold model, returning the time per hold in nanoseconds
+    double runHoldModel(EventQueueType type, size_t size, const std::vector<double>& increments) {
+        EventQueue queue(type);
+        queue.reserve(size);
+
+        size_t next = 0;
+        for (size_t i = 0; i < size; i++) {
+            queue.schedule(Event{ increments[next++ % s_incrementCount], 0, uint32_t(i) });
+        }
+
+        Timer timer;
+        timer.start();
+        Event event;
+        for (size_t i = 0; i < s_holdCount; i++) {
+            queue.pop(event);
+            event.m_time += increments[next++ % s_incrementCount];
+            queue.schedule(event);
+        }
+        return timer.getElapsed<double>() * 1e9 / double(s_holdCount);
+    }
+
+    static constexpr size_t s_incrementCount = 1 << 20;
+    static constexpr size_t s_holdCount = 1000000;
+    static constexpr const char* s_distributionNames[] = { "exponential", "uniform", "bimodal" };
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
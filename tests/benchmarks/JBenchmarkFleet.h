@@ -0,0 +1,114 @@
+#ifndef BENCHMARK_FLEET_H
+#define BENCHMARK_FLEET_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include <algorithm>
+#include <vector>
+#include <core/sim/JSimulator.h>
+#include <core/time/JTimer.h>
+#include <core/containers/JString.h>
+#include <core/diagnostics/JLogger.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Benchmarks the fleet's step kernels, and the fleet process stepping every aircraft in a scene
+/// @details Batteries are large enough and faults rare enough that every aircraft stays airborne, so each step
+/// is one pass over the fleet. Results are reported in nanoseconds per aircraft, and as the rate at which the
+/// fleet's arrays are streamed through
+class FleetBenchmark : public Test
+{
+public:
+
+    FleetBenchmark(): Test(){}
+    ~FleetBenchmark() {}
+
+    /// @brief Step fleets of increasing size with each kernel, and then within a scene
+    virtual void perform() {
+        const std::vector<size_t> sizes{ 10000, 100000, 1000000 };
+        for (size_t size : sizes) {
+            for (size_t level = 0; level < (size_t)SimdLevel::COUNT; level++) {
+                if (!Simd::IsSupported(SimdLevel(level))) {
+                    continue;
+                }
+                logResult("Fleet kernel", Simd::LevelName(SimdLevel(level)), size, runKernel(SimdLevel(level), size));
+            }
+            logResult("Fleet process", Simd::LevelName(Simd::SupportedLevel()), size, runSteps(size));
+        }
+    }
+
+private:
+
+    void logResult(const char* name, const char* kernelName, size_t aircraftCount, double nsPerAircraft) {
+        Logger::LogInfo(JString::Format("%s (%-6s), %8zu aircraft, %6.2f ns/aircraft, %6.2f GB/s",
+            name, kernelName, aircraftCount, nsPerAircraft, double(s_bytesPerAircraft) / nsPerAircraft).c_str());
+    }
+
+    /// @brief Step a bare fleet of the given size with a kernel, returning the time per aircraft per step in nanoseconds
+    double runKernel(SimdLevel kernel, size_t aircraftCount) {
+        Fleet fleet;
+        fleet.addSpecification(Aircraft{ 120.0, 1e9, 0.6, 1.6, 4, 1e-9 });
+        fleet.addSpecification(Aircraft{ 30, 1e9, 0.3, 5.8, 2, 1e-9 });
+        for (size_t i = 0; i < aircraftCount; i++) {
+            uint32_t id = fleet.add(uint32_t(i % 2));
+            fleet.setHoursToFault(id, 1e9);
+        }
+        fleet.setKernel(kernel);
+
+        std::vector<uint32_t> interrupted;
+        fleet.step(1.0, interrupted);
+
+        size_t stepCount = std::max(s_aircraftStepCount / aircraftCount, size_t(1));
+        Timer timer;
+        timer.start();
+        for (size_t i = 0; i < stepCount; i++) {
+            fleet.step(1.0, interrupted);
+        }
+        return timer.getElapsed<double>() * 1e9 / double(stepCount * aircraftCount);
+    }
+
+    /// @brief Step a fleet of the given size, returning the time per aircraft per step in nanoseconds
+    double runSteps(size_t aircraftCount) {
+        Scene scene;
+        scene.setChargerCount(1);
+        scene.addCompany("Alpha", Aircraft{ 120.0, 1e9, 0.6, 1.6, 4, 1e-9 });
+        scene.addCompany("Echo", Aircraft{ 30, 1e9, 0.3, 5.8, 2, 1e-9 });
+        scene.addAircraft(aircraftCount, 42);
+        scene.setFlightModel(FlightModel::kFixedStep);
+
+        Simulator sim(0);
+        sim.setDeterministic(true);
+        scene.initialize(sim);
+
+        // Warm up, so that the first pass doesn't pay for page faults
+        sim.simulateUntil(1.0, 1.0);
+
+        size_t stepCount = std::max(s_aircraftStepCount / aircraftCount, size_t(1));
+        Timer timer;
+        timer.start();
+        sim.simulateUntil(1.0 + double(stepCount), 1.0);
+        return timer.getElapsed<double>() * 1e9 / double(stepCount * aircraftCount);
+    }
+
+    /// @brief The total number of aircraft steps to time for each fleet size
+    static constexpr size_t s_aircraftStepCount = 50000000;
+
+    /// @brief The bytes read and written per airborne aircraft each step: the state and company are read, and
+    /// the battery charge, distance and time to fault are read and written
+    static constexpr size_t s_bytesPerAircraft = sizeof(AircraftState) + sizeof(uint32_t) + 3 * 2 * sizeof(double);
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef BENCHMARK_LOGGER_H
+#define BENCHMARK_LOGGER_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include <iostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+#include <core/containers/JString.h>
+#include <core/diagnostics/JLogger.h>
+#include <core/time/JTimer.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Benchmarks logging a million messages in bursts, from one thread and from several
+/// @details Messages are written to a stream that discards them, so that the console isn't measured. Results are
+/// reported in nanoseconds per message until everything has been written, and in nanoseconds per call as timed by
+/// each logging thread, which is what a caller waits for. On a machine with fewer cores than logging threads plus
+/// the writer, the time per call also includes whatever the writer and other threads run in between
+class LoggerBenchmark : public Test
+{
+public:
+
+    LoggerBenchmark(): Test(){}
+    ~LoggerBenchmark() {}
+
+    virtual void perform() {
+        for (size_t threadCount : { size_t(1), s_threadCount }) {
+            for (size_t mode = 0; mode < (size_t)LogMode::COUNT; mode++) {
+                double callSec = 0.0;
+                double totalSec = runLogger(LogMode(mode), threadCount, callSec);
+                Logger::LogInfo(JString::Format("Logger, %zu messages on %zu threads, %s %7.1f ns/message, %7.1f ns/call",
+                    s_messageCount, threadCount, s_modeNames[mode], totalSec * 1e9 / s_messageCount,
+                    callSec * 1e9 / s_messageCount).c_str());
+            }
+        }
+    }
+
+private:
+
+    /// @brief How each message is logged
+    enum class LogMode {
+        kSync = 0, // Formatted with JString::Format and written at once under the logger's lock
+        kAsync, // Formatted with JString::Format and queued for the background writer
+        kPreformatted, // The same text every time, queued for the background writer, which times the queue alone
+        kBinary, // The raw arguments of a registered format, queued for the background writer to format
+        COUNT
+    };
+
+    /// @brief A stream buffer that discards everything written to it
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+    };
+
+    /// @brief Log every message across the given number of threads
+    /// @param[out] outCallSec The time spent in logging calls, summed over the threads
+    /// @return The time taken until every message was written
+    double runLogger(LogMode mode, size_t threadCount, double& outCallSec) {
+        Logger& logger = Logger::Get();
+        NullBuffer nullBuffer;
+        std::streambuf* consoleBuffer = std::cout.rdbuf(&nullBuffer);
+        if (mode != LogMode::kSync) {
+            logger.startAsync(s_capacity, LogOverflowPolicy::kBlock);
+        }
+
+        // Log in bursts that fit in the queue, as a simulation does between reports, waiting for the writer to
+        // catch up after each. Each thread times only its own calls, so starting threads isn't counted
+        Timer timer;
+        timer.start();
+        std::vector<Timer> callTimers(threadCount);
+        for (size_t burst = 0; burst < s_messageCount / s_burstCount; burst++) {
+            std::vector<std::thread> threads;
+            for (size_t thread = 0; thread < threadCount; thread++) {
+                threads.emplace_back([mode, threadCount, &callTimer = callTimers[thread]]() {
+                    static const LogFormat s_format(s_message);
+                    callTimer.start();
+                    for (size_t i = 0; i < s_burstCount / threadCount; i++) {
+                        switch (mode) {
+                        case LogMode::kPreformatted:
+                            Logger::LogInfo("Aircraft 1042 of Alpha finished charging at Vertiport 3 after 0.250 hours and is waiting for passengers");
+                            break;
+                        case LogMode::kBinary:
+                            Logger::LogInfo(s_format, i, "Alpha", "Vertiport 3", 0.25 * i);
+                            break;
+                        default:
+                            Logger::LogInfo(JString::Format(s_message, i, "Alpha", "Vertiport 3", 0.25 * i).c_str());
+                            break;
+                        }
+                    }
+                    callTimer.stop();
+                });
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+            logger.flush();
+        }
+        logger.stopAsync();
+        double totalSec = timer.getElapsed<double>();
+
+        outCallSec = 0.0;
+        for (const Timer& callTimer : callTimers) {
+            outCallSec += callTimer.getElapsed<double>();
+        }
+        std::cout.rdbuf(consoleBuffer);
+        return totalSec;
+    }
+
+    static constexpr const char* s_modeNames[(size_t)LogMode::COUNT] = { "sync:        ", "async:       ", "preformatted:", "binary:      " };
+    static constexpr const char* s_message = "Aircraft %zu of %s finished charging at %s after %.3f hours and is waiting for passengers";
+    static constexpr size_t s_messageCount = 1000000;
+    static constexpr size_t s_threadCount = 4;
+    static constexpr size_t s_burstCount = 4000;
+    static constexpr size_t s_capacity = 8192;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
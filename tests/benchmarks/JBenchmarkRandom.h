@@ -0,0 +1,108 @@
+#ifndef BENCHMARK_RANDOM_H
+#define BENCHMARK_RANDOM_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <vector>
+#include <core/random/JPhilox.h>
+#include <core/random/JRandomStream.h>
+#include <core/simd/JSimd.h>
+#include <core/time/JTimer.h>
+#include <core/containers/JString.h>
+#include <core/diagnostics/JLogger.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Benchmarks drawing random numbers one at a time and in batches, and generating fleets with them
+/// @details Results are reported in nanoseconds per draw, or per aircraft
+class RandomBenchmark : public Test
+{
+public:
+
+    RandomBenchmark(): Test(){}
+    ~RandomBenchmark() {}
+
+    /// @brief Draw uniform and exponential values with each kernel, and then add large fleets to a scene
+    virtual void perform() {
+        Logger::LogInfo(JString::Format("Random draws, one at a time, %6.2f ns/draw", runSingle()).c_str());
+        for (size_t level = 0; level < (size_t)SimdLevel::COUNT; level++) {
+            if (!Simd::IsSupported(SimdLevel(level))) {
+                continue;
+            }
+            Logger::LogInfo(JString::Format("Random draws, batched (%-6s), %6.2f ns/uniform, %6.2f ns/exponential",
+                Simd::LevelName(SimdLevel(level)), runBatch(SimdLevel(level), false), runBatch(SimdLevel(level), true)).c_str());
+        }
+        for (size_t size : { 100000, 1000000 }) {
+            Logger::LogInfo(JString::Format("Fleet generation, %8zu aircraft, %6.2f ns/aircraft", size, runFleet(size)).c_str());
+        }
+    }
+
+private:
+
+    /// @brief Draw uniform values from a stream one at a time, returning the time per draw in nanoseconds
+    double runSingle() {
+        RandomStream stream(1, 0);
+        double sum = 0.0;
+        Timer timer;
+        timer.start();
+        for (size_t i = 0; i < s_drawCount; i++) {
+            sum += stream.uniform();
+        }
+        double elapsed = timer.getElapsed<double>();
+        assert_(sum > 0.0);
+        return elapsed * 1e9 / double(s_drawCount);
+    }
+
+    /// @brief Draw values in batches with a kernel, returning the time per draw in nanoseconds
+    double runBatch(SimdLevel kernel, bool exponential) {
+        std::vector<double> values(s_batchSize);
+        const uint64_t key = Philox::KeyFromSeed(1);
+        Timer timer;
+        timer.start();
+        for (size_t first = 0; first < s_drawCount; first += s_batchSize) {
+            if (exponential) {
+                Philox::GenerateExponentials(key, 0, first, false, 0.25, values.data(), s_batchSize, kernel);
+            }
+            else {
+                Philox::GenerateUniforms(key, 0, first, false, values.data(), s_batchSize, kernel);
+            }
+        }
+        return timer.getElapsed<double>() * 1e9 / double(s_drawCount);
+    }
+
+    /// @brief Add a fleet of the given size to a scene, returning the time per aircraft in nanoseconds
+    double runFleet(size_t aircraftCount) {
+        Scene scene;
+        for (size_t i = 0; i < 4; i++) {
+            scene.addVertiport("Vertiport " + std::to_string(i), 1);
+        }
+        SampleCompanies::AddTo(scene, { "Alpha", "Beta", "Echo" });
+
+        Timer timer;
+        timer.start();
+        scene.addAircraft(aircraftCount, 42);
+        for (uint32_t i = 0; i < aircraftCount; i++) {
+            scene.fleet().setHoursToFault(i, scene.drawHoursToFault(i));
+        }
+        return timer.getElapsed<double>() * 1e9 / double(aircraftCount);
+    }
+
+    static constexpr size_t s_drawCount = 10000000;
+    static constexpr size_t s_batchSize = 1024;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef BENCHMARK_SCENARIO_H
+#define BENCHMARK_SCENARIO_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <thread>
+#include <core/containers/JString.h>
+#include <core/diagnostics/JLogger.h>
+#include <apps/eVTOL/sim/JScenarioGenerator.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Benchmarks generating large scenes on one thread and on every thread
+/// @details Results are reported in seconds per scene, with the memory the scene holds
+class ScenarioBenchmark : public Test
+{
+public:
+
+    ScenarioBenchmark(): Test(){}
+    ~ScenarioBenchmark() {}
+
+    /// @brief Generate scenes of increasing size, with as many vertiports as a large network
+    virtual void perform() {
+        size_t threadCounts[] = { 0, std::thread::hardware_concurrency() };
+        for (size_t aircraftCount : { 100000, 1000000 }) {
+            for (size_t threadCount : threadCounts) {
+                ScenarioSettings settings;
+                settings.m_aircraftCount = aircraftCount;
+                settings.m_vertiportCount = 64;
+                settings.m_chargerCount = aircraftCount / 640;
+                settings.m_seed = 2021;
+
+                Scene scene;
+                SampleCompanies::AddTo(scene);
+                ScenarioGenerator generator(threadCount);
+                ScenarioStatistics statistics = generator.build(scene, settings);
+                assert_(scene.fleet().size() == aircraftCount);
+                Logger::LogInfo(JString::Format("Scenario generation, %8zu aircraft, %2zu threads, %6.3f s, %7.1f MB",
+                    aircraftCount, std::max<size_t>(generator.threadCount(), 1), statistics.m_elapsedSec,
+                    double(statistics.m_memoryBytes) / (1024.0 * 1024.0)).c_str());
+            }
+        }
+    }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef BENCHMARK_TABLE_H
+#define BENCHMARK_TABLE_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <core/containers/JString.h>
+#include <core/diagnostics/JLogger.h>
+#include <core/random/JRandomStream.h>
+#include <core/serialization/JTable.h>
+#include <core/time/JTimer.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Benchmarks exporting a million rows of replica metrics, formatted with JString::Format and written
+/// directly, against a TableWriter writing CSV and the columnar format
+/// @details Results are reported in nanoseconds per row, both in total and for the thread adding rows, which is
+/// all the simulation waits for
+class TableBenchmark : public Test
+{
+public:
+
+    TableBenchmark(): Test(){}
+    ~TableBenchmark() {}
+
+    /// @brief Export the same rows each way
+    virtual void perform() {
+        RandomStream stream(17, 0);
+        m_metrics.resize(s_rowCount * s_metricCount);
+        stream.exponentials(0.1, m_metrics.data(), m_metrics.size());
+
+        double formatSec = runFormat();
+        Logger::LogInfo(JString::Format("Table, %zu rows, Format:   %7.1f ns/row, %6.1f MB",
+            s_rowCount, formatSec * 1e9 / s_rowCount, fileMegabytes(s_csvPath)).c_str());
+        for (TableFormat format : { TableFormat::kCsv, TableFormat::kColumnar }) {
+            const char* path = format == TableFormat::kCsv ? s_csvPath : s_tablePath;
+            double addSec = 0.0;
+            double totalSec = runWriter(path, format, addSec);
+            Logger::LogInfo(JString::Format("Table, %zu rows, %s %7.1f ns/row, %7.1f ns/row adding, %6.1f MB",
+                s_rowCount, format == TableFormat::kCsv ? "CSV:     " : "columnar:", totalSec * 1e9 / s_rowCount,
+                addSec * 1e9 / s_rowCount, fileMegabytes(path)).c_str());
+        }
+        std::remove(s_csvPath);
+        std::remove(s_tablePath);
+    }
+
+private:
+
+    /// @brief Format each row with JString::Format and write it, as a baseline, returning the time taken in seconds
+    double runFormat() {
+        Timer timer;
+        timer.start();
+        std::ofstream file(s_csvPath, std::ios::binary | std::ios::trunc);
+        file << "replica,seed,company,flight hours,miles,charge hours,faults,passenger miles\n";
+        for (size_t row = 0; row < s_rowCount; row++) {
+            const double* metrics = m_metrics.data() + row * s_metricCount;
+            std::string line = JString::Format("%llu,%llu,%s", (unsigned long long)(row / 5), (unsigned long long)(2021 + row / 5),
+                s_companies[row % 5]);
+            for (size_t metric = 0; metric < s_metricCount; metric++) {
+                line += JString::Format(",%.17g", metrics[metric]);
+            }
+            line += '\n';
+            file << line;
+        }
+        file.flush();
+        return timer.getElapsed<double>();
+    }
+
+    /// @brief Write the rows with a TableWriter, returning the total time taken in seconds
+    /// @param[out] outAddSec The time spent adding rows, before waiting for the writer to finish
+    double runWriter(const char* path, TableFormat format, double& outAddSec) {
+        std::vector<TableColumn> columns = {
+            { "replica", TableColumnType::kInteger },
+            { "seed", TableColumnType::kInteger },
+            { "company", TableColumnType::kText }
+        };
+        for (const char* name : { "flight hours", "miles", "charge hours", "faults", "passenger miles" }) {
+            columns.push_back({ name, TableColumnType::kReal });
+        }
+
+        Timer timer;
+        timer.start();
+        TableWriter writer(path, columns, format);
+        for (size_t row = 0; row < s_rowCount; row++) {
+            const double* metrics = m_metrics.data() + row * s_metricCount;
+            writer.add(uint64_t(row / 5)).add(uint64_t(2021 + row / 5)).add(s_companies[row % 5]);
+            for (size_t metric = 0; metric < s_metricCount; metric++) {
+                writer.add(metrics[metric]);
+            }
+            writer.endRow();
+        }
+        outAddSec = timer.getElapsed<double>();
+        writer.flush();
+        return timer.getElapsed<double>();
+    }
+
+    static double fileMegabytes(const char* path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        return double(file.tellg()) / (1024.0 * 1024.0);
+    }
+
+    std::vector<double> m_metrics;
+
+    static constexpr const char* s_csvPath = "table_benchmark.csv";
+    static constexpr const char* s_tablePath = "table_benchmark.table";
+    static constexpr size_t s_rowCount = 1000000;
+    static constexpr size_t s_metricCount = 5;
+    static constexpr const char* s_companies[5] = { "Alpha", "Beta", "Charlie", "Delta", "Echo" };
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef BENCHMARK_TRACE_H
+#define BENCHMARK_TRACE_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include <cstdio>
+#include <vector>
+#include <core/containers/JString.h>
+#include <core/diagnostics/JLogger.h>
+#include <core/diagnostics/JTrace.h>
+#include <core/random/JRandomStream.h>
+#include <core/time/JTimer.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Benchmarks recording a few million state changes to a trace, with and without compression, and reading
+/// them back
+/// @details Results are reported in nanoseconds per record, and bytes per record on disk
+class TraceBenchmark : public Test
+{
+public:
+
+    TraceBenchmark(): Test(){}
+    ~TraceBenchmark() {}
+
+    /// @brief Record a trace resembling a large fleet's, and then read it back
+    virtual void perform() {
+        // Aircraft change state in time order, at a handful of vertiports, cycling through flying, waiting and charging
+        RandomStream stream(11, 0);
+        std::vector<TraceRecord> records(s_recordCount);
+        double time = 0.0;
+        for (size_t i = 0; i < s_recordCount; i++) {
+            uint32_t aircraft = uint32_t(RandomStream::ToIndex(stream.uniform(), s_aircraftCount));
+            time += stream.uniform() * 0.01;
+            records[i] = TraceRecord{ time, aircraft, aircraft % s_vertiportCount, uint8_t(i % 3) };
+        }
+
+        for (bool compress : { false, true }) {
+            Timer timer;
+            timer.start();
+            size_t writtenBytes = 0;
+            {
+                TraceRecorder recorder(s_path, Scene::AircraftTraceSchema(), 1, compress);
+                for (const TraceRecord& record : records) {
+                    recorder.record(0, record);
+                }
+                recorder.flush();
+                writtenBytes = recorder.writtenBytes();
+            }
+            double recordSec = timer.getElapsed<double>();
+
+            timer.reset();
+            timer.start();
+            size_t readCount = 0;
+            {
+                TraceReader reader(s_path);
+                std::vector<TraceRecord> block;
+                while (reader.readBlock(block)) {
+                    readCount += block.size();
+                }
+            }
+            double readSec = timer.getElapsed<double>();
+            assert_(readCount == s_recordCount);
+
+            Logger::LogInfo(JString::Format("Trace, %zu records, %s: record %6.2f ns, read %6.2f ns, %5.2f bytes per record",
+                s_recordCount, compress ? "LZ4" : "raw", recordSec * 1e9 / s_recordCount, readSec * 1e9 / s_recordCount,
+                double(writtenBytes) / s_recordCount).c_str());
+        }
+        std::remove(s_path);
+    }
+
+private:
+
+    static constexpr const char* s_path = "trace_benchmark.trace";
+    static constexpr size_t s_recordCount = 4000000;
+    static constexpr uint64_t s_aircraftCount = 100000;
+    static constexpr uint32_t s_vertiportCount = 64;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
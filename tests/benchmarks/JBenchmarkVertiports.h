@@ -0,0 +1,77 @@
+#ifndef BENCHMARK_VERTIPORTS_H
+#define BENCHMARK_VERTIPORTS_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <string>
+#include <thread>
+#include <vector>
+#include <core/sim/JPartitionedSimulator.h>
+#include <core/time/JTimer.h>
+#include <core/containers/JString.h>
+#include <core/diagnostics/JLogger.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Benchmarks vertiport networks run as partitions, on the calling thread and across every hardware thread
+/// @details Each vertiport has the same number of aircraft and chargers, so the work grows with the number of
+/// vertiports. Results are reported in events per second, and as the speedup from running partitions in parallel
+class VertiportBenchmark : public Test
+{
+public:
+
+    VertiportBenchmark(): Test(){}
+    ~VertiportBenchmark() {}
+
+    /// @brief Run networks of increasing size with and without worker threads
+    virtual void perform() {
+        const std::vector<size_t> sizes{ 1, 4, 16, 64 };
+        const size_t threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+        for (size_t size : sizes) {
+            double serialRate = run(size, 0);
+            double parallelRate = run(size, threadCount);
+            Logger::LogInfo(JString::Format("Vertiport network, %3zu vertiports, %8.0f events/s on one thread, %8.0f events/s on %zu threads, %.2fx",
+                size, serialRate, parallelRate, threadCount, parallelRate / serialRate).c_str());
+        }
+    }
+
+private:
+
+    /// @brief Simulate a day of a network on the given number of threads, returning the number of events per second
+    double run(size_t vertiportCount, size_t threadCount) {
+        Scene scene;
+        for (size_t i = 0; i < vertiportCount; i++) {
+            scene.addVertiport("Vertiport " + std::to_string(i), s_chargerCount);
+        }
+        SampleCompanies::AddTo(scene, { "Alpha", "Beta", "Echo" });
+        scene.addAircraft(vertiportCount * s_aircraftCount, 42);
+
+        Timer timer;
+        timer.start();
+        PartitionedSimulator sim(vertiportCount, threadCount);
+        scene.initialize(sim);
+        sim.simulateUntil(24.0 * 3600.0);
+        scene.finalize(sim.simulationTime());
+        return double(sim.statistics().m_eventCount) / timer.getElapsed<double>();
+    }
+
+    /// @brief The number of aircraft and chargers per vertiport
+    static constexpr size_t s_aircraftCount = 1000;
+    static constexpr size_t s_chargerCount = 50;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
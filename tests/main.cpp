@@ -14,6 +14,36 @@
 #include "unit_tests/JTestTimer.h"
 #include "unit_tests/JTestUnits.h"
 #include "unit_tests/JTestThreadpool.h"
+#include "unit_tests/JTestMpscQueue.h"
+#include "unit_tests/JTestEventQueue.h"
+#include "unit_tests/JTestEventDispatch.h"
+#include "unit_tests/JTestSimulator.h"
+#include "unit_tests/JTestDeterminism.h"
+#include "unit_tests/JTestRandom.h"
+#include "unit_tests/JTestCheckpoint.h"
+#include "unit_tests/JTestEnsemble.h"
+#include "unit_tests/JTestStatistics.h"
+#include "unit_tests/JTestScenario.h"
+#include "unit_tests/JTestConfig.h"
+#include "unit_tests/JTestTrace.h"
+#include "unit_tests/JTestTable.h"
+#include "unit_tests/JTestDemand.h"
+#include "unit_tests/JTestLogger.h"
+#include "unit_tests/JTestParameterSweep.h"
+#include "unit_tests/JTestFleet.h"
+#include "unit_tests/JTestChargerAllocator.h"
+#include "unit_tests/JTestVertiports.h"
+#include "benchmarks/JBenchmarkEventQueue.h"
+#include "benchmarks/JBenchmarkFleet.h"
+#include "benchmarks/JBenchmarkChargers.h"
+#include "benchmarks/JBenchmarkVertiports.h"
+#include "benchmarks/JBenchmarkRandom.h"
+#include "benchmarks/JBenchmarkScenario.h"
+#include "benchmarks/JBenchmarkConfig.h"
+#include "benchmarks/JBenchmarkTrace.h"
+#include "benchmarks/JBenchmarkTable.h"
+#include "benchmarks/JBenchmarkDemand.h"
+#include "benchmarks/JBenchmarkLogger.h"
 
 using namespace joby;
 
@@ -23,6 +53,36 @@ int main(int argc, char* argv[]) {
     tests.addTest(new TimerTest());
     tests.addTest(new UnitsTest());
     tests.addTest(new ThreadpoolTest());
+    tests.addTest(new MpscQueueTest());
+    tests.addTest(new EventQueueTest());
+    tests.addTest(new EventDispatchTest());
+    tests.addTest(new SimulatorTest());
+    tests.addTest(new DeterminismTest());
+    tests.addTest(new RandomTest());
+    tests.addTest(new CheckpointTest());
+    tests.addTest(new EnsembleTest());
+    tests.addTest(new StatisticsTest());
+    tests.addTest(new ScenarioTest());
+    tests.addTest(new ConfigTest());
+    tests.addTest(new TraceTest());
+    tests.addTest(new TableTest());
+    tests.addTest(new DemandTest());
+    tests.addTest(new LoggerTest());
+    tests.addTest(new ParameterSweepTest());
+    tests.addTest(new FleetTest());
+    tests.addTest(new ChargerAllocatorTest());
+    tests.addTest(new VertiportTest());
+    tests.addTest(new EventQueueBenchmark());
+    tests.addTest(new FleetBenchmark());
+    tests.addTest(new ChargerBenchmark());
+    tests.addTest(new VertiportBenchmark());
+    tests.addTest(new RandomBenchmark());
+    tests.addTest(new ScenarioBenchmark());
+    tests.addTest(new ConfigBenchmark());
+    tests.addTest(new TraceBenchmark());
+    tests.addTest(new TableBenchmark());
+    tests.addTest(new DemandBenchmark());
+    tests.addTest(new LoggerBenchmark());
 
     // Run tests
     tests.runTests();
@@ -0,0 +1,159 @@
+#ifndef TEST_CHARGER_ALLOCATOR_H
+#define TEST_CHARGER_ALLOCATOR_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <set>
+#include <stdexcept>
+#include <vector>
+#include <core/random/JRandomStream.h>
+#include <core/serialization/JBinaryStream.h>
+#include <core/sim/JSimulator.h>
+#include <apps/eVTOL/entities/charger/JChargerAllocator.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class ChargerAllocatorTest : public Test
+{
+public:
+
+    ChargerAllocatorTest(): Test(){}
+    ~ChargerAllocatorTest() {}
+
+    /// @brief Perform unit tests for charger allocation and queueing
+    virtual void perform() {
+        // Chargers should be handed out lowest first, matching a brute-force set of free chargers
+        const size_t chargerCount = 10000;
+        ChargerAllocator allocator;
+        allocator.resize(chargerCount);
+        std::set<uint32_t> free;
+        for (uint32_t i = 0; i < chargerCount; i++) {
+            free.insert(i);
+        }
+        RandomStream stream(21, 0);
+        std::vector<uint32_t> occupied;
+        uint32_t charger = 0;
+        uint32_t aircraft = 0;
+        for (size_t i = 0; i < 100000; i++) {
+            if (occupied.empty() || (free.size() && stream.uniform() < 0.55)) {
+                assert_(allocator.tryAcquire(double(i), charger));
+                assert_(charger == *free.begin());
+                free.erase(free.begin());
+                occupied.push_back(charger);
+            }
+            else {
+                size_t position = size_t(stream.uniformIndex(occupied.size()));
+                std::swap(occupied[position], occupied.back());
+                assert_(!allocator.release(occupied.back(), double(i), aircraft));
+                free.insert(occupied.back());
+                occupied.pop_back();
+            }
+            assert_(allocator.freeCount() == free.size());
+        }
+        while (allocator.tryAcquire(0.0, charger)) {}
+        assert_(allocator.freeCount() == 0);
+
+        // Utilization should count the time each charger spent occupied, including a charge in progress
+        allocator.resize(2);
+        assert_(allocator.tryAcquire(10.0, charger) && charger == 0);
+        assert_(!allocator.release(0, 40.0, aircraft));
+
+        // Releasing a charger that is already free should throw without changing the count of free chargers
+        bool threw = false;
+        try {
+            allocator.release(0, 45.0, aircraft);
+        }
+        catch (const std::logic_error&) {
+            threw = true;
+        }
+        assert_(threw && allocator.freeCount() == 2);
+
+        assert_(allocator.tryAcquire(50.0, charger) && charger == 0);
+        assert_(allocator.chargers()[0].busyTime(60.0) == 40.0);
+        assert_(allocator.chargers()[0].chargeCount() == 2);
+        assert_(approxEqual(allocator.chargers()[0].utilization(60.0, 60.0), 40.0 / 60.0, 1e-12));
+
+        // Freed chargers should go straight to the next aircraft in line, in order of arrival
+        assert_(allocator.tryAcquire(50.0, charger) && charger == 1 && !allocator.tryAcquire(50.0, charger));
+        allocator.enqueue(7, 5.0);
+        allocator.enqueue(3, 1.0);
+        assert_(allocator.waitingCount() == 2);
+        assert_(allocator.release(1, 70.0, aircraft) && aircraft == 7);
+        assert_(allocator.freeCount() == 0 && allocator.chargers()[1].isOccupied());
+
+        // Checkpoints should restore the chargers and the line
+        BinaryWriter writer;
+        allocator.save(writer);
+        std::vector<char> payload = writer.buffer();
+        ChargerAllocator restored;
+        restored.resize(2);
+        BinaryReader reader(payload);
+        restored.load(reader);
+        assert_(restored.freeCount() == 0 && restored.waitingCount() == 1);
+        assert_(restored.chargers()[0].busyTime(60.0) == 40.0);
+        assert_(restored.release(0, 80.0, aircraft) && aircraft == 3);
+        assert_(!restored.release(1, 80.0, aircraft) && restored.tryAcquire(80.0, charger) && charger == 1);
+
+        // The priority line should serve the lowest priority first, and equal priorities in order of arrival
+        allocator.resize(1);
+        allocator.setPolicy(ChargerQueuePolicy::kPriority);
+        assert_(allocator.tryAcquire(0.0, charger));
+        const double priorities[] = { 3.0, 1.0, 2.0, 1.0, 3.0 };
+        for (uint32_t i = 0; i < 5; i++) {
+            allocator.enqueue(i, priorities[i]);
+        }
+        std::vector<uint32_t> served;
+        while (allocator.release(0, 0.0, aircraft)) {
+            served.push_back(aircraft);
+        }
+        assert_(served == std::vector<uint32_t>({ 1, 3, 2, 0, 4 }));
+
+        // Scenes should account for every charge and every hour of waiting, under either policy
+        for (ChargerQueuePolicy policy : { ChargerQueuePolicy::kFirstComeFirstServed, ChargerQueuePolicy::kPriority }) {
+            Scene scene;
+            scene.setChargerCount(2);
+            scene.setChargerQueuePolicy(policy);
+            SampleCompanies::AddTo(scene, { "Alpha", "Echo" });
+            scene.addAircraft(20, 6);
+
+            Simulator sim(0);
+            sim.setDeterministic(true);
+            scene.initialize(sim);
+            sim.simulateUntil(3.0 * 3600.0, 1.0);
+            scene.finalize(sim.simulationTime());
+
+            size_t chargeCount = 0;
+            double waitTime = 0.0;
+            double companyWaitTime = 0.0;
+            for (const Charger& sceneCharger : scene.vertiports()[0].chargers()) {
+                chargeCount += sceneCharger.chargeCount();
+                assert_(sceneCharger.utilization(sim.simulationTime(), sim.simulationTime()) <= 1.0);
+            }
+            for (uint32_t i = 0; i < scene.fleet().size(); i++) {
+                waitTime += scene.fleet().waitTime(i);
+            }
+            for (const Company& company : scene.companies()) {
+                chargeCount -= company.statistics().m_chargeCount;
+                companyWaitTime += company.statistics().m_waitTime;
+            }
+            assert_(chargeCount == 0);
+            assert_(waitTime > 0.0 && approxEqual(waitTime, companyWaitTime, 1e-9));
+        }
+    }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef TEST_CHECKPOINT_H
+#define TEST_CHECKPOINT_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <core/serialization/JCheckpoint.h>
+#include <core/sim/JSimulator.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class CheckpointTest : public Test
+{
+public:
+
+    CheckpointTest(): Test(){}
+    ~CheckpointTest() {}
+
+    /// @brief Perform unit tests for saving and restoring simulation state
+    virtual void perform() {
+
+        // Binary streams should round-trip, and refuse to read past the end
+        BinaryWriter writer;
+        writer.write(3.5);
+        writer.writeString("eVTOL");
+        writer.writeVector(std::vector<uint32_t>{ 1, 2, 3 });
+        BinaryReader reader(writer.buffer());
+        std::vector<uint32_t> values;
+        assert_(reader.read<double>() == 3.5);
+        std::string name = reader.readString();
+        reader.readVector(values);
+        assert_(name == "eVTOL" && values.size() == 3 && values[2] == 3);
+        assert_(reader.atEnd());
+        assert_(throws([&reader]() { reader.read<uint8_t>(); }));
+
+        // A saved event queue should pop the same events, and keep its handles valid
+        for (size_t i = 0; i < (size_t)EventQueueType::COUNT; i++) {
+            EventQueue queue{ EventQueueType(i) };
+            std::vector<EventHandle> handles;
+            for (uint32_t j = 0; j < 200; j++) {
+                handles.push_back(queue.schedule(Event{ double(j % 13), 0, j }));
+            }
+            for (uint32_t j = 0; j < 200; j += 7) {
+                queue.cancel(handles[j]);
+            }
+
+            BinaryWriter queueWriter;
+            queue.save(queueWriter);
+            EventQueue restored{ EventQueueType(i) };
+            BinaryReader queueReader(queueWriter.buffer());
+            restored.load(queueReader);
+            assert_(restored.size() == queue.size());
+            assert_(restored.reschedule(handles[1], 20.0) && queue.reschedule(handles[1], 20.0));
+            assert_(!restored.isPending(handles[7]));
+
+            Event expected;
+            Event event;
+            while (queue.pop(expected)) {
+                assert_(restored.pop(event));
+                assert_(event.m_time == expected.m_time && event.m_target == expected.m_target);
+            }
+            assert_(restored.empty());
+        }
+
+        // Restoring mid-run and carrying on should end exactly where an uninterrupted run does
+        const std::string path = "checkpoint_test.checkpoint";
+        uint64_t expectedHash = runScene(3.0 * 3600.0, "", "");
+        uint64_t savedHash = runScene(1.25 * 3600.0, path, "");
+        assert_(savedHash != expectedHash);
+        assert_(runScene(3.0 * 3600.0, "", path) == expectedHash);
+
+        // Damaged or mismatched checkpoints should be rejected
+        {
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(-1, std::ios::end);
+            file.put('\x7f');
+        }
+        assert_(throws([&path]() { Checkpoint::Read(path); }));
+        assert_(throws([]() { Checkpoint::Read("missing.checkpoint"); }));
+
+        BinaryWriter sceneWriter;
+        std::unique_ptr<Scene> smallScene = createScene(5);
+        smallScene->save(sceneWriter);
+        std::unique_ptr<Scene> largeScene = createScene(10);
+        BinaryReader sceneReader(sceneWriter.buffer());
+        assert_(throws([&]() { largeScene->load(sceneReader); }));
+
+        std::remove(path.c_str());
+    }
+
+private:
+
+    /// @brief Set up an eVTOL scene with the given number of aircraft
+    std::unique_ptr<Scene> createScene(size_t aircraftCount) {
+        std::unique_ptr<Scene> scene = std::make_unique<Scene>();
+        scene->setChargerCount(3);
+        SampleCompanies::AddTo(*scene, { "Alpha", "Beta", "Echo" });
+        scene->addAircraft(aircraftCount, 5);
+        return scene;
+    }
+
+    /// @brief Run the eVTOL scenario until the given time, returning the run hash
+    /// @param[in] savePath If set, the final state is checkpointed to this path
+    /// @param[in] restorePath If set, the run starts from the checkpoint at this path
+    uint64_t runScene(double endTime, const std::string& savePath, const std::string& restorePath) {
+        std::unique_ptr<Scene> scene = createScene(12);
+        Simulator sim(1);
+        sim.setDeterministic(true);
+        scene->initialize(sim);
+        if (!restorePath.empty()) {
+            std::vector<char> payload = Checkpoint::Read(restorePath);
+            BinaryReader reader(payload);
+            sim.load(reader);
+            scene->load(reader);
+            assert_(reader.atEnd());
+        }
+
+        sim.simulateUntil(endTime, 1.0);
+        if (!savePath.empty()) {
+            CheckpointWriter checkpointWriter;
+            BinaryWriter& writer = checkpointWriter.beginSnapshot();
+            sim.save(writer);
+            scene->save(writer);
+            checkpointWriter.commit(savePath);
+            checkpointWriter.flush();
+            assert_(checkpointWriter.writtenCount() == 1);
+        }
+
+        scene->finalize(sim.simulationTime());
+        scene->hashState(sim.runHash());
+        return sim.runHash().value();
+    }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
@@ -0,0 +1,171 @@
+#ifndef TEST_CONFIG_H
+#define TEST_CONFIG_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <cstdio>
+#include <fstream>
+#include <core/containers/JString.h>
+#include <core/serialization/JConfigFile.h>
+#include <core/serialization/JMappedFile.h>
+#include <apps/eVTOL/sim/JScenarioConfig.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class ConfigTest : public Test
+{
+public:
+
+    ConfigTest(): Test(){}
+    ~ConfigTest() {}
+
+    /// @brief Perform unit tests for tokenizing text, and loading config and fleet files
+    virtual void perform() {
+
+        // Tokens should be views into the text, with empty tokens between adjacent delimiters
+        {
+            std::string_view text = "a,,bc ,";
+            const char* start = text.data();
+            assert_(JString::NextToken(text, ',') == "a");
+            assert_(JString::NextToken(text, ',').empty());
+            std::string_view token = JString::NextToken(text, ',');
+            assert_(token == "bc " && token.data() == start + 3);
+            assert_(text.empty() && JString::NextToken(text, ',').empty());
+            assert_(JString::Trim(" \t x y \r\n") == "x y" && JString::Trim(" \t").empty());
+
+            double value;
+            uint32_t count;
+            assert_(JString::ToNumber("2.5e-1", value) && value == 0.25);
+            assert_(JString::ToNumber("42", count) && count == 42);
+            assert_(!JString::ToNumber("42x", count) && !JString::ToNumber("", value) && !JString::ToNumber("-1", count));
+        }
+
+        // Config files should keep the order of repeated sections, and ignore comments and whitespace
+        {
+            ConfigFile file = ConfigFile::Parse(
+                "; The scene\n"
+                "[scenario]\n"
+                "seed = 7   # a comment\n"
+                "\n"
+                "  hours=1.5\r\n"
+                "[company]\n"
+                "name = Alpha\n"
+                "[company]\n"
+                "name = Beta\n");
+            assert_(file.sections().size() == 3);
+            const ConfigSection* scenario = file.section("scenario");
+            assert_(scenario && scenario->number<uint64_t>("seed") == 7 && scenario->number<double>("hours") == 1.5);
+            assert_(scenario->number<double>("missing", 2.0) == 2.0 && !scenario->has("missing"));
+            assert_(file.sections()[1].value("name") == "Alpha" && file.sections()[2].value("name") == "Beta");
+            assert_(file.sections()[2].entries()[0].m_line == 9);
+
+            // Errors should name the line they are on
+            assert_(throwsWith([]() { ConfigFile::Parse("[scenario]\nseed\n", "test.ini"); }, "test.ini:2"));
+            assert_(throwsWith([]() { ConfigFile::Parse("[scenario\n"); }, ":1"));
+            assert_(throwsWith([&]() { scenario->number<uint64_t>("hours"); }, ":5"));
+            assert_(throwsWith([&]() { scenario->value("name"); }, "missing name"));
+        }
+
+        // Scenario configs should build the same scene as one set up in code, unless weights are given
+        const std::string configPath = "config_test.ini";
+        const std::string fleetPath = "config_test_fleet.csv";
+        {
+            std::ofstream file(configPath, std::ios::trunc);
+            file << "[scenario]\nseed = 11\naircraft = 300\nvertiports = 3\nchargers = 2\nhours = 2\n\n";
+            file << "[company]\nname = Alpha\ncruise_speed = 120\nbattery_capacity = 320\ncharge_time = 0.6\n"
+                "energy_use = 1.6\npassengers = 4\nfault_rate = 0.25\n\n";
+            file << "[company]\nname = Echo\ncruise_speed = 30\nbattery_capacity = 150\ncharge_time = 0.3\n"
+                "energy_use = 5.8\npassengers = 2\nfault_rate = 0.61\n";
+        }
+        {
+            ScenarioConfig config = ScenarioConfig::Load(configPath);
+            assert_(config.m_companies.size() == 2 && config.m_companies[1].m_name == "Echo");
+            assert_(config.m_companies[1].m_aircraft.energyUse() == 5.8 && config.m_companies[0].m_aircraft.maxPassengerCount() == 4);
+            assert_(config.m_hours == 2.0 && config.m_scenario.m_chargerCount == 2 && config.m_scenario.m_companyWeights.empty());
+
+            Scene loaded;
+            config.addCompanies(loaded);
+            ScenarioGenerator(0).build(loaded, config.m_scenario);
+            Scene coded;
+            SampleCompanies::AddTo(coded, { "Alpha", "Echo" });
+            for (size_t i = 0; i < 3; i++) {
+                coded.addVertiport("Vertiport " + std::to_string(i), 2);
+            }
+            coded.addAircraft(300, 11);
+            assert_(loaded.fleet().size() == coded.fleet().size());
+            for (uint32_t i = 0; i < loaded.fleet().size(); i++) {
+                assert_(loaded.fleet().companyId(i) == coded.fleet().companyId(i));
+                assert_(loaded.fleet().vertiportId(i) == coded.fleet().vertiportId(i));
+            }
+
+            // Fleet files should give exactly the aircraft they list, and name the line of any bad row
+            {
+                std::ofstream file(fleetPath, std::ios::trunc);
+                file << "company,vertiport\nEcho,2\r\n\nAlpha, 0\nEcho,1";
+            }
+            Scene fleet;
+            config.addCompanies(fleet);
+            config.m_scenario.m_fleetPath = fleetPath;
+            ScenarioGenerator(0).build(fleet, config.m_scenario);
+            assert_(fleet.fleet().size() == 3);
+            assert_(fleet.fleet().companyId(0) == 1 && fleet.fleet().vertiportId(0) == 2);
+            assert_(fleet.fleet().companyId(1) == 0 && fleet.fleet().vertiportId(1) == 0);
+            assert_(fleet.fleet().companyId(2) == 1 && fleet.fleet().vertiportId(2) == 1);
+            assert_(fleet.randomStream(2).state() == coded.randomStream(2).state());
+
+            {
+                std::ofstream file(fleetPath, std::ios::trunc);
+                file << "Alpha,0\nGamma,1\n";
+            }
+            assert_(throwsWith([&]() { Scene other; config.addCompanies(other); ScenarioGenerator(0).build(other, config.m_scenario); }, ":2: no company named Gamma"));
+            {
+                std::ofstream file(fleetPath, std::ios::trunc);
+                file << "Alpha,3\n";
+            }
+            assert_(throws([&]() { Scene other; config.addCompanies(other); ScenarioGenerator(0).build(other, config.m_scenario); }));
+        }
+
+        // Mapped files should see the whole file, and survive being moved
+        {
+            MappedFile file(configPath);
+            std::ifstream stream(configPath, std::ios::binary);
+            std::string contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+            const char* data = file.data();
+            MappedFile moved(std::move(file));
+            assert_(moved.view() == contents && moved.data() == data && !file.isOpen());
+            assert_(throws([]() { MappedFile missing("missing_config.ini"); }));
+        }
+        std::remove(configPath.c_str());
+        std::remove(fleetPath.c_str());
+    }
+
+private:
+
+    /// @brief Whether the function throws an error containing the given text
+    template<typename Function>
+    static bool throwsWith(const Function& function, const std::string& text) {
+        try {
+            function();
+        }
+        catch (const std::exception& exception) {
+            return std::string(exception.what()).find(text) != std::string::npos;
+        }
+        return false;
+    }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
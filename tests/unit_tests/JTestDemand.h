@@ -0,0 +1,233 @@
+#ifndef TEST_DEMAND_H
+#define TEST_DEMAND_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+#include <core/diagnostics/JRunHash.h>
+#include <core/serialization/JBinaryStream.h>
+#include <core/sim/JPartitionedSimulator.h>
+#include <core/sim/JSimulator.h>
+#include <apps/eVTOL/entities/vertiport/JTripQueue.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class DemandTest : public Test
+{
+public:
+
+    DemandTest(): Test(){}
+    ~DemandTest() {}
+
+    /// @brief Perform unit tests for generating trip requests and matching them to idle aircraft
+    virtual void perform() {
+
+        // Parties should get the smallest idle aircraft that fits them, in order of arrival, and those that don't
+        // fit should keep their place in line until they give up
+        {
+            DemandSettings settings;
+            settings.m_maxWait = 600.0;
+            TripQueue queue;
+            queue.reset(settings, 1, 0, false, 0, 1, 0.0);
+            queue.addIdle(10, 4);
+            queue.addIdle(11, 2);
+            queue.addIdle(12, 2);
+            queue.addIdle(13, 6);
+            queue.addRequest(TripRequest{ 0.0, 0, 5 });
+            queue.addRequest(TripRequest{ 1.0, 0, 7 });
+            queue.addRequest(TripRequest{ 2.0, 0, 1 });
+            queue.addRequest(TripRequest{ 3.0, 0, 3 });
+            queue.addRequest(TripRequest{ 4.0, 0, 2 });
+            queue.addRequest(TripRequest{ 5.0, 0, 6 });
+            assert_(queue.requestCount() == 6 && queue.idleCount() == 4);
+
+            std::vector<TripMatch> matches = queue.dispatch(10.0);
+            assert_(matches.size() == 4);
+            assert_(matches[0].m_aircraft == 13 && matches[0].m_request.m_passengerCount == 5);
+            assert_(matches[1].m_aircraft == 11 && matches[1].m_request.m_passengerCount == 1);
+            assert_(matches[2].m_aircraft == 10 && matches[2].m_request.m_passengerCount == 3);
+            assert_(matches[3].m_aircraft == 12 && matches[3].m_request.m_passengerCount == 2);
+            assert_(queue.requestCount() == 2 && queue.idleCount() == 0);
+
+            // The party of seven still fits nothing, but the party of six that arrived after it gets the next
+            // large aircraft
+            queue.addIdle(14, 6);
+            matches = queue.dispatch(20.0);
+            assert_(matches.size() == 1 && matches[0].m_aircraft == 14 && matches[0].m_request.m_time == 5.0);
+            assert_(queue.requestCount() == 1);
+
+            const DemandStatistics& statistics = queue.statistics();
+            assert_(statistics.m_requestCount == 6 && statistics.m_tripCount == 5 && statistics.m_passengerCount == 17);
+            assert_(statistics.m_waitTime.count() == 5);
+
+            queue.addIdle(15, 4);
+            assert_(queue.dispatch(602.0).empty());
+            assert_(queue.requestCount() == 0 && queue.statistics().m_abandonedCount == 1 && queue.idleCount() == 1);
+        }
+
+        // Requests should arrive at the given rate, bound for other vertiports, with parties of every allowed size
+        {
+            DemandSettings settings;
+            settings.m_tripsPerHour = 3600.0;
+            settings.m_maxWait = 1e9;
+            settings.m_maxPartySize = 3;
+            TripQueue queue;
+            TripQueue twin;
+            queue.reset(settings, 7, 1000, false, 2, 4, 0.0);
+            twin.reset(settings, 7, 1000, false, 2, 4, 0.0);
+            const double hours = 10.0;
+            for (double time = 60.0; time <= hours * 3600.0; time += 60.0) {
+                queue.generate(time);
+                twin.generate(time);
+            }
+            double expectedCount = settings.m_tripsPerHour * hours;
+            double count = double(queue.requestCount());
+            assert_(std::abs(count - expectedCount) < 5.0 * std::sqrt(expectedCount));
+            assert_(twin.requestCount() == queue.requestCount());
+
+            std::vector<size_t> partyCounts(4, 0);
+            std::vector<size_t> destinationCounts(4, 0);
+            for (size_t i = 0; i < 400; i++) {
+                queue.addIdle(uint32_t(i), 3);
+            }
+            for (const TripMatch& match : queue.dispatch(hours * 3600.0)) {
+                assert_(match.m_request.m_passengerCount >= 1 && match.m_request.m_passengerCount <= 3);
+                assert_(match.m_request.m_time <= hours * 3600.0);
+                partyCounts[match.m_request.m_passengerCount]++;
+                destinationCounts[match.m_request.m_destination]++;
+            }
+            assert_(partyCounts[1] && partyCounts[2] && partyCounts[3]);
+            assert_(destinationCounts[0] && destinationCounts[1] && !destinationCounts[2] && destinationCounts[3]);
+        }
+
+        // Every flight of a scene with demand should carry a trip that was asked for
+        {
+            std::unique_ptr<Scene> scene = createScene(4, 60.0);
+            Simulator sim(0);
+            scene->initialize(sim);
+            sim.simulateUntil(s_endTime, 1.0);
+            scene->finalize(s_endTime);
+
+            DemandStatistics statistics = scene->demandStatistics();
+            size_t flightCount = 0;
+            for (const Company& company : scene->companies()) {
+                flightCount += company.statistics().m_flightCount;
+            }
+            size_t pendingCount = 0;
+            for (const Vertiport& vertiport : scene->vertiports()) {
+                pendingCount += vertiport.tripQueue().requestCount();
+            }
+            assert_(statistics.m_tripCount == flightCount && flightCount > 0);
+            assert_(statistics.m_requestCount == statistics.m_tripCount + statistics.m_abandonedCount + pendingCount);
+            assert_(statistics.m_abandonedCount > 0 && statistics.m_idleTime > 0.0);
+        }
+
+        // Partitioned scenes with demand should give the same results on any number of threads
+        {
+            uint64_t hashes[2];
+            for (size_t threadCount : { 1, 2 }) {
+                std::unique_ptr<Scene> scene = createScene(4, 60.0);
+                PartitionedSimulator sim(scene->vertiports().size(), threadCount);
+                scene->initialize(sim);
+                sim.simulateUntil(s_endTime);
+                scene->finalize(s_endTime);
+                RunHash hash = sim.runHash();
+                scene->hashState(hash);
+                hashes[threadCount - 1] = hash.value();
+                assert_(scene->demandStatistics().m_tripCount > 0);
+            }
+            assert_(hashes[0] == hashes[1]);
+        }
+
+        // A scene with demand should pick up from a checkpoint exactly where it left off
+        {
+            uint64_t expectedHash = 0;
+            {
+                std::unique_ptr<Scene> scene = createScene(2, 30.0);
+                Simulator sim(0);
+                sim.setDeterministic(true);
+                scene->initialize(sim);
+                sim.simulateUntil(s_endTime, 1.0);
+                scene->hashState(sim.runHash());
+                expectedHash = sim.runHash().value();
+            }
+            BinaryWriter writer;
+            {
+                std::unique_ptr<Scene> scene = createScene(2, 30.0);
+                Simulator sim(0);
+                sim.setDeterministic(true);
+                scene->initialize(sim);
+                sim.simulateUntil(0.4 * s_endTime, 1.0);
+                sim.save(writer);
+                scene->save(writer);
+            }
+            std::unique_ptr<Scene> scene = createScene(2, 30.0);
+            Simulator sim(0);
+            sim.setDeterministic(true);
+            scene->initialize(sim);
+            BinaryReader reader(writer.buffer());
+            sim.load(reader);
+            scene->load(reader);
+            assert_(reader.atEnd());
+            sim.simulateUntil(s_endTime, 1.0);
+            scene->hashState(sim.runHash());
+            assert_(sim.runHash().value() == expectedHash);
+        }
+
+        // Only analytic flight can model demand, and settings should be checked
+        {
+            std::unique_ptr<Scene> scene = createScene(1, 60.0);
+            scene->setFlightModel(FlightModel::kFixedStep);
+            Simulator sim(1);
+            assert_(throws([&]() { scene->initialize(sim); }));
+
+            DemandSettings settings;
+            settings.m_tripsPerHour = -1.0;
+            assert_(throws([&]() { scene->setDemand(settings, 0); }));
+            settings.m_tripsPerHour = 10.0;
+            settings.m_dispatchInterval = 0.0;
+            assert_(throws([&]() { scene->setDemand(settings, 0); }));
+            settings.m_dispatchInterval = 60.0;
+            settings.m_maxPartySize = 0;
+            assert_(throws([&]() { scene->setDemand(settings, 0); }));
+        }
+    }
+
+private:
+
+    /// @brief Create a scene of the given number of vertiports, with demand at the given rate at each
+    std::unique_ptr<Scene> createScene(size_t vertiportCount, double tripsPerHour) {
+        std::unique_ptr<Scene> scene = std::make_unique<Scene>();
+        for (size_t i = 0; i < vertiportCount; i++) {
+            scene->addVertiport("Vertiport " + std::to_string(i), 2);
+        }
+        SampleCompanies::AddTo(*scene, { "Alpha", "Echo" });
+        scene->addAircraft(10 * vertiportCount, 3);
+        DemandSettings settings;
+        settings.m_tripsPerHour = tripsPerHour;
+        settings.m_maxWait = 900.0;
+        scene->setDemand(settings, 11);
+        return scene;
+    }
+
+    static constexpr double s_endTime = 8.0 * 3600.0;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef TEST_DETERMINISM_H
+#define TEST_DETERMINISM_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <vector>
+#include <core/processes/JThreadedProcess.h>
+#include <core/random/JRandomStream.h>
+#include <core/sim/JSimulator.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class DeterminismTest : public Test
+{
+public:
+
+    DeterminismTest(): Test(){}
+    ~DeterminismTest() {}
+
+    /// @brief Perform unit tests for deterministic simulation runs
+    virtual void perform() {
+
+        // Streams depend only on their key
+        RandomStream first(7, 0);
+        RandomStream second(7, 1);
+        RandomStream repeat(7, 0);
+        assert_(first != second && first == repeat);
+        for (size_t i = 0; i < 1000; i++) {
+            double value = first.uniform();
+            assert_(value >= 0.0 && value < 1.0);
+            assert_(value == repeat.uniform());
+            assert_(first.uniformIndex(5) < 5);
+            repeat();
+        }
+
+        // Lock-step threaded processes should give the same results at any thread count
+        uint64_t expected = runThreadedWalkers(1);
+        for (size_t threadCount : { 2, 4 }) {
+            assert_(runThreadedWalkers(threadCount) == expected);
+        }
+
+        // Lock-step processes that post more events in one step than the inbox holds should neither wait for the
+        // simulation thread nor lose any events
+        uint64_t burstExpected = runThreadedWalkers(1, s_burstPostCount, 1.0);
+        assert_(runThreadedWalkers(2, s_burstPostCount, 1.0) == burstExpected);
+
+        // The same seed should give the same eVTOL run, and a different seed a different one
+        uint64_t sceneHash = runScene(11);
+        assert_(runScene(11) == sceneHash);
+        assert_(runScene(12) != sceneHash);
+    }
+
+private:
+
+    enum class WalkEventType {
+        kStep = 0,
+        COUNT
+    };
+
+    /// @brief A threaded process that takes a random walk, posting each of its steps as an event
+    class WalkerProcess : public ThreadedProcess {
+    public:
+        WalkerProcess(uint64_t entityId, size_t stepsPerUpdate) :
+            ThreadedProcess(),
+            m_entityId(uint32_t(entityId)),
+            m_stream(99, entityId),
+            m_stepsPerUpdate(stepsPerUpdate)
+        {
+        }
+
+        virtual void onUpdate(double deltaSec) override {
+            m_time += deltaSec;
+            for (size_t i = 0; i < m_stepsPerUpdate; i++) {
+                double offset = m_stream.uniform();
+                m_position += offset - 0.5;
+
+                // Round times so that walkers often post events for the same moment
+                Event step{ m_time + std::floor(offset * 4.0) * 0.25, (uint32_t)WalkEventType::kStep, m_entityId };
+                step.setPayload(m_position);
+                postEvent(step);
+            }
+        }
+        virtual void onFixedUpdate(double) override {}
+
+        uint32_t m_entityId;
+        RandomStream m_stream;
+        size_t m_stepsPerUpdate;
+        double m_time = 0.0;
+        double m_position = 0.0;
+    };
+
+    /// @brief Accumulates walker steps in the order they are dispatched
+    struct WalkRecorder {
+        template<WalkEventType Type>
+        void onEvent(const Event& event) {
+            m_sum = m_sum * 0.5 + event.payload<double>() * (event.m_target + 1);
+        }
+
+        double m_sum = 0.0;
+    };
+
+    /// @brief Run a set of walkers in lock-step on the given number of threads, returning the run hash
+    /// @param[in] stepsPerUpdate The number of events each walker posts per update
+    uint64_t runThreadedWalkers(size_t threadCount, size_t stepsPerUpdate = 1, double endTime = 50.0) {
+        Simulator sim(threadCount);
+        sim.setDeterministic(true);
+        WalkRecorder recorder;
+        sim.eventDispatcher().setHandler<WalkEventType>(recorder);
+        for (uint64_t entityId = 0; entityId < s_walkerCount; entityId++) {
+            sim.processQueue().attachProcess(std::make_shared<WalkerProcess>(entityId, stepsPerUpdate), true);
+        }
+
+        sim.simulateUntil(endTime, 0.5);
+        uint64_t updateCount = sim.statistics().m_fixedStepCount + sim.statistics().m_partialStepCount;
+        assert_(sim.eventQueue().statistics().m_postedCount == s_walkerCount * stepsPerUpdate * updateCount);
+        assert_(sim.statistics().m_eventCount > 500);
+        sim.runHash().add(recorder.m_sum);
+        return sim.runHash().value();
+    }
+
+    /// @brief Run the eVTOL scenario with the given seed, returning the run hash
+    uint64_t runScene(uint64_t seed) {
+        Scene scene;
+        scene.setChargerCount(3);
+        SampleCompanies::AddTo(scene, { "Alpha", "Beta", "Charlie" });
+        scene.addAircraft(20, seed);
+
+        Simulator sim(1);
+        sim.setDeterministic(true);
+        scene.initialize(sim);
+        sim.simulateUntil(3.0 * 3600.0, 1.0);
+        scene.finalize(sim.simulationTime());
+        scene.hashState(sim.runHash());
+        return sim.runHash().value();
+    }
+
+    static constexpr size_t s_walkerCount = 8;
+
+    /// @brief Enough events per walker that a single update overfills the event queue's inbox
+    static constexpr size_t s_burstPostCount = 1000;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
@@ -0,0 +1,203 @@
+#ifndef TEST_ENSEMBLE_H
+#define TEST_ENSEMBLE_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <cmath>
+#include <vector>
+#include <core/random/JRandomStream.h>
+#include <core/sim/JEnsembleRunner.h>
+#include <core/sim/JSimulator.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class EnsembleTest : public Test
+{
+public:
+
+    EnsembleTest(): Test(){}
+    ~EnsembleTest() {}
+
+    /// @brief Perform unit tests for running statistics and ensembles of replicas
+    virtual void perform() {
+
+        // Running statistics should match a two-pass calculation, however the samples are sharded
+        std::vector<double> samples;
+        RandomStream stream(3, 0);
+        for (size_t i = 0; i < 1000; i++) {
+            samples.push_back(1e6 + stream.uniform());
+        }
+        double mean = 0.0;
+        for (double sample : samples) {
+            mean += sample / samples.size();
+        }
+        double variance = 0.0;
+        for (double sample : samples) {
+            variance += (sample - mean) * (sample - mean) / (samples.size() - 1);
+        }
+
+        RunningStatistics all;
+        RunningStatistics shards[3];
+        for (size_t i = 0; i < samples.size(); i++) {
+            all.add(samples[i]);
+            shards[i % 3].add(samples[i]);
+        }
+        shards[0].merge(shards[1]);
+        shards[0].merge(RunningStatistics());
+        shards[0].merge(shards[2]);
+        for (const RunningStatistics& statistics : { all, shards[0] }) {
+            assert_(statistics.count() == samples.size());
+            assert_(approxEqual(statistics.mean(), mean, 1e-6));
+            assert_(approxEqual(statistics.variance(), variance, 1e-6));
+            assert_(statistics.min() >= 1e6 && statistics.max() < 1e6 + 1.0);
+        }
+
+        // Ensembles should give identical summaries on any number of threads
+        auto uniformReplica = [](size_t replica, double* outMetrics) {
+            RandomStream replicaStream(17, replica);
+            outMetrics[0] = replicaStream.uniform();
+            outMetrics[1] = double(replica);
+        };
+        EnsembleSummary expected = EnsembleRunner(0).run(1000, 2, uniformReplica);
+        assert_(expected.m_replicaCount == 1000 && expected.m_metrics.size() == 2);
+        assert_(std::abs(expected.m_metrics[0].mean() - 0.5) < 4.0 * expected.m_metrics[0].confidenceHalfWidth());
+        assert_(expected.m_metrics[1].mean() == 499.5 && expected.m_metrics[1].max() == 999.0);
+        for (size_t threadCount : { 1, 3, 8 }) {
+            EnsembleSummary summary = EnsembleRunner(threadCount).run(1000, 2, uniformReplica);
+            for (size_t metric = 0; metric < 2; metric++) {
+                assert_(summary.m_metrics[metric].mean() == expected.m_metrics[metric].mean());
+                assert_(summary.m_metrics[metric].variance() == expected.m_metrics[metric].variance());
+            }
+        }
+
+        // Sequential ensembles should stop soon after every interval reaches its target
+        StoppingRule rule;
+        rule.m_relativeHalfWidth = 0.01;
+        EnsembleSummary sequential = EnsembleRunner(0).runUntil(rule, 2, uniformReplica, 8);
+        double uniformDeviation = std::sqrt(1.0 / 12.0);
+        double requiredCount = std::pow(rule.m_zScore * uniformDeviation / (0.5 * rule.m_relativeHalfWidth), 2.0);
+        assert_(sequential.m_converged);
+        assert_(rule.isMet(sequential.m_metrics[0]) && rule.isMet(sequential.m_metrics[1]));
+        assert_(sequential.m_replicaCount % 8 == 0);
+        assert_(sequential.m_replicaCount > 0.8 * requiredCount && sequential.m_replicaCount < 1.5 * requiredCount);
+        for (size_t threadCount : { 2, 5 }) {
+            EnsembleSummary summary = EnsembleRunner(threadCount).runUntil(rule, 2, uniformReplica, 8);
+            assert_(summary.m_replicaCount == sequential.m_replicaCount);
+            assert_(summary.m_metrics[0].mean() == sequential.m_metrics[0].mean());
+        }
+
+        // Ensembles that cannot converge should give up at the replica limit
+        rule.m_relativeHalfWidth = 1e-6;
+        rule.m_maxReplicaCount = 500;
+        EnsembleSummary capped = EnsembleRunner(3).runUntil(rule, 2, uniformReplica);
+        assert_(!capped.m_converged && capped.m_replicaCount == 500);
+
+        // Antithetic streams should mirror their twins, and antithetic pairs should shrink the variance of a monotone metric
+        RandomStream original(8, 2);
+        RandomStream mirrored(8, 2);
+        mirrored.setAntithetic(true);
+        for (size_t i = 0; i < 100; i++) {
+            double value = mirrored.uniform();
+            assert_(value >= 0.0 && value < 1.0);
+            assert_(approxEqual(value, 1.0 - original.uniform(), 1e-12));
+        }
+        EnsembleRunner antitheticRunner(2);
+        antitheticRunner.setAntithetic(true);
+        EnsembleSummary antithetic = antitheticRunner.run(999, 1, [](size_t replica, double* outMetrics) {
+            RandomStream replicaStream(17, replica / 2);
+            replicaStream.setAntithetic(replica % 2);
+            double value = replicaStream.uniform();
+            outMetrics[0] = value * value;
+        });
+        assert_(antithetic.m_replicaCount == 1000);
+        assert_(antithetic.m_metrics[0].count() == 500 && antithetic.m_replicaMetrics[0].count() == 1000);
+        assert_(antithetic.varianceReductionFactor(0) > 4.0);
+        rule.m_maxReplicaCount = 501;
+        EnsembleSummary cappedPairs = antitheticRunner.runUntil(rule, 2, uniformReplica, 3);
+        assert_(!cappedPairs.m_converged && cappedPairs.m_replicaCount == 500);
+        assert_(expected.varianceReductionFactor(0) == 1.0);
+
+        // Common random numbers should make the difference in faults between charger counts far less noisy than independent runs
+        EnsembleSummary comparison = EnsembleRunner(2).run(24, 3, [](size_t replica, double* outMetrics) {
+            outMetrics[0] = runScene(replica, 2);
+            outMetrics[1] = runScene(replica, 3);
+            outMetrics[2] = outMetrics[1] - outMetrics[0];
+        });
+        assert_(EnsembleSummary::PairedVarianceReductionFactor(comparison.m_metrics[0], comparison.m_metrics[1], comparison.m_metrics[2]) > 4.0);
+
+        // Errors in a replica should reach the caller
+        bool threw = false;
+        try {
+            EnsembleRunner(2).run(10, 1, [](size_t replica, double* outMetrics) {
+                if (replica == 7) {
+                    throw std::runtime_error("Error, replica failed");
+                }
+                outMetrics[0] = 0.0;
+            });
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert_(threw);
+
+        // eVTOL replicas should be independent of the threads they land on
+        EnsembleSummary sceneSummary = runScenes(1);
+        EnsembleSummary threadedSceneSummary = runScenes(4);
+        for (size_t metric = 0; metric < sceneSummary.m_metrics.size(); metric++) {
+            assert_(sceneSummary.m_metrics[metric].mean() == threadedSceneSummary.m_metrics[metric].mean());
+        }
+        assert_(sceneSummary.m_metrics[0].variance() > 0.0);
+    }
+
+private:
+
+    /// @brief Run an eVTOL scene with the given seed and number of chargers, returning the total number of faults
+    static double runScene(uint64_t seed, size_t chargerCount) {
+        Scene scene;
+        scene.setChargerCount(chargerCount);
+        SampleCompanies::AddTo(scene, { "Alpha", "Echo" });
+        scene.addAircraft(10, seed);
+
+        Simulator sim(0);
+        sim.setDeterministic(true);
+        scene.initialize(sim);
+        sim.simulateUntil(3.0 * 3600.0, 1.0);
+        return double(scene.companies()[0].statistics().m_faultCount + scene.companies()[1].statistics().m_faultCount);
+    }
+
+    /// @brief Run a small ensemble of eVTOL scenes, reporting fault counts and flight time for each company
+    EnsembleSummary runScenes(size_t threadCount) {
+        return EnsembleRunner(threadCount).run(16, 4, [](size_t replica, double* outMetrics) {
+            Scene scene;
+            scene.setChargerCount(3);
+            SampleCompanies::AddTo(scene, { "Alpha", "Echo" });
+            scene.addAircraft(10, replica);
+
+            Simulator sim(0);
+            sim.setDeterministic(true);
+            scene.initialize(sim);
+            sim.simulateUntil(3600.0, 1.0);
+            scene.finalize(sim.simulationTime());
+            for (size_t i = 0; i < 2; i++) {
+                outMetrics[2 * i] = double(scene.companies()[i].statistics().m_faultCount);
+                outMetrics[2 * i + 1] = scene.companies()[i].statistics().m_flightTime;
+            }
+        });
+    }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
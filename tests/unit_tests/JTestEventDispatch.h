@@ -0,0 +1,137 @@
+#ifndef TEST_EVENT_DISPATCH_H
+#define TEST_EVENT_DISPATCH_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JAllocationCounter.h"
+#include <array>
+#include <random>
+#include <vector>
+#include <core/events/JEventQueue.h>
+#include <core/events/JEventDispatcher.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class EventDispatchTest : public Test
+{
+public:
+
+    EventDispatchTest(): Test(){}
+    ~EventDispatchTest() {}
+
+    /// @brief Perform unit tests for Event and EventDispatcher classes
+    virtual void perform() {
+
+        // Payloads should round-trip
+        Event event;
+        event.setPayload(2.5f);
+        assert_(event.payload<float>() == 2.5f);
+        event.setPayload(uint64_t(-1));
+        assert_(event.payload<uint64_t>() == uint64_t(-1));
+
+        // Every event type should reach its own handler
+        HoldHandler handler;
+        EventDispatcher dispatcher;
+        dispatcher.setHandler<HoldEventType>(handler);
+        assert_(dispatcher.hasHandler());
+        assert_(dispatcher.typeCount() == (size_t)HoldEventType::COUNT);
+        for (uint32_t i = 0; i < (uint32_t)HoldEventType::COUNT; i++) {
+            dispatcher.dispatch(Event{ 0.0, i, 0 });
+            assert_(handler.m_counts[i] == 1);
+        }
+
+        // Make sure allocations are actually being counted
+        size_t allocations = AllocationCounter::Count();
+        std::vector<Event> events(16);
+        assert_(AllocationCounter::Count() > allocations);
+
+        // Once warmed up, a simulation with a steady number of pending events should never allocate.
+        // The default queue type gets the full workload, the others a lighter one to keep the test quick
+        for (size_t i = 0; i < (size_t)EventQueueType::COUNT; i++) {
+            EventQueueType type = EventQueueType(i);
+            runHoldModel(type, type == EventQueueType::kQuaternaryHeap ? 10000000 : 1000000);
+        }
+    }
+
+private:
+
+    enum class HoldEventType {
+        kArrive = 0,
+        kService,
+        kDepart,
+        COUNT
+    };
+
+    /// @brief Handles each event by scheduling the next one in the cycle, so the queue size stays constant
+    struct HoldHandler {
+        template<HoldEventType Type>
+        void onEvent(const Event& event) {
+            m_counts[(size_t)Type]++;
+            if (!m_queue) {
+                return;
+            }
+            // The payload counts the events preceding this one in the target's chain
+            Event next{ event.m_time + m_delay(m_generator), (uint32_t(Type) + 1) % (uint32_t)HoldEventType::COUNT, event.m_target };
+            next.setPayload(event.payload<uint64_t>() + 1);
+            m_queue->schedule(next);
+        }
+
+        EventQueue* m_queue = nullptr;
+        std::mt19937_64 m_generator{ 42 };
+        std::exponential_distribution<double> m_delay{ 1.0 };
+        std::array<size_t, (size_t)HoldEventType::COUNT> m_counts{};
+    };
+
+    /// @brief Run the given number of events through a queue and dispatcher, checking for allocations
+    void runHoldModel(EventQueueType type, size_t eventCount) {
+        static constexpr uint32_t s_pendingCount = 10000;
+        EventQueue queue{ type };
+        HoldHandler handler;
+        handler.m_queue = &queue;
+        EventDispatcher dispatcher;
+        dispatcher.setHandler<HoldEventType>(handler);
+        for (uint32_t target = 0; target < s_pendingCount; target++) {
+            queue.schedule(Event{ handler.m_delay(handler.m_generator), 0, target });
+        }
+
+        // Warm up, so that every container reaches its high-water mark
+        Event event;
+        for (size_t i = 0; i < s_pendingCount * 10; i++) {
+            queue.pop(event);
+            dispatcher.dispatch(event);
+        }
+
+        size_t allocations = AllocationCounter::Count();
+        double previousTime = event.m_time;
+        uint64_t chainLength = 0;
+        for (size_t i = 0; i < eventCount; i++) {
+            queue.pop(event);
+            dispatcher.dispatch(event);
+            assert_(event.m_time >= previousTime);
+            previousTime = event.m_time;
+            chainLength += event.payload<uint64_t>();
+        }
+        assert_(AllocationCounter::Count() == allocations);
+        assert_(queue.size() == s_pendingCount);
+        assert_(chainLength > 0);
+
+        // Each chain cycles through the event types in order
+        size_t total = handler.m_counts[0] + handler.m_counts[1] + handler.m_counts[2];
+        assert_(total == eventCount + s_pendingCount * 10);
+        assert_(handler.m_counts[0] >= handler.m_counts[1] && handler.m_counts[1] >= handler.m_counts[2]);
+    }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef TEST_EVENT_QUEUE_H
+#define TEST_EVENT_QUEUE_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+#include <core/events/JEventQueue.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class EventQueueTest : public Test
+{
+public:
+
+    EventQueueTest(): Test(){}
+    ~EventQueueTest() {}
+
+    /// @brief Perform unit tests for EventQueue class
+    virtual void perform() {
+
+        // Every queue type should pop events in the same order
+        std::vector<Event> expected = runWorkload(EventQueueType::kBinaryHeap);
+        for (size_t i = 0; i < (size_t)EventQueueType::COUNT; i++) {
+            std::vector<Event> popped = runWorkload(EventQueueType(i));
+            assert_(popped.size() == expected.size());
+            for (size_t j = 0; j < popped.size(); j++) {
+                assert_(popped[j].m_time == expected[j].m_time);
+                assert_(popped[j].m_target == expected[j].m_target);
+            }
+        }
+
+        // Events should be popped in time order
+        for (size_t j = 1; j < expected.size(); j++) {
+            assert_(expected[j - 1].m_time <= expected[j].m_time);
+        }
+
+        // Ties should be popped in the order they were scheduled
+        for (size_t i = 0; i < (size_t)EventQueueType::COUNT; i++) {
+            EventQueue tieQueue{ EventQueueType(i) };
+            for (uint32_t j = 0; j < 100; j++) {
+                tieQueue.schedule(Event{ j % 2 ? 1.0 : 2.0, 0, j });
+            }
+            Event event;
+            uint32_t previous = 0;
+            for (uint32_t j = 0; j < 100; j++) {
+                assert_(tieQueue.pop(event));
+                assert_(j == 0 || j == 50 || event.m_target > previous);
+                previous = event.m_target;
+            }
+        }
+
+        // An empty queue has no next event
+        EventQueue queue(EventQueueType::kCalendarQueue);
+        Event event;
+        assert_(queue.empty());
+        assert_(!queue.pop(event));
+        assert_(queue.nextTime() == std::numeric_limits<double>::infinity());
+
+        // Handles should go stale once their event fires or is cancelled
+        for (size_t i = 0; i < (size_t)EventQueueType::COUNT; i++) {
+            EventQueue handleQueue{ EventQueueType(i) };
+            EventHandle first = handleQueue.schedule(Event{ 1.0, 0, 1 });
+            EventHandle second = handleQueue.schedule(Event{ 2.0, 0, 2 });
+            EventHandle third = handleQueue.schedule(Event{ 3.0, 0, 3 });
+
+            // Pull the last event ahead of the others, and drop the second
+            assert_(handleQueue.reschedule(third, 0.5));
+            assert_(handleQueue.cancel(second));
+            assert_(!handleQueue.isPending(second));
+            assert_(!handleQueue.cancel(second));
+
+            assert_(handleQueue.pop(event) && event.m_target == 3 && event.m_time == 0.5);
+            assert_(!handleQueue.reschedule(third, 4.0));
+            assert_(handleQueue.isPending(first));
+
+            // A recycled slot must not revive an old handle
+            EventHandle fourth = handleQueue.schedule(Event{ 5.0, 0, 4 });
+            assert_(fourth.m_slot == third.m_slot || fourth.m_slot == second.m_slot);
+            assert_(!handleQueue.isPending(third) && !handleQueue.isPending(second));
+
+            assert_(handleQueue.pop(event) && event.m_target == 1);
+            assert_(handleQueue.pop(event) && event.m_target == 4);
+            assert_(handleQueue.empty());
+
+            const EventQueueStatistics& statistics = handleQueue.statistics();
+            assert_(statistics.m_scheduledCount == 4);
+            assert_(statistics.m_poppedCount == 3);
+            assert_(statistics.m_cancelledCount == 1);
+            assert_(statistics.m_rescheduledCount == 1);
+            assert_(statistics.m_staleSkippedCount == 2);
+        }
+
+        // Events posted from several threads should be scheduled in the same order on every run
+        std::vector<Event> firstRun = runPostedWorkload();
+        for (size_t run = 0; run < 3; run++) {
+            std::vector<Event> nextRun = runPostedWorkload();
+            assert_(nextRun.size() == firstRun.size());
+            for (size_t j = 0; j < nextRun.size(); j++) {
+                assert_(nextRun[j].m_time == firstRun[j].m_time);
+                assert_(nextRun[j].m_target == firstRun[j].m_target);
+            }
+        }
+    }
+
+private:
+
+    /// @brief Post events with many tied times from several threads, then drain and pop them all
+    std::vector<Event> runPostedWorkload() {
+        static constexpr uint32_t s_producerCount = 4;
+        static constexpr uint32_t s_eventCount = 500;
+        EventQueue queue{ EventQueueType::kQuaternaryHeap, 4 * s_producerCount * s_eventCount };
+        std::vector<std::thread> producers;
+        for (uint32_t producer = 0; producer < s_producerCount; producer++) {
+            producers.emplace_back([&queue, producer]() {
+                for (uint32_t i = 0; i < s_eventCount; i++) {
+                    queue.post(Event{ double(i % 10), 0, producer * s_eventCount + i }, producer, i);
+                }
+            });
+        }
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+
+        assert_(queue.empty());
+        assert_(queue.drainInbox() == s_producerCount * s_eventCount);
+        assert_(queue.statistics().m_postedCount == s_producerCount * s_eventCount);
+        assert_(queue.drainInbox() == 0);
+
+        std::vector<Event> popped;
+        Event event;
+        while (queue.pop(event)) {
+            popped.push_back(event);
+        }
+        return popped;
+    }
+
+    /// @brief Interleave scheduling, cancelling, rescheduling and popping, returning events in the order they were popped
+    std::vector<Event> runWorkload(EventQueueType type) {
+        EventQueue queue(type);
+        std::mt19937_64 generator(1234);
+
+        // Quantize times so that there are plenty of ties
+        std::uniform_int_distribution<int> delay(0, 50);
+        std::uniform_int_distribution<int> action(0, 9);
+        std::vector<EventHandle> handles;
+        std::vector<Event> popped;
+        double now = 0.0;
+        uint32_t scheduled = 0;
+        size_t cancelled = 0;
+        for (size_t round = 0; round < 2000; round++) {
+            size_t scheduleCount = round < 1000 ? 3 : 1;
+            for (size_t i = 0; i < scheduleCount; i++) {
+                handles.push_back(queue.schedule(Event{ now + 0.25 * delay(generator), 0, scheduled++ }));
+            }
+
+            // Occasionally cancel or move a random event, which may already have fired
+            const EventHandle& handle = handles[generator() % handles.size()];
+            switch (action(generator)) {
+            case 0:
+                cancelled += queue.cancel(handle);
+                break;
+            case 1:
+                queue.reschedule(handle, now + 0.25 * delay(generator));
+                break;
+            default:
+                break;
+            }
+
+            Event event;
+            if (queue.pop(event)) {
+                now = event.m_time;
+                popped.push_back(event);
+            }
+        }
+
+        // Drain the remainder
+        Event event;
+        while (queue.pop(event)) {
+            popped.push_back(event);
+        }
+        assert_(popped.size() + cancelled == scheduled);
+        return popped;
+    }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
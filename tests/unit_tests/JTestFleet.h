@@ -0,0 +1,179 @@
+#ifndef TEST_FLEET_H
+#define TEST_FLEET_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <cmath>
+#include <string>
+#include <vector>
+#include <core/diagnostics/JRunHash.h>
+#include <core/random/JRandomStream.h>
+#include <core/sim/JSimulator.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class FleetTest : public Test
+{
+public:
+
+    FleetTest(): Test(){}
+    ~FleetTest() {}
+
+    /// @brief Perform unit tests for fleet storage, its step kernels, and the flight models that use them
+    virtual void perform() {
+        // Flying counts should follow state changes
+        Fleet fleet = createFleet();
+        assert_(fleet.size() == s_aircraftCount && fleet.specificationCount() == 2);
+        assert_(fleet.flyingCount(0) + fleet.flyingCount(1) < s_aircraftCount);
+        uint32_t flyingCount = fleet.flyingCount(fleet.companyId(0));
+        fleet.setState(0, AircraftState::kWaiting);
+        fleet.setState(0, AircraftState::kCharging);
+        assert_(fleet.flyingCount(fleet.companyId(0)) == flyingCount - 1);
+
+        // Every kernel should pass over the same aircraft, and leave the rest bit-identical to flying them one at a time
+        Fleet expected = createFleet();
+        std::vector<uint32_t> expectedInterrupted;
+        for (uint32_t i = 0; i < expected.size(); i++) {
+            if (expected.state(i) != AircraftState::kFlying) {
+                continue;
+            }
+            double deltaHours = Units::Convert<TimeUnits::kSeconds, TimeUnits::kHours>(s_deltaSec);
+            double energyNeeded = expected.companySpecification(expected.companyId(i)).energyUse() *
+                expected.companySpecification(expected.companyId(i)).cruiseSpeed() * deltaHours;
+            if (energyNeeded < expected.batteryCharge(i) && expected.hoursToFault(i) > deltaHours) {
+                assert_(expected.fly(i, s_deltaSec) == s_deltaSec);
+                expected.setHoursToFault(i, expected.hoursToFault(i) - deltaHours);
+            }
+            else {
+                expectedInterrupted.push_back(i);
+            }
+        }
+        assert_(expectedInterrupted.size() > 0 && expectedInterrupted.size() < s_aircraftCount / 4);
+
+        for (size_t level = 0; level < (size_t)SimdLevel::COUNT; level++) {
+            if (!Simd::IsSupported(SimdLevel(level))) {
+                continue;
+            }
+            Fleet stepped = createFleet();
+            stepped.setKernel(SimdLevel(level));
+            std::vector<uint32_t> interrupted{ 7 };
+            stepped.step(s_deltaSec, interrupted);
+            assert_(interrupted == expectedInterrupted);
+            for (uint32_t i = 0; i < stepped.size(); i++) {
+                assert_(stepped.batteryCharge(i) == expected.batteryCharge(i));
+                assert_(stepped.hoursToFault(i) == expected.hoursToFault(i));
+                assert_(stepped.distance(i) == expected.distance(i));
+            }
+        }
+
+        // Scenes should run identically on every kernel
+        uint64_t scalarHash = runScene(SimdLevel::kScalar);
+        assert_(runScene(Simd::SupportedLevel()) == scalarHash);
+
+        // Analytic flights should be exact, whatever the step size
+        std::vector<CompanyStatistics> single = runStatistics(FlightModel::kAnalytic, { Aircraft{ 120.0, 320.0, 0.6, 1.6, 4, 0.0 } }, 1, 3.0, 1.0);
+        assert_(single[0].m_flightCount == 2 && single[0].m_chargeCount == 1);
+        assert_(approxEqual(single[0].m_chargeTime, 0.6, 1e-12));
+        assert_(approxEqual(single[0].m_flightTime, 3.0 - 0.6, 1e-12));
+        assert_(approxEqual(single[0].m_distance, 120.0 * single[0].m_flightTime, 1e-12));
+
+        const std::vector<Aircraft> specifications{ SampleCompanies::Specification("Alpha"), SampleCompanies::Specification("Echo") };
+        std::vector<CompanyStatistics> coarse = runStatistics(FlightModel::kAnalytic, specifications, 23, 3.0, 7.0);
+        std::vector<CompanyStatistics> fine = runStatistics(FlightModel::kAnalytic, specifications, 23, 3.0, 0.25);
+        std::vector<CompanyStatistics> stepped = runStatistics(FlightModel::kFixedStep, specifications, 23, 3.0, 1.0);
+        for (size_t i = 0; i < specifications.size(); i++) {
+            assert_(coarse[i].m_flightTime == fine[i].m_flightTime);
+            assert_(coarse[i].m_faultCount == fine[i].m_faultCount);
+            assert_(coarse[i].m_flightCount == stepped[i].m_flightCount);
+
+            // Fixed steps end each flight on a step boundary, so differ by at most a step per flight
+            double stepHours = 1.0 / 3600.0;
+            assert_(std::abs(coarse[i].m_flightTime - stepped[i].m_flightTime) <= stepHours * coarse[i].m_flightCount);
+        }
+        assert_(coarse[1].m_faultCount > 0);
+    }
+
+private:
+
+    /// @brief Create a fleet with a mix of states, and of aircraft about to run out of battery or fault
+    static Fleet createFleet() {
+        Fleet fleet;
+        fleet.addSpecification(SampleCompanies::Specification("Alpha"));
+        fleet.addSpecification(SampleCompanies::Specification("Echo"));
+        RandomStream stream(11, 0);
+        for (uint32_t i = 0; i < s_aircraftCount; i++) {
+            fleet.add(uint32_t(stream.uniformIndex(2)));
+            double draw = stream.uniform();
+            if (draw < 0.2) {
+                fleet.setState(i, draw < 0.1 ? AircraftState::kWaiting : AircraftState::kCharging);
+            }
+            fleet.setBatteryCharge(i, stream.uniform() < 0.05 ? 0.1 * stream.uniform() : 100.0 * stream.uniform() + 1.0);
+            fleet.setHoursToFault(i, stream.uniform() < 0.05 ? 1e-3 * stream.uniform() : 10.0 * stream.uniform() + 1.0);
+        }
+        return fleet;
+    }
+
+    /// @brief Run a scene with a company for each specification, returning each company's statistics
+    /// @param[in] hours The simulated duration
+    /// @param[in] stepSec The simulator's step size, in seconds
+    static std::vector<CompanyStatistics> runStatistics(FlightModel model, const std::vector<Aircraft>& specifications,
+        size_t aircraftCount, double hours, double stepSec) {
+        Scene scene;
+        scene.setChargerCount(specifications.size() + 1);
+        for (size_t i = 0; i < specifications.size(); i++) {
+            scene.addCompany(std::to_string(i), specifications[i]);
+        }
+        scene.addAircraft(aircraftCount, 4);
+        scene.setFlightModel(model);
+
+        Simulator sim(0);
+        sim.setDeterministic(true);
+        scene.initialize(sim);
+        sim.simulateUntil(hours * 3600.0, stepSec);
+        scene.finalize(sim.simulationTime());
+
+        std::vector<CompanyStatistics> statistics;
+        for (const Company& company : scene.companies()) {
+            statistics.push_back(company.statistics());
+        }
+        return statistics;
+    }
+
+    /// @brief Run a scene with fixed-step flight on the given kernel, returning its run hash
+    static uint64_t runScene(SimdLevel kernel) {
+        Scene scene;
+        scene.setChargerCount(3);
+        SampleCompanies::AddTo(scene, { "Alpha", "Beta", "Echo" });
+        scene.addAircraft(37, 9);
+        scene.setFlightModel(FlightModel::kFixedStep);
+        scene.fleet().setKernel(kernel);
+
+        Simulator sim(0);
+        sim.setDeterministic(true);
+        scene.initialize(sim);
+        sim.simulateUntil(3.0 * 3600.0, 1.0);
+
+        RunHash hash;
+        scene.hashState(hash);
+        return hash.value();
+    }
+
+    static constexpr uint32_t s_aircraftCount = 1001;
+    static constexpr double s_deltaSec = 10.0;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
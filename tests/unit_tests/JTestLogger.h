@@ -0,0 +1,180 @@
+#ifndef TEST_LOGGER_H
+#define TEST_LOGGER_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <core/containers/JString.h>
+#include <core/diagnostics/JLogger.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class LoggerTest : public Test
+{
+public:
+
+    LoggerTest(): Test(){}
+    ~LoggerTest() {}
+
+    /// @brief Perform unit tests for the asynchronous mode and registered formats of the Logger class
+    virtual void perform() {
+        Logger& logger = Logger::Get();
+        std::stringstream output;
+        std::streambuf* consoleBuffer = std::cout.rdbuf(output.rdbuf());
+
+        // Messages from many threads should all be written, in order for each thread, without dropping any when
+        // the logger blocks
+        {
+            logger.startAsync(64, LogOverflowPolicy::kBlock);
+            assert_(logger.isAsync());
+            assert_(throws([&]() { logger.startAsync(); }));
+            logMessages(s_threadCount, s_messageCount);
+            logger.flush();
+            assert_(logger.droppedCount() == 0);
+
+            std::vector<size_t> nextIndices(s_threadCount, 0);
+            std::string line;
+            while (std::getline(output, line)) {
+                int thread;
+                int index;
+                assert_(std::sscanf(line.c_str(), "Info:: Thread %d message %d", &thread, &index) == 2);
+                assert_(size_t(index) == nextIndices[thread]++);
+            }
+            for (size_t count : nextIndices) {
+                assert_(count == s_messageCount);
+            }
+            logger.stopAsync();
+            assert_(!logger.isAsync());
+        }
+
+        // When messages are dropped, every one of them should either be written or counted
+        for (LogOverflowPolicy policy : { LogOverflowPolicy::kDrop, LogOverflowPolicy::kCount }) {
+            output.str("");
+            output.clear();
+            logger.startAsync(8, policy);
+            logMessages(s_threadCount, s_messageCount);
+            logger.stopAsync();
+
+            size_t writtenCount = 0;
+            size_t reportCount = 0;
+            std::string line;
+            while (std::getline(output, line)) {
+                if (line.rfind("Info:: Thread", 0) == 0) {
+                    writtenCount++;
+                }
+                else {
+                    reportCount++;
+                }
+            }
+            assert_(writtenCount + logger.droppedCount() == s_threadCount * s_messageCount);
+            if (policy == LogOverflowPolicy::kDrop) {
+                assert_(reportCount == 0);
+            }
+            else {
+                assert_((reportCount > 0) == (logger.droppedCount() > 0));
+            }
+        }
+
+        // Long messages should be cut short, and logging should go straight to the stream once stopped
+        {
+            output.str("");
+            output.clear();
+            logger.startAsync();
+            Logger::LogWarning(std::string(1000, 'x').c_str());
+            logger.flush();
+            std::string line;
+            std::getline(output, line);
+            assert_(line == "Warning:: " + std::string(sizeof(LogRecord::m_text) - 3, 'x') + "...");
+            logger.stopAsync();
+
+            output.str("");
+            output.clear();
+            Logger::LogError("Written at once");
+            assert_(output.str() == "Error:: Written at once\n");
+        }
+
+        // Registered formats should give the same text as formatting in the caller, whether written at once or by
+        // the background writer
+        for (bool async : { false, true }) {
+            static const LogFormat s_format("%s: %d flights, %.3f hours, %zu charges, %5.1f%% used, %016llx, %c%c, %-6s|%4d|%g");
+            std::string name = "Alpha";
+            size_t chargeCount = 12345678901;
+            unsigned long long hash = 0x6c5ad9822747c99aull;
+            std::string expected = "Info:: " + JString::Format("%s: %d flights, %.3f hours, %zu charges, %5.1f%% used, %016llx, %c%c, %-6s|%4d|%g",
+                name.c_str(), -42, 2.0 / 3.0, chargeCount, 79.25, hash, 'o', 'k', "ab", 7, 1e-9) + "\n";
+
+            output.str("");
+            output.clear();
+            if (async) {
+                logger.startAsync();
+            }
+            Logger::LogInfo(s_format, name, -42, 2.0 / 3.0, chargeCount, 79.25, hash, 'o', 'k', "ab", 7, 1e-9);
+            logger.stopAsync();
+            assert_(output.str() == expected);
+        }
+
+        // Arguments that don't match their conversions should be adapted, missing ones left out, null strings
+        // written as such, and arguments that don't fit cut short and marked
+        {
+            static const LogFormat s_format("%d %.1f %s [%d]");
+            output.str("");
+            output.clear();
+            Logger::LogWarning(s_format, 2.75, 3, 5u);
+            assert_(output.str() == "Warning:: 2 3.0 5 []\n");
+
+            static const LogFormat s_longFormat("%s|%d");
+            output.str("");
+            output.clear();
+            Logger::LogError(s_longFormat, std::string(1000, 'x'), 1);
+            size_t textLength = sizeof(LogRecord::m_text) - 2 - sizeof(uint16_t);
+            assert_(output.str() == "Error:: " + std::string(textLength, 'x') + "|...\n");
+
+            static const LogFormat s_nullFormat("[%s]");
+            output.str("");
+            output.clear();
+            Logger::LogInfo(s_nullFormat, (const char*)nullptr);
+            assert_(output.str() == "Info:: [(null)]\n");
+        }
+
+        std::cout.rdbuf(consoleBuffer);
+    }
+
+private:
+
+    /// @brief Log the given number of numbered messages from each of the given number of threads
+    static void logMessages(size_t threadCount, size_t messageCount) {
+        std::vector<std::thread> threads;
+        for (size_t thread = 0; thread < threadCount; thread++) {
+            threads.emplace_back([thread, messageCount]() {
+                for (size_t i = 0; i < messageCount; i++) {
+                    Logger::LogInfo(JString::Format("Thread %d message %d", (int)thread, (int)i).c_str());
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    static constexpr size_t s_threadCount = 4;
+    static constexpr size_t s_messageCount = 2000;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
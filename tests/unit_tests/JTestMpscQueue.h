@@ -0,0 +1,83 @@
+#ifndef TEST_MPSC_QUEUE_H
+#define TEST_MPSC_QUEUE_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include <thread>
+#include <vector>
+#include <core/threading/JMpscQueue.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class MpscQueueTest : public Test
+{
+public:
+
+    MpscQueueTest(): Test(){}
+    ~MpscQueueTest() {}
+
+    /// @brief Perform unit tests for MpscQueue class
+    virtual void perform() {
+
+        // Capacity is rounded up, and a full queue rejects values
+        MpscQueue<int> queue(5);
+        assert_(queue.capacity() == 8);
+        for (int i = 0; i < 8; i++) {
+            assert_(queue.tryPush(i));
+        }
+        assert_(!queue.tryPush(8));
+        int value;
+        for (int i = 0; i < 8; i++) {
+            assert_(queue.tryPop(value) && value == i);
+        }
+        assert_(!queue.tryPop(value));
+
+        // Values from many producers should all arrive, in order for each producer
+        static constexpr uint32_t s_producerCount = 4;
+        static constexpr uint32_t s_valueCount = 100000;
+        MpscQueue<uint64_t> sharedQueue(256);
+        std::vector<std::thread> producers;
+        for (uint32_t producer = 0; producer < s_producerCount; producer++) {
+            producers.emplace_back([&sharedQueue, producer]() {
+                for (uint32_t i = 0; i < s_valueCount; i++) {
+                    while (!sharedQueue.tryPush((uint64_t(producer) << 32) | i)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        std::vector<uint32_t> nextValues(s_producerCount, 0);
+        size_t received = 0;
+        uint64_t packed;
+        while (received < s_producerCount * s_valueCount) {
+            if (!sharedQueue.tryPop(packed)) {
+                std::this_thread::yield();
+                continue;
+            }
+            uint32_t producer = uint32_t(packed >> 32);
+            assert_(producer < s_producerCount);
+            assert_(uint32_t(packed) == nextValues[producer]);
+            nextValues[producer]++;
+            received++;
+        }
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+        assert_(!sharedQueue.tryPop(packed));
+    }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef TEST_PARAMETER_SWEEP_H
+#define TEST_PARAMETER_SWEEP_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <core/sim/JParameterSweep.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class ParameterSweepTest : public Test
+{
+public:
+
+    ParameterSweepTest(): Test(){}
+    ~ParameterSweepTest() {}
+
+    /// @brief Perform unit tests for parameter sweeps
+    virtual void perform() {
+        std::vector<SweepParameter> parameters = {
+            { "speed", 100.0, 200.0, 3 },
+            { "chargers", 1.0, 4.0, 4 }
+        };
+
+        // Grids should hold every combination of levels
+        std::vector<SweepPoint> grid = ParameterSweep::GridDesign(parameters);
+        assert_(grid.size() == 12);
+        assert_(grid.front() == SweepPoint({ 100.0, 1.0 }) && grid.back() == SweepPoint({ 200.0, 4.0 }));
+        assert_(grid[1] == SweepPoint({ 100.0, 2.0 }) && grid[4] == SweepPoint({ 150.0, 1.0 }));
+
+        // Latin hypercubes should put exactly one point in each stratum of each parameter
+        std::vector<SweepPoint> hypercube = ParameterSweep::LatinHypercubeDesign(parameters, 10, 5);
+        assert_(hypercube.size() == 10);
+        for (size_t j = 0; j < parameters.size(); j++) {
+            std::set<size_t> strata;
+            for (const SweepPoint& point : hypercube) {
+                double fraction = (point[j] - parameters[j].m_min) / (parameters[j].m_max - parameters[j].m_min);
+                assert_(fraction >= 0.0 && fraction < 1.0);
+                strata.insert(size_t(fraction * 10));
+            }
+            assert_(strata.size() == 10);
+        }
+        assert_(ParameterSweep::LatinHypercubeDesign(parameters, 10, 5) == hypercube);
+
+        // Finished points should be skipped when a sweep is rerun
+        const std::string path = "parameter_sweep_test.csv";
+        std::remove(path.c_str());
+        size_t callCount = 0;
+        auto runPoint = [&callCount](const SweepPoint& point) {
+            callCount++;
+            EnsembleSummary summary;
+            summary.m_metrics.resize(1);
+            summary.m_metrics[0].add(point[0] * point[1]);
+            summary.m_replicaCount = 1;
+            return summary;
+        };
+        {
+            ParameterSweep sweep(parameters, { "product" }, path);
+            assert_(sweep.run(std::vector<SweepPoint>(grid.begin(), grid.begin() + 5), runPoint) == 5);
+            assert_(sweep.finishedCount() == 5 && sweep.isFinished(grid[4]) && !sweep.isFinished(grid[5]));
+        }
+        {
+            ParameterSweep sweep(parameters, { "product" }, path);
+            assert_(sweep.finishedCount() == 5);
+            assert_(sweep.run(grid, runPoint) == 7);
+        }
+        assert_(callCount == 12);
+
+        // A row cut off mid-write should be discarded, and its point rerun
+        std::string contents;
+        {
+            std::ifstream file(path);
+            contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        {
+            std::ofstream file(path, std::ios::trunc);
+            file << contents.substr(0, contents.size() - 4);
+        }
+        {
+            ParameterSweep sweep(parameters, { "product" }, path);
+            assert_(sweep.finishedCount() == 11);
+            assert_(sweep.run(grid, runPoint) == 1);
+        }
+        {
+            std::ifstream file(path);
+            std::string rereadContents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            assert_(rereadContents.size() == contents.size());
+        }
+
+        // Different settings should not reuse results, and different sweeps should not share a file
+        ParameterSweep otherSettings(parameters, { "product" }, path, 1);
+        assert_(otherSettings.finishedCount() == 12 && !otherSettings.isFinished(grid[0]));
+        bool threw = false;
+        try {
+            ParameterSweep otherMetrics(parameters, { "sum" }, path);
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert_(threw);
+
+        std::remove(path.c_str());
+    }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
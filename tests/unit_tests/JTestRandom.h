@@ -0,0 +1,135 @@
+#ifndef TEST_RANDOM_H
+#define TEST_RANDOM_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <cmath>
+#include <vector>
+#include <core/random/JPhilox.h>
+#include <core/random/JRandomStream.h>
+#include <core/simd/JSimd.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class RandomTest : public Test
+{
+public:
+
+    RandomTest(): Test(){}
+    ~RandomTest() {}
+
+    /// @brief Perform unit tests for counter-based random numbers
+    virtual void perform() {
+
+        // Philox should match the known-answer vectors published with the reference implementation, Random123
+        assert_(Philox::Generate({ 0, 0, 0, 0 }, { 0, 0 }) ==
+            (Philox::Counter{ 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 }));
+        assert_(Philox::Generate({ 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }, { 0xffffffff, 0xffffffff }) ==
+            (Philox::Counter{ 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd }));
+        assert_(Philox::Generate({ 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }, { 0xa4093822, 0x299f31d0 }) ==
+            (Philox::Counter{ 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 }));
+
+        // Batches should give exactly the values drawn one at a time, for any kernel, start and length
+        for (bool antithetic : { false, true }) {
+            RandomStream stream(5, 9);
+            stream.setAntithetic(antithetic);
+            std::vector<double> expected(100);
+            for (double& value : expected) {
+                value = stream.uniform();
+            }
+            for (size_t level = 0; level < (size_t)SimdLevel::COUNT; level++) {
+                if (!Simd::IsSupported(SimdLevel(level))) {
+                    continue;
+                }
+                for (size_t first : { 0, 1, 6 }) {
+                    for (size_t count : { 0, 1, 7, 8, 9, 93 }) {
+                        std::vector<double> values(count + 1, -1.0);
+                        Philox::GenerateUniforms(Philox::KeyFromSeed(5), 9, first, antithetic, values.data(), count, SimdLevel(level));
+                        for (size_t i = 0; i < count; i++) {
+                            assert_(values[i] == expected[first + i]);
+                        }
+                        assert_(values[count] == -1.0);
+                    }
+                }
+            }
+        }
+
+        // Streams should jump straight to any draw, and pick up where a batch leaves off
+        {
+            RandomStream stream(3, 4);
+            std::vector<double> values(20);
+            stream.uniforms(values.data(), values.size());
+            assert_(stream.index() == 20);
+            double next = stream.uniform();
+
+            RandomStream jumped(3, 4);
+            jumped.setIndex(13);
+            assert_(jumped.uniform() == values[13]);
+            jumped.setIndex(20);
+            assert_(jumped.uniform() == next);
+        }
+
+        // Uniform values should be evenly spread, and exponential ones should have the right mean
+        {
+            const size_t count = 100000;
+            const double rate = 0.25;
+            RandomStream stream(11, 0);
+            std::vector<double> values(count);
+            stream.uniforms(values.data(), count);
+            size_t bins[10] = {};
+            for (double value : values) {
+                assert_(value >= 0.0 && value < 1.0);
+                bins[size_t(value * 10.0)]++;
+            }
+            for (size_t bin : bins) {
+                assert_(std::abs(double(bin) - count / 10.0) < 5.0 * std::sqrt(count / 10.0));
+            }
+
+            stream.exponentials(rate, values.data(), count);
+            double sum = 0.0;
+            for (double value : values) {
+                assert_(value >= 0.0);
+                sum += value;
+            }
+            assert_(std::abs(sum / count - 1.0 / rate) < 5.0 / (rate * std::sqrt(double(count))));
+            assert_(std::isinf(stream.exponential(0.0)));
+        }
+
+        // An aircraft's company and vertiport depend only on its ID, not on how the fleet was added
+        {
+            Scene together;
+            Scene split;
+            for (Scene* scene : { &together, &split }) {
+                scene->addVertiport("North", 1);
+                scene->addVertiport("South", 1);
+                SampleCompanies::AddTo(*scene, { "Alpha", "Beta" });
+            }
+            together.addAircraft(50, 7);
+            split.addAircraft(20, 7);
+            split.addAircraft(30, 7);
+            size_t vertiportCount = 0;
+            for (uint32_t i = 0; i < 50; i++) {
+                assert_(together.fleet().companyId(i) == split.fleet().companyId(i));
+                assert_(together.fleet().vertiportId(i) == split.fleet().vertiportId(i));
+                vertiportCount += together.fleet().vertiportId(i);
+            }
+            assert_(vertiportCount > 0 && vertiportCount < 50);
+        }
+    }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
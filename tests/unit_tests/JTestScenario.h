@@ -0,0 +1,134 @@
+#ifndef TEST_SCENARIO_H
+#define TEST_SCENARIO_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <core/sim/JSimulator.h>
+#include <apps/eVTOL/sim/JScenarioGenerator.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class ScenarioTest : public Test
+{
+public:
+
+    ScenarioTest(): Test(){}
+    ~ScenarioTest() {}
+
+    /// @brief Perform unit tests for generating scenes
+    virtual void perform() {
+
+        // A generated scene should be the same for any number of threads, and the same as one built aircraft by aircraft
+        ScenarioSettings settings;
+        settings.m_aircraftCount = 200000;
+        settings.m_vertiportCount = 8;
+        settings.m_chargerCount = 4;
+        settings.m_seed = 7;
+        Scene serial;
+        addCompanies(serial);
+        ScenarioStatistics statistics = ScenarioGenerator(0).build(serial, settings);
+        assert_(serial.fleet().size() == settings.m_aircraftCount && serial.vertiports().size() == settings.m_vertiportCount);
+        assert_(statistics.m_memoryBytes >= settings.m_aircraftCount * (sizeof(RandomStream) + 6 * sizeof(double)));
+        for (const Vertiport& vertiport : serial.vertiports()) {
+            assert_(vertiport.chargerAllocator().chargers().size() == settings.m_chargerCount);
+        }
+
+        Scene parallel;
+        addCompanies(parallel);
+        ScenarioGenerator(4).build(parallel, settings);
+        assert_(sameAircraft(serial, parallel));
+
+        Scene incremental;
+        addCompanies(incremental);
+        for (size_t i = 0; i < settings.m_vertiportCount; i++) {
+            incremental.addVertiport("Vertiport " + std::to_string(i), settings.m_chargerCount);
+        }
+        for (size_t added = 0; added < settings.m_aircraftCount; added += 70001) {
+            incremental.addAircraft(std::min<size_t>(70001, settings.m_aircraftCount - added), settings.m_seed);
+        }
+        assert_(sameAircraft(serial, incremental));
+
+        // Weighted companies should build their share of the fleet, and companies with no weight none of it
+        {
+            ScenarioSettings weighted = settings;
+            weighted.m_companyWeights = { 2.0, 0.0, 1.0, 1.0 };
+            Scene scene;
+            addCompanies(scene);
+            ScenarioGenerator(2).build(scene, weighted);
+            std::vector<size_t> counts(scene.companies().size(), 0);
+            for (uint32_t i = 0; i < scene.fleet().size(); i++) {
+                counts[scene.fleet().companyId(i)]++;
+            }
+            double fleetSize = double(scene.fleet().size());
+            assert_(counts[1] == 0);
+            assert_(std::abs(counts[0] / fleetSize - 0.5) < 0.01);
+            assert_(std::abs(counts[2] / fleetSize - 0.25) < 0.01 && std::abs(counts[3] / fleetSize - 0.25) < 0.01);
+
+            // Weights must match the companies, and give some company a chance
+            weighted.m_companyWeights = { 1.0, 1.0 };
+            assert_(throws([&]() { Scene other; addCompanies(other); ScenarioGenerator(0).build(other, weighted); }));
+            weighted.m_companyWeights = { 0.0, 0.0, 0.0, 0.0 };
+            assert_(throws([&]() { Scene other; addCompanies(other); ScenarioGenerator(0).build(other, weighted); }));
+        }
+
+        // A generated scene should run like any other
+        {
+            ScenarioSettings small = settings;
+            small.m_aircraftCount = 40;
+            small.m_vertiportCount = 1;
+            Scene scene;
+            addCompanies(scene);
+            ScenarioGenerator(2).build(scene, small);
+            Simulator sim(0);
+            scene.initialize(sim);
+            sim.simulateUntil(3600.0, 1.0);
+            scene.finalize(sim.simulationTime());
+            double flightTime = 0.0;
+            for (const Company& company : scene.companies()) {
+                flightTime += company.statistics().m_flightTime;
+            }
+            assert_(flightTime > 0.0);
+        }
+    }
+
+private:
+
+    static void addCompanies(Scene& scene) {
+        SampleCompanies::AddTo(scene, { "Alpha", "Beta", "Delta", "Echo" });
+    }
+
+    /// @brief Whether two scenes have the same aircraft, bound for the same vertiports, with the same random streams
+    static bool sameAircraft(Scene& first, Scene& second) {
+        if (first.fleet().size() != second.fleet().size()) {
+            return false;
+        }
+        for (uint32_t i = 0; i < first.fleet().size(); i++) {
+            if (first.fleet().companyId(i) != second.fleet().companyId(i) ||
+                first.fleet().vertiportId(i) != second.fleet().vertiportId(i) ||
+                first.fleet().batteryCharge(i) != second.fleet().batteryCharge(i) ||
+                first.randomStream(i).state() != second.randomStream(i).state()) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
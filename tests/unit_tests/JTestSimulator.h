@@ -0,0 +1,137 @@
+#ifndef TEST_SIMULATOR_H
+#define TEST_SIMULATOR_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include <vector>
+#include <core/processes/JProcess.h>
+#include <core/sim/JSimulator.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class SimulatorTest : public Test
+{
+public:
+
+    SimulatorTest(): Test(){}
+    ~SimulatorTest() {}
+
+    /// @brief Perform unit tests for Simulator class
+    virtual void perform() {
+
+        // Events mid-step should split the step, and fire at exactly their own time
+        {
+            Simulator sim(1);
+            auto process = std::make_shared<IntegratingProcess>();
+            EventRecorder recorder(sim);
+            sim.eventDispatcher().setHandler<TestEventType>(recorder);
+            sim.processQueue().attachProcess(process);
+            for (double time : { 2.5, 3.0, 7.25 }) {
+                sim.eventQueue().schedule(Event{ time, (uint32_t)TestEventType::kRecord, 0 });
+            }
+
+            sim.simulateUntil(10.0, 1.0);
+            assert_(sim.simulationTime() == 10.0);
+            assert_(approxEqual(process->m_integratedTime, 10.0));
+            assert_(recorder.m_dispatchTimes.size() == 3);
+            assert_(recorder.m_dispatchTimes[0] == 2.5 && recorder.m_dispatchTimes[1] == 3.0 && recorder.m_dispatchTimes[2] == 7.25);
+            assert_(recorder.m_integratedTimes[0] == 2.5 && recorder.m_integratedTimes[2] == 7.25);
+
+            const SimulatorStatistics& statistics = sim.statistics();
+            assert_(statistics.m_fixedStepCount == 8);
+            assert_(statistics.m_partialStepCount == 4);
+            assert_(statistics.m_skippedStepCount == 0);
+            assert_(statistics.m_eventCount == 3);
+        }
+
+        // With no continuous process, the simulator should jump from event to event
+        {
+            Simulator sim(1);
+            EventRecorder recorder(sim);
+            sim.eventDispatcher().setHandler<TestEventType>(recorder);
+            sim.eventQueue().schedule(Event{ 10.5, (uint32_t)TestEventType::kRecord, 0 });
+            sim.eventQueue().schedule(Event{ 50.0, (uint32_t)TestEventType::kRecord, 0 });
+
+            sim.simulateUntil(100.0, 1.0);
+            assert_(recorder.m_dispatchTimes.size() == 2 && recorder.m_dispatchTimes[0] == 10.5);
+            assert_(sim.statistics().m_fixedStepCount == 0);
+            assert_(sim.statistics().m_skippedStepCount == 100);
+        }
+
+        // A paused process should be skipped until an event wakes it, after which stepping resumes on the grid
+        {
+            Simulator sim(1);
+            auto process = std::make_shared<IntegratingProcess>();
+            process->m_pauseTime = 5.0;
+            EventRecorder recorder(sim);
+            recorder.m_process = process.get();
+            sim.eventDispatcher().setHandler<TestEventType>(recorder);
+            sim.processQueue().attachProcess(process);
+            sim.eventQueue().schedule(Event{ 20.0, (uint32_t)TestEventType::kWake, 0 });
+
+            sim.simulateUntil(30.0, 1.0);
+            assert_(approxEqual(process->m_integratedTime, 15.0));
+            assert_(sim.statistics().m_fixedStepCount == 15);
+            assert_(sim.statistics().m_skippedStepCount == 15);
+        }
+    }
+
+private:
+
+    enum class TestEventType {
+        kRecord = 0,
+        kWake,
+        COUNT
+    };
+
+    /// @brief A continuous process that just integrates time, optionally pausing itself at a given time
+    class IntegratingProcess : public Process {
+    public:
+        virtual void onUpdate(double deltaSec) override {
+            m_integratedTime += deltaSec;
+            if (m_integratedTime >= m_pauseTime) {
+                m_pauseTime = std::numeric_limits<double>::infinity();
+                pause();
+            }
+        }
+        virtual void onFixedUpdate(double) override {}
+
+        double m_integratedTime = 0.0;
+        double m_pauseTime = std::numeric_limits<double>::infinity();
+    };
+
+    /// @brief Records when events are dispatched, and how far processes had been integrated at the time
+    struct EventRecorder {
+        EventRecorder(Simulator& simulator): m_simulator(simulator) {}
+
+        template<TestEventType Type>
+        void onEvent(const Event&) {
+            if constexpr (Type == TestEventType::kRecord) {
+                m_dispatchTimes.push_back(m_simulator.simulationTime());
+                m_integratedTimes.push_back(m_process ? m_process->m_integratedTime : m_simulator.simulationTime());
+            }
+            else {
+                m_process->unPause();
+            }
+        }
+
+        Simulator& m_simulator;
+        IntegratingProcess* m_process = nullptr;
+        std::vector<double> m_dispatchTimes;
+        std::vector<double> m_integratedTimes;
+    };
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
@@ -0,0 +1,221 @@
+#ifndef TEST_STATISTICS_H
+#define TEST_STATISTICS_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <core/random/JRandomStream.h>
+#include <core/serialization/JBinaryStream.h>
+#include <core/sim/JPartitionedSimulator.h>
+#include <core/statistics/JDistribution.h>
+#include <core/statistics/JLinearHistogram.h>
+#include <core/statistics/JLogHistogram.h>
+#include <core/threading/JShards.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class StatisticsTest : public Test
+{
+public:
+
+    StatisticsTest(): Test(){}
+    ~StatisticsTest() {}
+
+    /// @brief Perform unit tests for histograms, distributions and sharded accumulators
+    virtual void perform() {
+
+        // Log histogram buckets should tile the line, and be no wider than the promised fraction of their values
+        {
+            LogHistogram histogram(0.5, 4);
+            histogram.add(1e9);
+            for (size_t i = 0; i + 1 < histogram.bucketCount(); i++) {
+                double lower = histogram.bucketLowerBound(i);
+                double upper = histogram.bucketUpperBound(i);
+                assert_(upper > lower && upper == histogram.bucketLowerBound(i + 1));
+                assert_(upper - lower <= std::max(0.5, lower / 8.0));
+            }
+            LogHistogram bucketed(0.5, 4);
+            for (size_t i = 0; i + 1 < histogram.bucketCount(); i += 7) {
+                bucketed.clear();
+                bucketed.add(histogram.bucketLowerBound(i));
+                bucketed.add(0.5 * (histogram.bucketLowerBound(i) + histogram.bucketUpperBound(i)));
+                assert_(bucketed.bucketCount() == i + 1 && bucketed.bucketSampleCount(i) == 2);
+            }
+        }
+
+        // Quantiles should be within a bucket of the exact ones, for long-tailed samples
+        RandomStream stream(13, 0);
+        std::vector<double> samples(20000);
+        stream.exponentials(0.5, samples.data(), samples.size());
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        {
+            LogHistogram histogram(1e-3, 6);
+            for (double sample : samples) {
+                histogram.add(sample);
+            }
+            for (double fraction : { 0.1, 0.5, 0.9, 0.99 }) {
+                double exact = sorted[size_t(fraction * sorted.size())];
+                assert_(std::abs(histogram.quantile(fraction) - exact) <= exact / 32.0 + 1e-3);
+            }
+        }
+
+        // Merging should give exactly the same histogram however the samples are split and grouped
+        {
+            const size_t shardCount = 4;
+            LogHistogram all(1e-3, 6);
+            LinearHistogram allLinear(0.0, 4.0, 16);
+            std::vector<LogHistogram> shards(shardCount, LogHistogram(1e-3, 6));
+            std::vector<LinearHistogram> linearShards(shardCount, LinearHistogram(0.0, 4.0, 16));
+            for (size_t i = 0; i < samples.size(); i++) {
+                all.add(samples[i]);
+                allLinear.add(samples[i] - 0.1);
+                shards[(i * 7) % shardCount].add(samples[i]);
+                linearShards[(i * 7) % shardCount].add(samples[i] - 0.1);
+            }
+            LogHistogram leftFirst = shards[0];
+            leftFirst.merge(shards[1]);
+            leftFirst.merge(shards[2]);
+            leftFirst.merge(shards[3]);
+            LogHistogram rightFirst = shards[2];
+            rightFirst.merge(shards[3]);
+            LogHistogram paired = shards[1];
+            paired.merge(shards[0]);
+            paired.merge(rightFirst);
+            for (const LogHistogram* merged : { &leftFirst, &paired }) {
+                assert_(merged->count() == all.count() && merged->bucketCount() == all.bucketCount());
+                for (size_t i = 0; i < all.bucketCount(); i++) {
+                    assert_(merged->bucketSampleCount(i) == all.bucketSampleCount(i));
+                }
+            }
+
+            LinearHistogram linear = linearShards[3];
+            for (size_t i = 0; i < 3; i++) {
+                linear.merge(linearShards[i]);
+            }
+            assert_(linear.count() == samples.size() && linear.underflowCount() == allLinear.underflowCount());
+            assert_(linear.underflowCount() > 0 && linear.overflowCount() > 0);
+            assert_(linear.overflowCount() == allLinear.overflowCount());
+            for (size_t i = 0; i < linear.bucketCount(); i++) {
+                assert_(linear.bucketSampleCount(i) == allLinear.bucketSampleCount(i));
+            }
+            double exactMedian = sorted[sorted.size() / 2] - 0.1;
+            assert_(std::abs(linear.quantile(0.5) - exactMedian) < 0.25);
+
+            // Histograms with different buckets can't be merged
+            assert_(throws([&]() { all.merge(LogHistogram(1e-3, 5)); }));
+            assert_(throws([&]() { linear.merge(LinearHistogram(0.0, 4.0, 8)); }));
+        }
+
+        // Distributions should survive a round trip through a checkpoint
+        {
+            Distribution distribution(1e-3);
+            for (double sample : samples) {
+                distribution.add(sample);
+            }
+            BinaryWriter writer;
+            distribution.save(writer);
+            Distribution loaded(1e-3);
+            BinaryReader reader(writer.buffer());
+            loaded.load(reader);
+            assert_(loaded.count() == distribution.count() && loaded.mean() == distribution.mean());
+            assert_(loaded.statistics().variance() == distribution.statistics().variance());
+            assert_(loaded.quantile(0.9) == distribution.quantile(0.9));
+        }
+
+        // Threads writing their own shards should need no locks, and merge to the serial result
+        {
+            const size_t threadCount = 4;
+            Shards<Distribution> shards(threadCount, Distribution(1e-3));
+            for (size_t i = 0; i < threadCount; i++) {
+                assert_(reinterpret_cast<uintptr_t>(&shards[i]) % Shards<Distribution>::s_cacheLineSize == 0);
+            }
+            std::vector<std::thread> threads;
+            for (size_t thread = 0; thread < threadCount; thread++) {
+                threads.emplace_back([&, thread]() {
+                    for (size_t i = thread; i < samples.size(); i += threadCount) {
+                        shards[thread].add(samples[i]);
+                    }
+                });
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+            Distribution merged(1e-3);
+            shards.mergeInto(merged, [](Distribution& into, const Distribution& shard) { into.merge(shard); });
+            Distribution serial(1e-3);
+            for (double sample : samples) {
+                serial.add(sample);
+            }
+            assert_(merged.count() == serial.count());
+            assert_(approxEqual(merged.mean(), serial.mean(), 1e-12));
+            assert_(approxEqual(merged.statistics().variance(), serial.statistics().variance(), 1e-9));
+            assert_(merged.quantile(0.5) == serial.quantile(0.5) && merged.quantile(0.99) == serial.quantile(0.99));
+        }
+
+        // A scene's distributions should count every landing and charge, whether partitioned or not
+        for (bool partitioned : { false, true }) {
+            Scene scene;
+            for (size_t i = 0; i < 4; i++) {
+                scene.addVertiport("Vertiport " + std::to_string(i), 2);
+            }
+            SampleCompanies::AddTo(scene, { "Alpha", "Echo" });
+            scene.addAircraft(80, 3);
+            Simulator sim(0);
+            PartitionedSimulator partitionedSim(scene.vertiports().size(), 2);
+            if (partitioned) {
+                scene.initialize(partitionedSim);
+                partitionedSim.simulateUntil(s_endTime);
+            }
+            else {
+                scene.initialize(sim);
+                sim.simulateUntil(s_endTime, 1.0);
+            }
+            scene.finalize(s_endTime);
+
+            size_t arrivalCount = 0;
+            for (const Vertiport& vertiport : scene.vertiports()) {
+                arrivalCount += vertiport.arrivalCount();
+            }
+            size_t flightCount = 0;
+            for (uint32_t i = 0; i < scene.companies().size(); i++) {
+                const Company& company = scene.companies()[i];
+                const CompanyDistributions& distributions = company.distributions();
+                const CompanyStatistics& statistics = company.statistics();
+                flightCount += distributions.m_flightTime.count();
+                assert_(distributions.m_distance.count() == distributions.m_flightTime.count());
+                assert_(distributions.m_waitTime.count() == statistics.m_chargeCount);
+                assert_(distributions.m_chargeTime.count() <= statistics.m_chargeCount);
+                assert_(distributions.m_waitTime.statistics().min() >= 0.0);
+
+                // Every flight starts on a full battery and ends when it runs out
+                assert_(approxEqual(distributions.m_flightTime.mean(), scene.fleet().fullChargeHours(i), 1e-9));
+                assert_(distributions.m_flightTime.statistics().variance() < 1e-12);
+            }
+            assert_(flightCount == arrivalCount && flightCount > 0);
+        }
+    }
+
+private:
+
+    static constexpr double s_endTime = 6.0 * 3600.0;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
@@ -0,0 +1,205 @@
+#ifndef TEST_TABLE_H
+#define TEST_TABLE_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <core/containers/JString.h>
+#include <core/random/JRandomStream.h>
+#include <core/serialization/JTable.h>
+#include <core/sim/JEnsembleRunner.h>
+#include <core/sim/JSimulator.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class TableTest : public Test
+{
+public:
+
+    TableTest(): Test(){}
+    ~TableTest() {}
+
+    /// @brief Perform unit tests for exporting tables to CSV and to the columnar format
+    virtual void perform() {
+        const std::vector<TableColumn> columns = {
+            { "id", TableColumnType::kInteger },
+            { "name", TableColumnType::kText },
+            { "value", TableColumnType::kReal }
+        };
+
+        // CSV should quote text that needs it, and write doubles in a form that parses back exactly
+        {
+            {
+                TableWriter writer(s_csvPath, columns, TableFormat::kCsv);
+                writer.add(uint64_t(7)).add("plain").add(0.1);
+                writer.endRow();
+                writer.add(uint64_t(18446744073709551615ull)).add("a \"quoted\", name").add(1.0 / 3.0);
+                writer.endRow();
+                writer.add(uint64_t(0)).add("").add(-2.5e-300);
+                writer.endRow();
+                assert_(writer.rowCount() == 3);
+            }
+            std::vector<std::string> lines = readLines(s_csvPath);
+            assert_(lines.size() == 4 && lines[0] == "id,name,value");
+            assert_(lines[1] == "7,plain,0.1");
+            assert_(lines[2].rfind("18446744073709551615,\"a \"\"quoted\"\", name\",", 0) == 0);
+            double third = 0.0;
+            assert_(JString::ToNumber(std::string_view(lines[2]).substr(lines[2].rfind(',') + 1), third) && third == 1.0 / 3.0);
+            assert_(lines[3] == "0,,-2.5e-300");
+
+            // Appending shouldn't repeat the header
+            {
+                TableWriter writer(s_csvPath, columns, TableFormat::kCsv, true);
+                writer.add(uint64_t(8)).add("appended").add(4.0);
+                writer.endRow();
+            }
+            lines = readLines(s_csvPath);
+            assert_(lines.size() == 5 && lines[4] == "8,appended,4");
+        }
+
+        // Values must match their columns, and rows must be complete
+        {
+            TableWriter writer(s_csvPath, columns, TableFormat::kCsv);
+            assert_(throws([&]() { writer.add(1.0); }));
+            assert_(throws([&]() { writer.endRow(); }));
+            writer.add(uint64_t(1)).add("name").add(2.0);
+            assert_(throws([&]() { writer.add(3.0); }));
+            writer.endRow();
+            assert_(writer.rowCount() == 1);
+        }
+        assert_(Table::FormatOf("summary.csv") == TableFormat::kCsv && Table::FormatOf("summary.table") == TableFormat::kColumnar);
+
+        // Columnar tables should read back exactly, across several batches, and convert to the same CSV
+        {
+            RandomStream stream(3, 0);
+            const size_t rowCount = 1000;
+            std::vector<double> values(rowCount);
+            stream.uniforms(values.data(), rowCount);
+            {
+                TableWriter columnar(s_tablePath, columns, TableFormat::kColumnar, false, 64);
+                TableWriter csv(s_csvPath, columns, TableFormat::kCsv, false, 64);
+                for (TableWriter* writer : { &columnar, &csv }) {
+                    for (size_t i = 0; i < rowCount; i++) {
+                        writer->add(uint64_t(i * i)).add(i % 3 ? "Company " + std::to_string(i % 5) : "").add(values[i]);
+                        writer->endRow();
+                    }
+                    writer->flush();
+                }
+                assert_(columnar.writtenBytes() < csv.writtenBytes());
+            }
+
+            TableReader reader(s_tablePath);
+            assert_(reader.columns().size() == columns.size());
+            for (size_t i = 0; i < columns.size(); i++) {
+                assert_(reader.columns()[i].m_name == columns[i].m_name && reader.columns()[i].m_type == columns[i].m_type);
+            }
+            TableBatch batch;
+            size_t row = 0;
+            while (reader.readBatch(batch)) {
+                assert_(batch.m_rowCount <= 64);
+                for (size_t i = 0; i < batch.m_rowCount; i++, row++) {
+                    assert_(batch.m_columns[0].m_integers[i] == row * row);
+                    assert_(batch.m_columns[1].text(i) == (row % 3 ? "Company " + std::to_string(row % 5) : ""));
+                    assert_(batch.m_columns[2].m_reals[i] == values[row]);
+                }
+            }
+            assert_(row == rowCount);
+
+            std::string convertedPath = std::string(s_csvPath) + ".converted";
+            assert_(TableReader::ToCsv(s_tablePath, convertedPath) == rowCount);
+            assert_(readLines(convertedPath) == readLines(s_csvPath));
+            std::remove(convertedPath.c_str());
+
+            // Anything else should be refused
+            assert_(throws([&]() { TableReader csvReader(s_csvPath); }));
+        }
+
+        // Ensembles should hand every replica's samples to their handler, in order
+        {
+            EnsembleRunner runner(2);
+            std::vector<double> exported;
+            runner.setReplicaHandler([&](size_t firstReplica, size_t replicaCount, size_t metricCount, const double* samples) {
+                assert_(firstReplica * metricCount == exported.size());
+                exported.insert(exported.end(), samples, samples + replicaCount * metricCount);
+            });
+            StoppingRule rule;
+            rule.m_minReplicaCount = 10;
+            rule.m_maxReplicaCount = 50;
+            rule.m_relativeHalfWidth = 1e-9;
+            EnsembleSummary summary = runner.runUntil(rule, 2, [](size_t replica, double* outMetrics) {
+                outMetrics[0] = double(replica);
+                outMetrics[1] = double(replica * replica);
+            });
+            assert_(exported.size() == 2 * summary.m_replicaCount && summary.m_replicaCount == 50);
+            for (size_t replica = 0; replica < summary.m_replicaCount; replica++) {
+                assert_(exported[2 * replica] == double(replica) && exported[2 * replica + 1] == double(replica * replica));
+            }
+        }
+
+        // A scene should export a row per company that matches its statistics
+        {
+            Scene scene;
+            scene.setChargerCount(3);
+            SampleCompanies::AddTo(scene, { "Alpha" });
+            scene.addCompany("Echo, Inc.", SampleCompanies::Specification("Echo"));
+            scene.addAircraft(20, 5);
+            Simulator sim(0);
+            scene.initialize(sim);
+            sim.simulateUntil(3.0 * 3600.0, 1.0);
+            scene.finalize(sim.simulationTime());
+            {
+                TableWriter writer(s_tablePath, Scene::SummaryColumns(), TableFormat::kColumnar);
+                scene.exportSummary(writer);
+            }
+            TableReader reader(s_tablePath);
+            TableBatch batch;
+            TableBatch end;
+            assert_(reader.readBatch(batch) && batch.m_rowCount == 2 && !reader.readBatch(end));
+            for (size_t i = 0; i < scene.companies().size(); i++) {
+                const CompanyStatistics& statistics = scene.companies()[i].statistics();
+                assert_(batch.m_columns[0].text(i) == scene.companies()[i].name());
+                assert_(batch.m_columns[1].m_integers[i] == statistics.m_flightCount && statistics.m_flightCount > 0);
+                assert_(batch.m_columns[2].m_reals[i] == statistics.m_flightTime);
+                assert_(batch.m_columns[7].m_integers[i] == statistics.m_faultCount);
+            }
+        }
+
+        std::remove(s_csvPath);
+        std::remove(s_tablePath);
+    }
+
+private:
+
+    static std::vector<std::string> readLines(const std::string& path) {
+        std::ifstream file(path);
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(file, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    static constexpr const char* s_csvPath = "test_table.csv";
+    static constexpr const char* s_tablePath = "test_table.table";
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
@@ -0,0 +1,215 @@
+#ifndef TEST_TRACE_H
+#define TEST_TRACE_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <core/diagnostics/JRunHash.h>
+#include <core/diagnostics/JTrace.h>
+#include <core/random/JRandomStream.h>
+#include <core/serialization/JLz4.h>
+#include <core/sim/JPartitionedSimulator.h>
+#include <core/sim/JSimulator.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class TraceTest : public Test
+{
+public:
+
+    TraceTest(): Test(){}
+    ~TraceTest() {}
+
+    /// @brief Perform unit tests for LZ4 blocks, and for recording and reading traces
+    virtual void perform() {
+
+        // Blocks should survive a round trip, whether they compress well or not at all
+        {
+            RandomStream stream(5, 0);
+            std::vector<char> random(100000);
+            for (char& byte : random) {
+                byte = char(stream.uniform() * 256.0);
+            }
+            std::vector<char> repetitive(100000);
+            for (size_t i = 0; i < repetitive.size(); i++) {
+                repetitive[i] = char((i / 13) % 3);
+            }
+            std::vector<char> tiny = { 'a', 'b', 'c' };
+            for (const std::vector<char>* data : { &random, &repetitive, &tiny }) {
+                std::vector<char> compressed = { 'x' };
+                size_t compressedSize = Lz4::Compress(data->data(), data->size(), compressed);
+                assert_(compressed.size() == compressedSize + 1 && compressed[0] == 'x');
+                assert_(compressedSize <= Lz4::MaxCompressedSize(data->size()));
+                std::vector<char> decompressed(data->size());
+                Lz4::Decompress(compressed.data() + 1, compressedSize, decompressed.data(), decompressed.size());
+                assert_(decompressed == *data);
+            }
+            std::vector<char> compressed;
+            Lz4::Compress(repetitive.data(), repetitive.size(), compressed);
+            assert_(compressed.size() < repetitive.size() / 20);
+
+            // Truncated blocks, and blocks that decompress to the wrong size, should throw rather than overrun
+            std::vector<char> decompressed(repetitive.size());
+            assert_(throws([&]() { Lz4::Decompress(compressed.data(), compressed.size() / 2, decompressed.data(), decompressed.size()); }));
+            assert_(throws([&]() { Lz4::Decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size() - 1); }));
+        }
+
+        // Records from several threads should all be read back, in order within each thread
+        for (bool compress : { true, false }) {
+            const size_t threadCount = 3;
+            const size_t recordCount = 10000;
+            TraceSchema schema;
+            schema.m_stateNames = { "on", "off" };
+            {
+                TraceRecorder recorder(s_tracePath, schema, threadCount, compress, 256);
+                std::vector<std::thread> threads;
+                for (size_t thread = 0; thread < threadCount; thread++) {
+                    threads.emplace_back([&, thread]() {
+                        for (uint32_t i = 0; i < recordCount; i++) {
+                            recorder.record(thread, TraceRecord{ 0.5 * i, uint32_t(thread), i % 7, uint8_t(i % 2) });
+                        }
+                    });
+                }
+                for (std::thread& thread : threads) {
+                    thread.join();
+                }
+                recorder.flush();
+                assert_(recorder.writtenCount() == threadCount * recordCount);
+            }
+
+            TraceReader reader(s_tracePath);
+            assert_(reader.schema().m_entityName == "entity" && reader.schema().m_stateNames == schema.m_stateNames);
+            assert_(reader.stateName(1) == "off" && reader.stateName(9) == "9");
+            std::vector<uint32_t> nextIndex(threadCount, 0);
+            std::vector<TraceRecord> records;
+            while (reader.readBlock(records)) {
+                for (const TraceRecord& record : records) {
+                    uint32_t& i = nextIndex[record.m_entity];
+                    assert_(record.m_time == 0.5 * i && record.m_location == i % 7 && record.m_state == i % 2);
+                    i++;
+                }
+            }
+            for (uint32_t count : nextIndex) {
+                assert_(count == recordCount);
+            }
+        }
+
+        // Traces should convert to CSV with a header row and state names
+        {
+            TraceSchema schema;
+            schema.m_entityName = "robot";
+            schema.m_locationName = "room";
+            schema.m_stateNames = { "idle", "busy" };
+            {
+                TraceRecorder recorder(s_tracePath, schema);
+                recorder.record(0, TraceRecord{ 1.5, 3, 2, 1 });
+                recorder.record(0, TraceRecord{ 2.25, 4, 0, 0 });
+            }
+            assert_(TraceReader::ToCsv(s_tracePath, s_csvPath) == 2);
+            std::ifstream csv(s_csvPath);
+            std::string header, first, second;
+            std::getline(csv, header);
+            std::getline(csv, first);
+            std::getline(csv, second);
+            assert_(header == "time,robot,room,state");
+            assert_(first == "1.5,3,2,busy" && second == "2.25,4,0,idle");
+            std::remove(s_csvPath);
+
+            // Anything else should be refused
+            assert_(throws([&]() { TraceReader reader(s_csvPath); }));
+        }
+
+        // Tracing a scene shouldn't change its run, and should see every charge
+        {
+            uint64_t untracedHash = runScene(nullptr);
+            TraceRecorder recorder(s_tracePath, Scene::AircraftTraceSchema());
+            uint64_t tracedHash = runScene(&recorder);
+            assert_(tracedHash == untracedHash);
+        }
+        for (bool partitioned : { false, true }) {
+            Scene scene;
+            for (size_t i = 0; i < 4; i++) {
+                scene.addVertiport("Vertiport " + std::to_string(i), 2);
+            }
+            SampleCompanies::AddTo(scene, { "Alpha", "Echo" });
+            scene.addAircraft(80, 3);
+            TraceRecorder recorder(s_tracePath, Scene::AircraftTraceSchema(), scene.vertiports().size(), true, 64);
+            scene.setTraceRecorder(&recorder);
+            Simulator sim(0);
+            PartitionedSimulator partitionedSim(scene.vertiports().size(), 2);
+            if (partitioned) {
+                scene.initialize(partitionedSim);
+                partitionedSim.simulateUntil(s_endTime);
+            }
+            else {
+                scene.initialize(sim);
+                sim.simulateUntil(s_endTime, 1.0);
+            }
+            scene.finalize(s_endTime);
+            recorder.flush();
+
+            std::vector<size_t> stateCounts(3, 0);
+            std::vector<TraceRecord> records;
+            TraceReader reader(s_tracePath);
+            while (reader.readBlock(records)) {
+                for (const TraceRecord& record : records) {
+                    assert_(record.m_entity < scene.fleet().size() && record.m_location < scene.vertiports().size());
+                    assert_(record.m_time >= 0.0 && record.m_time <= s_endTime);
+                    stateCounts[record.m_state]++;
+                }
+            }
+            size_t chargeCount = 0;
+            for (const Company& company : scene.companies()) {
+                chargeCount += company.statistics().m_chargeCount;
+            }
+            // Aircraft still waiting for a charger at the end have waited, but not charged
+            assert_(stateCounts[2] == chargeCount && chargeCount > 0);
+            assert_(stateCounts[1] >= stateCounts[2] && stateCounts[0] >= scene.fleet().size());
+        }
+        std::remove(s_tracePath);
+    }
+
+private:
+
+    /// @brief Run a small scene, traced to the given recorder if there is one, returning the run hash
+    uint64_t runScene(TraceRecorder* recorder) {
+        Scene scene;
+        scene.setChargerCount(3);
+        SampleCompanies::AddTo(scene, { "Alpha", "Beta" });
+        scene.addAircraft(20, 7);
+        scene.setTraceRecorder(recorder);
+
+        Simulator sim(1);
+        sim.setDeterministic(true);
+        scene.initialize(sim);
+        sim.simulateUntil(s_endTime, 1.0);
+        scene.finalize(sim.simulationTime());
+        scene.hashState(sim.runHash());
+        return sim.runHash().value();
+    }
+
+    static constexpr double s_endTime = 6.0 * 3600.0;
+    static constexpr const char* s_tracePath = "test.trace";
+    static constexpr const char* s_csvPath = "test.trace.csv";
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif
@@ -0,0 +1,203 @@
+#ifndef TEST_VERTIPORTS_H
+#define TEST_VERTIPORTS_H
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Includes
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../JTest.h"
+#include "../JSampleCompanies.h"
+#include <string>
+#include <vector>
+#include <core/diagnostics/JRunHash.h>
+#include <core/serialization/JBinaryStream.h>
+#include <core/sim/JPartitionedSimulator.h>
+#include <core/sim/JSimulator.h>
+#include <apps/eVTOL/sim/JScene.h>
+
+namespace joby{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class VertiportTest : public Test
+{
+public:
+
+    VertiportTest(): Test(){}
+    ~VertiportTest() {}
+
+    /// @brief Perform unit tests for vertiport networks, and for running them as partitions
+    virtual void perform() {
+        // A partitioned scene with a single vertiport should take exactly the same path as one on the simulator
+        {
+            Scene serial;
+            setUpScene(serial, 1, 3, 40);
+            Simulator sim(0);
+            sim.setDeterministic(true);
+            serial.initialize(sim);
+            sim.simulateUntil(s_endTime, 1.0);
+            serial.finalize(sim.simulationTime());
+
+            Scene partitioned;
+            setUpScene(partitioned, 1, 3, 40);
+            PartitionedSimulator partitionedSim(1, 0);
+            partitioned.initialize(partitionedSim);
+            partitionedSim.simulateUntil(s_endTime);
+            partitioned.finalize(partitionedSim.simulationTime());
+
+            assert_(hashScene(serial) == hashScene(partitioned));
+            assert_(partitionedSim.statistics().m_sentCount == 0);
+        }
+
+        // Networks should give the same results for any number of threads
+        uint64_t hash = 0;
+        for (size_t threadCount : { 0, 1, 4 }) {
+            Scene scene;
+            setUpScene(scene, 8, 2, 200);
+            PartitionedSimulator sim(scene.vertiports().size(), threadCount);
+            scene.initialize(sim);
+            sim.simulateUntil(s_endTime);
+            scene.finalize(sim.simulationTime());
+
+            if (!threadCount) {
+                hash = hashScene(scene);
+                checkTotals(scene);
+                assert_(sim.statistics().m_sentCount > 0 && sim.statistics().m_windowCount > 1);
+            }
+            assert_(hashScene(scene) == hash);
+        }
+
+        // The same network on the simulator should agree closely, since only the order of simultaneous events
+        // at different vertiports and the order in which statistics are added up can differ
+        {
+            std::vector<CompanyStatistics> statistics[2];
+            for (size_t partitioned = 0; partitioned < 2; partitioned++) {
+                Scene scene;
+                setUpScene(scene, 8, 2, 200);
+                Simulator sim(0);
+                PartitionedSimulator partitionedSim(scene.vertiports().size(), 2);
+                if (partitioned) {
+                    scene.initialize(partitionedSim);
+                    partitionedSim.simulateUntil(s_endTime);
+                }
+                else {
+                    scene.initialize(sim);
+                    sim.simulateUntil(s_endTime, 1.0);
+                }
+                scene.finalize(s_endTime);
+                checkTotals(scene);
+                for (const Company& company : scene.companies()) {
+                    statistics[partitioned].push_back(company.statistics());
+                }
+            }
+            for (size_t i = 0; i < statistics[0].size(); i++) {
+                assert_(statistics[0][i].m_flightCount == statistics[1][i].m_flightCount);
+                assert_(statistics[0][i].m_faultCount == statistics[1][i].m_faultCount);
+                assert_(approxEqual(statistics[0][i].m_flightTime, statistics[1][i].m_flightTime, 1e-9 * statistics[0][i].m_flightTime));
+                assert_(approxEqual(statistics[0][i].m_waitTime, statistics[1][i].m_waitTime, 1e-9 * statistics[0][i].m_waitTime + 1e-9));
+            }
+        }
+
+        // Events sent to another partition within the lookahead should be refused
+        {
+            PartitionedSimulator sim(2, 0);
+            sim.setLookahead(10.0);
+            Sender sender{ &sim, 5.0 };
+            sim.eventDispatcher().setHandler<SenderEventType>(sender);
+            sim.eventQueue(0).schedule(Event{ 1.0, 0, 0 });
+            bool threw = false;
+            try {
+                sim.simulateUntil(100.0);
+            }
+            catch (const std::logic_error&) {
+                threw = true;
+            }
+            assert_(threw);
+        }
+
+        // Only analytic scenes with one partition per vertiport can be partitioned, and they can't be checkpointed
+        {
+            Scene scene;
+            setUpScene(scene, 3, 1, 10);
+            PartitionedSimulator mismatched(2, 0);
+            assert_(throws([&]() { scene.initialize(mismatched); }));
+            scene.setFlightModel(FlightModel::kFixedStep);
+            PartitionedSimulator sim(3, 0);
+            assert_(throws([&]() { scene.initialize(sim); }));
+            scene.setFlightModel(FlightModel::kAnalytic);
+            scene.initialize(sim);
+            BinaryWriter writer;
+            assert_(throws([&]() { scene.save(writer); }));
+        }
+    }
+
+private:
+
+    enum class SenderEventType { kSend = 0, COUNT };
+
+    /// @brief Handles every event on the first partition by sending another to the second, after a delay
+    struct Sender {
+        template<SenderEventType Type>
+        void onEvent(const Event& event) {
+            m_simulator->send(0, 1, Event{ event.m_time + m_delay, 0, 0 });
+        }
+
+        PartitionedSimulator* m_simulator;
+        double m_delay;
+    };
+
+    /// @brief Set up a scene with the given number of vertiports and chargers at each, and aircraft spread across them
+    static void setUpScene(Scene& scene, size_t vertiportCount, size_t chargerCount, size_t aircraftCount) {
+        for (size_t i = 0; i < vertiportCount; i++) {
+            scene.addVertiport("Vertiport " + std::to_string(i), chargerCount);
+        }
+        SampleCompanies::AddTo(scene, { "Alpha", "Beta", "Echo" });
+        scene.addAircraft(aircraftCount, 17);
+    }
+
+    /// @brief Check that the traffic through the vertiports adds up to the activity of the companies
+    void checkTotals(const Scene& scene) {
+        size_t departureCount = 0;
+        size_t arrivalCount = 0;
+        size_t chargeCount = 0;
+        size_t busyVertiportCount = 0;
+        for (const Vertiport& vertiport : scene.vertiports()) {
+            departureCount += vertiport.departureCount();
+            arrivalCount += vertiport.arrivalCount();
+            busyVertiportCount += vertiport.arrivalCount() ? 1 : 0;
+            for (const Charger& charger : vertiport.chargers()) {
+                chargeCount += charger.chargeCount();
+            }
+        }
+
+        // Every flight either landed or is still in the air
+        size_t flightCount = 0;
+        size_t companyChargeCount = 0;
+        size_t flyingCount = 0;
+        for (uint32_t i = 0; i < scene.companies().size(); i++) {
+            flightCount += scene.companies()[i].statistics().m_flightCount;
+            companyChargeCount += scene.companies()[i].statistics().m_chargeCount;
+            flyingCount += scene.fleet().flyingCount(i);
+        }
+        assert_(departureCount == flightCount && chargeCount == companyChargeCount);
+        assert_(arrivalCount + flyingCount == flightCount);
+        assert_(busyVertiportCount == scene.vertiports().size());
+    }
+
+    static uint64_t hashScene(const Scene& scene) {
+        RunHash hash;
+        scene.hashState(hash);
+        return hash.value();
+    }
+
+    static constexpr double s_endTime = 3.0 * 3600.0;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// End namespaces
+}
+
+
+#endif